@@ -0,0 +1,42 @@
+/**
+ * Report.h
+ *
+ * End-of-run summary for all stations
+ *
+ * printReport() writes one line per station (verdict, tests passed/failed,
+ * first failing cell or the error, time) and the totals with throughput in
+ * boards per hour. writeCsv() writes one row per test result for the
+ * production log.
+ *
+ * Usage:
+ *   printReport(stdout, stations, wallMs);
+ *   writeCsv("run.csv", stations, error);
+ */
+
+#ifndef REPORT_H
+#define REPORT_H
+
+#include "Station.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+typedef std::vector<std::unique_ptr<Station>> StationList;
+
+const char* verdictName(Verdict verdict);
+
+/**
+ * Per-station table and totals
+ */
+void printReport(FILE* out, const StationList& stations, uint32_t wallMs);
+
+/**
+ * CSV:  station,port,step,command,test,name,result,elapsed_ms
+ *
+ * @return false with error set if the file can't be written
+ */
+bool writeCsv(const std::string& path, const StationList& stations, std::string& error);
+
+#endif // REPORT_H
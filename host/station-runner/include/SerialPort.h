@@ -0,0 +1,82 @@
+/**
+ * SerialPort.h
+ *
+ * Non-blocking POSIX serial port (termios), 8N1, raw
+ *
+ * The runner polls many ports from one thread, so reads and writes never
+ * block: read() returns what is there, write() queues what the driver
+ * doesn't take yet and flush() retries it.
+ *
+ * Usage:
+ *   SerialPort port;
+ *   if (!port.open("/dev/ttyACM0", 115200)) { ... port.getError() ... }
+ *   port.write("STATUS\n");
+ *   uint8_t buffer[256];
+ *   ssize_t n = port.read(buffer, sizeof(buffer));
+ *   port.setBaud(1000000);    // after PROTO BIN 1000000 was acknowledged
+ */
+
+#ifndef SERIAL_PORT_H
+#define SERIAL_PORT_H
+
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+class SerialPort {
+public:
+    SerialPort();
+    ~SerialPort();
+
+    SerialPort(const SerialPort&) = delete;
+    SerialPort& operator=(const SerialPort&) = delete;
+
+    /**
+     * Open and configure the port (raw 8N1, no flow control)
+     *
+     * Opening resets the Mega (DTR), so the firmware banner follows.
+     *
+     * @return false on error (see getError())
+     */
+    bool open(const std::string& path, uint32_t baud);
+    void close();
+
+    /**
+     * Change the baud rate of an open port
+     *
+     * @return false if the rate isn't supported on this host
+     */
+    bool setBaud(uint32_t baud);
+
+    /**
+     * @return bytes read, 0 if none available, -1 on error
+     */
+    ssize_t read(uint8_t* buffer, size_t size);
+
+    /**
+     * Queue text for sending and send as much as the driver takes
+     *
+     * @return false on error
+     */
+    bool write(const std::string& text);
+
+    /**
+     * Send queued output
+     *
+     * @return false on error
+     */
+    bool flush();
+
+    bool hasPendingOutput() const { return !pending.empty(); }
+    int getFd() const { return fd; }
+    const std::string& getError() const { return error; }
+
+private:
+    int fd;
+    std::string pending;
+    std::string error;
+
+    void setError(const std::string& what);
+};
+
+#endif // SERIAL_PORT_H
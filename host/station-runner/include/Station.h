@@ -0,0 +1,160 @@
+/**
+ * Station.h
+ *
+ * One tester board: serial port, plan progress and collected results
+ *
+ * Each station runs the plan on its own, driven by the runner's poll loop
+ * (onInput() when the port is readable, onTick() a few times per second),
+ * so boards never wait for each other.
+ *
+ * Step completion: the firmware has no common "done" line for every
+ * command (SRAM tests run in the background, single tests print no
+ * summary). After a step's output has been quiet for quietMs, the station
+ * sends STATUS. A mid-test reply ("STATUS: Test 3 ..." or a PROGRESS
+ * record) means it is still running; the idle status report means the step
+ * is done. The report itself is not part of the results. A probe lost
+ * while a Z80/6502 run has interrupts off is sent again after probeRetryMs.
+ *
+ * Results come from text lines and binary records alike:
+ *   "OK: Test 1 (Walking 1s) - PASSED" / TEST_END      per-test result
+ *   "ERROR: Test 8 FAIL - Addr: ..."   / FAILURE       first failing cell
+ *   "OK: All tests PASSED"             / SUMMARY       suite verdict
+ * Any other ERROR line is a command error and ends the station's plan.
+ *
+ * Usage:
+ *   Station station("A", "/dev/ttyACM0", plan, options);
+ *   station.start(now);
+ *   ... poll(station.getFd()) ...
+ *   station.onInput(now);
+ *   station.onTick(now);
+ *   if (station.isDone()) { ... station.getVerdict() ... }
+ */
+
+#ifndef STATION_H
+#define STATION_H
+
+#include "SerialPort.h"
+#include "StreamDecoder.h"
+#include "TestPlan.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+
+struct RunnerOptions {
+    uint32_t baud = 115200;
+    uint32_t bootMs = 3000;          // Wait for the banner after opening (Mega resets)
+    uint32_t quietMs = 400;          // Output pause before a STATUS probe
+    uint32_t probeRetryMs = 2000;    // Unanswered probe is sent again
+    uint32_t stepTimeoutS = 900;     // Longest step (FULL 32 KB runs take minutes)
+};
+
+enum Verdict {
+    VERDICT_RUNNING,
+    VERDICT_PASS,
+    VERDICT_FAIL,
+    VERDICT_ERROR
+};
+
+struct TestResult {
+    size_t step;            // Plan step it belongs to
+    unsigned test;
+    std::string name;       // Empty for binary records
+    bool passed;
+    bool aborted;
+    uint32_t elapsedMs;     // Board time (binary) or host time since the previous result
+};
+
+struct FailureDetail {
+    unsigned test;
+    unsigned address;
+    unsigned expected;
+    unsigned actual;
+};
+
+struct StepResult {
+    std::string command;
+    uint32_t elapsedMs;
+};
+
+class Station {
+public:
+    Station(const std::string& label, const std::string& path, const TestPlan& plan,
+            const RunnerOptions& options);
+
+    /**
+     * Open the port; a failure makes the station done with VERDICT_ERROR
+     */
+    void start(TimePoint now);
+
+    /**
+     * Port readable: decode and act on everything received
+     */
+    void onInput(TimePoint now);
+
+    /**
+     * Boot wait, quiet-time probes, step timeout, pending output
+     */
+    void onTick(TimePoint now);
+
+    bool isDone() const { return done; }
+    int getFd() const { return port.getFd(); }
+    bool wantsWrite() const { return port.hasPendingOutput(); }
+
+    const std::string& getLabel() const { return label; }
+    const std::string& getPath() const { return path; }
+    const TestPlan& getPlan() const { return plan; }
+    Verdict getVerdict() const;
+    const std::string& getError() const { return error; }
+    const std::vector<TestResult>& getTests() const { return tests; }
+    const std::vector<FailureDetail>& getFailures() const { return failures; }
+    const std::vector<StepResult>& getSteps() const { return steps; }
+    uint32_t getElapsedMs() const { return elapsedMs; }
+    uint32_t getCrcErrors() const { return decoder.getCrcErrors(); }
+
+private:
+    enum State { BOOTING, RUNNING };
+
+    std::string label;
+    std::string path;
+    const TestPlan& plan;
+    RunnerOptions options;
+
+    SerialPort port;
+    StreamDecoder decoder;
+    State state;
+    bool done;
+    std::string error;
+
+    size_t stepIndex;
+    TimePoint startTime;
+    TimePoint stepStart;
+    TimePoint lastInput;
+    TimePoint lastResult;     // Host timing of text results
+    bool probeOutstanding;
+    TimePoint probeSent;
+    bool inStatusReport;      // Swallowing an idle STATUS report
+    bool reportReady;         // ... its "Ready for commands" line seen
+    uint32_t followBaud;      // PROTO <p> <baud>: switch after the OK (0 = no)
+
+    bool suiteFailed;
+    bool commandError;
+    std::vector<TestResult> tests;
+    std::vector<FailureDetail> failures;
+    std::vector<StepResult> steps;
+    uint32_t elapsedMs;
+
+    void sendStep(TimePoint now);
+    void completeStep(TimePoint now);
+    void sendProbe(TimePoint now);
+    void finish(TimePoint now, const std::string& failure = std::string());
+
+    void handleLine(const std::string& line, TimePoint now);
+    void handleFrame(const Frame& frame, TimePoint now);
+    void parseResultLine(const std::string& line, TimePoint now);
+};
+
+#endif // STATION_H
@@ -0,0 +1,88 @@
+/**
+ * StreamDecoder.h
+ *
+ * Splits a tester's byte stream into text lines and binary frames
+ *
+ * The firmware mixes both on one port (Strategy/01-Phase1-Foundation.md
+ * section 11): a 0xA5 byte starts a 12-byte frame, anything else belongs
+ * to a text line. A frame with a bad CRC is dropped and decoding resumes
+ * on the byte after its sync, so the next 0xA5 resynchronises.
+ *
+ * Record constants mirror include/utils/BinaryProtocol.h (which needs
+ * Arduino.h); the CRC is the firmware's own utils/CRC.h.
+ *
+ * Usage:
+ *   StreamDecoder decoder;
+ *   std::vector<StreamEvent> events;
+ *   decoder.feed(buffer, n, events);
+ *   for (const StreamEvent& e : events) {
+ *       if (e.kind == StreamEvent::LINE) { ... e.line ... }
+ *       else if (e.frame.type == BIN_REC_TEST_END) { ... e.frame.get32(2) ... }
+ *   }
+ */
+
+#ifndef STREAM_DECODER_H
+#define STREAM_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Frame layout and record types (firmware: utils/BinaryProtocol.h)
+constexpr uint8_t BIN_SYNC = 0xA5;
+constexpr uint8_t BIN_PAYLOAD_SIZE = 8;
+constexpr uint8_t BIN_FRAME_SIZE = 2 + BIN_PAYLOAD_SIZE + 2;
+
+constexpr uint8_t BIN_REC_TEST_START = 0x01;
+constexpr uint8_t BIN_REC_TEST_END   = 0x02;
+constexpr uint8_t BIN_REC_FAILURE    = 0x03;
+constexpr uint8_t BIN_REC_PROGRESS   = 0x04;
+constexpr uint8_t BIN_REC_SUMMARY    = 0x05;
+
+constexpr uint8_t BIN_TEST_ABORTED = 2;
+
+struct Frame {
+    uint8_t type;
+    uint8_t payload[BIN_PAYLOAD_SIZE];
+
+    // Little-endian payload fields at a byte offset
+    uint8_t get8(size_t offset) const { return payload[offset]; }
+    uint16_t get16(size_t offset) const { return (uint16_t)(payload[offset] | (payload[offset + 1] << 8)); }
+    uint32_t get32(size_t offset) const { return get16(offset) | ((uint32_t)get16(offset + 2) << 16); }
+};
+
+struct StreamEvent {
+    enum Kind { LINE, FRAME };
+    Kind kind;
+    std::string line;   // LINE: text without CR/LF
+    Frame frame;        // FRAME: CRC checked
+};
+
+class StreamDecoder {
+public:
+    StreamDecoder();
+
+    /**
+     * Decode received bytes, appending complete lines and frames to events
+     * (a partial line or frame waits for the next feed)
+     */
+    void feed(const uint8_t* data, size_t length, std::vector<StreamEvent>& events);
+
+    /**
+     * Drop partial input (after a baud rate change)
+     */
+    void reset();
+
+    uint32_t getCrcErrors() const { return crcErrors; }
+
+private:
+    std::string line;
+    std::vector<uint8_t> frame;    // Bytes of the frame being collected, sync first
+    bool inFrame;
+    uint32_t crcErrors;
+
+    void decode(uint8_t byte, std::vector<StreamEvent>& events);
+};
+
+#endif // STREAM_DECODER_H
@@ -0,0 +1,35 @@
+/**
+ * TestPlan.h
+ *
+ * Commands pushed to every board, one per line of a plan file
+ *
+ * Plan file: one tester command per line (MODE, PROTO, TEST, ...), sent
+ * in order. Blank lines and lines starting with '#' are ignored.
+ *
+ *   # HM62256 production screen, binary results at 1 Mbaud
+ *   MODE SRAM 32768
+ *   PROTO BIN 1000000
+ *   TEST
+ *
+ * Usage:
+ *   TestPlan plan;
+ *   std::string error;
+ *   if (!plan.load("plans/sram-production.plan", error)) { ... }
+ */
+
+#ifndef TEST_PLAN_H
+#define TEST_PLAN_H
+
+#include <string>
+#include <vector>
+
+struct TestPlan {
+    std::vector<std::string> commands;
+
+    /**
+     * @return false if the file can't be read or has no commands
+     */
+    bool load(const std::string& path, std::string& error);
+};
+
+#endif // TEST_PLAN_H
@@ -0,0 +1,116 @@
+/**
+ * Report.cpp
+ *
+ * Implementation of the end-of-run summary
+ */
+
+#include "Report.h"
+
+#include <cerrno>
+#include <cstring>
+
+const char* verdictName(Verdict verdict) {
+    switch (verdict) {
+        case VERDICT_RUNNING: return "RUNNING";
+        case VERDICT_PASS:    return "PASS";
+        case VERDICT_FAIL:    return "FAIL";
+        case VERDICT_ERROR:   return "ERROR";
+    }
+    return "?";
+}
+
+static const char* resultName(const TestResult& test) {
+    if (test.aborted) return "ABORTED";
+    return test.passed ? "PASSED" : "FAILED";
+}
+
+// First failing cell, the error, or the first failed test
+static std::string firstProblem(const Station& station) {
+    char text[96];
+
+    if (!station.getError().empty()) return station.getError();
+    if (!station.getFailures().empty()) {
+        const FailureDetail& f = station.getFailures().front();
+        snprintf(text, sizeof(text), "Test %u: 0x%04X expected 0x%02X got 0x%02X",
+                 f.test, f.address, f.expected, f.actual);
+        return text;
+    }
+    for (const TestResult& test : station.getTests()) {
+        if (!test.passed) {
+            snprintf(text, sizeof(text), "Test %u %s", test.test, resultName(test));
+            return text;
+        }
+    }
+    return "";
+}
+
+void printReport(FILE* out, const StationList& stations, uint32_t wallMs) {
+    unsigned counts[4] = {0, 0, 0, 0};
+
+    fprintf(out, "\n%-10s %-22s %-7s %6s %6s %8s  %s\n",
+            "Station", "Port", "Verdict", "Passed", "Failed", "Time", "Detail");
+    for (const auto& station : stations) {
+        unsigned passed = 0;
+        unsigned failed = 0;
+        for (const TestResult& test : station->getTests()) {
+            if (test.passed) passed++; else failed++;
+        }
+
+        Verdict verdict = station->getVerdict();
+        counts[verdict]++;
+        fprintf(out, "%-10s %-22s %-7s %6u %6u %7.1fs  %s\n",
+                station->getLabel().c_str(), station->getPath().c_str(), verdictName(verdict),
+                passed, failed, station->getElapsedMs() / 1000.0, firstProblem(*station).c_str());
+        if (station->getCrcErrors() != 0) {
+            fprintf(out, "%-10s %u binary frames dropped (CRC)\n", "", station->getCrcErrors());
+        }
+    }
+
+    double hours = wallMs / 3600000.0;
+    fprintf(out, "\nPASS %u  FAIL %u  ERROR %u  in %.1fs",
+            counts[VERDICT_PASS], counts[VERDICT_FAIL], counts[VERDICT_ERROR], wallMs / 1000.0);
+    if (hours > 0) {
+        fprintf(out, "  (%.0f boards/hour)", stations.size() / hours);
+    }
+    fprintf(out, "\n");
+}
+
+// Quote a CSV field if it needs it
+static std::string csvField(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) return text;
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+bool writeCsv(const std::string& path, const StationList& stations, std::string& error) {
+    FILE* out = fopen(path.c_str(), "w");
+    if (out == nullptr) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+
+    fprintf(out, "station,port,step,command,test,name,result,elapsed_ms\n");
+    for (const auto& station : stations) {
+        const std::vector<std::string>& commands = station->getPlan().commands;
+        for (const TestResult& test : station->getTests()) {
+            const std::string& command = commands[test.step];
+            fprintf(out, "%s,%s,%zu,%s,%u,%s,%s,%u\n",
+                    csvField(station->getLabel()).c_str(), csvField(station->getPath()).c_str(),
+                    test.step + 1, csvField(command).c_str(), test.test, csvField(test.name).c_str(),
+                    resultName(test), test.elapsedMs);
+        }
+        if (station->getVerdict() == VERDICT_ERROR) {
+            fprintf(out, "%s,%s,,,,%s,ERROR,%u\n",
+                    csvField(station->getLabel()).c_str(), csvField(station->getPath()).c_str(),
+                    csvField(station->getError()).c_str(), station->getElapsedMs());
+        }
+    }
+
+    bool ok = fclose(out) == 0;
+    if (!ok) error = path + ": " + strerror(errno);
+    return ok;
+}
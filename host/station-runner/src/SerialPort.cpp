@@ -0,0 +1,137 @@
+/**
+ * SerialPort.cpp
+ *
+ * Implementation of the non-blocking POSIX serial port
+ */
+
+#include "SerialPort.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+// termios speed constant for a baud rate, B0 if the host has none
+static speed_t speedFor(uint32_t baud) {
+    switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+#ifdef B500000
+        case 500000: return B500000;
+#endif
+#ifdef B1000000
+        case 1000000: return B1000000;
+#endif
+        default: return B0;
+    }
+}
+
+SerialPort::SerialPort()
+    : fd(-1) {
+}
+
+SerialPort::~SerialPort() {
+    close();
+}
+
+bool SerialPort::open(const std::string& path, uint32_t baud) {
+    close();
+
+    fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        setError("open " + path);
+        return false;
+    }
+
+    struct termios tty;
+    if (tcgetattr(fd, &tty) != 0) {
+        setError("tcgetattr " + path);
+        close();
+        return false;
+    }
+    cfmakeraw(&tty);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+        setError("tcsetattr " + path);
+        close();
+        return false;
+    }
+
+    if (!setBaud(baud)) {
+        close();
+        return false;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return true;
+}
+
+void SerialPort::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    pending.clear();
+}
+
+bool SerialPort::setBaud(uint32_t baud) {
+    speed_t speed = speedFor(baud);
+    if (speed == B0) {
+        error = "baud rate " + std::to_string(baud) + " not supported on this host";
+        return false;
+    }
+
+    // Let queued output leave at the old rate first
+    tcdrain(fd);
+
+    struct termios tty;
+    if (tcgetattr(fd, &tty) != 0) {
+        setError("tcgetattr");
+        return false;
+    }
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+        setError("tcsetattr");
+        return false;
+    }
+    return true;
+}
+
+ssize_t SerialPort::read(uint8_t* buffer, size_t size) {
+    ssize_t n = ::read(fd, buffer, size);
+    if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+        setError("read");
+        return -1;
+    }
+    return n;
+}
+
+bool SerialPort::write(const std::string& text) {
+    pending += text;
+    return flush();
+}
+
+bool SerialPort::flush() {
+    while (!pending.empty()) {
+        ssize_t n = ::write(fd, pending.data(), pending.size());
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return true;
+            setError("write");
+            return false;
+        }
+        pending.erase(0, (size_t)n);
+    }
+    return true;
+}
+
+void SerialPort::setError(const std::string& what) {
+    error = what + ": " + std::strerror(errno);
+}
@@ -0,0 +1,261 @@
+/**
+ * Station.cpp
+ *
+ * Implementation of the per-board state machine
+ */
+
+#include "Station.h"
+
+#include <cstdlib>
+#include <regex>
+
+static uint32_t msBetween(TimePoint from, TimePoint to) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+static bool startsWith(const std::string& text, const char* prefix) {
+    return text.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+// Firmware result lines (see Station.h)
+static const std::regex TEST_RESULT("^(OK|ERROR): Test ([0-9]+) \\((.*)\\) - (PASSED|FAILED|ABORTED)$");
+static const std::regex TEST_FAILURE("^ERROR: Test ([0-9]+) FAIL - Addr: 0x([0-9A-Fa-f]+) "
+                                     "Expected: 0x([0-9A-Fa-f]+) Got: 0x([0-9A-Fa-f]+)");
+static const std::regex SUITE_FAILED("^ERROR: (Some tests FAILED|[0-9]+ of [0-9]+ tests FAILED|Tests ABORTED)$");
+static const std::regex PROTO_BAUD("^PROTO +(TEXT|BIN) +([0-9]+)$");
+
+Station::Station(const std::string& label, const std::string& path, const TestPlan& plan,
+                 const RunnerOptions& options)
+    : label(label), path(path), plan(plan), options(options), state(BOOTING), done(false),
+      stepIndex(0), probeOutstanding(false), inStatusReport(false), reportReady(false),
+      followBaud(0), suiteFailed(false), commandError(false), elapsedMs(0) {
+}
+
+void Station::start(TimePoint now) {
+    startTime = now;
+    lastInput = now;
+    if (!port.open(path, options.baud)) {
+        finish(now, port.getError());
+    }
+}
+
+Verdict Station::getVerdict() const {
+    if (!done) return VERDICT_RUNNING;
+    if (!error.empty() || commandError) return VERDICT_ERROR;
+    if (suiteFailed) return VERDICT_FAIL;
+    for (const TestResult& test : tests) {
+        if (!test.passed) return VERDICT_FAIL;
+    }
+    return VERDICT_PASS;
+}
+
+void Station::onInput(TimePoint now) {
+    if (done) return;
+
+    uint8_t buffer[512];
+    for (;;) {
+        ssize_t n = port.read(buffer, sizeof(buffer));
+        if (n < 0) {
+            finish(now, port.getError());
+            return;
+        }
+        if (n == 0) return;
+
+        std::vector<StreamEvent> events;
+        decoder.feed(buffer, (size_t)n, events);
+        for (const StreamEvent& event : events) {
+            lastInput = now;
+            if (event.kind == StreamEvent::LINE) {
+                handleLine(event.line, now);
+            } else {
+                handleFrame(event.frame, now);
+            }
+            if (done) return;
+        }
+    }
+}
+
+void Station::onTick(TimePoint now) {
+    if (done) return;
+
+    if (!port.flush()) {
+        finish(now, port.getError());
+        return;
+    }
+
+    if (state == BOOTING) {
+        // Banner may have been missed (board already up): start anyway
+        if (msBetween(startTime, now) >= options.bootMs) {
+            sendStep(now);
+        }
+        return;
+    }
+
+    if (msBetween(stepStart, now) >= options.stepTimeoutS * 1000UL) {
+        finish(now, "timeout in step '" + plan.commands[stepIndex] + "'");
+        return;
+    }
+
+    if (!probeOutstanding) {
+        if (msBetween(lastInput, now) >= options.quietMs) sendProbe(now);
+    } else if (msBetween(probeSent, now) >= options.probeRetryMs &&
+               msBetween(lastInput, now) >= options.probeRetryMs) {
+        sendProbe(now);
+    }
+}
+
+void Station::sendStep(TimePoint now) {
+    state = RUNNING;
+    if (stepIndex >= plan.commands.size()) {
+        finish(now);
+        return;
+    }
+
+    const std::string& command = plan.commands[stepIndex];
+    std::smatch match;
+    followBaud = std::regex_match(command, match, PROTO_BAUD) ? (uint32_t)std::stoul(match[2]) : 0;
+
+    stepStart = now;
+    lastInput = now;
+    lastResult = now;
+    probeOutstanding = false;
+    if (!port.write(command + "\n")) {
+        finish(now, port.getError());
+    }
+}
+
+void Station::completeStep(TimePoint now) {
+    steps.push_back(StepResult{plan.commands[stepIndex], msBetween(stepStart, now)});
+    if (commandError) {
+        finish(now);
+        return;
+    }
+    stepIndex++;
+    sendStep(now);
+}
+
+void Station::sendProbe(TimePoint now) {
+    probeOutstanding = true;
+    probeSent = now;
+    if (!port.write("STATUS\n")) {
+        finish(now, port.getError());
+    }
+}
+
+void Station::finish(TimePoint now, const std::string& failure) {
+    if (!failure.empty()) error = failure;
+    elapsedMs = msBetween(startTime, now);
+    done = true;
+    port.close();
+}
+
+void Station::handleLine(const std::string& line, TimePoint now) {
+    if (state == BOOTING) {
+        if (line.find("Type HELP for command list") != std::string::npos) {
+            sendStep(now);
+        }
+        return;
+    }
+
+    // Idle STATUS report: probe answered, the step is done
+    if (inStatusReport) {
+        if (line.find("Ready for commands") != std::string::npos) {
+            reportReady = true;
+        } else if (reportReady && startsWith(line, "====")) {
+            inStatusReport = false;
+            if (probeOutstanding) {
+                probeOutstanding = false;
+                completeStep(now);
+            }
+        }
+        return;
+    }
+    if (line.find("Multi-IC Tester Status") != std::string::npos) {
+        inStatusReport = true;
+        reportReady = false;
+        return;
+    }
+
+    // Mid-test STATUS reply: still running
+    if (startsWith(line, "STATUS: ")) {
+        probeOutstanding = false;
+        return;
+    }
+
+    // PROTO <p> <baud>: the OK still comes at the old rate
+    if (followBaud != 0 && startsWith(line, "OK:")) {
+        if (!port.setBaud(followBaud)) {
+            finish(now, port.getError());
+            return;
+        }
+        decoder.reset();
+        followBaud = 0;
+        return;
+    }
+
+    parseResultLine(line, now);
+}
+
+void Station::parseResultLine(const std::string& line, TimePoint now) {
+    std::smatch match;
+
+    if (std::regex_match(line, match, TEST_RESULT)) {
+        TestResult result;
+        result.step = stepIndex;
+        result.test = (unsigned)std::stoul(match[2]);
+        result.name = match[3];
+        result.passed = match[4] == "PASSED";
+        result.aborted = match[4] == "ABORTED";
+        result.elapsedMs = msBetween(lastResult, now);
+        tests.push_back(result);
+        lastResult = now;
+        return;
+    }
+    if (std::regex_search(line, match, TEST_FAILURE)) {
+        failures.push_back(FailureDetail{(unsigned)std::stoul(match[1]),
+                                         (unsigned)std::stoul(match[2], nullptr, 16),
+                                         (unsigned)std::stoul(match[3], nullptr, 16),
+                                         (unsigned)std::stoul(match[4], nullptr, 16)});
+        return;
+    }
+    if (std::regex_match(line, match, SUITE_FAILED)) {
+        suiteFailed = true;
+        return;
+    }
+    if (startsWith(line, "ERROR:")) {
+        commandError = true;
+        error = "'" + plan.commands[stepIndex] + "': " + line.substr(7);
+    }
+}
+
+void Station::handleFrame(const Frame& frame, TimePoint now) {
+    (void)now;
+    switch (frame.type) {
+        case BIN_REC_PROGRESS:
+            // Also the binary answer to a mid-test STATUS
+            probeOutstanding = false;
+            break;
+
+        case BIN_REC_TEST_END: {
+            TestResult result;
+            result.step = stepIndex;
+            result.test = frame.get8(0);
+            result.passed = frame.get8(1) == 1;
+            result.aborted = frame.get8(1) == BIN_TEST_ABORTED;
+            result.elapsedMs = frame.get32(2);
+            tests.push_back(result);
+            break;
+        }
+
+        case BIN_REC_FAILURE:
+            failures.push_back(FailureDetail{frame.get8(0), frame.get16(1), frame.get8(3), frame.get8(4)});
+            break;
+
+        case BIN_REC_SUMMARY:
+            if (frame.get8(0) != 1) suiteFailed = true;
+            break;
+
+        default:
+            break;
+    }
+}
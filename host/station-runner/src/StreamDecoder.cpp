@@ -0,0 +1,72 @@
+/**
+ * StreamDecoder.cpp
+ *
+ * Implementation of the text/binary stream splitter
+ */
+
+#include "StreamDecoder.h"
+
+#include "utils/CRC.h"
+
+#include <cstring>
+
+StreamDecoder::StreamDecoder()
+    : inFrame(false), crcErrors(0) {
+}
+
+void StreamDecoder::reset() {
+    line.clear();
+    frame.clear();
+    inFrame = false;
+}
+
+void StreamDecoder::feed(const uint8_t* data, size_t length, std::vector<StreamEvent>& events) {
+    for (size_t i = 0; i < length; i++) {
+        decode(data[i], events);
+    }
+}
+
+void StreamDecoder::decode(uint8_t byte, std::vector<StreamEvent>& events) {
+    if (inFrame) {
+        frame.push_back(byte);
+        if (frame.size() < BIN_FRAME_SIZE) return;
+
+        inFrame = false;
+        uint16_t crc = crc16(&frame[1], 1 + BIN_PAYLOAD_SIZE);
+        uint16_t sent = (uint16_t)(frame[BIN_FRAME_SIZE - 2] | (frame[BIN_FRAME_SIZE - 1] << 8));
+        if (crc == sent) {
+            StreamEvent event;
+            event.kind = StreamEvent::FRAME;
+            event.frame.type = frame[1];
+            std::memcpy(event.frame.payload, &frame[2], BIN_PAYLOAD_SIZE);
+            events.push_back(event);
+            return;
+        }
+
+        // Bad CRC: the sync was probably noise, decode what followed it
+        crcErrors++;
+        std::vector<uint8_t> rest(frame.begin() + 1, frame.end());
+        frame.clear();
+        for (uint8_t b : rest) {
+            decode(b, events);
+        }
+        return;
+    }
+
+    if (byte == BIN_SYNC) {
+        inFrame = true;
+        frame.clear();
+        frame.push_back(byte);
+        return;
+    }
+
+    if (byte == '\n') {
+        StreamEvent event;
+        event.kind = StreamEvent::LINE;
+        event.line = line;
+        events.push_back(event);
+        line.clear();
+    } else if (byte != '\r') {
+        line += (char)byte;
+    }
+}
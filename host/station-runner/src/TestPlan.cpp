@@ -0,0 +1,33 @@
+/**
+ * TestPlan.cpp
+ *
+ * Plan file loader
+ */
+
+#include "TestPlan.h"
+
+#include <fstream>
+
+bool TestPlan::load(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "can't read plan " + path;
+        return false;
+    }
+
+    commands.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        // Trim CR and surrounding spaces
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        size_t last = line.find_last_not_of(" \t\r");
+        commands.push_back(line.substr(first, last - first + 1));
+    }
+
+    if (commands.empty()) {
+        error = "plan " + path + " has no commands";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,167 @@
+/**
+ * main.cpp
+ *
+ * station-runner: run one test plan on many tester boards in parallel
+ *
+ * Usage:
+ *   station-runner --plan FILE [options] [LABEL=]PORT...
+ *
+ *   --plan FILE      Commands sent to every board, one per line (# comments)
+ *   --baud N         Initial baud rate (default 115200)
+ *   --timeout S      Longest time one step may take (default 900 s)
+ *   --boot MS        Wait for the boot banner (default 3000 ms)
+ *   --csv FILE       Per-test results for the production log
+ *   --verbose        Echo progress as stations finish
+ *
+ * Example:
+ *   station-runner --plan plans/sram-production.plan --csv lot42.csv \
+ *       A=/dev/ttyACM0 B=/dev/ttyACM1 C=/dev/ttyACM2
+ *
+ * Exit status: 0 all boards passed, 1 some board failed, 2 usage, plan or
+ * port error on some board.
+ */
+
+#include "Report.h"
+#include "Station.h"
+#include "TestPlan.h"
+
+#include <poll.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const int POLL_TICK_MS = 100;
+
+static void printUsage() {
+    fprintf(stderr,
+            "Usage: station-runner --plan FILE [--baud N] [--timeout S] [--boot MS]\n"
+            "                      [--csv FILE] [--verbose] [LABEL=]PORT...\n");
+}
+
+// Numeric option value, false if missing or not a positive number
+static bool parseNumber(int argc, char** argv, int& i, uint32_t& value) {
+    if (i + 1 >= argc) return false;
+    char* end;
+    unsigned long parsed = strtoul(argv[++i], &end, 10);
+    if (*end != '\0' || parsed == 0) return false;
+    value = (uint32_t)parsed;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    RunnerOptions options;
+    std::string planPath;
+    std::string csvPath;
+    bool verbose = false;
+    std::vector<std::string> ports;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg == "--plan" && i + 1 < argc) {
+            planPath = argv[++i];
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (arg == "--baud") {
+            ok = parseNumber(argc, argv, i, options.baud);
+        } else if (arg == "--timeout") {
+            ok = parseNumber(argc, argv, i, options.stepTimeoutS);
+        } else if (arg == "--boot") {
+            ok = parseNumber(argc, argv, i, options.bootMs);
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else if (arg.compare(0, 1, "-") == 0) {
+            ok = false;
+        } else {
+            ports.push_back(arg);
+        }
+        if (!ok) {
+            printUsage();
+            return 2;
+        }
+    }
+    if (planPath.empty() || ports.empty()) {
+        printUsage();
+        return 2;
+    }
+
+    TestPlan plan;
+    std::string error;
+    if (!plan.load(planPath, error)) {
+        fprintf(stderr, "station-runner: %s\n", error.c_str());
+        return 2;
+    }
+
+    StationList stations;
+    for (size_t n = 0; n < ports.size(); n++) {
+        std::string label = std::to_string(n + 1);
+        std::string path = ports[n];
+        size_t equals = path.find('=');
+        if (equals != std::string::npos) {
+            label = path.substr(0, equals);
+            path = path.substr(equals + 1);
+        }
+        stations.emplace_back(new Station(label, path, plan, options));
+    }
+
+    TimePoint begin = std::chrono::steady_clock::now();
+    for (auto& station : stations) station->start(begin);
+
+    // All stations in one thread: each only reacts to its own port and clock
+    std::vector<pollfd> fds;
+    std::vector<Station*> polled;
+    size_t finished = 0;
+    for (;;) {
+        fds.clear();
+        polled.clear();
+        for (auto& station : stations) {
+            if (station->isDone()) continue;
+            short events = POLLIN;
+            if (station->wantsWrite()) events |= POLLOUT;
+            fds.push_back(pollfd{station->getFd(), events, 0});
+            polled.push_back(station.get());
+        }
+        if (polled.empty()) break;
+
+        if (poll(fds.data(), fds.size(), POLL_TICK_MS) < 0 && errno != EINTR) {
+            perror("station-runner: poll");
+            return 2;
+        }
+
+        TimePoint now = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < polled.size(); n++) {
+            if (fds[n].revents & (POLLIN | POLLERR | POLLHUP)) polled[n]->onInput(now);
+            polled[n]->onTick(now);
+        }
+
+        if (verbose) {
+            for (Station* station : polled) {
+                if (station->isDone()) {
+                    finished++;
+                    fprintf(stderr, "[%zu/%zu] %s: %s\n", finished, stations.size(),
+                            station->getLabel().c_str(), verdictName(station->getVerdict()));
+                }
+            }
+        }
+    }
+
+    uint32_t wallMs = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    printReport(stdout, stations, wallMs);
+
+    int status = 0;
+    if (!csvPath.empty() && !writeCsv(csvPath, stations, error)) {
+        fprintf(stderr, "station-runner: %s\n", error.c_str());
+        status = 2;
+    }
+    for (const auto& station : stations) {
+        Verdict verdict = station->getVerdict();
+        if (verdict == VERDICT_ERROR) status = 2;
+        else if (verdict == VERDICT_FAIL && status == 0) status = 1;
+    }
+    return status;
+}
@@ -0,0 +1,201 @@
+/**
+ * BusTrace.h
+ *
+ * Compressed bus-cycle trace for the Z80 and 6502 engines
+ *
+ * Every bus cycle of a run (address, data, control flags) is recorded into
+ * a static ring of BUS_TRACE_BLOCKS blocks. When the ring is full the
+ * oldest block is dropped, so the trace always holds the last cycles of
+ * the run. Each block decodes on its own:
+ *
+ *   [0..3]  Index of the block's first cycle in the run (uint32, LE)
+ *   [4..]   Records, 0xFF = end of block (unused bytes stay 0xFF)
+ *
+ * Records (tag byte first):
+ *   cc dddddd  data          Memory cycle, class cc: 0 fetch, 1 read, 2 write
+ *                            d = address - previous address + 31 (0-62)
+ *   cc 111111  addr(2) data  Same, absolute address (first cycle of a
+ *                            block, or a jump of more than 31)
+ *   C0  control addr(2) data Any other cycle (IORQ, ...), flags as recorded
+ *   C1  period count(2)      The next count cycles each repeat the cycle
+ *                            period (1-8) cycles before it
+ *   FF                       End of block
+ *
+ * A program loop of up to 8 bus cycles costs one 4-byte REPEAT record per
+ * block, straight-line code about 2 bytes per cycle.
+ *
+ * Control flags (logical, 1 = active): BUS_TRACE_FETCH is Z80 /M1 or 6502
+ * SYNC. The 6502 has no /MREQ, all its cycles are recorded as memory
+ * cycles.
+ *
+ * Recording is controlled by TRACE ON/OFF. A strategy holds the trace when
+ * a test fails, so that run stays in the buffer for TRACE DUMP and later
+ * runs don't overwrite it (TRACE CLEAR or TRACE ON releases it).
+ *
+ * Usage:
+ *   BusTrace trace;
+ *   trace.setEnabled(true);
+ *
+ *   if (trace.begin()) { ... trace.record(addr, data, BUS_TRACE_READ | BUS_TRACE_MREQ); ... }
+ *   trace.end();
+ *
+ *   BusTraceReader reader(trace);
+ *   BusTraceCycle cycle;
+ *   while (reader.next(cycle)) { ... }
+ *
+ * See Strategy/04-Phase4-Z80.md section 8 for the dump format
+ */
+
+#ifndef BUS_TRACE_H
+#define BUS_TRACE_H
+
+#include <Arduino.h>
+
+//=============================================================================
+// FORMAT
+//=============================================================================
+
+constexpr uint16_t BUS_TRACE_SIZE = 2048;
+constexpr uint8_t BUS_TRACE_BLOCK_SIZE = 128;
+constexpr uint8_t BUS_TRACE_BLOCKS = BUS_TRACE_SIZE / BUS_TRACE_BLOCK_SIZE;
+constexpr uint8_t BUS_TRACE_HEADER_SIZE = 4;
+constexpr uint8_t BUS_TRACE_PERIOD_MAX = 8;    // Longest loop REPEAT detects
+
+// Control flags
+constexpr uint8_t BUS_TRACE_FETCH = 0x01;      // /M1 (Z80), SYNC (6502)
+constexpr uint8_t BUS_TRACE_READ  = 0x02;      // /RD (Z80), R/W HIGH (6502)
+constexpr uint8_t BUS_TRACE_WRITE = 0x04;      // /WR (Z80), R/W LOW (6502)
+constexpr uint8_t BUS_TRACE_MREQ  = 0x08;
+constexpr uint8_t BUS_TRACE_IORQ  = 0x10;
+
+// Record tags
+constexpr uint8_t BUS_TRACE_CLASS_FETCH = 0;
+constexpr uint8_t BUS_TRACE_CLASS_READ = 1;
+constexpr uint8_t BUS_TRACE_CLASS_WRITE = 2;
+constexpr uint8_t BUS_TRACE_DELTA_BIAS = 31;
+constexpr uint8_t BUS_TRACE_ABSOLUTE = 0x3F;
+constexpr uint8_t BUS_TRACE_TAG_RAW = 0xC0;
+constexpr uint8_t BUS_TRACE_TAG_REPEAT = 0xC1;
+constexpr uint8_t BUS_TRACE_TAG_END = 0xFF;
+
+constexpr uint8_t BUS_TRACE_NOT_HELD = 0;
+
+struct BusTraceCycle {
+    uint32_t index;     // Cycle number in the run (0 = first after reset)
+    uint16_t address;
+    uint8_t data;
+    uint8_t control;    // BUS_TRACE_* flags
+};
+
+//=============================================================================
+// RECORDER
+//=============================================================================
+
+class BusTrace {
+public:
+    BusTrace();
+
+    /**
+     * TRACE ON / OFF (ON also clears and releases a held trace)
+     */
+    void setEnabled(bool on);
+    bool isEnabled() const { return enabled; }
+
+    /**
+     * Empty the buffer and release a held trace
+     */
+    void clear();
+
+    /**
+     * Keep the last run for TRACE DUMP: later runs don't record
+     */
+    void hold(uint8_t testNumber);
+    uint8_t getHeldTest() const { return heldTest; }
+
+    /**
+     * Start of a run: clears the buffer if recording
+     *
+     * @return true if this run is recorded (enabled and not held)
+     */
+    bool begin();
+
+    /**
+     * One bus cycle (only between begin() returning true and end())
+     */
+    void record(uint16_t address, uint8_t data, uint8_t control);
+
+    /**
+     * End of a run: writes a pending REPEAT record
+     */
+    void end();
+
+    /**
+     * Cycles recorded in the run, and how many of them the buffer still holds
+     */
+    uint32_t getRunCycles() const { return runCycles; }
+    uint32_t getHeldCycles() const;
+
+    /**
+     * Blocks in use, oldest first (each BUS_TRACE_BLOCK_SIZE bytes)
+     */
+    uint8_t getBlockCount() const { return blockCount; }
+    const uint8_t* getBlock(uint8_t n) const;
+
+private:
+    uint8_t buffer[BUS_TRACE_SIZE];
+    bool enabled;
+    bool recording;
+    uint8_t heldTest;
+    uint8_t firstBlock;     // Oldest block in the ring
+    uint8_t blockCount;
+    uint8_t writePos;       // Next free byte in the newest block
+    uint32_t runCycles;
+
+    // Encoder state, reset at every block start
+    uint32_t history[BUS_TRACE_PERIOD_MAX];  // Last cycles, packed, newest at historyPos
+    uint8_t historyPos;
+    uint8_t historyCount;
+    uint16_t lastAddress;
+    uint8_t repeatPeriod;   // 0 = no REPEAT pending
+    uint16_t repeatCount;
+
+    uint8_t* currentBlock() { return buffer + (uint16_t)((firstBlock + blockCount - 1) % BUS_TRACE_BLOCKS) * BUS_TRACE_BLOCK_SIZE; }
+    void startBlock();
+    void ensureSpace(uint8_t bytes);
+    void push(uint32_t packed, uint16_t address);
+    uint32_t past(uint8_t period) const;
+    void writeCycle(uint16_t address, uint8_t data, uint8_t control);
+    void flushRepeat();
+};
+
+//=============================================================================
+// DECODER
+//=============================================================================
+
+/**
+ * Walks a BusTrace (or a dumped copy of its blocks) cycle by cycle, oldest first
+ */
+class BusTraceReader {
+public:
+    explicit BusTraceReader(const BusTrace& trace);
+
+    /**
+     * @return false after the last cycle
+     */
+    bool next(BusTraceCycle& cycle);
+
+private:
+    const BusTrace& trace;
+    uint8_t block;
+    uint8_t pos;
+    uint32_t index;
+    uint32_t history[BUS_TRACE_PERIOD_MAX];
+    uint8_t historyPos;
+    uint16_t lastAddress;
+    uint8_t repeatPeriod;
+    uint16_t repeatLeft;
+
+    bool startBlock();
+};
+
+#endif // BUS_TRACE_H
@@ -0,0 +1,60 @@
+/**
+ * CycleCounter.h
+ *
+ * Free-running CPU cycle counter on Timer5 for PERF instrumentation
+ *
+ * Timer5 runs at F_CPU with no prescaler (62.5 ns per count at 16 MHz).
+ * The overflow interrupt extends TCNT5 to 32 bits, so intervals of up to
+ * 2^32 cycles (~268 s) can be measured by subtraction.
+ *
+ * Overhead: one ~2 us overflow interrupt every 4.1 ms (< 0.1% of CPU).
+ *
+ * Timer3 is the CPU clock generator (Timer3Clock); Timer0 belongs to
+ * millis()/micros(). Timer5 has no other user in this firmware.
+ *
+ * Usage:
+ *   CycleCounter::begin();
+ *   uint32_t start = CycleCounter::now();
+ *   // ... work ...
+ *   uint32_t cycles = CycleCounter::now() - start;
+ *   uint32_t us = CycleCounter::toMicros(cycles);
+ */
+
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+
+#include <Arduino.h>
+
+class CycleCounter {
+public:
+    static constexpr uint8_t CYCLES_PER_US = F_CPU / 1000000UL;
+
+    /**
+     * Start Timer5 in normal mode at F_CPU and enable the overflow interrupt
+     */
+    static void begin();
+
+    /**
+     * Current 32-bit cycle count (0 until begin() is called)
+     *
+     * Safe to call with interrupts enabled or disabled.
+     */
+    static uint32_t now();
+
+    /**
+     * Fold a pending overflow into the count
+     *
+     * For loops that run with interrupts disabled for longer than one
+     * overflow period (Z80Bus::run()). Call with interrupts off.
+     *
+     * @return true if an overflow was pending (one every 65536 cycles, 4.1 ms)
+     */
+    static bool catchUp();
+
+    /**
+     * Convert a cycle count to microseconds
+     */
+    static uint32_t toMicros(uint32_t cycles) { return cycles / CYCLES_PER_US; }
+};
+
+#endif // CYCLE_COUNTER_H
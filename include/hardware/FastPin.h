@@ -0,0 +1,174 @@
+/**
+ * FastPin.h
+ *
+ * Compile-time pin access for the control signals
+ *
+ * Port, bit and polarity are template parameters, so every call inlines to
+ * the same instruction hand-written register code would use:
+ * - PORTA-PORTG (I/O space): sbi / cbi / sbis / sbic, 1-2 cycles
+ * - PORTH-PORTL (extended I/O): lds / ori|andi / sts, 5 cycles, not atomic
+ *   (no ISR in this firmware writes PORTH/PORTJ/PORTK/PORTL)
+ *
+ * Polarity carries the signal inversions between ICs (pinout "Signal Logic
+ * Inversions"): PB4 is Z80 /WAIT (active LOW) and 6502 RDY (active HIGH),
+ * so Z80Pins::Wait::activate() and IC6502Pins::Rdy::deactivate() both
+ * drive it LOW. Strategy code only says what it means.
+ *
+ * FastPinGroup combines pins on one port into a single read-modify-write.
+ * FastPinMask is the same for a raw mask, e.g. a whole bus port.
+ *
+ * Usage:
+ *   using Wait = FastPin<PortB, 4, ACTIVE_LOW>;
+ *   Wait::outputInactive();          // PB4 HIGH, then OUTPUT
+ *   Wait::activate();                // cbi PORTB, 4
+ *   if (Wait::isActive()) { ... }    // sbic PINB, 4
+ *
+ *   using Control = FastPinGroup<CS, OE, WE>;
+ *   Control::deactivate();           // All three inactive in one write
+ *
+ * Signals for each IC are defined in hardware/PinConfig.h
+ */
+
+#ifndef FAST_PIN_H
+#define FAST_PIN_H
+
+#include <Arduino.h>
+
+//=============================================================================
+// PORTS
+// Register accessors for each port; constant addresses after inlining
+//=============================================================================
+
+// decltype keeps the register's own type (volatile uint8_t& on the target)
+#define FAST_PIN_PORT(L)                                              \
+    struct Port##L {                                                  \
+        static decltype((PIN##L)) pin() { return PIN##L; }            \
+        static decltype((DDR##L)) ddr() { return DDR##L; }            \
+        static decltype((PORT##L)) port() { return PORT##L; }         \
+    };
+
+FAST_PIN_PORT(A)
+FAST_PIN_PORT(B)
+FAST_PIN_PORT(C)
+FAST_PIN_PORT(D)
+FAST_PIN_PORT(E)
+FAST_PIN_PORT(F)
+FAST_PIN_PORT(G)
+FAST_PIN_PORT(H)
+FAST_PIN_PORT(J)
+FAST_PIN_PORT(K)
+FAST_PIN_PORT(L)
+
+#undef FAST_PIN_PORT
+
+enum PinPolarity : uint8_t {
+    ACTIVE_HIGH,
+    ACTIVE_LOW
+};
+
+//=============================================================================
+// MASKED PIN SET
+//=============================================================================
+
+/**
+ * Pins of Mask on Port, those in ActiveLowMask active LOW
+ */
+template <class Port, uint8_t Mask, uint8_t ActiveLowMask = 0>
+struct FastPinMask {
+    typedef Port PortType;
+    static constexpr uint8_t MASK = Mask;
+    static constexpr uint8_t ACTIVE_LOW_MASK = ActiveLowMask & Mask;
+    static constexpr uint8_t ACTIVE_HIGH_MASK = Mask & ~ActiveLowMask;
+
+    // Direction (input() also turns the pull-ups off)
+    static void output() { Port::ddr() |= MASK; }
+    static void input() {
+        Port::ddr() &= (uint8_t)~MASK;
+        Port::port() &= (uint8_t)~MASK;
+    }
+
+    // Electrical level
+    static void high() { Port::port() |= MASK; }
+    static void low() { Port::port() &= (uint8_t)~MASK; }
+    static void write(uint8_t value) {
+        Port::port() = (uint8_t)((Port::port() & ~MASK) | (value & MASK));
+    }
+    static uint8_t read() { return Port::pin() & MASK; }
+
+    // Logical level, polarity applied
+    static void activate() {
+        Port::port() = (uint8_t)((Port::port() & ~ACTIVE_LOW_MASK) | ACTIVE_HIGH_MASK);
+    }
+    static void deactivate() {
+        Port::port() = (uint8_t)((Port::port() & ~ACTIVE_HIGH_MASK) | ACTIVE_LOW_MASK);
+    }
+
+    // Inactive level first, then OUTPUT: no glitch on the line
+    static void outputInactive() {
+        deactivate();
+        output();
+    }
+};
+
+//=============================================================================
+// SINGLE PIN
+//=============================================================================
+
+/**
+ * One pin: Bit of Port with the given polarity
+ */
+template <class Port, uint8_t Bit, PinPolarity Polarity = ACTIVE_HIGH>
+struct FastPin : FastPinMask<Port, (uint8_t)(1 << Bit), Polarity == ACTIVE_LOW ? (uint8_t)(1 << Bit) : 0> {
+    typedef FastPinMask<Port, (uint8_t)(1 << Bit), Polarity == ACTIVE_LOW ? (uint8_t)(1 << Bit) : 0> Base;
+    static constexpr uint8_t BIT = Bit;
+
+    // Single-bit forms (sbi / cbi / sbis / sbic in I/O space)
+    static void activate() {
+        if (Polarity == ACTIVE_LOW) Base::low(); else Base::high();
+    }
+    static void deactivate() {
+        if (Polarity == ACTIVE_LOW) Base::high(); else Base::low();
+    }
+    static bool isHigh() { return (Port::pin() & Base::MASK) != 0; }
+    static bool isActive() { return isHigh() != (Polarity == ACTIVE_LOW); }
+
+    // Writing 1 to PINx toggles PORTx (clock generation)
+    static void toggle() { Port::pin() = Base::MASK; }
+
+    static void outputInactive() {
+        deactivate();
+        Base::output();
+    }
+};
+
+//=============================================================================
+// PIN GROUP
+//=============================================================================
+
+template <class A, class B>
+struct FastPinSamePort { static constexpr bool value = false; };
+
+template <class A>
+struct FastPinSamePort<A, A> { static constexpr bool value = true; };
+
+/**
+ * Several FastPins on the same port, accessed in one read-modify-write
+ */
+template <class... Pins>
+struct FastPinGroup;
+
+template <class Pin>
+struct FastPinGroup<Pin>
+    : FastPinMask<typename Pin::PortType, Pin::MASK, Pin::ACTIVE_LOW_MASK> {
+};
+
+template <class Pin, class... Rest>
+struct FastPinGroup<Pin, Rest...>
+    : FastPinMask<typename Pin::PortType,
+                  Pin::MASK | FastPinGroup<Rest...>::MASK,
+                  Pin::ACTIVE_LOW_MASK | FastPinGroup<Rest...>::ACTIVE_LOW_MASK> {
+    static_assert(FastPinSamePort<typename Pin::PortType, typename FastPinGroup<Rest...>::PortType>::value,
+                  "FastPinGroup pins must share a port");
+};
+
+#endif // FAST_PIN_H
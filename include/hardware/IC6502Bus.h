@@ -0,0 +1,215 @@
+/**
+ * IC6502Bus.h
+ *
+ * Bus-cycle engine for 6502 CPU testing with a firmware-generated clock
+ *
+ * With Timer3 free-running on Φ0 the firmware has to race the CPU to find
+ * out which phase it is in (Φ1/Φ2 monitors on PD0/PD1). In firmware clock
+ * mode there is nothing to race: Timer3 is stopped, PE3 becomes a plain
+ * output and the engine makes every Φ0 edge itself, in step with serving
+ * the bus cycle:
+ *
+ *   Φ0 LOW  (Φ1)  wait tADS, sample address, R/W, SYNC;
+ *                 read: look up byte, drive PORTL
+ *   Φ0 HIGH (Φ2)  write: wait tMDS, latch PINL; bookkeeping (covers tPWH)
+ *   Φ0 LOW        CPU latches read data on this edge; release PORTL
+ *
+ * Every cycle is served, so there is no bus contention and no missed
+ * cycle at any rate: the clock runs as fast as the handler, but never
+ * faster than the chip timing below.
+ *
+ * Cycles are clocked in bursts of up to IC6502_BURST_CYCLES with
+ * interrupts off. Between bursts the clock pauses in Φ1 with interrupts on
+ * for a moment, so UART RX and millis() keep up. NMOS 6502s are dynamic
+ * (tCYC max ~40 µs), so the clock never stops for longer than that: even
+ * step() records its cycles back to back and leaves printing to the caller.
+ *
+ * With a BusTrace attached and TRACE ON, run() and step() also record
+ * every cycle into it, in Φ1 after the cycle (about 5 µs longer Φ1,
+ * still far below the dynamic limit).
+ *
+ * Memory map seen by the 6502:
+ *   0x0000 - 0x01FF      RAM window: zero page and stack (cpuRamWindow, IC6502_RAM_SIZE bytes)
+ *   0x1FFF               Stop port: a write ends the run (value = exit code)
+ *   0xF000 - ...         ROM, served straight from a PROGMEM image
+ *   0xFFFA - 0xFFFF      NMI/RES/IRQ vectors, all pointing to 0xF000
+ *   anything else        MemoryMap pages if one is set (TEST IMAGE: the
+ *                        uploaded program, MAP RAM/FAULT pages), else
+ *                        reads 0xFF, writes ignored
+ *
+ * The map is looked up after the ROM, vectors, RAM window and stop port
+ * (which win where they overlap it); a program meant to start at reset
+ * sits at 0xF000 with no PROGMEM ROM loaded.
+ *
+ * Usage:
+ *   IC6502Bus bus;
+ *   bus.configurePins();
+ *   bus.beginFirmwareClock(&timer3);         // Stops Timer3, PE3 = output
+ *   bus.loadRom(PROGRAM, sizeof(PROGRAM));   // PROGRAM is PROGMEM
+ *   bus.clearRam();
+ *   IC6502RunResult result = bus.run(10000, 100);
+ *   if (result.end == IC6502_END_STOP) { ... result.exitCode ... }
+ *
+ * See Strategy/05-Phase5-6502.md for timing details
+ */
+
+#ifndef IC6502_BUS_H
+#define IC6502_BUS_H
+
+#include <Arduino.h>
+#include "hardware/Timer3.h"
+#include "hardware/PinConfig.h"
+#include "hardware/BusTrace.h"
+#include "hardware/MemoryMap.h"
+
+//=============================================================================
+// MEMORY MAP
+//=============================================================================
+
+constexpr uint16_t IC6502_RAM_BASE = 0x0000;
+constexpr uint16_t IC6502_RAM_SIZE = CPU_RAM_WINDOW_SIZE;  // cpuRamWindow, shared with Z80Bus
+constexpr uint16_t IC6502_STOP_ADDR = 0x1FFF;
+constexpr uint16_t IC6502_ROM_BASE = 0xF000;
+constexpr uint16_t IC6502_VECTORS = 0xFFFA;
+constexpr uint8_t IC6502_UNMAPPED = 0xFF;
+
+//=============================================================================
+// CHIP TIMING
+// NMOS 6502 at 1 MHz (MOS datasheet); W65C02S parts are faster
+//=============================================================================
+
+constexpr uint16_t IC6502_ADDRESS_SETUP_NS = 300;  // tADS: Φ0 falling → address, R/W, SYNC valid
+constexpr uint16_t IC6502_WRITE_SETUP_NS = 200;    // tMDS: Φ0 rising → write data valid
+
+/**
+ * Convert nanoseconds to Mega cycles (rounded up)
+ */
+constexpr uint8_t ic6502CyclesFor(uint16_t ns) {
+    return (uint8_t)(((uint32_t)ns * (F_CPU / 1000000UL) + 999) / 1000);
+}
+
+// Padding on top of the port accesses (2 cycles each). Φ2 itself is
+// longer than tPWH (430 ns) from the bookkeeping done in it.
+constexpr uint8_t IC6502_ADDRESS_SETUP_CYCLES = ic6502CyclesFor(IC6502_ADDRESS_SETUP_NS) - 2;
+constexpr uint8_t IC6502_WRITE_SETUP_CYCLES = ic6502CyclesFor(IC6502_WRITE_SETUP_NS) - 2;
+
+// 115200 baud: one RX byte per 87 µs, the USART buffers two. A burst of
+// 64 cycles (~2 µs each) keeps interrupts off for less than that.
+constexpr uint16_t IC6502_BURST_CYCLES = 64;
+
+constexpr uint8_t IC6502_RESET_CYCLES = 8;  // RES LOW for 2+ cycles, then 7-cycle sequence
+
+//=============================================================================
+// RUN RESULTS
+//=============================================================================
+
+enum IC6502RunEnd : uint8_t {
+    IC6502_END_STOP,     // Program wrote IC6502_STOP_ADDR
+    IC6502_END_LIMIT,    // cycleLimit bus cycles clocked
+    IC6502_END_TIMEOUT   // No end condition within timeoutMs
+};
+
+constexpr uint8_t IC6502_TRACE_SIZE = 8;  // Read addresses kept per run (reset sequence skipped)
+
+struct IC6502RunResult {
+    uint8_t end;                // IC6502RunEnd
+    uint8_t exitCode;           // Value written to IC6502_STOP_ADDR
+    uint32_t cycles;            // Bus cycles clocked
+    uint32_t reads;             // ... of which reads (R/W HIGH)
+    uint32_t fetches;           // ... of which opcode fetches (SYNC HIGH)
+    uint32_t writes;            // ... of which writes (R/W LOW)
+    uint16_t bursts;            // Bursts (pauses + 1)
+    uint8_t traced;             // Entries used in trace
+    uint16_t trace[IC6502_TRACE_SIZE];  // Read addresses from the first opcode fetch on
+    uint32_t elapsed;           // Mega CPU cycles spent clocking (pauses excluded)
+};
+
+/**
+ * One single-stepped bus cycle
+ */
+struct IC6502Cycle {
+    uint16_t address;
+    uint8_t data;               // Byte served (read) or latched (write)
+    bool read;                  // R/W HIGH
+    bool sync;                  // SYNC HIGH (opcode fetch)
+};
+
+//=============================================================================
+// BUS ENGINE
+//=============================================================================
+
+class IC6502Bus {
+public:
+    IC6502Bus();
+
+    /**
+     * 6502 mode pin directions (address/data, R/W, SYNC, Φ1/Φ2 monitors in;
+     * RES, RDY, IRQ, NMI, S.O. out and inactive, CPU held in reset)
+     */
+    void configurePins();
+
+    /**
+     * Take PE3 from Timer3: stop the timer, drive Φ0 LOW from the firmware
+     */
+    void beginFirmwareClock(Timer3Clock* timer);
+
+    /**
+     * ROM image at IC6502_ROM_BASE (PROGMEM pointer, read in place)
+     */
+    void loadRom(const uint8_t* image, uint16_t size);
+
+    /**
+     * Pages for the rest of the address space (nullptr = none, unmapped)
+     */
+    void setMemoryMap(MemoryMap* memory) { map = memory; }
+
+    /**
+     * RAM window access (0xFF outside the window, pokes outside it ignored)
+     */
+    void clearRam(uint8_t value = 0x00);
+    uint8_t peekRam(uint16_t addr) const;
+    void pokeRam(uint16_t addr, uint8_t value);
+
+    /**
+     * RES LOW for IC6502_RESET_CYCLES firmware clocks, then released.
+     * The next cycles are the CPU's 7-cycle reset sequence.
+     */
+    void resetCpu();
+    void holdReset();
+    void releaseReset();
+
+    /**
+     * Single-step: clock count bus cycles and record each one
+     * (interrupts off, no pause between them)
+     */
+    void step(IC6502Cycle* cycles, uint8_t count);
+
+    /**
+     * Reset, then clock bursts until the stop port is written, the cycle
+     * limit is reached or it times out. The CPU is held in reset afterwards.
+     *
+     * @param cycleLimit Stop after this many bus cycles (0 = no limit)
+     * @param timeoutMs  Longest run (checked between bursts)
+     */
+    IC6502RunResult run(uint32_t cycleLimit, uint16_t timeoutMs);
+
+    /**
+     * Trace recorder for run() and step() (nullptr = none)
+     */
+    void setTrace(BusTrace* recorder) { trace = recorder; }
+    BusTrace* getTrace() const { return trace; }
+
+private:
+    const uint8_t* rom;     // PROGMEM
+    uint16_t romSize;
+    MemoryMap* map;
+    BusTrace* trace;
+
+    uint8_t lookup(uint16_t addr) const;
+    bool store(uint16_t addr, uint8_t data, IC6502RunResult& result);
+    bool clockCycle(IC6502RunResult& result, IC6502Cycle& cycle);
+    bool burst(IC6502RunResult& result, uint16_t cycles, bool tracing);
+    void traceCycle(const IC6502Cycle& cycle);
+};
+
+#endif // IC6502_BUS_H
@@ -0,0 +1,174 @@
+/**
+ * MemoryMap.h
+ *
+ * Sparse 64 KB memory map for the CPU bus engines: one byte per 256-byte
+ * page says what the CPU sees there
+ *
+ * Page kinds:
+ *   RAM     A page from a small static pool (MEMORY_POOL_PAGES), read/write
+ *   ROM     Read in place from a flash (PROGMEM) or RAM array, writes ignored
+ *   FAULT   Reads 0xFF, every access is counted (first address kept)
+ *   OPEN    Open bus: reads 0xFF, writes ignored (every page after clear())
+ *
+ * A program can touch scattered pages (code at 0x0000, data at 0x2000,
+ * stack at 0xFFxx) for the price of the pages it actually uses: 256 bytes
+ * of page table, MEMORY_POOL_PAGES * 256 bytes of pool, and a pointer per
+ * mapped ROM page (MEMORY_ROM_PAGES slots). The engines' own RAM window,
+ * cpuRamWindow, is declared here too: one buffer for both CPU modes.
+ *
+ * Page table entries:
+ *   0x00 - 0x7F   RAM, pool page n
+ *   0x80 - 0x8F   ROM in flash, slot n
+ *   0x90 - 0x9F   ROM in RAM, slot n
+ *   0xFE          FAULT
+ *   0xFF          OPEN
+ *
+ * read() and write() are one table load and at most three compares, the
+ * same for every address, so the bus engines can call them while serving
+ * a cycle. Mapping is configuration-time work (scans the table) and must
+ * not happen during a run.
+ *
+ * The CPU engines look the map up after their fixed ROM, RAM window and
+ * stop port (Z80Bus::setMemoryMap(), IC6502Bus::setMemoryMap()); the
+ * built-in tests run without a map, so their read response is unchanged.
+ *
+ * Usage:
+ *   MemoryMap map;
+ *   map.mapRom(0x0000, image, 300);          // RAM array, 2 pages
+ *   map.mapRam(0xFF00, 256);                 // Stack page from the pool
+ *   map.mapFault(0x8000, 0x4000);            // Catch stray accesses
+ *   uint8_t b = map.read(0x0123);            // In the bus handler
+ *   if (map.getFaults() != 0) { ... map.getFirstFault() ... }
+ *
+ * See Strategy/04-Phase4-Z80.md section 10
+ */
+
+#ifndef MEMORY_MAP_H
+#define MEMORY_MAP_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+constexpr uint16_t MEMORY_PAGE_SIZE = 256;
+constexpr uint8_t MEMORY_POOL_PAGES = 2;      // RAM pages (512 bytes of Mega SRAM)
+constexpr uint8_t MEMORY_ROM_PAGES = 16;      // ROM page slots, of each source kind together
+constexpr uint8_t MEMORY_OPEN_BUS = 0xFF;
+
+// Page table entries
+constexpr uint8_t MEMORY_ENTRY_FLASH = 0x80;  // + ROM slot
+constexpr uint8_t MEMORY_ENTRY_RAM_ROM = 0x90;
+constexpr uint8_t MEMORY_ENTRY_FAULT = 0xFE;
+constexpr uint8_t MEMORY_ENTRY_OPEN = 0xFF;
+
+static_assert(MEMORY_POOL_PAGES <= MEMORY_ENTRY_FLASH, "Pool pages must fit below the ROM entries");
+static_assert(MEMORY_ROM_PAGES <= MEMORY_ENTRY_RAM_ROM - MEMORY_ENTRY_FLASH, "ROM slots overlap");
+
+// Fixed RAM window of the CPU bus engines (Z80 0x1000, 6502 0x0000). Only
+// one IC mode is active at a time, so Z80Bus and IC6502Bus share it; every
+// test that uses it clears it first.
+constexpr uint16_t CPU_RAM_WINDOW_SIZE = 512;
+extern uint8_t cpuRamWindow[CPU_RAM_WINDOW_SIZE];
+
+enum MemoryPageKind : uint8_t {
+    MEMORY_OPEN,
+    MEMORY_RAM,
+    MEMORY_ROM,
+    MEMORY_FAULT
+};
+
+class MemoryMap {
+public:
+    MemoryMap();
+
+    /**
+     * Every page OPEN, pool and ROM slots free, fault count cleared
+     */
+    void clear();
+
+    /**
+     * Pool pages for the pages covering addr .. addr+length-1, filled with
+     * fill (pages that already are RAM keep their pool page and contents)
+     *
+     * @return false if the pool is too small (nothing changed)
+     */
+    bool mapRam(uint16_t addr, uint16_t length, uint8_t fill = 0x00);
+
+    /**
+     * Serve data as ROM from addr (page-aligned), in place. Bytes past
+     * length in the last page read whatever follows data in memory.
+     *
+     * @param flash true for a PROGMEM array
+     * @return false if addr isn't page-aligned or the ROM slots run out
+     */
+    bool mapRom(uint16_t addr, const uint8_t* data, uint16_t length, bool flash = false);
+
+    /**
+     * FAULT or OPEN for the pages covering addr .. addr+length-1
+     */
+    void mapFault(uint16_t addr, uint16_t length);
+    void unmap(uint16_t addr, uint16_t length);
+
+    /**
+     * Every ROM page OPEN again (before mapping a new program)
+     */
+    void unmapRom();
+
+    /**
+     * Bus access (O(1), callable with interrupts off)
+     */
+    inline uint8_t read(uint16_t addr) {
+        uint8_t entry = pages[addr >> 8];
+        uint8_t low = (uint8_t)addr;
+        if (entry < MEMORY_ENTRY_FLASH) {
+            return pool[entry][low];
+        }
+        if (entry < MEMORY_ENTRY_RAM_ROM) {
+            return pgm_read_byte(rom[entry - MEMORY_ENTRY_FLASH] + low);
+        }
+        if (entry < MEMORY_ENTRY_FAULT) {
+            return rom[entry - MEMORY_ENTRY_RAM_ROM][low];
+        }
+        if (entry == MEMORY_ENTRY_FAULT) {
+            noteFault(addr);
+        }
+        return MEMORY_OPEN_BUS;
+    }
+
+    inline void write(uint16_t addr, uint8_t data) {
+        uint8_t entry = pages[addr >> 8];
+        if (entry < MEMORY_ENTRY_FLASH) {
+            pool[entry][(uint8_t)addr] = data;
+        } else if (entry == MEMORY_ENTRY_FAULT) {
+            noteFault(addr);
+        }
+    }
+
+    MemoryPageKind getKind(uint8_t page) const;
+    uint8_t getFreePoolPages() const;
+
+    /**
+     * Accesses to FAULT pages since clear() or resetFaults()
+     */
+    uint16_t getFaults() const { return faults; }
+    uint16_t getFirstFault() const { return firstFault; }
+    void resetFaults();
+
+private:
+    uint8_t pages[256];
+    uint8_t pool[MEMORY_POOL_PAGES][MEMORY_PAGE_SIZE];
+    const uint8_t* rom[MEMORY_ROM_PAGES];   // First byte of each mapped ROM page
+    uint16_t faults;
+    uint16_t firstFault;
+
+    inline void noteFault(uint16_t addr) {
+        if (faults == 0) firstFault = addr;
+        if (faults != 0xFFFF) faults++;
+    }
+
+    void setPages(uint16_t addr, uint16_t length, uint8_t entry);
+    bool entryInUse(uint8_t entry) const;
+    int16_t findFree(uint8_t first, uint8_t count) const;
+    static uint16_t pageCount(uint16_t addr, uint16_t length);
+};
+
+#endif // MEMORY_MAP_H
@@ -9,16 +9,25 @@
  *
  * Design: Uses constexpr for compile-time constants (type-safe, zero overhead)
  *
+ * Arduino pin numbers are for pinMode()/digitalWrite() (setup, debugging).
+ * Strategy code uses the FastPin signal types at the end of this file:
+ * port, bit and polarity fixed at compile time, single sbi/cbi where the
+ * port allows it (see hardware/FastPin.h).
+ *
  * Usage:
  *   #include "hardware/PinConfig.h"
  *   pinMode(RESET_PIN, OUTPUT);
  *   digitalWrite(RESET_PIN, HIGH);
+ *
+ *   Z80Pins::Reset::activate();          // PH6 LOW
+ *   if (IC6502Pins::Sync::isActive()) {} // PH3 HIGH (inverted vs Z80 /M1)
  */
 
 #ifndef PIN_CONFIG_H
 #define PIN_CONFIG_H
 
 #include <Arduino.h>
+#include "hardware/FastPin.h"
 
 //=============================================================================
 // ADDRESS BUS (A0-A15) - Shared across all ICs
@@ -130,6 +139,29 @@ constexpr uint8_t CTRL_BUSREQ_PIN = 13;    // PB7 - Z80 /BUSREQ (DMA)
 
 constexpr uint8_t CTRL_SO_PIN = 18;        // PD3 - 6502 S.O. (Set Overflow)
 
+//=============================================================================
+// OPERATOR PANEL - Not connected to any IC
+//=============================================================================
+
+constexpr uint8_t PANEL_START_PIN = 19;    // PD2 - Footswitch/button to GND, starts RUN
+
+//=============================================================================
+// SRAM SOCKET B - Dual-socket fixture (MODE SRAM <size> DUAL)
+// Shares A0-A14, /OE and /WE with socket A; own data bus and /CS
+//=============================================================================
+
+// Socket B data bus (D0-D7) - PORTK
+constexpr uint8_t SOCKET_B_D0_PIN = 62;    // PK0 (A8)
+constexpr uint8_t SOCKET_B_D1_PIN = 63;    // PK1 (A9)
+constexpr uint8_t SOCKET_B_D2_PIN = 64;    // PK2 (A10)
+constexpr uint8_t SOCKET_B_D3_PIN = 65;    // PK3 (A11)
+constexpr uint8_t SOCKET_B_D4_PIN = 66;    // PK4 (A12)
+constexpr uint8_t SOCKET_B_D5_PIN = 67;    // PK5 (A13)
+constexpr uint8_t SOCKET_B_D6_PIN = 68;    // PK6 (A14)
+constexpr uint8_t SOCKET_B_D7_PIN = 69;    // PK7 (A15)
+
+constexpr uint8_t SOCKET_B_CS_PIN = 54;    // PF0 (A0) - socket B /CS
+
 //=============================================================================
 // PORT REGISTER ALIASES
 // For performance-critical code, use direct port manipulation
@@ -143,7 +175,65 @@ constexpr uint8_t CTRL_SO_PIN = 18;        // PD3 - 6502 S.O. (Set Overflow)
 // PORTH - Control signals (pins 6-9)
 // PORTB - Control signals (pins 10-13)
 // PORTE - Clock and /HALT (pins 2, 5)
-// PORTD - 6502 specific (pins 18, 20-21)
+// PORTD - 6502 specific (pins 18, 20-21), panel start (pin 19)
+// PORTK - SRAM socket B data D0-D7 (pins 62-69)
+// PORTF - SRAM socket B /CS (pin 54)
+
+//=============================================================================
+// FAST PIN SIGNALS
+// One namespace per IC; polarity is the signal's, so the inversions below
+// are handled by the types (activate() = signal asserted)
+//=============================================================================
+
+namespace SRAMPins {
+    using CS = FastPin<PortG, 0, ACTIVE_LOW>;        // /CS
+    using CSB = FastPin<PortF, 0, ACTIVE_LOW>;       // Socket B /CS (dual-socket fixture)
+    using OE = FastPin<PortG, 2, ACTIVE_LOW>;        // /OE
+    using WE = FastPin<PortG, 3, ACTIVE_LOW>;        // /WE
+    using Strobes = FastPinGroup<OE, WE>;
+    using Control = FastPinGroup<CS, OE, WE>;
+}
+
+namespace Z80Pins {
+    using Mreq   = FastPin<PortG, 0, ACTIVE_LOW>;    // /MREQ
+    using Iorq   = FastPin<PortG, 1, ACTIVE_LOW>;    // /IORQ
+    using Rd     = FastPin<PortG, 2, ACTIVE_LOW>;    // /RD
+    using Wr     = FastPin<PortG, 3, ACTIVE_LOW>;    // /WR
+    using M1     = FastPin<PortH, 3, ACTIVE_LOW>;    // /M1
+    using Rfsh   = FastPin<PortH, 4, ACTIVE_LOW>;    // /RFSH
+    using Busack = FastPin<PortH, 5, ACTIVE_LOW>;    // /BUSACK
+    using Reset  = FastPin<PortH, 6, ACTIVE_LOW>;    // /RESET
+    using Wait   = FastPin<PortB, 4, ACTIVE_LOW>;    // /WAIT
+    using Int    = FastPin<PortB, 5, ACTIVE_LOW>;    // /INT
+    using Nmi    = FastPin<PortB, 6, ACTIVE_LOW>;    // /NMI
+    using Busreq = FastPin<PortB, 7, ACTIVE_LOW>;    // /BUSREQ
+    using Clock  = FastPin<PortE, 3>;                // CLK
+    using Halt   = FastPin<PortE, 4, ACTIVE_LOW>;    // /HALT
+
+    using BusControl = FastPinGroup<Mreq, Iorq, Rd, Wr>;  // PG0-PG3 inputs
+    using Status = FastPinGroup<M1, Rfsh, Busack>;        // PH3-PH5 inputs
+    using Requests = FastPinGroup<Wait, Int, Nmi, Busreq>;  // PB4-PB7 outputs
+}
+
+namespace IC6502Pins {
+    using Read   = FastPin<PortG, 2, ACTIVE_HIGH>;   // R/W: HIGH = read (inverted vs /RD)
+    using Sync   = FastPin<PortH, 3, ACTIVE_HIGH>;   // SYNC: HIGH = fetch (inverted vs /M1)
+    using Reset  = FastPin<PortH, 6, ACTIVE_LOW>;    // RES
+    using Rdy    = FastPin<PortB, 4, ACTIVE_HIGH>;   // RDY: HIGH = ready (inverted vs /WAIT)
+    using Irq    = FastPin<PortB, 5, ACTIVE_LOW>;    // IRQ
+    using Nmi    = FastPin<PortB, 6, ACTIVE_LOW>;    // NMI
+    using Phi0   = FastPin<PortE, 3>;                // Φ0 clock input
+    using Phi1   = FastPin<PortD, 0>;                // Φ1 output (monitor)
+    using Phi2   = FastPin<PortD, 1>;                // Φ2 output (monitor)
+    using SetOverflow = FastPin<PortD, 3, ACTIVE_LOW>;  // S.O. (falling edge sets V)
+
+    using Interrupts = FastPinGroup<Irq, Nmi>;            // PB5-PB6 outputs
+    using PhaseMonitors = FastPinGroup<Phi1, Phi2>;       // PD0-PD1 inputs
+}
+
+namespace PanelPins {
+    using Start  = FastPin<PortD, 2, ACTIVE_LOW>;    // Footswitch: input, pull-up, pressed = LOW
+}
 
 //=============================================================================
 // IMPORTANT NOTES
@@ -0,0 +1,511 @@
+/**
+ * SRAMBus.h
+ *
+ * Block/burst access engine for parallel SRAM chips (HM62256, HM6265, D4168)
+ *
+ * Per-byte access (recompute address, flip DDRL, toggle /CS, wait 1 µs) spends
+ * far more time on overhead than the chip needs. This engine works on address
+ * ranges instead:
+ * - Data bus direction is set once per pass
+ * - /CS is held LOW for the whole sweep (/OE too for read passes)
+ * - PORTA is stepped every access, PORTC only rewritten on 256-byte boundaries
+ * - Strobes are cycle-counted from the chip timing below (no delayMicroseconds)
+ *
+ * Patterns are small functor objects with `uint8_t at(uint16_t addr)`, called
+ * once per address in sweep order (see strategies/SRAMPatterns.h). Templates
+ * keep the pattern code inlined into the bus loop.
+ *
+ * sweepCells() runs a short read/write sequence on every cell before moving
+ * to the next address (March elements), ascending or descending.
+ *
+ * Read trim (setReadTrim(), from TEST SPEED): verify() and sweepCells()
+ * reads settle SRAM_READ_SETTLE_CYCLES minus the trim, for the chip in the
+ * socket instead of the slowest supported part. The loops are instantiated
+ * per settle time, so the delay stays a compile-time cycle count. Writes
+ * keep the datasheet pulse; at 16 MHz it is one cycle over the shortest
+ * the port can make. begin() goes back to datasheet timing.
+ *
+ * fillTimed()/verifyTimed() are the TEST SPEED sweep passes: a fixed
+ * strobe or settle time as a template argument, and a pattern whose
+ * neighbouring cells differ in every bit (speedData()).
+ *
+ * Every operation counts the chip accesses it made (getAccessCount(), one
+ * add per burst, not per byte) for the PERF throughput figures.
+ *
+ * Dual socket (setSockets(SRAM_SOCKETS_BOTH)): socket B shares the address
+ * bus and /OE, /WE, with its own data bus (PORTK) and /CS (PF0). Block
+ * operations then drive both chips from one address setup: writes put the
+ * byte on both data buses under one /WE pulse, reads compare PINL and PINK.
+ * Socket B mismatches reach the sink with SRAM_TAG_SOCKET_B set in the tag.
+ * An access counts once for both chips. Socket B alone (SRAM_SOCKET_B) is
+ * for the single-byte access diagnostics and read(); the pattern block
+ * operations run on A or both.
+ *
+ * Usage:
+ *   SRAMBus bus;
+ *   bus.begin(32768);
+ *   SRAMConstantPattern pattern(0x55);
+ *   bus.fill(0x0000, 0x7FFF, pattern);
+ *   SRAMFirstFault fault;
+ *   if (!bus.verify(0x0000, 0x7FFF, pattern, fault)) {
+ *       // fault.address / fault.expected / fault.actual
+ *   }
+ *
+ * See Strategy/03-Phase3-SRAM.md section 12 for timing details
+ */
+
+#ifndef SRAM_BUS_H
+#define SRAM_BUS_H
+
+#include <Arduino.h>
+#include "hardware/PinConfig.h"
+
+//=============================================================================
+// CHIP TIMING
+// Worst case of the supported parts (HM62256-15, HM6265-15, D4168-20)
+//=============================================================================
+
+constexpr uint16_t SRAM_ACCESS_TIME_NS = 200;  // tAA: address valid → data valid
+constexpr uint16_t SRAM_WRITE_PULSE_NS = 150;  // tWP: /WE LOW pulse width
+
+/**
+ * Convert nanoseconds to CPU cycles (rounded up)
+ */
+constexpr uint8_t sramCyclesFor(uint16_t ns) {
+    return (uint8_t)(((uint32_t)ns * (F_CPU / 1000000UL) + 999) / 1000);
+}
+
+// cbi/sbi on PORTG take 2 cycles, which already counts towards the /WE pulse
+constexpr uint8_t SRAM_WRITE_STROBE_CYCLES =
+    sramCyclesFor(SRAM_WRITE_PULSE_NS) > 2 ? sramCyclesFor(SRAM_WRITE_PULSE_NS) - 2 : 0;
+
+// PINL passes through a 1-cycle input synchronizer before it can be read
+constexpr uint8_t SRAM_READ_SETTLE_CYCLES = sramCyclesFor(SRAM_ACCESS_TIME_NS) + 1;
+
+// Production reads can settle up to this many cycles less (setReadTrim())
+constexpr uint8_t SRAM_READ_TRIM_MAX = 3;
+static_assert(SRAM_READ_SETTLE_CYCLES >= SRAM_READ_TRIM_MAX, "Read trim below zero settle cycles");
+
+//=============================================================================
+// SOCKETS
+//=============================================================================
+
+constexpr uint8_t SRAM_SOCKET_A = 1 << 0;     // Data PORTL, /CS PG0
+constexpr uint8_t SRAM_SOCKET_B = 1 << 1;     // Data PORTK, /CS PF0 (dual-socket fixture)
+constexpr uint8_t SRAM_SOCKETS_BOTH = SRAM_SOCKET_A | SRAM_SOCKET_B;
+
+// Tag bit added to socket B mismatches (caller tags use bits 0-6)
+constexpr uint8_t SRAM_TAG_SOCKET_B = 0x80;
+
+//=============================================================================
+// FAULT REPORTING
+//=============================================================================
+
+/**
+ * Receives every mismatch found by SRAMBus::verify() / sweepCells()
+ *
+ * The tag is whatever the caller attached to the pass or operation, so one
+ * sweep can serve several tests (see SRAMStrategy fused patterns).
+ * Return true to keep sweeping, false to stop the pass immediately.
+ */
+class SRAMFaultSink {
+public:
+    virtual bool onFault(uint16_t address, uint8_t expected, uint8_t actual, uint8_t tag) = 0;
+    virtual ~SRAMFaultSink() = default;
+};
+
+/**
+ * Fault sink that records the first mismatch and stops the pass (fail-fast)
+ */
+class SRAMFirstFault : public SRAMFaultSink {
+public:
+    SRAMFirstFault() : address(0), expected(0), actual(0), failed(false) {}
+
+    bool onFault(uint16_t addr, uint8_t exp, uint8_t act, uint8_t) override {
+        address = addr;
+        expected = exp;
+        actual = act;
+        failed = true;
+        return false;
+    }
+
+    uint16_t address;
+    uint8_t expected;
+    uint8_t actual;
+    bool failed;
+};
+
+//=============================================================================
+// PER-CELL SEQUENCES
+//=============================================================================
+
+/**
+ * One access in a per-cell sequence (one March element operation)
+ */
+struct SRAMCellOp {
+    bool write;    // true = write data, false = read and compare against data
+    uint8_t data;
+    uint8_t tag;   // Passed to the fault sink on mismatch
+};
+
+//=============================================================================
+// BUS ENGINE
+//=============================================================================
+
+class SRAMBus {
+public:
+    /**
+     * Constructor
+     * Starts with no size configured (no forced address bits)
+     */
+    SRAMBus();
+
+    /**
+     * Configure engine for chip size
+     *
+     * @param sizeInBytes Memory size (8192 or 32768)
+     *
+     * For 8KB chips, pin 26 is CS2/CS (active HIGH), so A13 is forced HIGH
+     * on every access.
+     */
+    void begin(uint16_t sizeInBytes);
+
+    /**
+     * Cycles verify() and sweepCells() reads settle less than the
+     * datasheet timing (0 to SRAM_READ_TRIM_MAX, larger values clamp)
+     */
+    void setReadTrim(uint8_t cycles) { readTrim = (cycles < SRAM_READ_TRIM_MAX) ? cycles : SRAM_READ_TRIM_MAX; }
+    uint8_t getReadTrim() const { return readTrim; }
+    uint8_t getReadSettleCycles() const { return SRAM_READ_SETTLE_CYCLES - readTrim; }
+
+    /**
+     * Chips the following operations access
+     *
+     * @param mask SRAM_SOCKET_A (default), SRAM_SOCKET_B or SRAM_SOCKETS_BOTH
+     */
+    void setSockets(uint8_t mask) { sockets = mask; }
+    uint8_t getSockets() const { return sockets; }
+
+    /**
+     * Write a pattern to every address in [first, last]
+     */
+    template <typename Pattern>
+    void fill(uint16_t first, uint16_t last, Pattern& pattern);
+
+    /**
+     * Read every address in [first, last] and compare against pattern
+     *
+     * @param sink Receives each mismatch, decides whether to continue
+     * @param tag Passed to the sink with each mismatch
+     * @return false if the sink stopped the pass, true if sweep completed
+     */
+    template <typename Pattern>
+    bool verify(uint16_t first, uint16_t last, Pattern& pattern, SRAMFaultSink& sink,
+                uint8_t tag = 0);
+
+    /**
+     * Read every address in [first, last] into a consumer (socket B's data
+     * when only socket B is selected, socket A's otherwise)
+     *
+     * @param consumer Functor called as consumer(addr, data) for each byte
+     */
+    template <typename Consumer>
+    void read(uint16_t first, uint16_t last, Consumer& consumer);
+
+    /**
+     * Apply an operation sequence to every cell in [first, last]
+     *
+     * /CS stays LOW for the sweep; the data bus is turned around per
+     * operation (/OE released before driving, DDRL released before /OE).
+     *
+     * @param descending true to walk from last down to first
+     * @param ops Sequence applied to each cell (reads compare against data)
+     * @param sink Receives each mismatch, decides whether to continue
+     * @return false if the sink stopped the sweep, true if sweep completed
+     */
+    bool sweepCells(uint16_t first, uint16_t last, bool descending,
+                    const SRAMCellOp* ops, uint8_t opCount, SRAMFaultSink& sink);
+
+    /**
+     * Single-byte access (same strobe timing as the block operations)
+     *
+     * readByte() returns socket B's data when only socket B is selected,
+     * socket A's otherwise.
+     */
+    void writeByte(uint16_t addr, uint8_t data);
+    uint8_t readByte(uint16_t addr);
+
+    /**
+     * TEST SPEED passes over [first, last] on the selected socket(s): write
+     * speedData() with a (Strobe + 2)-cycle /WE pulse, or read it back
+     * Settle + 1 cycles after the address changes (socket B's data bus for
+     * SocketB). Run them with interrupts off: an interrupt stretches the
+     * access it lands in.
+     *
+     * @return false if the sink stopped the pass
+     */
+    template <uint8_t Strobe>
+    void fillTimed(uint16_t first, uint16_t last, uint8_t seed);
+    template <uint8_t Settle, bool SocketB>
+    bool verifyTimed(uint16_t first, uint16_t last, uint8_t seed, SRAMFaultSink& sink);
+
+    /**
+     * Sweep data: odd cells are the complement of their even neighbour, so
+     * every data line changes between consecutive reads
+     */
+    static uint8_t speedData(uint16_t addr, uint8_t seed) {
+        uint8_t data = seed ^ (uint8_t)(addr >> 1) ^ (uint8_t)(addr >> 9);
+        return (addr & 1) ? (uint8_t)~data : data;
+    }
+
+    /**
+     * Read/write cycles issued since power-up (wraps at 2^32)
+     */
+    uint32_t getAccessCount() const { return accessCount; }
+
+private:
+    uint8_t highMask;  // Bits forced HIGH on PORTC (A13 for 8KB chips)
+    uint8_t sockets;   // SRAM_SOCKET_* mask
+    uint8_t readTrim;  // Cycles below SRAM_READ_SETTLE_CYCLES for verify/sweep reads
+    uint32_t accessCount;
+
+    void setAddress(uint16_t addr);
+    void setHighByte(uint16_t addr);
+    void selectChips();
+    void beginWrite(uint16_t first);
+    void beginRead(uint16_t first);
+    void endAccess();
+
+    // Sweep loops; Dual drives and checks socket B's data bus as well,
+    // Settle is the read delay in cycles (the read trim picks one)
+    template <bool Dual, typename Pattern>
+    void fillLoop(uint16_t first, uint16_t last, Pattern& pattern);
+    template <bool Dual, typename Pattern>
+    bool verifyTrimmed(uint16_t first, uint16_t last, Pattern& pattern, SRAMFaultSink& sink, uint8_t tag);
+    template <bool Dual, uint8_t Settle, typename Pattern>
+    bool verifyLoop(uint16_t first, uint16_t last, Pattern& pattern, SRAMFaultSink& sink, uint8_t tag);
+    template <bool Dual>
+    bool sweepTrimmed(uint16_t first, uint16_t last, bool descending,
+                      const SRAMCellOp* ops, uint8_t opCount, SRAMFaultSink& sink);
+    template <bool Dual, uint8_t Settle>
+    bool sweepLoop(uint16_t first, uint16_t last, bool descending,
+                   const SRAMCellOp* ops, uint8_t opCount, SRAMFaultSink& sink);
+};
+
+//=============================================================================
+// INLINE / TEMPLATE IMPLEMENTATION
+//=============================================================================
+
+inline void SRAMBus::setHighByte(uint16_t addr) {
+    PORTC = (uint8_t)(addr >> 8) | highMask;
+}
+
+inline void SRAMBus::setAddress(uint16_t addr) {
+    PORTA = (uint8_t)addr;
+    setHighByte(addr);
+}
+
+inline void SRAMBus::selectChips() {
+    if (sockets & SRAM_SOCKET_A) SRAMPins::CS::activate();
+    if (sockets & SRAM_SOCKET_B) SRAMPins::CSB::activate();
+}
+
+inline void SRAMBus::beginWrite(uint16_t first) {
+    // /OE HIGH before driving the bus so the chip never drives against us
+    SRAMPins::Strobes::deactivate();
+    if (sockets & SRAM_SOCKET_A) DDRL = 0xFF;
+    if (sockets & SRAM_SOCKET_B) DDRK = 0xFF;
+    setAddress(first);
+    selectChips();
+}
+
+inline void SRAMBus::beginRead(uint16_t first) {
+    // Release the bus before enabling chip output
+    DDRL = 0x00;
+    PORTL = 0x00;
+    if (sockets & SRAM_SOCKET_B) {
+        DDRK = 0x00;
+        PORTK = 0x00;
+    }
+    setAddress(first);
+    selectChips();
+    SRAMPins::OE::activate();
+}
+
+inline void SRAMBus::endAccess() {
+    SRAMPins::Control::deactivate();
+    DDRL = 0x00;
+    PORTL = 0x00;  // No pull-ups: a floating line must not read back old data
+    if (sockets & SRAM_SOCKET_B) {
+        SRAMPins::CSB::deactivate();
+        DDRK = 0x00;
+        PORTK = 0x00;
+    }
+}
+
+template <typename Pattern>
+void SRAMBus::fill(uint16_t first, uint16_t last, Pattern& pattern) {
+    if (sockets == SRAM_SOCKETS_BOTH) {
+        fillLoop<true>(first, last, pattern);
+    } else {
+        fillLoop<false>(first, last, pattern);
+    }
+}
+
+template <typename Pattern>
+bool SRAMBus::verify(uint16_t first, uint16_t last, Pattern& pattern, SRAMFaultSink& sink,
+                     uint8_t tag) {
+    if (sockets == SRAM_SOCKETS_BOTH) {
+        return verifyTrimmed<true>(first, last, pattern, sink, tag);
+    }
+    return verifyTrimmed<false>(first, last, pattern, sink, tag);
+}
+
+template <bool Dual, typename Pattern>
+bool SRAMBus::verifyTrimmed(uint16_t first, uint16_t last, Pattern& pattern, SRAMFaultSink& sink,
+                            uint8_t tag) {
+    switch (readTrim) {
+        case 0:
+            return verifyLoop<Dual, SRAM_READ_SETTLE_CYCLES>(first, last, pattern, sink, tag);
+        case 1:
+            return verifyLoop<Dual, SRAM_READ_SETTLE_CYCLES - 1>(first, last, pattern, sink, tag);
+        case 2:
+            return verifyLoop<Dual, SRAM_READ_SETTLE_CYCLES - 2>(first, last, pattern, sink, tag);
+        default:
+            return verifyLoop<Dual, SRAM_READ_SETTLE_CYCLES - 3>(first, last, pattern, sink, tag);
+    }
+}
+
+template <bool Dual, typename Pattern>
+void SRAMBus::fillLoop(uint16_t first, uint16_t last, Pattern& pattern) {
+    beginWrite(first);
+
+    uint16_t addr = first;
+    for (;;) {
+        PORTA = (uint8_t)addr;
+        uint8_t data = pattern.at(addr);
+        PORTL = data;
+        if (Dual) PORTK = data;
+
+        // /WE-controlled write: data and address are stable before /WE falls
+        SRAMPins::WE::activate();
+        __builtin_avr_delay_cycles(SRAM_WRITE_STROBE_CYCLES);
+        SRAMPins::WE::deactivate();
+
+        if (addr == last) break;
+        addr++;
+        if ((uint8_t)addr == 0) setHighByte(addr);
+    }
+
+    endAccess();
+    accessCount += (uint16_t)(last - first) + 1UL;
+}
+
+template <bool Dual, uint8_t Settle, typename Pattern>
+bool SRAMBus::verifyLoop(uint16_t first, uint16_t last, Pattern& pattern, SRAMFaultSink& sink,
+                         uint8_t tag) {
+    beginRead(first);
+
+    // /CS and /OE held LOW: address-controlled read cycles
+    uint16_t addr = first;
+    for (;;) {
+        PORTA = (uint8_t)addr;
+        uint8_t expected = pattern.at(addr);
+        __builtin_avr_delay_cycles(Settle);
+        uint8_t actual = PINL;
+        uint8_t actualB = Dual ? (uint8_t)PINK : expected;
+
+        if ((actual != expected && !sink.onFault(addr, expected, actual, tag)) ||
+            (actualB != expected && !sink.onFault(addr, expected, actualB, tag | SRAM_TAG_SOCKET_B))) {
+            endAccess();
+            accessCount += (uint16_t)(addr - first) + 1UL;
+            return false;
+        }
+
+        if (addr == last) break;
+        addr++;
+        if ((uint8_t)addr == 0) setHighByte(addr);
+    }
+
+    endAccess();
+    accessCount += (uint16_t)(last - first) + 1UL;
+    return true;
+}
+
+template <typename Consumer>
+void SRAMBus::read(uint16_t first, uint16_t last, Consumer& consumer) {
+    beginRead(first);
+
+    uint16_t addr = first;
+    for (;;) {
+        PORTA = (uint8_t)addr;
+        __builtin_avr_delay_cycles(SRAM_READ_SETTLE_CYCLES);
+        consumer(addr, (sockets == SRAM_SOCKET_B) ? PINK : PINL);
+
+        if (addr == last) break;
+        addr++;
+        if ((uint8_t)addr == 0) setHighByte(addr);
+    }
+
+    endAccess();
+    accessCount += (uint16_t)(last - first) + 1UL;
+}
+
+template <uint8_t Strobe>
+void SRAMBus::fillTimed(uint16_t first, uint16_t last, uint8_t seed) {
+    beginWrite(first);
+
+    uint16_t addr = first;
+    for (;;) {
+        PORTA = (uint8_t)addr;
+        uint8_t data = speedData(addr, seed);
+        if (sockets & SRAM_SOCKET_A) PORTL = data;
+        if (sockets & SRAM_SOCKET_B) PORTK = data;
+
+        SRAMPins::WE::activate();
+        __builtin_avr_delay_cycles(Strobe);
+        SRAMPins::WE::deactivate();
+
+        if (addr == last) break;
+        addr++;
+        if ((uint8_t)addr == 0) setHighByte(addr);
+    }
+
+    endAccess();
+    accessCount += (uint16_t)(last - first) + 1UL;
+}
+
+template <uint8_t Settle, bool SocketB>
+bool SRAMBus::verifyTimed(uint16_t first, uint16_t last, uint8_t seed, SRAMFaultSink& sink) {
+    beginRead(first);
+
+    uint16_t addr = first;
+    uint8_t expected = speedData(addr, seed);
+    for (;;) {
+        // Nothing but the delay between the address and the sample: the
+        // empty asm keeps the compiler from moving the next byte's
+        // computation into the window
+        asm volatile("" : "+r"(expected));
+        PORTA = (uint8_t)addr;
+        __builtin_avr_delay_cycles(Settle);
+        uint8_t actual = SocketB ? PINK : PINL;
+
+        if (actual != expected &&
+            !sink.onFault(addr, expected, actual, SocketB ? SRAM_TAG_SOCKET_B : 0)) {
+            endAccess();
+            accessCount += (uint16_t)(addr - first) + 1UL;
+            return false;
+        }
+
+        if (addr == last) break;
+        addr++;
+        if ((uint8_t)addr == 0) setHighByte(addr);
+        expected = speedData(addr, seed);
+    }
+
+    endAccess();
+    accessCount += (uint16_t)(last - first) + 1UL;
+    return true;
+}
+
+#endif // SRAM_BUS_H
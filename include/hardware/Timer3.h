@@ -1,7 +1,7 @@
 /**
  * Timer3.h
  *
- * Hardware PWM clock generation using Timer3 in CTC mode
+ * Hardware PWM clock generation using Timer3
  *
  * Generates stable clock signals for Z80 and 6502 CPU testing.
  * Uses Timer3 with Output Compare A on PE3 (pin 5).
@@ -11,16 +11,25 @@
  *   Timer3Clock clock;
  *   clock.configure(1000000);  // 1 MHz
  *   clock.start();
- *   // ... clock running on PE3 ...
+ *   clock.retune(1250000);     // Running: new frequency without a glitch
+ *   uint16_t milliHz;
+ *   uint32_t hz = clock.getActualFrequency(&milliHz);  // What PE3 really outputs
  *   clock.stop();
  *
  * Technical Details:
- * - Mode: CTC (Clear Timer on Compare) with toggle output
+ * - Mode: Fast PWM with TOP = OCR3A (WGM 15), toggle output; CTC (WGM 4)
+ *   above 2 MHz, where Fast PWM would need OCR3A < 3
  * - Output: PE3 (pin 5) toggles on compare match
  * - Duty Cycle: 50% (hardware toggle)
  * - Prescalers: Auto-selected from 1, 8, 64, 256, 1024
  * - Formula: f_out = F_CPU / (2 * prescaler * (OCR3A + 1))
  *
+ * Retuning: in Fast PWM, OCR3A is double-buffered and loads at BOTTOM, so a
+ * new value with the same prescaler takes effect at the end of the current
+ * half period. Any other change waits for a compare match (the output just
+ * toggled) and reloads the timer there: that half period is stretched by
+ * the reload, never shortened, so the CPU never sees a runt pulse.
+ *
  * See Strategy/02-Phase2-Timer3.md for implementation details
  */
 
@@ -73,16 +82,39 @@ public:
      */
     void stop();
 
+    /**
+     * Change the frequency of a running clock without a glitch
+     *
+     * Waits for at most one half period of the old clock. A stopped clock
+     * is configured and stays stopped.
+     *
+     * @param frequency New frequency in Hz (1 Hz to ~4 MHz)
+     */
+    void retune(uint32_t frequency);
+
     /**
      * Get currently configured frequency
      *
      * @return Frequency in Hz, or 0 if not configured
      *
-     * Note: Returns configured frequency, not actual output
-     *       (actual may differ slightly due to integer rounding)
+     * Note: Returns the requested frequency; getActualFrequency() is
+     *       what the divider really produces
      */
     uint32_t getFrequency() const;
 
+    /**
+     * Exact output frequency, F_CPU / (2 * prescaler * (OCR3A + 1))
+     *
+     * @param milliHz Output (optional): fractional part, 0-999 mHz
+     * @return Whole Hz (truncated), 0 if not configured
+     */
+    uint32_t getActualFrequency(uint16_t* milliHz = nullptr) const;
+
+    /**
+     * CPU cycles per output period (2 * prescaler * (OCR3A + 1))
+     */
+    uint32_t getPeriodCycles() const;
+
     /**
      * Check if clock is running
      *
@@ -94,6 +126,8 @@ private:
     uint32_t currentFrequency;  // Configured frequency in Hz
     bool isRunning;             // true if clock is active
     uint8_t prescalerBits;      // CS3x bits for TCCR3B
+    uint16_t prescaler;         // Division of prescalerBits
+    uint16_t top;               // OCR3A
 
     /**
      * Select optimal prescaler for given frequency
@@ -103,9 +137,20 @@ private:
      *
      * @param frequency Desired frequency in Hz
      * @param ocr3a Output: calculated OCR3A value
+     * @param division Output: prescaler division (1-1024)
      * @return CS3x bits for TCCR3B
      */
-    uint8_t selectPrescaler(uint32_t frequency, uint16_t& ocr3a);
+    uint8_t selectPrescaler(uint32_t frequency, uint16_t& ocr3a, uint16_t& division);
+
+    /**
+     * Load mode, OCR3A and TCNT3 with the timer stopped (no CS3x bits)
+     */
+    void load();
+
+    /**
+     * TCCR3B waveform bits for the current OCR3A (Fast PWM or CTC)
+     */
+    uint8_t waveformB() const;
 };
 
 #endif // TIMER3_H
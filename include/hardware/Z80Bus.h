@@ -0,0 +1,211 @@
+/**
+ * Z80Bus.h
+ *
+ * Bus-cycle engine for Z80 CPU testing: the Mega is the Z80's memory
+ *
+ * Memory map seen by the Z80:
+ *   0x0000 - romSize-1   ROM, served straight from a PROGMEM image (no RAM copy)
+ *   0x1000 - 0x11FF      RAM window (cpuRamWindow, Z80_RAM_SIZE bytes of Mega SRAM)
+ *   0x1FFF               Stop port: a write ends the run (value = exit code)
+ *   anything else        MemoryMap pages if one is set (TEST IMAGE: the
+ *                        uploaded program, MAP RAM/FAULT pages), else
+ *                        reads 0xFF, writes ignored
+ *
+ * The map is only looked up after the ROM and the RAM window, so the
+ * PROGMEM test programs keep their read response; mapped reads take a few
+ * cycles longer, and mapped runs use /WAIT (Z80Strategy TEST IMAGE).
+ *
+ * run() services bus cycles with interrupts disabled until the Z80 writes
+ * the stop port, /HALT goes LOW, a read limit is reached, or it times out.
+ * /MREQ is on PG0, which has no external or pin-change interrupt, so its
+ * falling edge is caught by a sbis polling loop (3-8 cycles from edge to
+ * response, less than an ISR entry would take).
+ *
+ * Per memory cycle (Z80 timing, T = one CPU clock):
+ *   /MREQ falls mid T1 ─┬─ /RD LOW:  look up byte, drive PORTL, wait /RD HIGH
+ *                       ├─ /RFSH LOW: refresh, wait /MREQ HIGH
+ *                       └─ else:     wait /WR LOW, latch PINL, wait /MREQ HIGH
+ *   /WAIT sampled at T2 falling (1 T after /MREQ), opcode latched at
+ *   T3 rising (1.5 T), other reads at T3 falling (2 T)
+ *
+ * /WAIT (PB4) is asserted the moment /MREQ is seen LOW, and released as
+ * soon as the data is on the bus, but only when the handler can't make the
+ * deadline on its own (Z80_WAIT_AUTO: clock above the no-wait limit, the
+ * z80NoWaitLimitHz() estimate until TEST FMAX has measured it). Below that
+ * the Z80 runs without wait states.
+ *
+ * With a BusTrace attached and TRACE ON, run() records every memory cycle
+ * (refresh excluded) while /WAIT still holds the Z80, so recording never
+ * costs a missed cycle; traced runs always use /WAIT.
+ *
+ * Usage:
+ *   Z80Bus bus;
+ *   bus.configurePins();
+ *   bus.loadRom(PROGRAM, sizeof(PROGRAM));   // PROGRAM is PROGMEM
+ *   bus.clearRam();
+ *   bus.selectWait(Z80_WAIT_AUTO, 500000);
+ *   Z80RunResult result = bus.run(100);      // Clock must be running
+ *   if (result.end == Z80_END_STOP) { ... result.exitCode ... }
+ *
+ * See Strategy/04-Phase4-Z80.md for timing details
+ */
+
+#ifndef Z80_BUS_H
+#define Z80_BUS_H
+
+#include <Arduino.h>
+#include "hardware/PinConfig.h"
+#include "hardware/BusTrace.h"
+#include "hardware/MemoryMap.h"
+
+//=============================================================================
+// MEMORY MAP
+//=============================================================================
+
+constexpr uint16_t Z80_RAM_BASE = 0x1000;
+constexpr uint16_t Z80_RAM_SIZE = CPU_RAM_WINDOW_SIZE;  // cpuRamWindow, shared with IC6502Bus
+constexpr uint16_t Z80_STOP_ADDR = 0x1FFF;
+constexpr uint8_t Z80_UNMAPPED = 0xFF;
+
+//=============================================================================
+// HANDLER TIMING
+//=============================================================================
+
+// Cycles from /MREQ falling to data on PORTL (poll + decode + LPM + DDRL),
+// and from /MREQ falling to /WAIT LOW (poll + cbi). Worst case, checked
+// against measured fmax (TEST FMAX).
+constexpr uint8_t Z80_READ_RESPONSE_CYCLES = 26;
+constexpr uint8_t Z80_WAIT_RESPONSE_CYCLES = 10;
+
+/**
+ * Highest clock at which a read is answered before the opcode latch
+ * (1.5 T after /MREQ) without wait states
+ */
+constexpr uint32_t z80NoWaitLimitHz() {
+    return (uint32_t)(F_CPU * 3 / 2) / Z80_READ_RESPONSE_CYCLES;
+}
+
+/**
+ * Highest clock at which /WAIT is still asserted before it is sampled (1 T)
+ */
+constexpr uint32_t z80WaitLimitHz() {
+    return (uint32_t)F_CPU / Z80_WAIT_RESPONSE_CYCLES;
+}
+
+//=============================================================================
+// RUN RESULTS
+//=============================================================================
+
+enum Z80WaitMode : uint8_t {
+    Z80_WAIT_NEVER,   // Never assert /WAIT (misses cycles above the no-wait limit)
+    Z80_WAIT_ALWAYS,  // Assert /WAIT on every memory cycle
+    Z80_WAIT_AUTO     // Assert only when the clock is above the no-wait limit
+};
+
+enum Z80RunEnd : uint8_t {
+    Z80_END_STOP,     // Program wrote Z80_STOP_ADDR
+    Z80_END_HALT,     // /HALT went LOW
+    Z80_END_LIMIT,    // readLimit memory reads served
+    Z80_END_TIMEOUT   // No end condition within timeoutMs
+};
+
+constexpr uint8_t Z80_TRACE_SIZE = 8;  // First read addresses kept per run
+
+struct Z80RunResult {
+    uint8_t end;                // Z80RunEnd
+    uint8_t exitCode;           // Value written to Z80_STOP_ADDR
+    uint32_t reads;             // Memory read cycles served
+    uint32_t fetches;           // ... of which opcode fetches (/M1 LOW)
+    uint32_t writes;            // Memory write cycles seen
+    uint32_t refreshes;         // Refresh cycles skipped
+    uint16_t trace[Z80_TRACE_SIZE];  // Addresses of the first reads
+    uint32_t cycles;            // Mega CPU cycles from reset release to end
+};
+
+//=============================================================================
+// BUS ENGINE
+//=============================================================================
+
+class Z80Bus {
+public:
+    Z80Bus();
+
+    /**
+     * Z80 mode pin directions (address/data/control in, /RESET, /WAIT,
+     * /INT, /NMI, /BUSREQ out and inactive, Z80 held in reset)
+     */
+    void configurePins();
+
+    /**
+     * ROM image at 0x0000 (PROGMEM pointer, read in place)
+     */
+    void loadRom(const uint8_t* image, uint16_t size);
+
+    /**
+     * Pages for the rest of the address space (nullptr = none, unmapped).
+     * The ROM, the RAM window and the stop port take precedence.
+     */
+    void setMemoryMap(MemoryMap* memory) { map = memory; }
+
+    /**
+     * Fill the RAM window
+     */
+    void clearRam(uint8_t value = 0x00);
+
+    /**
+     * RAM window byte at a Z80 address (0xFF outside the window,
+     * pokes outside it are ignored)
+     */
+    uint8_t peekRam(uint16_t addr) const;
+    void pokeRam(uint16_t addr, uint8_t value);
+
+    /**
+     * Choose whether run() asserts /WAIT for a clock frequency
+     */
+    void selectWait(Z80WaitMode mode, uint32_t clockHz);
+    bool getUseWait() const { return useWait; }
+
+    /**
+     * Highest clock Z80_WAIT_AUTO runs without /WAIT (measured fmax)
+     */
+    void setNoWaitLimit(uint32_t hz) { noWaitLimitHz = hz; }
+    uint32_t getNoWaitLimit() const { return noWaitLimitHz; }
+
+    /**
+     * Trace recorder for run() (nullptr = none)
+     */
+    void setTrace(BusTrace* recorder) { trace = recorder; }
+    BusTrace* getTrace() const { return trace; }
+
+    /**
+     * /RESET control (the clock must run for 3+ cycles while LOW)
+     */
+    void holdReset();
+    void releaseReset();
+
+    /**
+     * Release reset and serve bus cycles until an end condition
+     *
+     * Interrupts are off for the whole run (no millis(), no UART RX);
+     * keep timeoutMs short. The Z80 is held in reset again afterwards.
+     *
+     * @param timeoutMs Longest run (4 ms resolution)
+     * @param readLimit Stop after this many reads (0 = no limit)
+     */
+    Z80RunResult run(uint16_t timeoutMs, uint32_t readLimit = 0);
+
+private:
+    const uint8_t* rom;     // PROGMEM
+    uint16_t romSize;
+    MemoryMap* map;
+    bool useWait;
+    uint32_t noWaitLimitHz;
+    BusTrace* trace;
+
+    uint8_t lookup(uint16_t addr) const;
+
+    template <bool WAIT, bool TRACE>
+    void serve(Z80RunResult& result, uint16_t ticks, uint32_t readLimit);
+};
+
+#endif // Z80_BUS_H
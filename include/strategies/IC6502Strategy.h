@@ -0,0 +1,132 @@
+/**
+ * IC6502Strategy.h
+ *
+ * 6502 CPU testing strategy (40-pin DIP, NMOS 6502 or W65C02S)
+ *
+ * Execution tests run on the firmware burst clock (see hardware/IC6502Bus.h):
+ * the Mega makes every Φ0 edge itself while serving the bus, so programs
+ * run as fast as the Mega can serve them with no contention. The clock
+ * test switches PE3 back to Timer3 free-run and checks Φ1/Φ2 on PD0/PD1.
+ *
+ * Tests (5 total):
+ * 1. Reset Vector      - reads FFFC/FFFD after RES, first opcode fetch at F000
+ * 2. Clock Generation  - Timer3 free-run on Φ0, Φ1/Φ2 toggling and complementary
+ * 3. JMP Loop          - 4C 00 F0: fetch sequence F000→F001→F002, SYNC per loop
+ * 4. Memory Write      - STA $00 / STA $01, exit code via the stop port
+ * 5. Memory Read       - 6502 reads $00/$01 back, EOR written to the stop port
+ *
+ * TEST IMAGE runs the uploaded program (LOAD, utils/ProgramImage.h, based
+ * at 0xF000 to start from reset) as test 6, mapped as ROM pages of the
+ * MemoryMap (with any MAP RAM/FAULT pages): it passes by writing 00h to
+ * the stop port without touching a FAULT page.
+ *
+ * TEST STEP [n] clocks the first n bus cycles after reset and lists them.
+ *
+ * If the CLOCK command had Timer3 running, it is restarted at the same
+ * frequency when the tests are done.
+ *
+ * Usage:
+ *   IC6502Strategy cpu;
+ *   cpu.setClock(&timer3);
+ *   cpu.setUARTHandler(&uart);
+ *   cpu.configurePins();
+ *   cpu.runTests();           // Tests 1-5
+ *   cpu.stepCycles(16);       // TEST STEP 16
+ *   cpu.setMemoryMap(&map);
+ *   cpu.setImage(image.getData(), image.getBase(), image.getLength());
+ *   cpu.runTest(IC6502_IMAGE_TEST);
+ *
+ * See Strategy/05-Phase5-6502.md for implementation details
+ */
+
+#ifndef IC6502_STRATEGY_H
+#define IC6502_STRATEGY_H
+
+#include "strategies/ICTestStrategy.h"
+#include "hardware/IC6502Bus.h"
+#include "hardware/Timer3.h"
+#include "utils/UARTHandler.h"
+
+constexpr uint32_t IC6502_FREE_RUN_HZ = 100000;     // Test 2 (Timer3 free-run)
+constexpr uint16_t IC6502_RUN_TIMEOUT_MS = 100;     // One program run
+constexpr uint8_t IC6502_STEP_DEFAULT = 16;         // TEST STEP without a count
+constexpr uint8_t IC6502_STEP_MAX = 32;
+constexpr uint8_t IC6502_TEST_COUNT = 5;
+constexpr uint8_t IC6502_IMAGE_TEST = IC6502_TEST_COUNT + 1;  // TEST IMAGE (not in runTests())
+
+class IC6502Strategy : public ICTestStrategy {
+public:
+    IC6502Strategy();
+
+    // ICTestStrategy interface implementation
+    void configurePins() override;
+    void reset() override;
+    bool runTests() override;  // Tests 1-5
+    const __FlashStringHelper* getName() const override;
+
+    /**
+     * Run one test (1-5, or IC6502_IMAGE_TEST)
+     *
+     * @return true if passed
+     */
+    bool runTest(uint8_t testNumber);
+
+    /**
+     * Reset, clock count bus cycles (1-IC6502_STEP_MAX) and list them
+     */
+    void stepCycles(uint8_t count);
+
+    /**
+     * Clock generator shared with the CLOCK command (required)
+     */
+    void setClock(Timer3Clock* timer);
+
+    /**
+     * Set UART handler for results (optional)
+     */
+    void setUARTHandler(UARTHandler* handler);
+
+    /**
+     * Bus trace for the program runs (optional, TRACE command)
+     */
+    void setTrace(BusTrace* trace);
+
+    /**
+     * Uploaded program for IC6502_IMAGE_TEST (RAM, kept by the caller)
+     */
+    void setImage(const uint8_t* data, uint16_t base, uint16_t size);
+
+    /**
+     * Pages IC6502_IMAGE_TEST runs in (required for it; the image is
+     * mapped in as ROM, MAP RAM/FAULT pages are kept)
+     */
+    void setMemoryMap(MemoryMap* memory);
+
+private:
+    IC6502Bus bus;
+    Timer3Clock* clock;
+    UARTHandler* uart;
+    uint32_t savedClockHz;  // CLOCK frequency to restore (0 = was stopped)
+    const uint8_t* image;   // IC6502_IMAGE_TEST program
+    uint16_t imageBase;
+    uint16_t imageSize;
+    MemoryMap* map;         // IC6502_IMAGE_TEST pages
+
+    // Test implementations
+    bool testResetVector();
+    bool testClock();
+    bool testJmpLoop();
+    bool testMemoryWrite();
+    bool testMemoryRead();
+    bool testImage();
+
+    // Helpers
+    bool runSingle(uint8_t testNumber);  // Clock already taken by saveClock()
+    void saveClock();
+    void restoreClock();
+    IC6502RunResult runProgram(const uint8_t* program, uint16_t size, uint32_t cycleLimit = 0);
+    PGM_P getTestName(uint8_t testNumber);  // Name in flash (print with %S)
+    void sendRunEnd(const IC6502RunResult& result);
+};
+
+#endif // IC6502_STRATEGY_H
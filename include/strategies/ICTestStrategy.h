@@ -25,13 +25,15 @@
  *       void configurePins() override { ... }
  *       void reset() override { ... }
  *       bool runTests() override { ... }
- *       const char* getName() const override { return "Z80"; }
+ *       const __FlashStringHelper* getName() const override { return F("Z80"); }
  *   };
  */
 
 #ifndef IC_TEST_STRATEGY_H
 #define IC_TEST_STRATEGY_H
 
+#include <Arduino.h>
+
 /**
  * Abstract base class for IC testing strategies
  *
@@ -91,9 +93,9 @@ public:
     /**
      * Get IC name for display
      *
-     * @return Null-terminated string with IC name (e.g., "Z80", "6502", "HM62256")
+     * @return IC name in flash (e.g., "Z80", "6502", "HM62256")
      */
-    virtual const char* getName() const = 0;
+    virtual const __FlashStringHelper* getName() const = 0;
 
     /**
      * Virtual destructor
@@ -0,0 +1,125 @@
+/**
+ * MarchTest.h
+ *
+ * Table-driven March test definitions for SRAM testing
+ *
+ * A March test is a list of elements. Each element walks the whole address
+ * range in one direction and applies the same short sequence of operations
+ * to every cell before moving to the next one:
+ *
+ *   March C-: ⇕(w0); ⇑(r0,w1); ⇑(r1,w0); ⇓(r0,w1); ⇓(r1,w0); ⇕(r0)
+ *
+ * "0" is the data background, "1" its complement. Elements are stored in
+ * PROGMEM and interpreted by SRAMStrategy, so adding an algorithm is a new
+ * table entry, not new test code.
+ *
+ * Built-in algorithms:
+ *   MATS+    5n   stuck-at, address decoder faults
+ *   CMINUS  10n   + transition, unlinked coupling faults (default screen)
+ *   B       17n   + linked coupling faults
+ *
+ * Usage:
+ *   int8_t index = findMarchAlgorithm("CMINUS");
+ *   const MarchAlgorithm& alg = MARCH_ALGORITHMS[index];
+ *   MarchElement element;
+ *   readMarchElement(alg, 0, element);
+ */
+
+#ifndef MARCH_TEST_H
+#define MARCH_TEST_H
+
+#include <Arduino.h>
+
+//=============================================================================
+// OPERATION ENCODING
+// bit 0 = data (0 = background, 1 = inverted background), bit 1 = write
+// bits 4-7 = result tag (which test a read reports to, 0 = the March test)
+//=============================================================================
+
+constexpr uint8_t MARCH_OP_INVERT = (1 << 0);
+constexpr uint8_t MARCH_OP_WRITE  = (1 << 1);
+constexpr uint8_t MARCH_TAG_SHIFT = 4;
+
+constexpr uint8_t marchTag(uint8_t mask) { return (uint8_t)(mask << MARCH_TAG_SHIFT); }
+
+constexpr uint8_t MARCH_R0 = 0;
+constexpr uint8_t MARCH_R1 = MARCH_OP_INVERT;
+constexpr uint8_t MARCH_W0 = MARCH_OP_WRITE;
+constexpr uint8_t MARCH_W1 = MARCH_OP_WRITE | MARCH_OP_INVERT;
+
+/**
+ * Address order of a March element
+ */
+enum MarchOrder : uint8_t {
+    MARCH_ANY,   // ⇕ either direction (runs ascending)
+    MARCH_UP,    // ⇑ ascending addresses
+    MARCH_DOWN   // ⇓ descending addresses
+};
+
+constexpr uint8_t MARCH_MAX_OPS = 6;
+
+/**
+ * One March element: direction plus up to MARCH_MAX_OPS operations per cell
+ */
+struct MarchElement {
+    uint8_t order;
+    uint8_t opCount;
+    uint8_t ops[MARCH_MAX_OPS];
+};
+
+/**
+ * Built-in algorithm descriptor
+ */
+struct MarchAlgorithm {
+    const char* keyword;             // Name used in TEST MARCH <keyword> (PROGMEM)
+    const char* name;                // Display name (PROGMEM)
+    uint8_t background;              // Data for "0" ("1" is the complement)
+    uint8_t opsPerCell;              // Complexity in n (operations per cell)
+    uint8_t elementCount;
+    const MarchElement* elements;    // PROGMEM table
+};
+
+constexpr uint8_t MARCH_ALGORITHM_COUNT = 3;
+constexpr uint8_t MARCH_DEFAULT_ALGORITHM = 1;  // March C-
+
+extern const MarchAlgorithm MARCH_ALGORITHMS[MARCH_ALGORITHM_COUNT];
+
+/**
+ * Fused pattern sweep: tests 1, 4 and 5 in one table (background 0x55)
+ *
+ *   ⇑(w0); ⇑(r0[4], w1, r1[1]); ⇑(r1[4,5], w0, r0[1]); ⇑(r0[5])
+ *
+ * Reads are tagged with the tests they stand in for:
+ * - Checkerboard (4):         all-0x55 verified, then all-0xAA verified
+ * - Inverse Checkerboard (5): all-0xAA verified, then all-0x55 verified
+ * - Basic Read/Write (1):     each cell written and read back, 0xAA and 0x55
+ * 4 sweeps instead of the 10 the three separate tests need.
+ */
+constexpr uint8_t FUSED_TAG_BASIC        = (1 << 0);
+constexpr uint8_t FUSED_TAG_CHECKERBOARD = (1 << 1);
+constexpr uint8_t FUSED_TAG_INVERSE      = (1 << 2);
+
+extern const MarchAlgorithm MARCH_FUSED_PATTERNS;
+
+/**
+ * Test 1 (Basic Read/Write) on its own: ⇑(w0, r0); ⇑(w1, r1), background
+ * 0xAA. Each cell is written and read back at once, 0xAA then 0x55, as
+ * the original test 1 did: it checks that every cell stores both values
+ * and leaves retention and cell interaction to the other tests.
+ */
+extern const MarchAlgorithm MARCH_BASIC_PATTERNS;
+
+/**
+ * Find algorithm by keyword
+ *
+ * @param keyword Algorithm keyword (e.g., "CMINUS", "B", "MATS+")
+ * @return Index into MARCH_ALGORITHMS, or -1 if unknown
+ */
+int8_t findMarchAlgorithm(const char* keyword);
+
+/**
+ * Copy one element of an algorithm from PROGMEM into RAM
+ */
+void readMarchElement(const MarchAlgorithm& algorithm, uint8_t index, MarchElement& element);
+
+#endif // MARCH_TEST_H
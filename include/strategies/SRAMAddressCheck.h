@@ -0,0 +1,104 @@
+/**
+ * SRAMAddressCheck.h
+ *
+ * Address bus diagnosis for test 2: stuck, open and shorted address lines
+ *
+ * Writing and reading back one byte per address line can't see a fault on
+ * the line itself: the write and the read go to the same (wrong) cell. A
+ * bad line shows up as aliasing instead, two addresses that reach one cell.
+ * Two walks look for it, each over a base address and its one-line
+ * neighbours:
+ *
+ *   Walking ones:   base 0000h, neighbours 0001h, 0002h, ... 4000h
+ *   Walking zeros:  base 7FFFh, neighbours 7FFEh, 7FFDh, ... 3FFFh
+ *
+ * Each walk writes a background (55h) to the base and every neighbour,
+ * checks that all of them read it back, then for each line i writes AAh to
+ * neighbour i and reads the base and every other neighbour:
+ * - The base changed: line i has no effect in this walk
+ * - Neighbour j changed (base did not): lines i and j are shorted
+ *
+ * A stuck or open line has no effect in both walks. A short between two
+ * lines is seen as a pair in one walk (wired-OR in walking ones, wired-AND
+ * in walking zeros) and explains the "no effect" of both lines in the other.
+ * A line with no effect in one walk only and no partner is shorted to a
+ * signal that isn't walked (another pin, or A13/CS2 on 8KB parts).
+ *
+ * 8KB parts: SRAMBus forces A13 HIGH on every access (pin 26 is CS2), so
+ * only A0-A12 are walked; an A13 fault deselects the chip and shows up as
+ * a data fault (no valid data at the base).
+ *
+ * Cost: about 2 * lines^2 single accesses (600 for 32KB), a millisecond or
+ * two. A data fault (background not read back) ends the check before the
+ * walks: with the data bus broken, aliasing can't be told apart.
+ *
+ * Usage:
+ *   SRAMAddressCheck check;
+ *   if (!check.run(bus, 15)) {
+ *       check.getStuckLines();       // Bit n = An
+ *       check.getShortedWith(3);     // Lines shorted to A3
+ *       check.getFirstFault();       // First mismatch (address, expected, actual)
+ *   }
+ */
+
+#ifndef SRAM_ADDRESS_CHECK_H
+#define SRAM_ADDRESS_CHECK_H
+
+#include "hardware/SRAMBus.h"
+
+constexpr uint8_t SRAM_ADDRESS_MAX_LINES = 15;      // A0-A14 (32KB)
+constexpr uint8_t SRAM_ADDRESS_BACKGROUND = 0x55;
+constexpr uint8_t SRAM_ADDRESS_MARK = 0xAA;
+
+class SRAMAddressCheck {
+public:
+    SRAMAddressCheck();
+
+    /**
+     * Run both walks over lines A0..A(lines - 1)
+     *
+     * @param lines Address lines of the part (13 for 8KB, 15 for 32KB)
+     * @return true if no address or data fault was found
+     */
+    bool run(SRAMBus& bus, uint8_t lines);
+
+    /**
+     * Background not read back: chip missing or not selected, data bus fault
+     */
+    bool hasDataFault() const { return dataFault; }
+
+    /**
+     * Lines with no effect in both walks (stuck or open)
+     */
+    uint16_t getStuckLines() const;
+
+    /**
+     * Lines shorted to line (bit n = An), 0 if none
+     */
+    uint16_t getShortedWith(uint8_t line) const;
+
+    /**
+     * Lines with no effect in one walk only and no shorted partner
+     */
+    uint16_t getUnpairedLines() const;
+
+    const SRAMFirstFault& getFirstFault() const { return firstFault; }
+
+    /**
+     * Single accesses run() makes on a good part (for run-time estimates)
+     */
+    static uint16_t accessCount(uint8_t lines);
+
+private:
+    uint8_t lineCount;
+    bool dataFault;
+    uint16_t noEffect[2];                       // [walking ones, walking zeros]
+    uint16_t shorted[SRAM_ADDRESS_MAX_LINES];   // Partner lines per line, both walks
+    SRAMFirstFault firstFault;
+
+    bool walk(SRAMBus& bus, uint8_t walkIndex, uint16_t base);
+    uint8_t check(SRAMBus& bus, uint16_t addr, uint8_t expected);
+    uint16_t shortedLines() const;
+};
+
+#endif // SRAM_ADDRESS_CHECK_H
@@ -0,0 +1,109 @@
+/**
+ * SRAMDump.h
+ *
+ * SRAM read-back: raw dump in binary frames (DUMP) and on-board CRC (CRC)
+ *
+ * DUMP streams a range as DUMP_DATA records (address + 6 bytes) followed
+ * by a CRC record with the CRC-32 of the range, so the host can check the
+ * image it received. CRC reads the range on the board and only sends the
+ * checksum: a host compares a 32 KB region against the CRC of the pattern
+ * it wrote (or against an earlier CRC, for retention tests) without the
+ * transfer.
+ *
+ * Both run as a SchedulerTask: the range is read in units between
+ * commands, so ABORT and STATUS are answered. DUMP only queues a record
+ * when it fits in the UART TX ring; a full ring ends the slice instead of
+ * waiting, so the link runs at full speed without stalling the main loop.
+ *
+ * Records go out in either protocol (like TRACE DUMP); the final OK line
+ * is text.
+ *
+ * Usage:
+ *   SRAMDump dump;
+ *   scheduler.add(&dump);
+ *   dump.setUARTHandler(&uart);
+ *   dump.start(sram.getBus(), 0x0000, 32768, SRAM_READ_CRC32, SRAM_SOCKET_A);
+ *   ... scheduler.run() ...
+ *   dump.getCrc();
+ *
+ * See Strategy/03-Phase3-SRAM.md section 26
+ */
+
+#ifndef SRAM_DUMP_H
+#define SRAM_DUMP_H
+
+#include "hardware/SRAMBus.h"
+#include "utils/Scheduler.h"
+#include "utils/UARTHandler.h"
+
+enum SRAMReadKind : uint8_t {
+    SRAM_READ_DUMP,       // DUMP_DATA records, then CRC-32
+    SRAM_READ_CRC32,      // CRC-32 only
+    SRAM_READ_CRC16       // CRC-16/CCITT-FALSE only
+};
+
+class SRAMDump : public SchedulerTask {
+public:
+    SRAMDump();
+
+    void setUARTHandler(UARTHandler* handler);
+
+    /**
+     * Start reading [first, first + length - 1] (returns immediately)
+     *
+     * @param socket SRAM_SOCKET_A or SRAM_SOCKET_B
+     * @return false if a read is already active or length is 0
+     */
+    bool start(SRAMBus& bus, uint16_t first, uint32_t length, uint8_t kind, uint8_t socket);
+
+    /**
+     * Read (and send) the next units until budgetUs has elapsed (SchedulerTask)
+     *
+     * @return true while the read is active
+     */
+    bool step(uint16_t budgetUs) override;
+
+    bool isActive() const;
+    void abort();         // Ends the read at the next unit
+
+    /**
+     * Send the current position ("STATUS: Dump 0x0000-0x7FFF, 37%")
+     */
+    void sendStatus();
+
+    /**
+     * Result of the last completed read (CRC-16 in the low half)
+     */
+    uint32_t getCrc() const;
+
+    /**
+     * Bytes read by the current or last read
+     */
+    uint32_t getBytesRead() const;
+
+    // Bytes per CRC unit (one bus burst)
+    static constexpr uint16_t CRC_UNIT = 256;
+
+private:
+    SRAMBus* bus;
+    UARTHandler* uart;
+    uint8_t kind;
+    uint8_t socket;
+    uint16_t first;
+    uint32_t length;
+    uint32_t bytesRead;
+    uint32_t crc;         // Running value (result after finish())
+    bool active;
+    bool aborted;
+
+    // DUMP: chunk read but not yet queued
+    uint8_t chunk[BIN_DUMP_CHUNK];
+    uint8_t chunkLength;
+    uint16_t chunkAddress;
+
+    void readUnit(uint16_t address, uint16_t count, uint8_t* into);
+    bool sendChunk();
+    void finish();
+};
+
+#endif // SRAM_DUMP_H
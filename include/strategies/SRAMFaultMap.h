@@ -0,0 +1,108 @@
+/**
+ * SRAMFaultMap.h
+ *
+ * Continue-on-error fault collection for SRAM tests (TEST ... MAP)
+ *
+ * Instead of stopping at the first mismatch, every failure is folded into
+ * a fixed-size summary that fits the Mega's 8KB RAM:
+ * - Per data bit fail counters, split by direction (read 0 / read 1)
+ * - Run-length list of failing address ranges (a dead row is one entry)
+ * - The first MAP_MAX_RECORDS failures in full detail
+ *
+ * Nothing is sent while a test runs; the report is one burst at the end.
+ *
+ * RAM budget: ~300 bytes (see MAP_* constants below)
+ *
+ * Usage:
+ *   SRAMFaultMap map;
+ *   map.clear();
+ *   map.setTest(1);
+ *   bus.verify(0, maxAddress, pattern, map);   // never stops early
+ *   if (map.getTotalFailures() > 0) { ... }
+ */
+
+#ifndef SRAM_FAULT_MAP_H
+#define SRAM_FAULT_MAP_H
+
+#include <Arduino.h>
+#include "hardware/SRAMBus.h"
+
+constexpr uint8_t MAP_MAX_RANGES = 32;   // 6 bytes each
+constexpr uint8_t MAP_MAX_RECORDS = 16;  // 5 bytes each
+
+/**
+ * Contiguous run of failing addresses
+ */
+struct SRAMFaultRange {
+    uint16_t first;
+    uint16_t last;
+    uint16_t failures;  // Mismatches inside the range (saturates at 0xFFFF)
+};
+
+/**
+ * One failure in full detail
+ */
+struct SRAMFaultRecord {
+    uint8_t test;
+    uint16_t address;
+    uint8_t expected;
+    uint8_t actual;
+};
+
+class SRAMFaultMap : public SRAMFaultSink {
+public:
+    SRAMFaultMap();
+
+    /**
+     * Forget all collected failures
+     */
+    void clear();
+
+    /**
+     * Test number stored with failures from now on
+     */
+    void setTest(uint8_t testNumber);
+
+    /**
+     * Record a mismatch for the current test (always continues)
+     */
+    bool onFault(uint16_t address, uint8_t expected, uint8_t actual, uint8_t tag) override;
+
+    /**
+     * Record a mismatch for an explicit test number
+     */
+    void record(uint8_t testNumber, uint16_t address, uint8_t expected, uint8_t actual);
+
+    uint32_t getTotalFailures() const { return totalFailures; }
+
+    // Data bit D<bit>: expected 1, read 0 / expected 0, read 1
+    uint16_t getBitReadLow(uint8_t bit) const { return bitReadLow[bit]; }
+    uint16_t getBitReadHigh(uint8_t bit) const { return bitReadHigh[bit]; }
+
+    uint8_t getRangeCount() const { return rangeCount; }
+    const SRAMFaultRange& getRange(uint8_t index) const { return ranges[index]; }
+
+    // Failures that fell outside every range once the list was full
+    uint32_t getUnmappedFailures() const { return unmappedFailures; }
+
+    uint8_t getRecordCount() const { return recordCount; }
+    const SRAMFaultRecord& getRecord(uint8_t index) const { return records[index]; }
+
+private:
+    uint8_t currentTest;
+    uint32_t totalFailures;
+    uint32_t unmappedFailures;
+
+    uint16_t bitReadLow[8];
+    uint16_t bitReadHigh[8];
+
+    SRAMFaultRange ranges[MAP_MAX_RANGES];
+    uint8_t rangeCount;
+
+    SRAMFaultRecord records[MAP_MAX_RECORDS];
+    uint8_t recordCount;
+
+    void addToRanges(uint16_t address);
+};
+
+#endif // SRAM_FAULT_MAP_H
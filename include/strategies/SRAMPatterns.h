@@ -0,0 +1,91 @@
+/**
+ * SRAMPatterns.h
+ *
+ * Data pattern generators for SRAM tests
+ *
+ * Each pattern provides `uint8_t at(uint16_t addr)`, called once per tested
+ * address in sweep order by SRAMBus::fill() / SRAMBus::verify(). Stateful
+ * patterns (random) must be recreated with the same seed for the verify pass.
+ *
+ * Usage:
+ *   SRAMConstantPattern checker(0x55);
+ *   bus.fill(0, maxAddress, checker);
+ *
+ *   SRAMRandomPattern written(seed), expected(seed);
+ *   bus.fill(0, maxAddress, written);
+ *   bus.verify(0, maxAddress, expected, sink);
+ */
+
+#ifndef SRAM_PATTERNS_H
+#define SRAM_PATTERNS_H
+
+#include <Arduino.h>
+
+/**
+ * Same value at every address (checkerboard, basic read/write)
+ */
+class SRAMConstantPattern {
+public:
+    explicit SRAMConstantPattern(uint8_t value) : value(value) {}
+    uint8_t at(uint16_t) const { return value; }
+
+private:
+    uint8_t value;
+};
+
+/**
+ * Low byte of the address (address equals data)
+ */
+class SRAMAddressPattern {
+public:
+    uint8_t at(uint16_t addr) const { return (uint8_t)(addr & 0xFF); }
+};
+
+/**
+ * Pseudo-random bytes from a seed: xorshift32 (Marsaglia 13/17/5), four
+ * output bytes per step
+ *
+ * Shifts and XORs only, so each byte costs tens of cycles. Arduino
+ * random(256) costs several hundred (a 32-bit division per call). The same
+ * seed gives the same sequence, so the verify pass recreates it. Seed 0 is
+ * the generator's fixed point and is replaced by SRAM_RANDOM_ZERO_SEED.
+ */
+constexpr uint32_t SRAM_RANDOM_ZERO_SEED = 0x2545F491;
+
+class SRAMRandomPattern {
+public:
+    explicit SRAMRandomPattern(uint32_t seed)
+        : state(seed != 0 ? seed : SRAM_RANDOM_ZERO_SEED), bits(0), left(0) {}
+
+    uint8_t at(uint16_t) {
+        if (left == 0) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            bits = state;
+            left = 4;
+        }
+        uint8_t value = (uint8_t)bits;
+        bits >>= 8;
+        left--;
+        return value;
+    }
+
+    /**
+     * Seed for the pass after the one using seed (never 0)
+     */
+    static uint32_t nextSeed(uint32_t seed) {
+        seed += 0x9E3779B9;     // Golden ratio step: nearby seeds diverge
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed != 0 ? seed : SRAM_RANDOM_ZERO_SEED;
+    }
+
+private:
+    uint32_t state;
+    uint32_t bits;          // Unused bytes of the last step, low byte next
+    uint8_t left;
+};
+
+#endif // SRAM_PATTERNS_H
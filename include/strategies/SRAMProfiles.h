@@ -0,0 +1,63 @@
+/**
+ * SRAMProfiles.h
+ *
+ * Named SRAM test profiles: fast-fail tiers from cheapest to strongest
+ *
+ * Each profile is a test sequence that stops at its first failing tier,
+ * so a dead part costs milliseconds and only a good part pays for the
+ * whole run:
+ *
+ *   TRIAGE      data bus (3), address bus (2), March C- QUICK
+ *   PRODUCTION  data bus (3), address bus (2), March C- FULL
+ *   QUALIFY     data bus (3), address bus (2), March B FULL, random x4 FULL
+ *
+ * The table is in PROGMEM; readSRAMProfile() copies an entry into RAM.
+ *
+ * Profiles are ordered weakest first. TEST BUDGET <ms> picks the last one
+ * whose estimate (SRAMStrategy::estimateRunMs()) fits.
+ *
+ * Usage:
+ *   int8_t index = findSRAMProfile("PRODUCTION");
+ *   SRAMProfile profile;
+ *   readSRAMProfile(index, profile);
+ *   sram.setMarchAlgorithm(profile.marchAlgorithm);
+ *   sram.startRun(SRAMStrategy::profilePlan(index));
+ */
+
+#ifndef SRAM_PROFILES_H
+#define SRAM_PROFILES_H
+
+#include <Arduino.h>
+
+constexpr uint8_t SRAM_PROFILE_MAX_TESTS = 4;
+
+/**
+ * Profile descriptor
+ */
+struct SRAMProfile {
+    const char* keyword;             // Name used in TEST PROFILE <keyword> (PROGMEM)
+    const char* description;         // Tier list for the listing (PROGMEM)
+    uint8_t tests[SRAM_PROFILE_MAX_TESTS];
+    uint8_t testCount;
+    bool fullTest;
+    uint8_t marchAlgorithm;          // Test 8 (index into MARCH_ALGORITHMS)
+    uint8_t randomPasses;            // Test 7
+};
+
+constexpr uint8_t SRAM_PROFILE_COUNT = 3;
+
+extern const SRAMProfile SRAM_PROFILES[SRAM_PROFILE_COUNT] PROGMEM;
+
+/**
+ * Find profile by keyword
+ *
+ * @return Index into SRAM_PROFILES, or -1 if unknown
+ */
+int8_t findSRAMProfile(const char* keyword);
+
+/**
+ * Copy one profile from PROGMEM into RAM (index past the table: profile 0)
+ */
+void readSRAMProfile(uint8_t index, SRAMProfile& profile);
+
+#endif // SRAM_PROFILES_H
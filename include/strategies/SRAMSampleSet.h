@@ -0,0 +1,82 @@
+/**
+ * SRAMSampleSet.h
+ *
+ * Address set tested in QUICK mode, as a precomputed run list
+ *
+ * Sampled addresses:
+ * - First and last 512 bytes (decoder edges, most common fault area)
+ * - Powers of two (one per address line)
+ * - Every <stride>th address (default 128)
+ *
+ * build() turns that set into a sorted list of runs (first, last, step),
+ * once per setSize() or stride change. Tests then iterate runs directly:
+ * a step-1 run is one bus burst, a strided run one burst per cell, and no
+ * time is spent on unsampled addresses. For 32KB at stride 128:
+ *
+ *   [0x0000-0x0200 /1] [0x0280-0x7E00 /128] [0x7E01-0x7FFF /1]
+ *   1272 cells in 3 runs, instead of 32768 shouldTestAddress() calls
+ *
+ * RAM budget: ~200 bytes (SAMPLE_MAX_RUNS)
+ *
+ * Usage:
+ *   SRAMSampleSet samples;
+ *   samples.build(0x7FFF, 128);
+ *   for (uint8_t i = 0; i < samples.getRunCount(); i++) {
+ *       SRAMSampleRun run;
+ *       if (samples.clip(i, 0x0000, 0x03FF, run)) { ... }
+ *   }
+ */
+
+#ifndef SRAM_SAMPLE_SET_H
+#define SRAM_SAMPLE_SET_H
+
+#include <Arduino.h>
+
+constexpr uint16_t SAMPLE_DEFAULT_STRIDE = 128;
+constexpr uint16_t SAMPLE_MAX_STRIDE = 4096;
+constexpr uint16_t SAMPLE_EDGE_BYTES = 512;  // Always tested at both ends
+constexpr uint8_t SAMPLE_MAX_RUNS = 32;      // 6 bytes each
+
+/**
+ * Addresses first, first + step, ... up to last (last - first is a multiple of step)
+ */
+struct SRAMSampleRun {
+    uint16_t first;
+    uint16_t last;
+    uint16_t step;
+};
+
+class SRAMSampleSet {
+public:
+    SRAMSampleSet();
+
+    /**
+     * Rebuild the run list for addresses 0..maxAddress
+     *
+     * @param stride Sampling interval between the edge blocks (1 = every address)
+     * @return false if stride is out of range (1..SAMPLE_MAX_STRIDE),
+     *         the previous list is kept
+     */
+    bool build(uint16_t maxAddress, uint16_t stride);
+
+    uint16_t getStride() const { return stride; }
+    uint32_t getCellCount() const { return cellCount; }
+    uint8_t getRunCount() const { return runCount; }
+
+    /**
+     * Part of run index that lies in [low, high]
+     *
+     * @return false if no sampled address of the run is in the window
+     */
+    bool clip(uint8_t index, uint16_t low, uint16_t high, SRAMSampleRun& out) const;
+
+private:
+    SRAMSampleRun runs[SAMPLE_MAX_RUNS];
+    uint8_t runCount;
+    uint16_t stride;
+    uint32_t cellCount;
+
+    bool append(uint16_t addr);
+};
+
+#endif // SRAM_SAMPLE_SET_H
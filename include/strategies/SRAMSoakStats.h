@@ -0,0 +1,102 @@
+/**
+ * SRAMSoakStats.h
+ *
+ * Running statistics of a soak run (TEST ... LOOP <n|FOREVER>)
+ *
+ * A soak repeats one run plan many times. Instead of the per-test output
+ * of every iteration, the board keeps:
+ * - Completed and failed iterations, and the first failed one
+ * - Per test of the plan: runs, failures, min/max/mean active time
+ *
+ * Times are the PERF active time of each test (Timer5, pauses and main
+ * loop work excluded), so they compare across boards and link speeds.
+ *
+ * RAM budget: ~190 bytes (8 tests of 21 bytes, plus counters). The mean is
+ * a 32-bit running mean, as in HealthMonitor.
+ *
+ * Usage:
+ *   SRAMSoakStats soak;
+ *   soak.begin(plan.tests, plan.testCount, 1000);
+ *   soak.recordTest(index, us, passed);       // After each test
+ *   soak.endIteration(passed);                // After each pass of the plan
+ *   if (soak.isDone()) { ... soak.getTest(i).maxUs ... }
+ */
+
+#ifndef SRAM_SOAK_STATS_H
+#define SRAM_SOAK_STATS_H
+
+#include <Arduino.h>
+
+constexpr uint32_t SRAM_LOOP_FOREVER = 0xFFFFFFFF;  // Iteration target: until ABORT
+constexpr uint8_t SOAK_MAX_TESTS = 8;               // SRAMRunPlan::tests
+
+/**
+ * Figures for one test of the looped plan
+ */
+struct SRAMSoakTestStats {
+    uint8_t test;         // Test number (1-8)
+    uint32_t runs;        // Completed runs (a skipped tier doesn't count)
+    uint32_t failures;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint32_t meanUs;      // Running mean of the completed runs
+};
+
+class SRAMSoakStats {
+public:
+    SRAMSoakStats();
+
+    /**
+     * Start counting for a plan
+     *
+     * @param tests Test numbers, in plan order
+     * @param target Iterations to run, or SRAM_LOOP_FOREVER
+     */
+    void begin(const uint8_t* tests, uint8_t testCount, uint32_t target);
+
+    /**
+     * Record one finished test of the current iteration
+     *
+     * @param index Position in the plan (as passed to begin())
+     */
+    void recordTest(uint8_t index, uint32_t us, bool passed);
+
+    /**
+     * Count a completed iteration
+     */
+    void endIteration(bool passed);
+
+    /**
+     * Target reached (never for SRAM_LOOP_FOREVER)
+     */
+    bool isDone() const;
+
+    uint32_t getTarget() const { return target; }
+    uint32_t getIterations() const { return iterations; }
+    uint32_t getFailedIterations() const { return failedIterations; }
+    uint32_t getFirstFailedIteration() const { return firstFailed; }  // 1-based, 0 = none
+
+    uint8_t getTestCount() const { return testCount; }
+    const SRAMSoakTestStats& getTest(uint8_t index) const { return testStats[index]; }
+
+    /**
+     * Mean active time of a test, 0 before its first run
+     */
+    uint32_t getMeanUs(uint8_t index) const;
+
+    /**
+     * Plan tests with at least one failure
+     */
+    uint8_t getFailingTests() const;
+
+private:
+    uint32_t target;
+    uint32_t iterations;
+    uint32_t failedIterations;
+    uint32_t firstFailed;
+
+    uint8_t testCount;
+    SRAMSoakTestStats testStats[SOAK_MAX_TESTS];
+};
+
+#endif // SRAM_SOAK_STATS_H
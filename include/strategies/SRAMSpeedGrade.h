@@ -0,0 +1,96 @@
+/**
+ * SRAMSpeedGrade.h
+ *
+ * TEST SPEED: access-time grading by sweeping the SRAM strobes one CPU
+ * cycle at a time
+ *
+ * The datasheet timing in SRAMBus.h is the worst case of the supported
+ * parts, so a 70 ns chip and a 200 ns chip look the same. The sweep goes
+ * from slower than the datasheet down to no delay at all, one cycle
+ * (62.5 ns at 16 MHz) per step, and stops at the first failure:
+ *
+ *   Reads:  write at datasheet timing, read back with a settle of
+ *           SRAM_SPEED_READ_STEPS - 1 .. 0 cycles
+ *   Writes: write with an extra /WE pulse of SRAM_SPEED_WRITE_STEPS - 1 .. 0
+ *           cycles, read back at datasheet timing
+ *
+ * Each step is the pattern and its complement over the whole chip, in
+ * address-controlled reads where consecutive cells differ in every bit
+ * (SRAMBus::speedData()), the hardest case for tAA. Every step is its own
+ * template instance (SRAMBus::fillTimed()/verifyTimed()), so each delay is
+ * a compile-time NOP chain. Interrupts are off during each 256-byte page.
+ *
+ * The shortest passing read settle gives an upper bound on tAA of
+ * (cycles + 1) * 62.5 ns, binned into the standard grades (-70 ... -20).
+ * With SRAM_SPEED_MARGIN_CYCLES added, it becomes the production read
+ * trim (SRAMBus::setReadTrim()), which must pass a March C- before it is
+ * kept; otherwise the trim steps back toward datasheet timing.
+ *
+ * In dual-socket mode each socket is swept on its own; the slower one sets
+ * the trim, and the March C- runs on both.
+ *
+ * Cost: about 0.1 s per step on a 32KB part, 1-2 s in all.
+ *
+ * Usage:
+ *   SRAMSpeedGrade grade;
+ *   SRAMSpeedResult result;
+ *   grade.run(bus, 32768, result);        // bus.getReadTrim() is applied
+ *   sramSpeedGradeName(result.readCycles);
+ *
+ * See Strategy/03-Phase3-SRAM.md section 27
+ */
+
+#ifndef SRAM_SPEED_GRADE_H
+#define SRAM_SPEED_GRADE_H
+
+#include "hardware/SRAMBus.h"
+
+constexpr uint8_t SRAM_SPEED_READ_STEPS = 8;      // Read settle 7 .. 0 cycles
+constexpr uint8_t SRAM_SPEED_WRITE_STEPS = 4;     // Extra /WE pulse 3 .. 0 cycles
+constexpr uint8_t SRAM_SPEED_MARGIN_CYCLES = 1;   // Production reads: shortest pass + margin
+constexpr uint8_t SRAM_SPEED_READ_FIXED_CYCLES = 1;   // Address out to sample, beside the settle
+constexpr uint8_t SRAM_SPEED_WRITE_FIXED_CYCLES = 2;  // cbi/sbi of /WE, beside the pulse
+constexpr uint8_t SRAM_SPEED_SEED = 0x5A;
+constexpr uint8_t SRAM_SPEED_FAILED = 0xFF;       // Failed even at the slowest step
+
+static_assert(SRAM_SPEED_READ_STEPS > SRAM_READ_SETTLE_CYCLES, "Read sweep must start above the datasheet timing");
+static_assert(SRAM_SPEED_WRITE_STEPS > SRAM_WRITE_STROBE_CYCLES, "Write sweep must start above the datasheet timing");
+
+struct SRAMSpeedResult {
+    uint8_t readCycles;     // Shortest passing read settle (SRAM_SPEED_FAILED: none)
+    uint8_t writeCycles;    // Shortest passing extra /WE pulse (SRAM_SPEED_FAILED: none)
+    uint8_t readTrim;       // Applied to the bus
+    bool marchPassed;       // March C- at the applied trim
+    SRAMFirstFault fault;   // First failure of the step that failed (or the March)
+};
+
+/**
+ * Time in ns of cycles CPU cycles (rounded up: an upper bound)
+ */
+constexpr uint16_t sramCyclesToNs(uint8_t cycles) {
+    return (uint16_t)(((uint32_t)cycles * 1000 + F_CPU / 1000000UL - 1) / (F_CPU / 1000000UL));
+}
+
+/**
+ * Speed grade name for a read settle ("-70", ..., "-20"; "slower than -20")
+ */
+PGM_P sramSpeedGradeName(uint8_t readCycles);
+
+class SRAMSpeedGrade {
+public:
+    /**
+     * Sweep reads and writes on the selected socket(s), then choose and
+     * apply the read trim
+     *
+     * @return false if the chip fails at the slowest step or the March C-
+     *         fails at datasheet timing (trim 0 is left applied)
+     */
+    bool run(SRAMBus& bus, uint16_t size, SRAMSpeedResult& result);
+
+private:
+    static uint8_t sweepReads(SRAMBus& bus, uint16_t last, bool socketB, SRAMFirstFault& fault);
+    static uint8_t sweepWrites(SRAMBus& bus, uint16_t last, bool socketB, SRAMFirstFault& fault);
+    static bool marchPass(SRAMBus& bus, uint16_t last, SRAMFirstFault& fault);
+};
+
+#endif // SRAM_SPEED_GRADE_H
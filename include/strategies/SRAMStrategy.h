@@ -14,22 +14,69 @@
  *
  * Test Patterns (7 total):
  * 1. Basic Read/Write
- * 2. Walking Ones Address
+ * 2. Address Bus (walking ones/zeros with aliasing checks - see SRAMAddressCheck.h)
  * 3. Walking Ones Data
  * 4. Checkerboard (0x55/0xAA)
  * 5. Inverse Checkerboard (0xAA/0x55)
  * 6. Address Equals Data
  * 7. Random Pattern
+ * 8. March (table-driven: MATS+, March C-, March B - see MarchTest.h)
+ *
+ * Production screen (default TEST / runTests()): Test 8 with March C-,
+ * FULL array. 10n operations with stuck-at, transition and coupling fault
+ * coverage, less bus traffic than tests 1-7 combined.
+ *
+ * Profiles (SRAMProfiles.h): TRIAGE / PRODUCTION / QUALIFY chain fast-fail
+ * tiers (stopOnFail). estimateRunMs() predicts a run's duration from the
+ * chip size and the access times measured on the part in the socket.
+ *
+ * Soak (plan.loopCount): the plan repeats until the count or ABORT. Per-test
+ * output is muted except the first failure; a one-line summary goes out
+ * every SRAM_LOOP_REPORT_INTERVAL_MS and the statistics (SRAMSoakStats.h)
+ * at the end.
+ *
+ * Dual socket (setDualSocket(), MODE SRAM <size> DUAL): a second chip in
+ * socket B is tested alongside socket A with the same bus cycles (see
+ * SRAMBus.h). Sweeps write and check both chips at once, so a run takes
+ * about as long as for one; tests 2 and 3 probe each socket in turn. A
+ * failing chip doesn't stop the other: results, failures and diagnosis are
+ * reported per socket, and a test passes when both chips pass it. A failed
+ * pre-screen or tier ends the run only once both chips have failed it.
+ *
+ * Pre-screen: the production screen and the 1-6 / 1-7 suites run test 2
+ * first (a few ms). If it fails, the run ends there: a board with a broken
+ * address bus is rejected before the long tests start.
+ *
+ * Speed (measureSpeed(), TEST SPEED): grades the chip's access time by a
+ * cycle-by-cycle strobe sweep (SRAMSpeedGrade.h) and shortens the read
+ * settle of every later run to match, until the next setSize() or
+ * useDatasheetTiming().
  *
  * Test Modes:
- * - QUICK: Fast sampling (~1-2 seconds per test)
+ * - QUICK: Edges, address lines and every 128th cell (SRAMSampleSet.h)
  * - FULL:  Complete memory test (~5-20 seconds per test)
  *
+ * Execution: every test is a list of phases (fill, verify, March element,
+ * walking bits). A run is resumable: step() advances it by 1KB units until
+ * its time budget is used, so the main loop's Scheduler can interleave it
+ * with UART commands. The run*() methods are blocking wrappers.
+ *
  * Usage:
  *   SRAMStrategy sram;
  *   sram.setSize(32768);      // Configure for HM62256
  *   sram.configurePins();     // Set up hardware
- *   sram.runAllTests(false, false);  // Run tests 1-6, QUICK mode
+ *   sram.runAllTests(false, false);  // Run tests 1-6, QUICK mode (blocking)
+ *
+ *   SRAMRunPlan plan = SRAMStrategy::allTestsPlan(false, true);
+ *   sram.startRun(plan);             // Scheduled: scheduler.run() drives it
+ *
+ * PERF: each test's active time, bus time, UART time and chip accesses are
+ * measured with the Timer5 cycle counter (see CycleCounter.h).
+ *
+ * FULL progress goes out at most every SRAM_PROGRESS_INTERVAL_MS, and only
+ * if it fits in the UART TX ring without waiting. Skipped updates are
+ * coalesced into the next one (the next update shows the current
+ * percentage) and counted for the PERF report.
  *
  * See Strategy/03-Phase3-SRAM.md for implementation details
  */
@@ -38,9 +85,89 @@
 #define SRAM_STRATEGY_H
 
 #include "strategies/ICTestStrategy.h"
+#include "hardware/SRAMBus.h"
+#include "strategies/MarchTest.h"
+#include "strategies/SRAMAddressCheck.h"
+#include "strategies/SRAMFaultMap.h"
+#include "strategies/SRAMPatterns.h"
+#include "strategies/SRAMProfiles.h"
+#include "strategies/SRAMSampleSet.h"
+#include "strategies/SRAMSoakStats.h"
+#include "strategies/SRAMSpeedGrade.h"
 #include "utils/UARTHandler.h"
+#include "utils/Scheduler.h"
+
+constexpr uint16_t SRAM_PROGRESS_INTERVAL_MS = 250;  // Shortest time between progress updates
+constexpr uint8_t SRAM_MAX_RANDOM_PASSES = 100;      // Test 7 passes per run (2 phases each)
+constexpr uint16_t SRAM_LOOP_REPORT_INTERVAL_MS = 10000;  // Soak summary line interval
+
+/**
+ * What a run executes, in order
+ */
+struct SRAMRunPlan {
+    uint8_t tests[8];     // Test numbers (1-8)
+    uint8_t testCount;
+    bool fullTest;        // FULL or QUICK
+    uint16_t quickStride; // QUICK sampling interval (see SRAMSampleSet.h)
+    bool fused;           // Tests 1/4/5 from one fused sweep
+    bool mapFaults;       // Continue on error, fault map report at the end
+    bool summary;         // "All tests PASSED" / SUMMARY record at the end
+    uint32_t randomSeed;  // Test 7 seed of pass 1 (0 = new seed every run)
+    uint8_t randomPasses; // Test 7 passes, each with the next seed (1-SRAM_MAX_RANDOM_PASSES)
+    bool prescreen;       // Test 2 first, a failure ends the run
+    bool stopOnFail;      // Tiers: the first failing test ends the run
+    uint32_t loopCount;   // Soak iterations (0 = run once, SRAM_LOOP_FOREVER = until ABORT)
+};
+
+/**
+ * Access times measured on the part in the socket (see estimateRunMs())
+ */
+struct SRAMAccessTiming {
+    uint16_t burstNs;     // Per access in a fill/verify burst
+    uint16_t cellNs;      // Per operation in a per-cell sweep (March elements)
+    uint16_t singleNs;    // Per single-byte access (tests 2/3, QUICK strided cells)
+};
 
-class SRAMStrategy : public ICTestStrategy {
+/**
+ * PERF figures from the last completed run of one test
+ */
+struct SRAMTestPerf {
+    uint32_t cycles;      // Active time (pauses and main loop work excluded)
+    uint32_t busCycles;   // Inside bus bursts
+    uint32_t uartCycles;  // Inside UART send calls
+    uint32_t accesses;    // Chip read/write cycles
+    uint16_t runs;        // Completed runs since PERF RESET
+};
+
+constexpr uint8_t PERF_FUSED_SLOT = 0;  // Fused 1/4/5 sweep
+constexpr uint8_t PERF_SLOTS = 9;       // [1..8] = tests 1-8
+constexpr uint8_t PERF_NO_SLOT = 0xFF;  // Tests 4/5 of a fused run (work done by slot 0)
+
+/**
+ * One step of a test (see SRAMStrategy::loadPhase())
+ */
+enum SRAMPhaseKind : uint8_t {
+    PHASE_FILL,           // Write pattern to the tested address set
+    PHASE_VERIFY,         // Read back and compare against pattern
+    PHASE_MARCH,          // One March element (value = element index)
+    PHASE_WALK_ADDRESS,   // Address bus diagnosis (single unit)
+    PHASE_WALK_DATA       // Walking ones on data lines (single unit)
+};
+
+enum SRAMPatternKind : uint8_t {
+    PATTERN_CONSTANT,     // value at every address
+    PATTERN_ADDRESS,      // Low byte of address
+    PATTERN_RANDOM        // Sequence from seed = value
+};
+
+struct SRAMPhase {
+    uint8_t kind;         // SRAMPhaseKind
+    uint8_t pattern;      // SRAMPatternKind (fill/verify)
+    uint16_t value;       // Constant, seed, or March element index
+    const char* label;    // Progress label (PROGMEM in the tables, nullptr = no progress)
+};
+
+class SRAMStrategy : public ICTestStrategy, public SchedulerTask {
 public:
     /**
      * Constructor
@@ -69,27 +196,59 @@ public:
      */
     uint16_t getSize() const;
 
+    /**
+     * Test socket B alongside socket A (dual-socket fixture)
+     *
+     * Call configurePins() afterwards. Not while a run is active.
+     *
+     * @return false if a run is active
+     */
+    bool setDualSocket(bool dual);
+    bool isDualSocket() const;
+
+    /**
+     * Bus engine of the configured chip, for DUMP/CRC (SRAMDump)
+     *
+     * Not while a run is active: the run owns the bus.
+     */
+    SRAMBus& getBus();
+
+    /**
+     * TEST SPEED: sweep the strobes, report the grade and apply the
+     * shortest safe read timing (blocking, 1-2 s). Not while a run is active.
+     *
+     * @return false if the chip fails at every step, or a March C- at
+     *         datasheet timing (which is then left in use)
+     */
+    bool measureSpeed();
+
+    /**
+     * Back to the datasheet read timing (TEST SPEED OFF)
+     */
+    void useDatasheetTiming();
+
     // ICTestStrategy interface implementation
     void configurePins() override;
     void reset() override;
-    bool runTests() override;  // Default: runs tests 1-6, QUICK mode
-    const char* getName() const override;
+    bool runTests() override;  // Default: production screen (March C-, FULL)
+    const __FlashStringHelper* getName() const override;
 
     /**
      * Run specific test by number
      *
-     * @param testNumber Test to run (1-7)
+     * @param testNumber Test to run (1-8)
      * @param fullTest true for FULL mode, false for QUICK mode
      * @return true if test passed, false if failed
      *
      * Test Numbers:
      *   1 = Basic Read/Write
-     *   2 = Walking Ones Address
+     *   2 = Address Bus
      *   3 = Walking Ones Data
      *   4 = Checkerboard
      *   5 = Inverse Checkerboard
      *   6 = Address Equals Data
      *   7 = Random Pattern
+     *   8 = March (last selected algorithm, see runMarch())
      *
      * Example:
      *   sram.runTest(2, false);  // Run test 2, QUICK mode
@@ -102,15 +261,201 @@ public:
      *
      * @param includeRandom true to include test 7 (random), false for tests 1-6 only
      * @param fullTest true for FULL mode, false for QUICK mode
+     * @param fused true to get tests 1, 4 and 5 from one fused sweep
+     *              (4 traversals instead of 10, same per-test output)
      * @return true if all tests passed, false if any failed
      *
      * Example:
-     *   sram.runAllTests(false, false);  // Tests 1-6, QUICK (default)
-     *   sram.runAllTests(false, true);   // Tests 1-6, FULL
-     *   sram.runAllTests(true, false);   // Tests 1-7, QUICK
-     *   sram.runAllTests(true, true);    // Tests 1-7, FULL
+     *   sram.runAllTests(false, false);        // Tests 1-6, QUICK
+     *   sram.runAllTests(false, true);         // Tests 1-6, FULL
+     *   sram.runAllTests(true, false);         // Tests 1-7, QUICK
+     *   sram.runAllTests(true, true);          // Tests 1-7, FULL
+     *   sram.runAllTests(false, true, true);   // Tests 1-6, FULL, fused
+     */
+    bool runAllTests(bool includeRandom, bool fullTest, bool fused = false);
+
+    /**
+     * Run a March algorithm as test 8
+     *
+     * @param algorithm Index into MARCH_ALGORITHMS (see findMarchAlgorithm())
+     * @param fullTest true for the whole array, false for QUICK sampling
+     * @return true if test passed, false if failed
+     *
+     * Example:
+     *   sram.runMarch(findMarchAlgorithm("B"), true);  // March B, FULL
+     */
+    bool runMarch(uint8_t algorithm, bool fullTest);
+
+    /**
+     * Run test 7 with a given seed and number of passes
+     *
+     * Pass 1 uses seed, every further pass SRAMRandomPattern::nextSeed() of
+     * the one before. Each pass reports its seed, so a failing pass can be
+     * repeated alone with that seed.
+     *
+     * @param seed Seed of pass 1 (0 = new seed)
+     * @param passes 1-SRAM_MAX_RANDOM_PASSES
+     * @return true if all passes passed
+     *
+     * Example:
+     *   sram.runRandom(0x1D2C3B4A, 4, true);   // 4 FULL passes
+     */
+    bool runRandom(uint32_t seed, uint8_t passes, bool fullTest);
+
+    /**
+     * Seed of pass 1 of the last run started (test 7)
+     */
+    uint32_t getRandomSeed() const;
+
+    /**
+     * Run the production screen (March C-, FULL) with summary line
+     *
+     * @return true if passed, false if failed
+     */
+    bool runProductionScreen();
+
+    /**
+     * Plan for tests 1-6 (or 1-7), as run by runAllTests() (with pre-screen)
+     */
+    static SRAMRunPlan allTestsPlan(bool includeRandom, bool fullTest, bool fused = false);
+
+    /**
+     * Plan for a single test
      */
-    bool runAllTests(bool includeRandom, bool fullTest);
+    static SRAMRunPlan singleTestPlan(uint8_t testNumber, bool fullTest);
+
+    /**
+     * Plan for a profile (index into SRAM_PROFILES); the caller selects
+     * the profile's marchAlgorithm (readSRAMProfile()) before starting it
+     */
+    static SRAMRunPlan profilePlan(uint8_t profile);
+
+    /**
+     * Predicted duration of a plan, in ms
+     *
+     * Access counts per test (sweeps x cells, March ops per cell, test 2/3
+     * single accesses) times the measured access times. Never touches the
+     * chip: call measureAccessTiming() first (hasAccessTiming()).
+     *
+     * @param algorithm March algorithm test 8 would run
+     * @return 0 if no size is configured or the times are not measured
+     *
+     * Example:
+     *   sram.measureAccessTiming();
+     *   sram.estimateRunMs(SRAMStrategy::profilePlan(1), MARCH_DEFAULT_ALGORITHM);
+     */
+    uint32_t estimateRunMs(const SRAMRunPlan& plan, uint8_t algorithm);
+
+    /**
+     * Measure the access times estimateRunMs() uses, unless they are already
+     * measured for this size and bus setup (about 2 ms, cells 0-511
+     * overwritten). For a run about to start; not while one is active.
+     */
+    void measureAccessTiming();
+    bool hasAccessTiming() const { return timingSize == sramSize && sramSize != 0; }
+
+    /**
+     * Access times used by estimateRunMs() (valid if hasAccessTiming())
+     */
+    const SRAMAccessTiming& getAccessTiming() const { return timing; }
+
+    /**
+     * Select the algorithm test 8 runs
+     *
+     * @return false if algorithm is out of range
+     */
+    bool setMarchAlgorithm(uint8_t algorithm);
+
+    /**
+     * QUICK sampling of the last run (stride and cells per pass)
+     */
+    uint16_t getQuickStride() const;
+    uint32_t getQuickCellCount() const;
+
+    /**
+     * Start a resumable run (returns immediately)
+     *
+     * @return false if a run is already active, size not configured,
+     *         the plan is empty, plan.quickStride is out of range, or the
+     *         plan maps faults in dual-socket mode
+     *
+     * Example:
+     *   SRAMRunPlan plan = SRAMStrategy::allTestsPlan(true, true);
+     *   plan.mapFaults = true;
+     *   sram.startRun(plan);
+     */
+    bool startRun(const SRAMRunPlan& plan);
+
+    /**
+     * Advance the active run (SchedulerTask)
+     *
+     * Works in 1KB units until budgetUs has elapsed; progress and result
+     * lines are sent as the run reaches them.
+     *
+     * @return true while the run is active (including paused)
+     */
+    bool step(uint16_t budgetUs) override;
+
+    /**
+     * Run a plan to completion (blocking)
+     *
+     * ABORT and STATUS are still answered between units.
+     *
+     * @return true if every test in the plan passed
+     */
+    bool runPlan(const SRAMRunPlan& plan);
+
+    /**
+     * Run control for the active run
+     */
+    bool isRunning() const;
+    bool isPaused() const;
+    void pause();
+    void resume();
+    void abortRun();      // Ends the run at the next unit, current test ABORTED
+
+    /**
+     * Send current test and progress ("STATUS: Test 4 (...) running, 37%"),
+     * plus the soak line during a soak
+     */
+    void sendRunStatus();
+
+    /**
+     * Statistics of the current or last soak run
+     */
+    const SRAMSoakStats& getSoakStats() const;
+
+    /**
+     * Check if the last run was stopped by an ABORT command
+     *
+     * ABORT ends the run at the next unit, STATUS is answered with the
+     * current test and progress.
+     */
+    bool wasAborted() const;
+
+    /**
+     * Check if every test of the last finished run passed (false after an
+     * ABORT, and before the first run)
+     */
+    bool didLastRunPass() const;
+
+    /**
+     * PERF instrumentation
+     *
+     * sendPerfReport() lists every test run since resetPerf(). With attach
+     * on, each test result is followed by its own PERF line (or records).
+     */
+    void sendPerfReport();
+    void resetPerf();
+    void setPerfAttach(bool attach);
+    bool getPerfAttach() const;
+    const SRAMTestPerf& getTestPerf(uint8_t slot) const;
+
+    /**
+     * Progress updates sent / coalesced since resetPerf()
+     */
+    uint32_t getProgressSent() const;
+    uint32_t getProgressCoalesced() const;
 
     /**
      * Set UART handler for progress updates
@@ -127,29 +472,138 @@ private:
     uint16_t maxAddress;    // Maximum valid address (sramSize - 1)
     uint8_t addressBits;    // Number of address lines (13 for 8KB, 15 for 32KB)
     UARTHandler* uart;      // Optional UART handler for progress updates
+    SRAMBus bus;            // Block/burst access engine
+    SRAMSampleSet samples;  // QUICK mode address runs (rebuilt on size/stride change)
+    uint8_t marchAlgorithm; // Algorithm used by test 8 (index into MARCH_ALGORITHMS)
+    uint8_t currentTest;    // Test being run (for binary progress records)
+    uint32_t testStartMs;   // millis() at sendTestStart (for binary timing)
+
+    // TEST ... MAP: every mismatch goes into faultMap
+    bool mapFaults;
+    SRAMFaultMap faultMap;
+    uint32_t mapFailuresAtStart;  // Total at sendTestStart (per-test result)
+
+    // Active run (see startRun()/step())
+    SRAMRunPlan plan;
+    bool running;
+    bool paused;
+    bool abortRequested;
+    bool lastRunPassed;
+    uint8_t planIndex;            // Current entry in plan.tests
+    uint8_t testsFailed;
+    uint32_t runStartMs;
+    uint8_t testsSkipped;         // Tests not run after a failed pre-screen or tier
+    bool testStarted;             // sendTestStart sent for plan.tests[planIndex]
+    SRAMFirstFault testFaults[2]; // First mismatch of the current test per socket (fail-fast)
+    uint8_t faultsSent;           // Sockets whose failure line is out (bit 0 = A)
+    uint8_t testSocketsFailed;    // Sockets that failed the test just ended
+
+    // Dual socket: socket B is tested with A; currentSocket (0 = A, 1 = B)
+    // labels the result, failure and diagnosis lines being sent
+    bool dualSocket;
+    uint8_t currentSocket;
+    uint8_t socketTestsFailed[2];
 
-    // Low-level hardware access
-    void setAddress(uint16_t addr);
-    void writeByte(uint16_t addr, uint8_t data);
-    uint8_t readByte(uint16_t addr);
+    // Soak run (plan.loopCount != 0)
+    SRAMSoakStats soak;
+    bool soakFailureShown;        // First failure sent, later ones only counted
+    uint32_t lastSoakReportMs;
 
-    // Test implementations
-    bool testBasicReadWrite(bool fullTest);
-    bool testWalkingOnesAddress(bool fullTest);
-    bool testWalkingOnesData(bool fullTest);
-    bool testCheckerboard(bool fullTest);
-    bool testInverseCheckerboard(bool fullTest);
-    bool testAddressEqualsData(bool fullTest);
-    bool testRandomPattern(bool fullTest);
+    // Current phase of the current test
+    uint8_t phaseIndex;
+    bool phaseLoaded;
+    SRAMPhase phase;
+    uint16_t cursor;              // Addresses done in this phase
+    char phaseLabel[24];          // Label of the current phase (copied from flash or built)
+    SRAMCellOp marchOps[MARCH_MAX_OPS];
+    uint8_t marchOpCount;
+    bool marchDescending;
+    SRAMRandomPattern randomPattern;
+    uint32_t randomSeed;          // Pass 1 seed of this run (plan seed, or picked at start)
+
+    // Fused tests 1/4/5 (see MARCH_FUSED_PATTERNS)
+    SRAMFirstFault fusedFaults[6];  // Basic R/W, Checkerboard, Inverse Checkerboard; socket B's after A's
+
+    // PERF: figures per test, the test being measured, and the marks the
+    // current advance() started from
+    SRAMTestPerf testPerf[PERF_SLOTS];
+    SRAMTestPerf perfCurrent;
+    uint32_t perfMark;
+    uint32_t perfTxMark;
+    uint32_t perfAccessStart;
+    bool perfAttach;
+
+    // Run-time estimates (measured for timingSize)
+    SRAMAccessTiming timing;
+    uint16_t timingSize;
+
+    // Progress throttle
+    uint32_t lastProgressMs;
+    uint32_t progressSent;
+    uint32_t progressCoalesced;
+
+    // Size of one resumable unit, and sweep size between progress updates
+    static constexpr uint16_t STEP_CHUNK = 0x0400;
+    static constexpr uint16_t PASS_CHUNK = 0x1000;
+    static constexpr uint16_t RUN_SLICE_US = 10000;  // Blocking wrappers
+
+    // Run engine
+    void advance();
+    bool loadPhase(uint8_t testNumber, uint8_t index, SRAMPhase& out);
+    void beginPhase();
+    bool runUnit();
+    bool runWalkAddress();
+    bool runWalkData();
+    bool isFusedTest(uint8_t testNumber) const;
+    uint8_t socketCount() const;
+    void applyPrescreen();
+    void beginTest(uint8_t testNumber);
+    bool endTest(uint8_t testNumber);
+    bool reportSocket(uint8_t testNumber, uint8_t socket);
+    void nextTest(bool passed);
+    void finishRun();
+    void beginIteration();
+    void checkpoint();
+
+    // Pattern unit over [first, last]: FULL = one burst, QUICK = sampled runs
+    template <typename Pattern>
+    bool patternUnit(Pattern& pattern, bool write, uint16_t first, uint16_t last,
+                     SRAMFaultSink& sink);
+    bool marchUnit(uint16_t first, uint16_t last, SRAMFaultSink& sink);
 
     // Helper functions
-    bool shouldTestAddress(uint16_t addr, bool fullTest);
-    const char* getTestName(uint8_t testNumber);
-    void sendProgress(const char* message);
+    PGM_P getTestName(uint8_t testNumber);  // Name in flash (print with %S)
     void sendProgress(const char* message, uint16_t current, uint16_t total);
     void sendTestStart(uint8_t testNumber, bool fullTest);
     void sendTestResult(uint8_t testNumber, bool passed);
     void sendTestError(uint8_t testNumber, uint16_t addr, uint8_t expected, uint8_t actual);
+    void sendNewFaults(uint8_t testNumber);
+    void sendSocketSummary();
+    uint8_t socketId() const;     // Binary socket field: 0 = single socket, else SRAM_SOCKET_*
+    PGM_P socketSuffix() const;   // ", socket B" (result lines), "" with one socket
+    PGM_P socketPrefix() const;   // "Socket B: " (diagnosis lines), "" with one socket
+    void sendRandomSeed(uint8_t pass, uint32_t seed);
+    void sendAddressDiagnosis(const SRAMAddressCheck& check);
+    uint32_t randomPassSeed(uint8_t pass) const;
+    void sendTestAborted(uint8_t testNumber);
+    void sendSummary(bool allPassed, uint8_t testsRun, uint8_t testsFailed, uint32_t startMs);
+    bool reportFusedTest(uint8_t testNumber, const SRAMFirstFault& fault);
+    bool finishTest(uint8_t testNumber);
+    void sendFaultMapReport();
+    bool soakMuted(bool failure) const;
+    bool sendSoakLine(bool tryOnly);
+    void sendSoakReport();
+
+    // Run-time estimates
+    float marchNs(const MarchAlgorithm& algorithm, bool fullTest, uint32_t burstCells, uint32_t singleCells);
+
+    // PERF helpers
+    uint32_t txCycles() const;
+    uint8_t perfSlot(uint8_t testNumber) const;
+    void perfStart();
+    void perfCollect();
+    void commitTestPerf(uint8_t testNumber);
+    void sendTestPerf(uint8_t slot);
 };
 
 #endif // SRAM_STRATEGY_H
@@ -0,0 +1,135 @@
+/**
+ * Z80Strategy.h
+ *
+ * Z80 CPU testing strategy (40-pin DIP, NMOS or CMOS)
+ *
+ * The Mega plays the Z80's memory through Z80Bus: test programs are
+ * PROGMEM ROM images, the Z80 runs them from the Timer3 clock, and every
+ * memory cycle is served in real time (see hardware/Z80Bus.h).
+ *
+ * Tests (5 total):
+ * 1. Control Signals   - /MREQ, /IORQ, /RD, /WR, /M1, /RFSH, /HALT idle in reset
+ * 2. Clock Generation  - Timer3 clock toggling on PE3
+ * 3. JP Loop           - C3 00 00: fetch sequence 0000→0001→0002, /M1 per loop
+ * 4. Memory Write      - LD (1000h),A / LD (1001h),A then HALT
+ * 5. Memory Read       - Z80 reads 1000h/1001h back, XOR written to the stop port
+ *
+ * TEST IMAGE runs the uploaded program (LOAD, utils/ProgramImage.h) as
+ * test 6, mapped as ROM pages of the MemoryMap (with any MAP RAM/FAULT
+ * pages): it passes by writing 00h to the stop port or by HALT, without
+ * touching a FAULT page.
+ *
+ * Test clock: Z80_TEST_CLOCK_HZ, or the CLOCK command's frequency if the
+ * clock is already running. /WAIT is only used above the no-wait limit.
+ *
+ * TEST FMAX sweeps the clock with a fixed benchmark program, with and
+ * without /WAIT, and reports the highest frequency with zero missed cycles
+ * (same result, read, fetch and write counts as a 50 kHz reference run).
+ *
+ * Usage:
+ *   Z80Strategy z80;
+ *   z80.setClock(&timer3);
+ *   z80.setUARTHandler(&uart);
+ *   z80.configurePins();
+ *   z80.runTests();           // Tests 1-5
+ *   z80.measureFmax();        // TEST FMAX
+ *   z80.setMemoryMap(&map);
+ *   z80.setImage(image.getData(), image.getBase(), image.getLength());
+ *   z80.runTest(Z80_IMAGE_TEST);
+ *
+ * See Strategy/04-Phase4-Z80.md for implementation details
+ */
+
+#ifndef Z80_STRATEGY_H
+#define Z80_STRATEGY_H
+
+#include "strategies/ICTestStrategy.h"
+#include "hardware/Z80Bus.h"
+#include "hardware/Timer3.h"
+#include "utils/UARTHandler.h"
+
+constexpr uint32_t Z80_TEST_CLOCK_HZ = 500000;       // Tests 1-5
+constexpr uint32_t Z80_FMAX_REFERENCE_HZ = 50000;    // TEST FMAX reference run
+constexpr uint16_t Z80_RUN_TIMEOUT_MS = 250;         // One program run (interrupts off)
+constexpr uint8_t Z80_TEST_COUNT = 5;
+constexpr uint8_t Z80_IMAGE_TEST = Z80_TEST_COUNT + 1;  // TEST IMAGE (not in runTests())
+
+class Z80Strategy : public ICTestStrategy {
+public:
+    Z80Strategy();
+
+    // ICTestStrategy interface implementation
+    void configurePins() override;
+    void reset() override;
+    bool runTests() override;  // Tests 1-5
+    const __FlashStringHelper* getName() const override;
+
+    /**
+     * Run one test (1-5, or Z80_IMAGE_TEST)
+     *
+     * @return true if passed
+     */
+    bool runTest(uint8_t testNumber);
+
+    /**
+     * Sweep Timer3 and report the highest clock with zero missed bus
+     * cycles, without and with /WAIT. The no-wait result becomes the
+     * threshold Z80_WAIT_AUTO uses from then on.
+     *
+     * @return false if the reference run already failed (no CPU / wiring)
+     */
+    bool measureFmax();
+
+    /**
+     * Clock generator shared with the CLOCK command (required)
+     */
+    void setClock(Timer3Clock* timer);
+
+    /**
+     * Set UART handler for results (optional)
+     */
+    void setUARTHandler(UARTHandler* handler);
+
+    /**
+     * Bus trace for the program runs (optional, TRACE command)
+     */
+    void setTrace(BusTrace* trace);
+
+    /**
+     * Uploaded program for Z80_IMAGE_TEST (RAM, kept by the caller)
+     */
+    void setImage(const uint8_t* data, uint16_t base, uint16_t size);
+
+    /**
+     * Pages Z80_IMAGE_TEST runs in (required for it; the image is mapped
+     * in as ROM, MAP RAM/FAULT pages are kept)
+     */
+    void setMemoryMap(MemoryMap* memory);
+
+private:
+    Z80Bus bus;
+    Timer3Clock* clock;
+    UARTHandler* uart;
+    uint32_t clockHz;       // Frequency tests 2-5 run at
+    const uint8_t* image;   // Z80_IMAGE_TEST program
+    uint16_t imageBase;
+    uint16_t imageSize;
+    MemoryMap* map;         // Z80_IMAGE_TEST pages
+
+    // Test implementations
+    bool testControlSignals();
+    bool testClock();
+    bool testJpLoop();
+    bool testMemoryWrite();
+    bool testMemoryRead();
+    bool testImage();
+
+    // Helpers
+    void startClock(uint32_t frequency);
+    Z80RunResult runProgram(const uint8_t* program, uint16_t size, uint32_t readLimit = 0);
+    static bool sameRun(const Z80RunResult& a, const Z80RunResult& b);
+    PGM_P getTestName(uint8_t testNumber);  // Name in flash (print with %S)
+    void sendRunEnd(const Z80RunResult& result);
+};
+
+#endif // Z80_STRATEGY_H
@@ -0,0 +1,157 @@
+/**
+ * BinaryProtocol.h
+ *
+ * Fixed-size binary records for PROTO BIN mode
+ *
+ * Every record is BIN_FRAME_SIZE (12) bytes:
+ *
+ *   [0]     BIN_SYNC (0xA5)
+ *   [1]     Record type (BIN_REC_*)
+ *   [2..9]  Payload (8 bytes, little-endian fields, unused bytes 0)
+ *   [10..11] CRC-16/CCITT-FALSE over bytes 1..9, little-endian
+ *
+ * Text lines (OK:/ERROR:/info) never contain 0xA5, so a host can read
+ * both from one stream: a 0xA5 byte starts a frame, anything else is text.
+ *
+ * Record payloads:
+ *   TEST_START  test, fullTest, chipSize(2)
+ *   TEST_END    test, result (0 fail, 1 pass, 2 aborted), elapsedMs(4), socket
+ *   FAILURE     test, address(2), expected, actual, socket
+ *               (socket: 0 = single socket, else SRAM_SOCKET_A / SRAM_SOCKET_B)
+ *   PROGRESS    test, percent, current(2), total(2)
+ *   SUMMARY     passed, testsRun, testsFailed, aborted, elapsedMs(4)
+ *   MAP_TOTAL   failures(4), unmapped(4)
+ *   MAP_BIT     bit, readLow(2), readHigh(2)
+ *   MAP_RANGE   first(2), last(2), failures(2)
+ *   PERF        slot (0 = fused 1/4/5, 1-8 = test), bus%, UART%, runs, cycles(4)
+ *   PERF_ACCESSES slot, 0, 0, 0, accesses(4)
+ *   TRACE_INFO  blocks, heldTest, bytes(2), cycles(4)
+ *   TRACE_DATA  offset(2), 6 trace bytes (see hardware/BusTrace.h)
+ *   SEED        test, pass, seed(4)
+ *   ADDRESS     stuck(2), shorted(2), unpaired(2), lines, dataFault
+ *               (line masks, bit n = An, see strategies/SRAMAddressCheck.h)
+ *   LOOP        iterations(4), failedIterations(4)
+ *   LOOP_TEST   test, stat (BIN_LOOP_*), 0, 0, value(4)
+ *   DUMP_DATA   address(2), 6 SRAM bytes (last record zero-padded)
+ *   CRC         first(2), length(2), crc(4) (CRC-32, or CRC-16 in the low half)
+ *   LOAD_ACK    next(2), status (BIN_LOAD_*), window, 0, 0, 0, 0
+ *   HEALTH      stat (BIN_HEALTH_*), command (CommandType, COMMAND_* stats), 0, 0, value(4)
+ *   (fault map detail records reuse FAILURE)
+ *
+ * Host to board (same framing, see UARTHandler::readRecord()):
+ *   LOAD_DATA   offset(2), 6 image bytes (last record zero-padded)
+ *
+ * Usage:
+ *   BinaryRecord record(BIN_REC_FAILURE);
+ *   record.put8(testNumber).put16(address).put8(expected).put8(actual);
+ *   uart.sendRecord(record);
+ *
+ * See Strategy/01-Phase1-Foundation.md section 11 for the host side
+ */
+
+#ifndef BINARY_PROTOCOL_H
+#define BINARY_PROTOCOL_H
+
+#include <Arduino.h>
+
+constexpr uint8_t BIN_SYNC = 0xA5;
+constexpr uint8_t BIN_PAYLOAD_SIZE = 8;
+constexpr uint8_t BIN_FRAME_SIZE = 2 + BIN_PAYLOAD_SIZE + 2;
+
+// Record types
+constexpr uint8_t BIN_REC_TEST_START = 0x01;
+constexpr uint8_t BIN_REC_TEST_END   = 0x02;
+constexpr uint8_t BIN_REC_FAILURE    = 0x03;
+constexpr uint8_t BIN_REC_PROGRESS   = 0x04;
+constexpr uint8_t BIN_REC_SUMMARY    = 0x05;
+constexpr uint8_t BIN_REC_MAP_TOTAL  = 0x06;
+constexpr uint8_t BIN_REC_MAP_BIT    = 0x07;
+constexpr uint8_t BIN_REC_MAP_RANGE  = 0x08;
+constexpr uint8_t BIN_REC_PERF       = 0x09;
+constexpr uint8_t BIN_REC_PERF_ACCESSES = 0x0A;
+constexpr uint8_t BIN_REC_TRACE_INFO = 0x0B;
+constexpr uint8_t BIN_REC_TRACE_DATA = 0x0C;
+constexpr uint8_t BIN_REC_SEED       = 0x0D;
+constexpr uint8_t BIN_REC_ADDRESS    = 0x0E;
+constexpr uint8_t BIN_REC_LOOP       = 0x0F;
+constexpr uint8_t BIN_REC_LOOP_TEST  = 0x10;
+constexpr uint8_t BIN_REC_DUMP_DATA  = 0x11;
+constexpr uint8_t BIN_REC_CRC        = 0x12;
+constexpr uint8_t BIN_REC_LOAD_DATA  = 0x13;   // Host to board
+constexpr uint8_t BIN_REC_LOAD_ACK   = 0x14;
+constexpr uint8_t BIN_REC_HEALTH     = 0x15;
+
+// Trace bytes per TRACE_DATA record (after the 2-byte offset)
+constexpr uint8_t BIN_TRACE_CHUNK = BIN_PAYLOAD_SIZE - 2;
+
+// SRAM bytes per DUMP_DATA record (after the 2-byte address)
+constexpr uint8_t BIN_DUMP_CHUNK = BIN_PAYLOAD_SIZE - 2;
+
+// Image bytes per LOAD_DATA record (after the 2-byte offset)
+constexpr uint8_t BIN_LOAD_CHUNK = BIN_PAYLOAD_SIZE - 2;
+
+// LOAD_ACK status values
+constexpr uint8_t BIN_LOAD_CONTINUE = 0;   // Stored up to next, keep sending
+constexpr uint8_t BIN_LOAD_RESEND   = 1;   // Gap or silence: send again from next
+constexpr uint8_t BIN_LOAD_DONE     = 2;   // All bytes stored (CRC record follows)
+constexpr uint8_t BIN_LOAD_FAILED   = 3;   // Transfer given up
+
+// TEST_END result value for a test stopped by ABORT
+constexpr uint8_t BIN_TEST_ABORTED = 2;
+
+// LOOP_TEST stat values (times in microseconds)
+constexpr uint8_t BIN_LOOP_RUNS     = 0;
+constexpr uint8_t BIN_LOOP_FAILURES = 1;
+constexpr uint8_t BIN_LOOP_MIN_US   = 2;
+constexpr uint8_t BIN_LOOP_MAX_US   = 3;
+constexpr uint8_t BIN_LOOP_MEAN_US  = 4;
+
+// HEALTH stat values (STATUS in BIN mode; times in microseconds)
+constexpr uint8_t BIN_HEALTH_FREE_RAM        = 0;
+constexpr uint8_t BIN_HEALTH_STACK_UNUSED    = 1;   // Free RAM at the stack high-water mark
+constexpr uint8_t BIN_HEALTH_HEAP            = 2;
+constexpr uint8_t BIN_HEALTH_LOOPS           = 3;
+constexpr uint8_t BIN_HEALTH_LOOP_MAX_US     = 4;
+constexpr uint8_t BIN_HEALTH_LOOP_MEAN_US    = 5;
+constexpr uint8_t BIN_HEALTH_RX_OVERRUNS     = 6;
+constexpr uint8_t BIN_HEALTH_DROPPED_LINES   = 7;
+constexpr uint8_t BIN_HEALTH_BAD_FRAMES      = 8;
+constexpr uint8_t BIN_HEALTH_COMMAND_COUNT   = 9;   // One each per command type handled
+constexpr uint8_t BIN_HEALTH_COMMAND_MEAN_US = 10;
+constexpr uint8_t BIN_HEALTH_COMMAND_MAX_US  = 11;
+
+/**
+ * Record builder: type plus payload fields written in order
+ */
+class BinaryRecord {
+public:
+    explicit BinaryRecord(uint8_t type) : type(type), length(0) {
+        memset(payload, 0, sizeof(payload));
+    }
+
+    BinaryRecord& put8(uint8_t value) {
+        if (length < BIN_PAYLOAD_SIZE) {
+            payload[length++] = value;
+        }
+        return *this;
+    }
+
+    BinaryRecord& put16(uint16_t value) {
+        return put8((uint8_t)value).put8((uint8_t)(value >> 8));
+    }
+
+    BinaryRecord& put32(uint32_t value) {
+        return put16((uint16_t)value).put16((uint16_t)(value >> 16));
+    }
+
+    // Received records: little-endian field at a payload offset
+    uint16_t get16(uint8_t offset) const {
+        return payload[offset] | ((uint16_t)payload[offset + 1] << 8);
+    }
+
+    uint8_t type;
+    uint8_t length;
+    uint8_t payload[BIN_PAYLOAD_SIZE];
+};
+
+#endif // BINARY_PROTOCOL_H
@@ -0,0 +1,74 @@
+/**
+ * CRC.h
+ *
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection)
+ * CRC-32 (IEEE 802.3 / zlib: reflected poly 0xEDB88320, init and final
+ * XOR 0xFFFFFFFF)
+ *
+ * CRC-16 protects binary protocol records and the stored plan; CRC-32 is
+ * for SRAM contents (CRC / DUMP commands), where a 32 KB image wants
+ * more than 16 bits and hosts have it built in (zlib.crc32, binascii).
+ * Bitwise implementation: no lookup table in flash or RAM.
+ *
+ * Usage:
+ *   uint16_t crc = crc16(buffer, length);
+ *
+ *   uint16_t running = CRC16_INIT;
+ *   running = crc16Update(running, nextByte);
+ *
+ *   uint32_t image = CRC32_INIT;
+ *   image = crc32Update(image, nextByte);
+ *   image = crc32Final(image);           // Same value as zlib.crc32()
+ */
+
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+
+constexpr uint16_t CRC16_INIT = 0xFFFF;
+
+/**
+ * Feed one byte into a running CRC
+ */
+inline uint16_t crc16Update(uint16_t crc, uint8_t data) {
+    crc ^= (uint16_t)data << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * CRC of a buffer
+ *
+ * @param crc Starting value (CRC16_INIT, or a previous result to continue)
+ */
+inline uint16_t crc16(const uint8_t* data, uint16_t length, uint16_t crc = CRC16_INIT) {
+    for (uint16_t i = 0; i < length; i++) {
+        crc = crc16Update(crc, data[i]);
+    }
+    return crc;
+}
+
+constexpr uint32_t CRC32_INIT = 0xFFFFFFFF;
+
+/**
+ * Feed one byte into a running CRC-32 (start from CRC32_INIT)
+ */
+inline uint32_t crc32Update(uint32_t crc, uint8_t data) {
+    crc ^= data;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320UL : (crc >> 1);
+    }
+    return crc;
+}
+
+/**
+ * Final XOR: running value to CRC-32 result
+ */
+inline uint32_t crc32Final(uint32_t crc) {
+    return ~crc;
+}
+
+#endif // CRC_H
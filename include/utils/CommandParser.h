@@ -6,16 +6,51 @@
  * Supported commands:
  * - MODE <IC>    Select IC type (Z80, 6502, 62256)
  * - TEST         Run tests for selected IC
- * - STATUS       Show current configuration
+ * - STATUS       Show configuration and health (STATUS RESET clears the figures)
  * - RESET        Reset the selected IC
  * - HELP         Show help message
+ * - PROTO        Select TEXT/BIN output protocol and baud rate
+ * - ABORT        Stop the running test
+ * - PAUSE        Pause the running test at the next checkpoint
+ * - RESUME       Continue a paused test
+ * - PERF         Show per-test timing (PERF RESET|ON|OFF)
+ * - TRACE        Bus-cycle trace (TRACE ON|OFF|CLEAR|DUMP|LIST [n])
+ * - PLAN         Stored test plan (PLAN ADD|CLEAR|REPEAT|STOP|RESET)
+ * - RUN          Run the stored plan on one DUT
+ * - DUMP         Stream SRAM bytes in binary frames (DUMP [<start> <len>])
+ * - CRC          On-board CRC-32/16 of an SRAM range (CRC [<start> <len>] [16])
+ * - LOAD         Upload a CPU test program (LOAD <addr> <len>|SAVE|CLEAR)
+ * - MAP          CPU memory pages for TEST IMAGE (MAP RAM|FAULT|OPEN <addr> <len>|CLEAR)
+ *
+ * The line is split in place (no copies, no heap): the command word is
+ * terminated and parameter points at the rest of the same buffer.
+ * Command words are looked up in a keyword table in flash, indexed like
+ * CommandType; handlers use the same tokenizer and findKeyword() for their
+ * own sub-option tables, and parseNumber() for numeric arguments (a whole
+ * word or nothing: "1x" is not 1).
+ *
+ * A line may hold several commands separated by ';'
+ * ("MODE SRAM 32768; TEST MARCH CMINUS; CRC 0 32768"): nextCommand()
+ * cuts it into one command at a time, in place. main.cpp runs them in
+ * order (see Strategy/01-Phase1-Foundation.md section 15).
  *
  * Usage:
  *   CommandParser parser;
- *   ParsedCommand cmd = parser.parse("MODE Z80");
+ *   char line[] = "MODE Z80";
+ *   ParsedCommand cmd = parser.parse(line);
  *   if (cmd.type == MODE) {
- *       // Handle MODE command with cmd.parameter
+ *       // Handle MODE command with cmd.parameter ("Z80")
  *   }
+ *
+ *   char* cursor = cmd.parameter;                  // "SRAM 32768 DUAL"
+ *   char* word = CommandParser::nextToken(cursor); // "SRAM", cursor at "32768 DUAL"
+ *   int8_t index = CommandParser::findKeyword(word, TABLE, TABLE_COUNT);
+ *   uint32_t size;
+ *   if (!CommandParser::parseNumber(CommandParser::nextToken(cursor), size, 10)) { ... }
+ *
+ *   char batch[] = "MODE Z80; TEST";
+ *   char* rest = batch;
+ *   while (char* command = CommandParser::nextCommand(rest)) { ... }
  */
 
 #ifndef COMMAND_PARSER_H
@@ -34,15 +69,29 @@ enum CommandType {
     HELP,       // Show help
     CLOCK,      // Configure and start clock (Phase 2 test)
     CLOCKSTOP,  // Stop clock (Phase 2 test)
+    PROTO,      // Select output protocol / baud rate
+    ABORT,      // Stop running test (only meaningful mid-test)
+    PAUSE,      // Pause running test
+    RESUME,     // Resume paused test
+    PERF,       // Per-test timing and throughput
+    TRACE,      // Z80/6502 bus-cycle trace
+    PLAN,       // Edit/show the stored test plan
+    RUN,        // Run the stored plan
+    DUMP,       // Stream SRAM contents
+    CRC,        // On-board SRAM checksum
+    LOAD,       // CPU test program upload
+    MAP,        // CPU memory map pages
     INVALID     // Unknown command
 };
 
+constexpr uint8_t COMMAND_TYPE_COUNT = INVALID + 1;
+
 /**
  * Parsed command structure
  */
 struct ParsedCommand {
     CommandType type;     // Command type
-    String parameter;     // Command parameter (for MODE command)
+    char* parameter;      // Command parameter, trimmed ("" if none; points into the line)
 };
 
 /**
@@ -52,10 +101,46 @@ class CommandParser {
 public:
     /**
      * Parse a command string
-     * @param line Command line to parse (e.g., "MODE Z80")
+     * @param line Command line to parse (e.g., "MODE Z80"), modified in place
      * @return ParsedCommand structure with type and parameter
      */
-    ParsedCommand parse(const String& line);
+    ParsedCommand parse(char* line);
+
+    /**
+     * Command word of a type ("MODE", ...; "INVALID" for INVALID), in flash
+     */
+    static PGM_P getCommandName(CommandType type);
+
+    /**
+     * Next space-separated word of cursor, terminated in place
+     *
+     * @param cursor Advanced past the word and the spaces after it
+     * @return The word ("" at the end of the string)
+     */
+    static char* nextToken(char*& cursor);
+
+    /**
+     * Index of word in a PROGMEM table of PROGMEM strings
+     * @return -1 if not found
+     */
+    static int8_t findKeyword(const char* word, const char* const* table, uint8_t count);
+
+    /**
+     * Unsigned number filling the whole word
+     *
+     * @param base 10 for decimal only, 0 to also take 0x hex (strtoul())
+     * @return false for an empty word, a sign or trailing characters
+     */
+    static bool parseNumber(const char* word, uint32_t& value, uint8_t base);
+
+    /**
+     * Next ';'-separated command of a line, trimmed and terminated in place
+     * (empty commands are skipped)
+     *
+     * @param cursor Advanced past the command; nullptr once none are left
+     * @return The command, or nullptr if none is left
+     */
+    static char* nextCommand(char*& cursor);
 
 private:
     /**
@@ -63,7 +148,7 @@ private:
      * @param cmd Command string (e.g., "MODE")
      * @return CommandType enum value
      */
-    CommandType parseCommandType(const String& cmd);
+    CommandType parseCommandType(const char* cmd);
 };
 
 #endif // COMMAND_PARSER_H
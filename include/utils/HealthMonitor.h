@@ -0,0 +1,90 @@
+/**
+ * HealthMonitor.h
+ *
+ * Main loop and command latency figures for STATUS
+ *
+ * Every loop() pass and every operator command is timed with the Timer5
+ * cycle counter:
+ * - Loop: the longest pass, and the mean of the last HEALTH_LOOP_WINDOW
+ *   passes. A pass that runs a blocking command or a long scheduler slice
+ *   is how long STATUS and ABORT had to wait, so the maximum is the
+ *   figure to watch when a new feature adds work to the loop.
+ * - Commands: per CommandType, how many were handled and the mean and
+ *   longest time from parsing the line to the last reply byte queued.
+ *   Replies that wait for room in the TX ring count; the link draining it
+ *   afterwards does not.
+ *
+ * STATUS shows these next to the free RAM and stack figures of
+ * MemoryInfo.h and the UART counters, so a new buffer or a slower loop
+ * shows up in the field and not only on the bench.
+ *
+ * RAM budget: ~220 bytes (COMMAND_TYPE_COUNT entries of 10 bytes, plus
+ * the loop figures). The command mean is a running mean in 32 bits, so
+ * recording a command needs no 64-bit sum or division.
+ *
+ * Usage:
+ *   HealthMonitor health;
+ *   uint32_t start = CycleCounter::now();
+ *   dispatchCommand(cmd);
+ *   health.recordCommand(cmd.type, CycleCounter::now() - start);
+ *   health.recordLoop(CycleCounter::now() - loopStart);
+ *   health.getLoopMaxUs(); health.getCommand(TEST).count;
+ *
+ * See Strategy/01-Phase1-Foundation.md section 13
+ */
+
+#ifndef HEALTH_MONITOR_H
+#define HEALTH_MONITOR_H
+
+#include <Arduino.h>
+#include "utils/CommandParser.h"
+
+constexpr uint16_t HEALTH_LOOP_WINDOW = 256;   // loop() passes per mean
+
+/**
+ * Turnaround of one command type
+ */
+struct HealthCommandStats {
+    uint16_t count;       // Handled (stops at 0xFFFF)
+    uint32_t maxUs;
+    uint32_t meanUs;      // Running mean of the recorded commands
+};
+
+class HealthMonitor {
+public:
+    HealthMonitor();
+
+    /**
+     * Clear every figure (STATUS RESET)
+     */
+    void reset();
+
+    /**
+     * Record one loop() pass / one handled command
+     * @param cycles Elapsed CycleCounter cycles
+     */
+    void recordLoop(uint32_t cycles);
+    void recordCommand(CommandType type, uint32_t cycles);
+
+    /**
+     * Loop passes since reset(), the longest, and the mean of the last
+     * full window (0 until HEALTH_LOOP_WINDOW passes have run)
+     */
+    uint32_t getLoops() const { return loops; }
+    uint32_t getLoopMaxUs() const;
+    uint32_t getLoopMeanUs() const;
+
+    const HealthCommandStats& getCommand(CommandType type) const;
+    uint32_t getCommandMeanUs(CommandType type) const;
+
+private:
+    uint32_t loops;
+    uint32_t loopMaxCycles;
+    uint32_t loopMeanCycles;      // Of the last full window
+    uint32_t windowCycles;        // Current window so far
+    uint16_t windowLoops;
+
+    HealthCommandStats commands[COMMAND_TYPE_COUNT];
+};
+
+#endif // HEALTH_MONITOR_H
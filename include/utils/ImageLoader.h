@@ -0,0 +1,89 @@
+/**
+ * ImageLoader.h
+ *
+ * LOAD <addr> <len>: windowed block transfer of a CPU test program into
+ * the ProgramImage buffer
+ *
+ * XMODEM-like, on the binary record framing both ways:
+ * - The board answers LOAD with LOAD_ACK (next 0, CONTINUE, window)
+ * - The host sends LOAD_DATA records (offset + 6 bytes), at most window
+ *   records past the last acknowledged offset
+ * - Every record stored in order is acknowledged (LOAD_ACK next, CONTINUE),
+ *   so the host keeps the window full and the link busy
+ * - A record past a gap (one lost or failed its CRC) gets one LOAD_ACK
+ *   RESEND with the offset to go back to; repeats below it are ignored
+ * - Silence for LOAD_RETRY_MS repeats the RESEND (a lost last record, or
+ *   a lost ACK); after LOAD_MAX_RETRIES the transfer fails
+ * - When all bytes are in: LOAD_ACK DONE, a CRC record with the image
+ *   CRC-32, and an OK line
+ *
+ * The window is the UART record queue, so a full window always fits in
+ * the board's RX buffers even while a slice of work holds the main loop.
+ * In-window records are 48 bytes, within the 64-byte Serial RX ring.
+ *
+ * Records go out in either protocol (like DUMP); the final line is text.
+ *
+ * Usage:
+ *   ImageLoader loader(image, uart);
+ *   scheduler.add(&loader);
+ *   loader.start(0xF000, 64);             // Host then sends LOAD_DATA
+ *   if (loader.isActive()) { ... loader.abort(); }
+ *
+ * See Strategy/04-Phase4-Z80.md section 9
+ */
+
+#ifndef IMAGE_LOADER_H
+#define IMAGE_LOADER_H
+
+#include <Arduino.h>
+#include "utils/ProgramImage.h"
+#include "utils/Scheduler.h"
+#include "utils/UARTHandler.h"
+
+constexpr uint8_t LOAD_WINDOW = UARTHandler::RX_RECORD_QUEUE_SIZE;  // Records in flight
+constexpr uint16_t LOAD_RETRY_MS = 500;     // Silence before a RESEND
+constexpr uint8_t LOAD_MAX_RETRIES = 6;     // RESENDs without progress before giving up
+
+class ImageLoader : public SchedulerTask {
+public:
+    ImageLoader(ProgramImage& image, UARTHandler& uart);
+
+    /**
+     * Start a transfer of length bytes to base (returns immediately)
+     * @return false if one is active or the block doesn't fit the image
+     */
+    bool start(uint16_t base, uint16_t length);
+
+    /**
+     * Give up the transfer (the saved image, if any, is loaded again)
+     */
+    void abort();
+
+    bool isActive() const;
+
+    /**
+     * Send the transfer position ("STATUS: LOAD 0xF000, 24 of 64 bytes")
+     */
+    void sendStatus();
+
+    // SchedulerTask: store queued records, acknowledge, time out
+    bool step(uint16_t budgetUs) override;
+
+private:
+    ProgramImage& image;
+    UARTHandler& uart;
+
+    bool active;
+    bool resendSent;          // RESEND already sent for the current gap
+    uint8_t retries;
+    uint16_t base;
+    uint16_t length;
+    uint16_t received;        // Bytes stored in order (= next offset expected)
+    uint32_t lastActivityMs;
+
+    void sendAck(uint8_t status);
+    void finish();
+    void fail(const __FlashStringHelper* reason);
+};
+
+#endif // IMAGE_LOADER_H
@@ -0,0 +1,99 @@
+/**
+ * MemoryInfo.h
+ *
+ * RAM usage of the running firmware (ATmega2560: 8KB at 0x0200-0x21FF)
+ *
+ *   0x0200 [.data | .bss ][ heap -> ...        ... <- stack ] RAMEND
+ *          static RAM     __heap_start  __brkval        SP
+ *
+ * The firmware allocates nothing after setup() (no String, no new), so
+ * heapUsed() should read 0; anything else means an allocation crept in.
+ *
+ * Stack high-water: paintStack() fills the gap between heap and stack with
+ * STACK_PAINT, and stackUnused() counts the painted bytes the stack never
+ * reached since. Deep call chains (a test inside a plan step inside a
+ * command) and ISR frames all leave their mark, so the figure is the worst
+ * case seen, not a snapshot like freeRam(). The scan takes under 1 ms per
+ * KB of untouched stack; it is meant for STATUS, not for test loops.
+ *
+ * Usage:
+ *   paintStack();                            // Early in setup()
+ *   uart.sendInfof(F("Free RAM: %u bytes"), freeRam());
+ *   uart.sendInfof(F("Stack never reached: %u bytes"), stackUnused());
+ */
+
+#ifndef MEMORY_INFO_H
+#define MEMORY_INFO_H
+
+#include <Arduino.h>
+
+constexpr uint8_t STACK_PAINT = 0xC5;          // Unlikely as data or a return address
+constexpr uint8_t STACK_PAINT_GUARD = 32;      // Bytes below SP left alone (this frame, one ISR)
+
+// Linker / malloc symbols from avr-libc
+extern char __heap_start;
+extern char* __brkval;
+
+/**
+ * Bytes used by .data and .bss (fixed at link time)
+ */
+inline uint16_t staticRam() {
+    return (uint16_t)(&__heap_start - (char*)RAMSTART);
+}
+
+/**
+ * Bytes handed out by malloc() since reset (high-water, never shrinks)
+ */
+inline uint16_t heapUsed() {
+    return (__brkval != nullptr) ? (uint16_t)(__brkval - &__heap_start) : 0;
+}
+
+/**
+ * Bytes between the top of the heap and the current stack pointer
+ */
+inline uint16_t freeRam() {
+    char top;
+    char* heapEnd = (__brkval != nullptr) ? __brkval : &__heap_start;
+    return (uint16_t)(&top - heapEnd);
+}
+
+/**
+ * Fill the free RAM below the stack with STACK_PAINT (repainting resets
+ * the high-water mark). Interrupts are held off so no ISR frame below SP
+ * is overwritten while it is live.
+ *
+ * Does nothing when the heap and stack are not one 8KB address space
+ * (host build).
+ */
+inline void paintStack() {
+    char top;
+    char* heapEnd = (__brkval != nullptr) ? __brkval : &__heap_start;
+    if (&top <= heapEnd || &top - heapEnd > RAMEND - RAMSTART) {
+        return;
+    }
+
+    uint8_t sreg = SREG;
+    cli();
+    for (char* p = heapEnd; p < &top - STACK_PAINT_GUARD; p++) {
+        *p = (char)STACK_PAINT;
+    }
+    SREG = sreg;
+}
+
+/**
+ * Painted bytes above the heap that the stack has never overwritten
+ * (0 on the host build)
+ */
+inline uint16_t stackUnused() {
+    char top;
+    char* heapEnd = (__brkval != nullptr) ? __brkval : &__heap_start;
+    if (&top <= heapEnd || &top - heapEnd > RAMEND - RAMSTART) {
+        return 0;
+    }
+
+    const char* p = heapEnd;
+    while (p < &top && *p == (char)STACK_PAINT) p++;
+    return (uint16_t)(p - heapEnd);
+}
+
+#endif // MEMORY_INFO_H
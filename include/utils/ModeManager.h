@@ -83,13 +83,13 @@ public:
      * Get mode name as string
      *
      * @param mode The mode to get name for
-     * @return Null-terminated string with mode name
+     * @return Mode name in flash (print with sendInfof("%S") or Serial.print)
      *
      * Example:
-     *   const char* name = ModeManager::getModeName(manager.getCurrentMode());
+     *   const __FlashStringHelper* name = ModeManager::getModeName(manager.getCurrentMode());
      *   // Returns: "NONE", "Z80", "6502", or "HM62256"
      */
-    static const char* getModeName(ICMode mode);
+    static const __FlashStringHelper* getModeName(ICMode mode);
 
 private:
     ICTestStrategy* currentStrategy;  // Pointer to current strategy (nullptr if none)
@@ -0,0 +1,127 @@
+/**
+ * PlanRunner.h
+ *
+ * Unattended batch runs of the stored test plan (PlanStore.h)
+ *
+ * RUN, or the footswitch on PD2 while idle, tests one DUT: every step of
+ * the plan, repeated getRepeat() times, then one summary line:
+ *   OK: DUT 12 PASS (3 steps, 41223 ms)
+ *   ERROR: DUT 13 FAIL step 2: Test 4 FAIL - Addr: 0x0100 Expected: 0x55 Got: 0x54
+ *   ERROR: DUT 14 ABORTED at step 3
+ *
+ * Steps run through the normal command dispatcher with the UART muted and
+ * in TEXT protocol; a step failed if it sent an ERROR line (failed test,
+ * failed suite, bad command). The first error of the DUT goes into its
+ * summary. With stop-on-fail the DUT ends at its first failing step.
+ *
+ * A runner is a scheduler task: a step that starts a background SRAM test
+ * is complete when the busy callback goes false, and the next step is
+ * dispatched from a later slice. Blocking steps (Z80/6502) complete inside
+ * the dispatch. Idle, step() only debounces the footswitch.
+ *
+ * DUTs are numbered from 1 at power-up, with PASS/FAIL tallies for the
+ * batch.
+ *
+ * Usage:
+ *   PlanStore planStore;
+ *   PlanRunner planRunner(planStore, uart, runPlanStep, isTestRunning);
+ *   planStore.load();
+ *   planRunner.begin();                   // Footswitch pin
+ *   scheduler.add(&planRunner);
+ *
+ *   planRunner.start();                   // RUN
+ *   if (planRunner.isRunning()) { ... planRunner.abort(); }
+ */
+
+#ifndef PLAN_RUNNER_H
+#define PLAN_RUNNER_H
+
+#include <Arduino.h>
+#include "utils/PlanStore.h"
+#include "utils/Scheduler.h"
+#include "utils/UARTHandler.h"
+
+constexpr uint8_t PLAN_FOOTSWITCH_DEBOUNCE_MS = 30;
+
+// Runs one command line (modified in place)
+typedef void (*PlanDispatch)(char* line);
+
+// True while the command of the last step is still running
+typedef bool (*PlanBusy)();
+
+class PlanRunner : public SchedulerTask {
+public:
+    PlanRunner(PlanStore& store, UARTHandler& uart, PlanDispatch dispatch, PlanBusy busy);
+
+    /**
+     * Footswitch input with pull-up
+     */
+    void begin();
+
+    /**
+     * Start a DUT
+     * @return false if already running, a test is running or the plan
+     *         has no steps
+     */
+    bool start();
+
+    /**
+     * End the DUT after the current step (reported as ABORTED)
+     */
+    void abort();
+
+    bool isRunning() const;
+
+    /**
+     * Current or next step and pass (1-based), valid while running
+     */
+    uint8_t getStep() const;
+    uint8_t getPass() const;
+
+    /**
+     * Batch tallies since power-up or resetCounts()
+     */
+    uint16_t getDutCount() const;
+    uint16_t getPassCount() const;
+    uint16_t getFailCount() const;
+    void resetCounts();
+
+    // SchedulerTask: next step when the previous one is done, footswitch
+    bool step(uint16_t budgetUs) override;
+
+private:
+    PlanStore& store;
+    UARTHandler& uart;
+    PlanDispatch dispatch;
+    PlanBusy busy;
+
+    bool running;
+    bool aborted;
+    bool stepPending;           // Dispatched, waiting for busy() to clear
+    uint8_t stepIndex;          // Next step (0-based)
+    uint8_t pass;               // Current pass (0-based)
+    uint8_t stepsRun;
+    uint8_t failedStep;         // 1-based, 0 = none
+    uint8_t failedPass;
+    uint8_t abortedStep;        // 1-based step running at abort()
+    uint8_t errorsBefore;       // Muted error count before the pending step
+    UARTHandler::Protocol savedProtocol;
+    uint32_t startMs;
+
+    uint16_t dutCount;
+    uint16_t passCount;
+    uint16_t failCount;
+
+    bool switchLevel;           // Last sampled level (true = pressed)
+    bool switchPressed;         // Debounced state
+    uint32_t switchChangedMs;
+
+    char line[PLAN_STEP_SIZE];  // Step being dispatched (the parser splits it in place)
+
+    bool footswitchPressed();
+    void completeStep();
+    void dispatchNext();
+    void finish();
+};
+
+#endif // PLAN_RUNNER_H
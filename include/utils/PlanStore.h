@@ -0,0 +1,107 @@
+/**
+ * PlanStore.h
+ *
+ * Test plan kept in EEPROM: up to PLAN_MAX_STEPS command lines, a repeat
+ * count and the stop-on-fail policy
+ *
+ * Layout at PLAN_EEPROM_ADDRESS:
+ *   [0..7]   PlanHeader (magic, step count, repeat, flags, CRC-16)
+ *   [8..]    PLAN_MAX_STEPS slots of PLAN_STEP_SIZE bytes, NUL-terminated
+ *
+ * The CRC covers the header fields and the used slots, so a blank or
+ * half-written EEPROM loads as an empty plan. Only the header is held in
+ * RAM; steps are read back when they run. Writes use eeprom_update_*,
+ * which skips bytes that already hold the value (EEPROM endurance is
+ * about 100,000 writes per cell).
+ *
+ * Usage:
+ *   PlanStore store;
+ *   store.load();                         // In setup()
+ *   store.addStep("MODE SRAM 32768");
+ *   store.setRepeat(2);
+ *
+ *   char line[PLAN_STEP_SIZE];
+ *   for (uint8_t i = 0; i < store.getStepCount(); i++) {
+ *       store.getStep(i, line, sizeof(line));
+ *   }
+ */
+
+#ifndef PLAN_STORE_H
+#define PLAN_STORE_H
+
+#include <Arduino.h>
+#include "utils/UARTHandler.h"
+
+constexpr uint16_t PLAN_EEPROM_ADDRESS = 0x0000;
+constexpr uint8_t PLAN_MAX_STEPS = 8;
+constexpr uint8_t PLAN_STEP_SIZE = 64;   // One command incl. terminator (fixed EEPROM layout)
+static_assert(PLAN_STEP_SIZE <= UARTHandler::RX_LINE_SIZE, "A stored step must fit a received line");
+constexpr uint8_t PLAN_DEFAULT_REPEAT = 1;
+
+class PlanStore {
+public:
+    /**
+     * Constructor
+     * Empty plan until load()
+     */
+    PlanStore();
+
+    /**
+     * Read the header from EEPROM and check the CRC
+     * @return false if there was no valid plan (the plan is left empty)
+     */
+    bool load();
+
+    uint8_t getStepCount() const;
+
+    /**
+     * Copy step index (0-based) into buffer
+     * @return false if index is past the last step (buffer set to "")
+     */
+    bool getStep(uint8_t index, char* buffer, uint8_t size) const;
+
+    /**
+     * Append a command line and save
+     * @return false if the plan is full or the line does not fit a slot
+     */
+    bool addStep(const char* command);
+
+    /**
+     * Remove all steps and save (repeat and policy are kept)
+     */
+    void clear();
+
+    /**
+     * Passes over the step list per DUT (1-255)
+     */
+    uint8_t getRepeat() const;
+    void setRepeat(uint8_t repeat);
+
+    /**
+     * End the DUT's run at its first failing step (default on)
+     */
+    bool getStopOnFail() const;
+    void setStopOnFail(bool stop);
+
+private:
+    struct PlanHeader {
+        uint8_t magic;
+        uint8_t stepCount;
+        uint8_t repeat;
+        uint8_t flags;
+        uint16_t reserved;
+        uint16_t crc;
+    };
+
+    static constexpr uint8_t PLAN_MAGIC = 0x50;           // 'P'
+    static constexpr uint8_t FLAG_STOP_ON_FAIL = 0x01;
+
+    PlanHeader header;
+
+    void setDefaults();
+    void save();
+    uint16_t computeCrc() const;
+    static uint8_t* stepAddress(uint8_t index);
+};
+
+#endif // PLAN_STORE_H
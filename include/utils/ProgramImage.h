@@ -0,0 +1,123 @@
+/**
+ * ProgramImage.h
+ *
+ * CPU test program uploaded over the link (LOAD), instead of a PROGMEM
+ * array compiled into the firmware
+ *
+ * The image is a block of up to PROGRAM_IMAGE_SIZE bytes at a page-aligned
+ * base address in the CPU's memory map (Z80: from 0x0000, 6502: 0xF000,
+ * where the reset vector points). TEST IMAGE serves it as ROM pages of the
+ * MemoryMap (hardware/MemoryMap.h); the rest of the last page reads 0xFF.
+ * Only one CPU is tested at a time, so both strategies share this buffer.
+ *
+ * save() keeps a copy in EEPROM after the stored plan; load() brings it
+ * back at power-up, so a diagnostic program survives a reset without a
+ * firmware build.
+ *
+ * EEPROM layout at IMAGE_EEPROM_ADDRESS:
+ *   [0..7]   ImageHeader (magic, base, length, CRC-16)
+ *   [8..]    length image bytes
+ *
+ * RAM budget: PROGRAM_IMAGE_SIZE + 8 bytes
+ *
+ * Usage:
+ *   ProgramImage image;
+ *   image.load();                         // In setup()
+ *   image.begin(0xF000, 64);              // LOAD: bytes go in with write()
+ *   image.write(0, bytes, 6);
+ *   image.commit();
+ *   image.save();                         // LOAD SAVE
+ *   if (image.isLoaded()) { ... image.getData() ... }
+ */
+
+#ifndef PROGRAM_IMAGE_H
+#define PROGRAM_IMAGE_H
+
+#include <Arduino.h>
+#include "hardware/MemoryMap.h"
+#include "utils/PlanStore.h"
+
+constexpr uint16_t PROGRAM_IMAGE_SIZE = 512;
+constexpr uint16_t IMAGE_EEPROM_ADDRESS = 0x0400;   // After the plan (PlanStore.h)
+
+static_assert(IMAGE_EEPROM_ADDRESS >= PLAN_EEPROM_ADDRESS + 8 + PLAN_MAX_STEPS * PLAN_STEP_SIZE,
+              "Image overlaps the stored plan");
+static_assert(PROGRAM_IMAGE_SIZE % MEMORY_PAGE_SIZE == 0, "Image must be whole memory map pages");
+
+class ProgramImage {
+public:
+    /**
+     * Constructor
+     * No image until load() or a LOAD
+     */
+    ProgramImage();
+
+    /**
+     * Read the image back from EEPROM and check the CRC
+     * @return false if none was saved (no image)
+     */
+    bool load();
+
+    /**
+     * Write the image to EEPROM
+     * @return false if no image is loaded
+     */
+    bool save();
+
+    /**
+     * Drop the image from RAM and EEPROM
+     */
+    void clear();
+
+    /**
+     * Start receiving an image (the previous one is gone)
+     * @return false if the block isn't valid (isValidBlock())
+     */
+    bool begin(uint16_t base, uint16_t length);
+
+    /**
+     * 1 to PROGRAM_IMAGE_SIZE bytes from a page-aligned base, within 0xFFFF
+     */
+    static bool isValidBlock(uint16_t base, uint16_t length);
+
+    /**
+     * Store received bytes at an offset (ignored past the length)
+     */
+    void write(uint16_t offset, const uint8_t* bytes, uint8_t count);
+
+    /**
+     * All bytes received: the image can be run and saved
+     */
+    void commit();
+
+    bool isLoaded() const { return loaded; }
+    bool isSaved() const { return saved; }              // EEPROM holds this image
+    uint16_t getBase() const { return header.base; }
+    uint16_t getLength() const { return header.length; }
+    const uint8_t* getData() const { return data; }
+
+    /**
+     * CRC-32 of the image (zlib, as in the LOAD completion line)
+     */
+    uint32_t getCrc32() const;
+
+private:
+    struct ImageHeader {
+        uint8_t magic;
+        uint8_t reserved;
+        uint16_t base;
+        uint16_t length;
+        uint16_t crc;
+    };
+
+    static constexpr uint8_t IMAGE_MAGIC = 0x49;       // 'I'
+
+    ImageHeader header;
+    uint8_t data[PROGRAM_IMAGE_SIZE];
+    bool loaded;
+    bool saved;
+
+    uint16_t computeCrc() const;
+};
+
+#endif // PROGRAM_IMAGE_H
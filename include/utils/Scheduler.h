@@ -0,0 +1,71 @@
+/**
+ * Scheduler.h
+ *
+ * Cooperative round-robin scheduler for long-running work
+ *
+ * Tasks do a bounded amount of work per step() call and keep their own
+ * state between calls, so the main loop stays responsive (UART commands,
+ * progress, clock service) while a test is running.
+ *
+ * Usage:
+ *   Scheduler scheduler;
+ *   scheduler.add(&sramStrategy);
+ *
+ *   void loop() {
+ *       handleCommands();
+ *       scheduler.run();      // each task gets one time slice
+ *   }
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+/**
+ * Unit of resumable work
+ */
+class SchedulerTask {
+public:
+    /**
+     * Do up to budgetUs microseconds of work, then return
+     *
+     * A step may overrun the budget by one unit of work (the task decides
+     * how big a unit is). Idle tasks return immediately.
+     *
+     * @return true if the task still has work to do
+     */
+    virtual bool step(uint16_t budgetUs) = 0;
+    virtual ~SchedulerTask() = default;
+};
+
+class Scheduler {
+public:
+    static constexpr uint8_t MAX_TASKS = 4;
+    static constexpr uint16_t DEFAULT_SLICE_US = 10000;  // 10 ms per task per loop()
+
+    Scheduler();
+
+    /**
+     * Register a task (static lifetime)
+     * @return false if MAX_TASKS are already registered
+     */
+    bool add(SchedulerTask* task);
+
+    /**
+     * Give every registered task one time slice
+     */
+    void run(uint16_t sliceUs = DEFAULT_SLICE_US);
+
+    /**
+     * Check if any task reported work left in the last run()
+     */
+    bool isBusy() const;
+
+private:
+    SchedulerTask* tasks[MAX_TASKS];
+    uint8_t taskCount;
+    bool busy;
+};
+
+#endif // SCHEDULER_H
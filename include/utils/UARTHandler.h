@@ -4,12 +4,76 @@
  * UART communication wrapper for Multi-IC Tester
  * Provides formatted message output and line-based input
  *
+ * Input never blocks: poll() moves bytes from the Serial RX buffer (filled
+ * by the USART interrupt) into a 256-byte queue that holds completed lines
+ * back to back, each taking only its own length, with the line being
+ * received stored after them. A line longer than RX_LINE_SIZE - 1
+ * characters is not queued: it is answered "ERROR: Line too long", so a
+ * cut-off command never runs. Long-running tests call poll() at cheap
+ * checkpoints and pick out ABORT/STATUS with takeCommand(); everything else
+ * stays queued for the main loop.
+ *
+ * The host may also send binary records (LOAD_DATA), framed like the
+ * board's: a 0xA5 byte starts a 12-byte frame wherever it appears, since
+ * command text never contains it. Frames with a good CRC are queued for
+ * readRecord(); bad ones are counted and dropped, and the receiver
+ * resyncs on the next 0xA5 inside the rejected frame.
+ *
+ * Two protocols share the port:
+ * - TEXT (default): human-readable lines only
+ * - BIN: test progress and results go out as framed binary records
+ *   (see BinaryProtocol.h); command responses stay text lines
+ *
+ * No heap: constant text is passed as F("...") and stays in flash, and
+ * sendInfof()/sendOKf()/sendErrorf() format printf-style (format in flash,
+ * %S for flash string arguments) into one static line buffer.
+ *
+ * Muted (stored test plans, see PlanRunner.h), nothing is sent: ERROR
+ * lines are counted instead and the first one is kept, so a batch run
+ * can tell which step failed and report it in one summary line.
+ *
+ * Output is queued in Serial's TX ring (256 bytes, SERIAL_TX_BUFFER_SIZE in
+ * platformio.ini), which the USART0 UDRE interrupt drains. The send calls
+ * wait only when the ring is full. trySendInfof()/trySendRecord() never
+ * wait: if the line or record does not fit, nothing is sent. Progress
+ * uses them, so a slow port drops progress and never stalls a test.
+ *
+ * If poll() finds the Serial RX ring full, the USART interrupt may have
+ * had to drop bytes since the last poll (a long interrupts-off run, or a
+ * host sending faster than the loop reads): getRxOverruns() counts those.
+ *
+ * Every send call adds the cycles it spent (mostly waiting for room in the
+ * TX ring) to getTxCycles(), so PERF can split test time into bus work and
+ * UART output.
+ *
  * Usage:
  *   UARTHandler uart;
  *   uart.begin(115200);
- *   if (uart.available()) {
- *       String line = uart.readLine();
- *       uart.sendOK("Command received");
+ *   char line[UARTHandler::RX_LINE_SIZE];
+ *   if (uart.readLine(line, sizeof(line))) {
+ *       uart.sendOK(F("Command received"));
+ *       uart.sendInfof(F("Test %d (%S) - PASSED"), 4, name);
+ *   }
+ *
+ *   // Inside a long test
+ *   uart.poll();
+ *   if (uart.takeCommand(F("ABORT"))) { ... }
+ *
+ *   BinaryRecord received(0);
+ *   while (uart.readRecord(received)) { ... received.get16(0) ... }
+ *
+ *   uart.clearMutedErrors();
+ *   uart.setMuted(true);
+ *   runStep();
+ *   if (uart.getMutedErrors() != 0) { ... uart.getFirstMutedError() ... }
+ *
+ *   uart.setProtocol(UARTHandler::PROTOCOL_BINARY);
+ *   if (uart.isBinary()) {
+ *       uart.sendRecord(record);
+ *   }
+ *
+ *   if (!uart.trySendInfof(F("%s: %d%%"), label, percent)) {
+ *       coalesced++;                     // No room: skip, never wait
  *   }
  */
 
@@ -17,9 +81,22 @@
 #define UART_HANDLER_H
 
 #include <Arduino.h>
+#include <stdarg.h>
+#include "utils/BinaryProtocol.h"
 
 class UARTHandler {
 public:
+    enum Protocol : uint8_t {
+        PROTOCOL_TEXT,
+        PROTOCOL_BINARY
+    };
+
+    /**
+     * Constructor
+     * Starts in TEXT protocol
+     */
+    UARTHandler();
+
     /**
      * Initialize UART communication
      * @param baud Baud rate (typically 115200)
@@ -27,17 +104,126 @@ public:
     void begin(uint32_t baud);
 
     /**
-     * Check if data is available to read
-     * @return true if data available
+     * Change baud rate
+     *
+     * Waits for pending output to drain, then restarts the port.
+     * Rates above 115200 (250000, 500000, 1000000) divide 16 MHz exactly
+     * and are supported by the Mega's USB bridge.
+     *
+     * @param baud New baud rate
+     * @return false if the rate is not in the supported list
+     */
+    bool setBaud(uint32_t baud);
+
+    /**
+     * Get current baud rate
+     */
+    uint32_t getBaud() const;
+
+    /**
+     * Check if a baud rate is in the supported list
+     */
+    static bool isSupportedBaud(uint32_t baud);
+
+    /**
+     * Select TEXT or BIN protocol for test output
+     */
+    void setProtocol(Protocol newProtocol);
+    Protocol getProtocol() const;
+    bool isBinary() const;
+
+    /**
+     * Send one framed binary record (sync, type, payload, CRC)
+     * Sent regardless of protocol; callers check isBinary()
+     */
+    void sendRecord(const BinaryRecord& record);
+
+    /**
+     * Send a record or info line only if it fits in the TX ring now
+     * @return false if it did not fit (nothing sent)
+     */
+    bool trySendRecord(const BinaryRecord& record);
+    bool trySendInfof(const __FlashStringHelper* format, ...);
+
+    /**
+     * Bytes that can be queued without waiting
+     */
+    uint16_t getTxFree();
+
+    /**
+     * Drop all output (lines and records)
+     * ERROR lines sent while muted are counted, and the first one since
+     * clearMutedErrors() is kept (without the "ERROR: " prefix)
+     */
+    void setMuted(bool mute);
+    bool isMuted() const;
+    uint8_t getMutedErrors() const;
+    const char* getFirstMutedError() const;
+    void clearMutedErrors();
+
+    /**
+     * Move received bytes into the line buffer / command queue
+     * Non-blocking, safe to call from test loops
+     */
+    void poll();
+
+    /**
+     * Check if a complete command line is queued
+     * @return true if readLine() has a line to return
      */
     bool available();
 
     /**
-     * Read a complete line (until \n or \r\n)
-     * Blocks until newline received
-     * @return String containing the line (trimmed, without line ending)
+     * Take the next queued line (received until \n or \r\n)
+     * Does not block
+     * @param buffer Receives the line (trimmed, NUL-terminated)
+     * @param size Buffer size (RX_LINE_SIZE holds any line)
+     * @return false if no line was queued (buffer set to "")
+     */
+    bool readLine(char* buffer, uint8_t size);
+
+    /**
+     * Remove the first queued line equal to keyword
+     *
+     * Used by running tests to handle ABORT/STATUS without disturbing
+     * other queued commands.
+     *
+     * @return true if such a line was queued (and has been removed)
      */
-    String readLine();
+    bool takeCommand(const __FlashStringHelper* keyword);
+
+    /**
+     * Lines dropped because the queue had no room for them
+     */
+    uint8_t getDroppedLines() const;
+
+    /**
+     * Take the next binary record received from the host
+     * Does not block
+     * @return false if none was queued
+     */
+    bool readRecord(BinaryRecord& record);
+
+    /**
+     * Received frames dropped: bad CRC, or the record queue was full
+     */
+    uint8_t getBadFrames() const;
+
+    /**
+     * Polls that found the Serial RX ring full (bytes may have been lost)
+     */
+    uint8_t getRxOverruns() const;
+
+    /**
+     * ERROR lines sent since power-up (wraps; muted ones not included)
+     * A caller compares two readings to see whether a command failed.
+     */
+    uint16_t getErrorLines() const;
+
+    /**
+     * Total CPU cycles spent inside send calls since power-up (wraps)
+     */
+    uint32_t getTxCycles() const;
 
     /**
      * Send OK message
@@ -45,6 +231,7 @@ public:
      * @param message Success message to send
      */
     void sendOK(const char* message);
+    void sendOK(const __FlashStringHelper* message);
 
     /**
      * Send error message
@@ -52,6 +239,7 @@ public:
      * @param message Error description
      */
     void sendError(const char* message);
+    void sendError(const __FlashStringHelper* message);
 
     /**
      * Send informational message
@@ -59,6 +247,19 @@ public:
      * @param message Information to send
      */
     void sendInfo(const char* message);
+    void sendInfo(const __FlashStringHelper* message);
+
+    /**
+     * Formatted OK / ERROR / info line
+     *
+     * @param format printf-style format in flash (F("...")); %S takes a
+     *               flash string, %lu a uint32_t cast to unsigned long
+     *
+     * Output longer than LINE_BUFFER_SIZE - 1 characters is truncated.
+     */
+    void sendOKf(const __FlashStringHelper* format, ...);
+    void sendErrorf(const __FlashStringHelper* format, ...);
+    void sendInfof(const __FlashStringHelper* format, ...);
 
     /**
      * Send test result
@@ -66,7 +267,46 @@ public:
      * @param passed true if test passed
      * @param message Additional message (for failures, or empty for pass)
      */
-    void sendResult(bool passed, const char* message = "");
+    void sendResult(bool passed, const char* message = nullptr);
+
+    static constexpr uint8_t RX_LINE_SIZE = 128;  // Longest line (a ';' batch) incl. terminator
+    static constexpr uint16_t RX_QUEUE_BYTES = 256;     // Queued lines plus the one being received
+    static constexpr uint8_t RX_RECORD_QUEUE_SIZE = 4;  // Received records waiting (LOAD window)
+    static constexpr uint8_t LINE_BUFFER_SIZE = 96;  // Longest formatted line incl. terminator
+    static constexpr uint8_t ERROR_TEXT_SIZE = 72;   // Kept first muted error incl. terminator
+
+private:
+    uint32_t baudRate;
+    Protocol protocol;
+
+    char rxQueue[RX_QUEUE_BYTES];                 // Completed lines back to back (oldest first), then the line being received
+    uint16_t queueBytes;                          // Taken by completed lines, terminators included
+    uint8_t queueCount;
+    uint8_t rxLength;                             // Characters of the line being received (stops at 0xFF)
+    uint8_t droppedLines;
+
+    uint8_t rxFrame[BIN_FRAME_SIZE];              // Frame being received
+    uint8_t rxFrameLength;                        // 0 = not inside a frame
+    uint8_t rxRecords[RX_RECORD_QUEUE_SIZE][1 + BIN_PAYLOAD_SIZE];  // Type + payload, oldest first
+    uint8_t recordCount;
+    uint8_t badFrames;
+    uint8_t rxOverruns;
+
+    uint32_t txCycles;
+    uint16_t errorLines;
+
+    char lineBuffer[LINE_BUFFER_SIZE];            // Shared by the *f() senders
+
+    bool muted;
+    uint8_t mutedErrors;
+    char firstMutedError[ERROR_TEXT_SIZE];
+
+    void sendFormatted(const __FlashStringHelper* prefix, const __FlashStringHelper* format,
+                       va_list args);
+    void countMutedError(const char* message, bool inFlash);
+    void queueLine();
+    void receiveFrameByte(uint8_t c);
+    void removeQueued(uint16_t offset);
 };
 
 #endif // UART_HANDLER_H
@@ -0,0 +1,101 @@
+/**
+ * Arduino.h (native build)
+ *
+ * The part of the Arduino core the firmware uses, for host builds
+ * (pio run -e native): types, F(), timing, random, Serial.
+ *
+ * - millis()/micros() count host time since the program started
+ * - delay()/delayMicroseconds() and cycle delays return at once
+ * - Serial writes to stdout; its input is a string the program supplies
+ *   (Serial.feed(), text or binary records), so a host program can drive
+ *   the command loop
+ * - pinMode()/digitalWrite() do nothing: the firmware drives the bus
+ *   through the port registers (see avr/io.h)
+ */
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "avr/interrupt.h"
+#include "avr/io.h"
+#include "avr/pgmspace.h"
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(PSTR(s)))
+
+#define __builtin_avr_delay_cycles(n) ((void)(n))
+
+unsigned long millis();
+unsigned long micros();
+inline void delay(unsigned long) {}
+inline void delayMicroseconds(unsigned int) {}
+
+void randomSeed(unsigned long seed);
+long random(long howBig);
+long random(long howSmall, long howBig);
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) { this->baud = baud; }
+    void end() {}
+    void flush() { fflush(stdout); }
+    operator bool() const { return true; }
+
+    // Input: bytes queued with feed()
+    void feed(const char* text) { input += text; }
+    void feed(const uint8_t* bytes, size_t size) { input.append(reinterpret_cast<const char*>(bytes), size); }
+    int available() const { return (int)(input.size() - inputPos); }
+    int read();
+
+    // Output goes straight to stdout: the TX ring is always empty
+    int availableForWrite() const { return 255; }
+    size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buffer, size_t size) { return fwrite(buffer, 1, size, stdout); }
+
+    size_t print(const char* text) { return fputs(text, stdout) == EOF ? 0 : strlen(text); }
+    size_t print(const __FlashStringHelper* text) { return print(reinterpret_cast<const char*>(text)); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value) { return printf("%d", value); }
+    size_t print(unsigned int value) { return printf("%u", value); }
+    size_t print(long value) { return printf("%ld", value); }
+    size_t print(unsigned long value) { return printf("%lu", value); }
+
+    template <typename T>
+    size_t println(T value) { return print(value) + println(); }
+    size_t println() { return print("\r\n"); }
+
+    unsigned long getBaud() const { return baud; }
+
+private:
+    std::string input;
+    size_t inputPos = 0;
+    unsigned long baud = 0;
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,149 @@
+/**
+ * SimSRAM.h (native build)
+ *
+ * HM62256 / HM6265 bus model with injectable faults
+ *
+ * Attached to the port registers (avr/io.h), it behaves like the chip in
+ * the socket as far as SRAMBus can tell:
+ * - Address from PORTA/PORTC (A0-A14), data on PORTL/PINL, /CS /OE /WE on
+ *   PG0/PG2/PG3 (inactive while the pin is still an input)
+ * - A write is latched when /WE or /CS ends a cycle that had both LOW, with
+ *   the byte PORTL drives (FFh if DDRL is not all outputs)
+ * - PINL reads the addressed cell while /CS and /OE are LOW, /WE is HIGH
+ *   and DDRL is all inputs; otherwise FFh (floating, no pull-ups)
+ * - 8 KB chips: pin 26 is CS2, the chip is deselected unless A13 is HIGH
+ * - Socket B (dual-socket fixture): data on PORTK/PINK, /CS on PF0, same
+ *   address bus and /OE /WE; a chip can sit in each socket at once
+ *
+ * Faults (any number, all active at once):
+ * - Stuck-at:    one bit of a cell always reads 0 or 1
+ * - Transition:  one bit of a cell can't rise (or can't fall)
+ * - Coupling:    a rising or falling write on an aggressor bit inverts,
+ *                clears or sets a victim bit (CFin / CFid)
+ * - Address:     two address lines shorted (wired-AND), or one stuck
+ *
+ * Every chip read and write is counted. A bus contention (chip driving
+ * PORTL while DDRL drives it too) is counted as well; SRAMBus must never
+ * cause one.
+ *
+ * Usage:
+ *   SimSRAM chip;
+ *   chip.attach(32768);
+ *   chip.addStuckAt(0x1234, 3, false);
+ *   ... run SRAMStrategy ...
+ *   printf("%u reads\n", chip.getReads());
+ *   chip.detach();
+ *
+ *   SimSRAM second;
+ *   second.attach(32768, SIM_SOCKET_B);       // MODE SRAM 32768 DUAL
+ *
+ * See Strategy/07-Native-Build.md
+ */
+
+#ifndef SIM_SRAM_H
+#define SIM_SRAM_H
+
+#include <Arduino.h>
+
+#include <vector>
+
+enum SimSocket : uint8_t {
+    SIM_SOCKET_A,           // Data PORTL, /CS PG0
+    SIM_SOCKET_B            // Data PORTK, /CS PF0
+};
+
+enum SimCouplingEffect : uint8_t {
+    SIM_COUPLING_INVERT,    // CFin
+    SIM_COUPLING_CLEAR,     // CFid, victim forced to 0
+    SIM_COUPLING_SET        // CFid, victim forced to 1
+};
+
+class SimSRAM {
+public:
+    SimSRAM();
+    ~SimSRAM();
+
+    /**
+     * Put the chip in a socket: hooks the control port(s) and the socket's
+     * data DDR and PIN register
+     *
+     * @param sizeInBytes 8192 or 32768
+     */
+    void attach(uint16_t sizeInBytes, SimSocket socket = SIM_SOCKET_A);
+    void detach();
+
+    /**
+     * Power-up contents (every cell = value) and no faults
+     */
+    void fill(uint8_t value);
+    void clearFaults();
+
+    void addStuckAt(uint16_t cell, uint8_t bit, bool value);
+    void addTransitionFault(uint16_t cell, uint8_t bit, bool rising);
+    void addCoupling(uint16_t aggressor, uint8_t aggressorBit, bool rising,
+                     uint16_t victim, uint8_t victimBit, SimCouplingEffect effect);
+    void addAddressShort(uint8_t lineA, uint8_t lineB);
+    void addAddressStuck(uint8_t line, bool value);
+
+    /**
+     * Chip accesses and contentions since attach() or resetCounters()
+     */
+    uint32_t getReads() const { return reads; }
+    uint32_t getWrites() const { return writes; }
+    uint32_t getContentions() const { return contentions; }
+    void resetCounters();
+
+    /**
+     * Cell contents without a bus cycle
+     */
+    uint8_t peek(uint16_t cell) const { return memory[cell]; }
+    uint16_t getSize() const { return size; }
+
+private:
+    struct CellFault {
+        uint16_t cell;
+        uint8_t mask;
+        bool value;       // Stuck-at value, or true = can't rise
+    };
+    struct Coupling {
+        uint16_t aggressor;
+        uint8_t aggressorMask;
+        bool rising;
+        uint16_t victim;
+        uint8_t victimMask;
+        SimCouplingEffect effect;
+    };
+
+    uint8_t memory[32768];
+    uint16_t size;
+    bool attached;
+    SimSocket socket;
+    uint8_t control;                      // /CS /OE /WE as the chip sees them
+
+    std::vector<CellFault> stuckAt;
+    std::vector<CellFault> transitions;
+    std::vector<Coupling> couplings;
+    uint16_t addressAndMask;              // Stuck-at-0 lines cleared
+    uint16_t addressOrMask;               // Stuck-at-1 lines set
+    std::vector<uint16_t> addressShorts;  // Both line bits of each pair
+
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t contentions;
+
+    bool decode(uint8_t control, uint16_t& cell) const;
+    void write(uint16_t cell, uint8_t data);
+    void applyStuckAt(uint16_t cell);
+    void checkContention();
+
+    uint8_t controlLevel() const;
+    NativeRegister& dataPort() const;
+    NativeRegister& dataDirection() const;
+
+    static SimSRAM* active[2];            // Per SimSocket
+    static uint8_t readData(const NativeRegister& reg);
+    static void controlChanged(NativeRegister& reg, uint8_t previous);
+    static void directionChanged(NativeRegister& reg, uint8_t previous);
+};
+
+#endif // SIM_SRAM_H
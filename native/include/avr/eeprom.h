@@ -0,0 +1,21 @@
+/**
+ * avr/eeprom.h (native build)
+ *
+ * The ATmega2560's 4 KB EEPROM as a RAM array, erased (0xFF) at start-up.
+ * EEPROM addresses are offsets into it, passed as pointers like avr-libc.
+ */
+
+#ifndef NATIVE_AVR_EEPROM_H
+#define NATIVE_AVR_EEPROM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "avr/io.h"     // E2END
+
+uint8_t eeprom_read_byte(const uint8_t* address);
+void eeprom_read_block(void* destination, const void* source, size_t size);
+void eeprom_update_byte(uint8_t* address, uint8_t value);
+void eeprom_update_block(const void* source, void* destination, size_t size);
+
+#endif // NATIVE_AVR_EEPROM_H
@@ -0,0 +1,15 @@
+/**
+ * avr/interrupt.h (native build)
+ *
+ * No interrupts on the host: cli()/sei() do nothing and an ISR is an
+ * ordinary function nobody calls.
+ */
+
+#ifndef NATIVE_AVR_INTERRUPT_H
+#define NATIVE_AVR_INTERRUPT_H
+
+#define cli() ((void)0)
+#define sei() ((void)0)
+#define ISR(vector) extern "C" void vector(void)
+
+#endif // NATIVE_AVR_INTERRUPT_H
@@ -0,0 +1,122 @@
+/**
+ * avr/io.h (native build)
+ *
+ * ATmega2560 registers as host variables
+ *
+ * Each 8-bit register is a NativeRegister: it reads and writes like the
+ * volatile uint8_t on the target, and a bus model can hook a register to
+ * see writes (PORTG strobes) or supply reads (PINL data). As on the AVR,
+ * writing 1s to PINx toggles those PORTx bits; reading an unhooked PINx
+ * returns the PORTx latch (outputs loop back, inputs read what was
+ * written).
+ *
+ * 16-bit timer registers are plain variables.
+ *
+ * Only the registers and bit names the firmware uses are defined.
+ */
+
+#ifndef NATIVE_AVR_IO_H
+#define NATIVE_AVR_IO_H
+
+#include <stdint.h>
+
+class NativeRegister {
+public:
+    typedef uint8_t (*ReadHook)(const NativeRegister& reg);
+    typedef void (*WriteHook)(NativeRegister& reg, uint8_t previous);
+
+    explicit NativeRegister(NativeRegister* toggles = nullptr)
+        : value(0), onRead(nullptr), onWrite(nullptr), toggles(toggles) {}
+
+    operator uint8_t() const {
+        if (onRead != nullptr) return onRead(*this);
+        return toggles != nullptr ? toggles->value : value;
+    }
+
+    NativeRegister& operator=(uint8_t x) {
+        if (toggles != nullptr) {
+            *toggles = (uint8_t)(toggles->value ^ x);
+            return *this;
+        }
+        uint8_t previous = value;
+        value = x;
+        if (onWrite != nullptr) onWrite(*this, previous);
+        return *this;
+    }
+    NativeRegister& operator=(const NativeRegister& other) { return *this = (uint8_t)other; }
+    NativeRegister& operator|=(uint8_t x) { return *this = (uint8_t)(*this | x); }
+    NativeRegister& operator&=(uint8_t x) { return *this = (uint8_t)(*this & x); }
+    NativeRegister& operator^=(uint8_t x) { return *this = (uint8_t)(*this ^ x); }
+
+    uint8_t value;          // Last value written (the latch)
+    ReadHook onRead;        // nullptr = read the latch
+    WriteHook onWrite;      // Called after every write
+
+private:
+    NativeRegister* toggles;  // PINx: the PORTx it toggles
+};
+
+// Ports: PORTx / DDRx / PINx
+#define NATIVE_PORTS(X) X(A) X(B) X(C) X(D) X(E) X(F) X(G) X(H) X(J) X(K) X(L)
+
+#define NATIVE_DECLARE_PORT(L) extern NativeRegister PORT##L, DDR##L, PIN##L;
+NATIVE_PORTS(NATIVE_DECLARE_PORT)
+#undef NATIVE_DECLARE_PORT
+
+// Other 8-bit registers
+#define NATIVE_REGISTERS(X) \
+    X(TCCR1A) X(TCCR1B) X(TCCR1C) X(TIMSK1) X(TIFR1) \
+    X(TCCR3A) X(TCCR3B) X(TCCR3C) X(TIMSK3) X(TIFR3) \
+    X(TCCR4A) X(TCCR4B) X(TIMSK4) X(TIFR4) \
+    X(TCCR5A) X(TCCR5B) X(TCCR5C) X(TIMSK5) X(TIFR5) \
+    X(UCSR0A) X(UCSR0B) X(UCSR0C) X(UDR0) X(SREG) X(MCUSR) \
+    X(EIMSK) X(EICRA) X(EICRB) X(EIFR) X(PCICR) X(PCMSK0) X(PCIFR)
+
+#define NATIVE_DECLARE_REGISTER(R) extern NativeRegister R;
+NATIVE_REGISTERS(NATIVE_DECLARE_REGISTER)
+#undef NATIVE_DECLARE_REGISTER
+
+#define NATIVE_REGISTERS16(X) \
+    X(OCR3A) X(OCR3B) X(TCNT3) X(ICR3) X(TCNT1) X(OCR1A) X(TCNT4) \
+    X(TCNT5) X(OCR5A) X(ICR5) X(SP) X(UBRR0)
+
+#define NATIVE_DECLARE_REGISTER16(R) extern volatile uint16_t R;
+NATIVE_REGISTERS16(NATIVE_DECLARE_REGISTER16)
+#undef NATIVE_DECLARE_REGISTER16
+
+// Timer3 (CPU clock)
+#define WGM30 0
+#define WGM31 1
+#define COM3A0 6
+#define COM3A1 7
+#define CS30 0
+#define CS31 1
+#define CS32 2
+#define WGM32 3
+#define WGM33 4
+#define TOV3 0
+#define OCF3A 1
+
+// Timer5 (CycleCounter)
+#define CS50 0
+#define CS51 1
+#define CS52 2
+#define TOIE5 0
+#define TOV5 0
+
+// PORTE
+#define PE3 3
+#define PORTE3 3
+#define DDE3 3
+
+// USART0
+#define DOR0 3
+#define FE0 4
+#define UDRE0 5
+
+// Memory layout
+#define RAMSTART 0x200
+#define RAMEND 0x21FF
+#define E2END 0xFFF
+
+#endif // NATIVE_AVR_IO_H
@@ -0,0 +1,42 @@
+/**
+ * avr/pgmspace.h (native build)
+ *
+ * Flash and RAM share one address space on the host: PROGMEM data is
+ * ordinary const data and the _P functions are their RAM versions.
+ *
+ * The AVR printf family reads a flash string for %S; host printf would
+ * take a wide string. vsnprintf_P() rewrites %S to %s before formatting.
+ */
+
+#ifndef NATIVE_AVR_PGMSPACE_H
+#define NATIVE_AVR_PGMSPACE_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define pgm_read_ptr(p) (*(void* const*)(p))
+#define pgm_read_byte_far(p) (*(const uint8_t*)(uintptr_t)(p))
+#define pgm_get_far_address(x) ((uint32_t)(uintptr_t)&(x))
+
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcasecmp_P strcasecmp
+
+int vsnprintf_P(char* buffer, size_t size, const char* format, va_list args);
+int snprintf_P(char* buffer, size_t size, const char* format, ...);
+
+#endif // NATIVE_AVR_PGMSPACE_H
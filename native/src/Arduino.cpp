@@ -0,0 +1,137 @@
+/**
+ * Arduino.cpp (native build)
+ *
+ * Register storage, Serial, EEPROM and the timing/random functions of
+ * the host Arduino core (see Arduino.h)
+ */
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+#include <chrono>
+
+#define NATIVE_DEFINE_PORT(L) NativeRegister PORT##L, DDR##L, PIN##L(&PORT##L);
+NATIVE_PORTS(NATIVE_DEFINE_PORT)
+
+#define NATIVE_DEFINE_REGISTER(R) NativeRegister R;
+NATIVE_REGISTERS(NATIVE_DEFINE_REGISTER)
+
+#define NATIVE_DEFINE_REGISTER16(R) volatile uint16_t R;
+NATIVE_REGISTERS16(NATIVE_DEFINE_REGISTER16)
+
+// MemoryInfo.h: no heap on the host
+char __heap_start;
+char* __brkval = nullptr;
+
+HardwareSerial Serial;
+
+// avr/eeprom.h: erased on every start, like a new board
+static uint8_t eeprom[E2END + 1];
+static bool eepromErased = false;
+
+static uint8_t* eepromAt(const void* address) {
+    if (!eepromErased) {
+        memset(eeprom, 0xFF, sizeof(eeprom));
+        eepromErased = true;
+    }
+    return &eeprom[(uintptr_t)address & E2END];
+}
+
+uint8_t eeprom_read_byte(const uint8_t* address) {
+    return *eepromAt(address);
+}
+
+void eeprom_read_block(void* destination, const void* source, size_t size) {
+    memcpy(destination, eepromAt(source), size);
+}
+
+void eeprom_update_byte(uint8_t* address, uint8_t value) {
+    *eepromAt(address) = value;
+}
+
+void eeprom_update_block(const void* source, void* destination, size_t size) {
+    memcpy(eepromAt(destination), source, size);
+}
+
+static const std::chrono::steady_clock::time_point programStart = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - programStart).count();
+}
+
+unsigned long micros() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - programStart).count();
+}
+
+// avr-libc random(): Park-Miller minimal standard generator, same sequence as the target
+static uint32_t randomState = 1;
+
+void randomSeed(unsigned long seed) {
+    if (seed != 0) randomState = (uint32_t)seed;
+}
+
+static long nextRandom() {
+    if (randomState == 0) randomState = 123459876;
+    int32_t hi = (int32_t)(randomState / 127773);
+    int32_t lo = (int32_t)(randomState % 127773);
+    int32_t x = 16807 * lo - 2836 * hi;
+    if (x < 0) x += 0x7FFFFFFF;
+    randomState = (uint32_t)x;
+    return x;
+}
+
+long random(long howBig) {
+    return howBig == 0 ? 0 : nextRandom() % howBig;
+}
+
+long random(long howSmall, long howBig) {
+    return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall);
+}
+
+int HardwareSerial::read() {
+    if (inputPos >= input.size()) return -1;
+    int c = (unsigned char)input[inputPos++];
+    if (inputPos == input.size()) {
+        input.clear();
+        inputPos = 0;
+    }
+    return c;
+}
+
+// %S (flash string on the AVR) is %s on the host
+int vsnprintf_P(char* buffer, size_t size, const char* format, va_list args) {
+    char hostFormat[256];
+    size_t out = 0;
+    for (size_t in = 0; format[in] != '\0' && out < sizeof(hostFormat) - 1; in++) {
+        char c = format[in];
+        if (c == '%' && format[in + 1] == '%') {
+            hostFormat[out++] = '%';
+            if (out < sizeof(hostFormat) - 1) hostFormat[out++] = '%';
+            in++;
+            continue;
+        }
+        hostFormat[out++] = c;
+        if (c != '%') continue;
+        // Copy flags, width, length; turn the conversion S into s
+        while (format[in + 1] != '\0' && strchr("-+ #0123456789.lhz", format[in + 1]) != nullptr &&
+               out < sizeof(hostFormat) - 1) {
+            hostFormat[out++] = format[++in];
+        }
+        if (format[in + 1] == 'S') {
+            hostFormat[out++] = 's';
+            in++;
+        }
+    }
+    hostFormat[out] = '\0';
+    return vsnprintf(buffer, size, hostFormat, args);
+}
+
+int snprintf_P(char* buffer, size_t size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf_P(buffer, size, format, args);
+    va_end(args);
+    return n;
+}
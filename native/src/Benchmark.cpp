@@ -0,0 +1,303 @@
+/**
+ * Benchmark.cpp (native build)
+ *
+ * SRAM algorithm benchmark: bus operations, host time and fault coverage
+ * of every SRAM test, on the simulated chip (SimSRAM.h)
+ *
+ * Each case runs once on a good chip (cost) and once per catalogued fault
+ * (coverage). Operation counts and coverage are exact and repeatable, so
+ * they are checked against BASELINE below: any difference fails the run
+ * (exit status 1) and shows which algorithm changed. Host time is for
+ * comparison only.
+ *
+ * After an intended change, update BASELINE with the table --baseline
+ * prints.
+ *
+ * Usage:
+ *   pio run -e native -t exec                     Table and baseline check
+ *   .pio/build/native/program --baseline          Print a new BASELINE
+ *
+ * See Strategy/07-Native-Build.md
+ */
+
+#include "SimSRAM.h"
+#include "strategies/MarchTest.h"
+#include "strategies/SRAMStrategy.h"
+
+#include <chrono>
+
+//=============================================================================
+// CASES
+//=============================================================================
+
+enum BenchKind : uint8_t {
+    BENCH_TEST,         // runTest(number, full)
+    BENCH_SUITE,        // runAllTests(number == 7, full, fused)
+    BENCH_MARCH,        // runMarch(number, full)
+    BENCH_RANDOM,       // runRandom(BENCH_RANDOM_SEED, number passes, full)
+    BENCH_PROFILE,      // runPlan(profilePlan(number)), fast-fail tiers
+    BENCH_DUAL          // BENCH_SUITE with a good chip in socket B (faults go to socket A)
+};
+
+// Fixed test 7 seed: a run picks a new one, the benchmark must repeat
+constexpr uint32_t BENCH_RANDOM_SEED = 12345;
+
+struct BenchCase {
+    const char* name;
+    BenchKind kind;
+    uint8_t number;     // Test, last suite test, March algorithm, random passes, or profile
+    bool full;
+    bool fused;
+};
+
+static const BenchCase CASES[] = {
+    {"T1 Basic R/W",        BENCH_TEST, 1, true, false},
+    {"T2 Address Bus",      BENCH_TEST, 2, true, false},
+    {"T3 Walking Data",     BENCH_TEST, 3, true, false},
+    {"T4 Checkerboard",     BENCH_TEST, 4, true, false},
+    {"T5 Inv Checkerboard", BENCH_TEST, 5, true, false},
+    {"T6 Address=Data",     BENCH_TEST, 6, true, false},
+    {"T7 Random",           BENCH_RANDOM, 1, true, false},
+    {"T7 Random 4 passes",  BENCH_RANDOM, 4, true, false},
+    {"March MATS+",         BENCH_MARCH, 0, true, false},
+    {"March C-",            BENCH_MARCH, 1, true, false},
+    {"March B",             BENCH_MARCH, 2, true, false},
+    {"Tests 1-6",           BENCH_SUITE, 6, true, false},
+    {"Tests 1-6 FUSED",     BENCH_SUITE, 6, true, true},
+    {"Tests 1-6 QUICK",     BENCH_SUITE, 6, false, false},
+    {"March C- QUICK",      BENCH_MARCH, 1, false, false},
+    {"Profile TRIAGE",      BENCH_PROFILE, 0, false, false},
+    {"Profile PRODUCTION",  BENCH_PROFILE, 1, true, false},
+    {"Profile QUALIFY",     BENCH_PROFILE, 2, true, false},
+    {"Tests 1-6 DUAL",      BENCH_DUAL, 6, true, false},
+};
+
+constexpr uint8_t CASE_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+
+//=============================================================================
+// FAULTS (32 KB chip)
+//=============================================================================
+
+enum FaultKind : uint8_t {
+    FAULT_STUCK,
+    FAULT_TRANSITION,
+    FAULT_COUPLING,
+    FAULT_ADDRESS_SHORT,
+    FAULT_ADDRESS_STUCK
+};
+
+struct BenchFault {
+    const char* name;
+    FaultKind kind;
+    uint16_t cell;          // Cell, aggressor, or first address line
+    uint8_t bit;
+    bool value;             // Stuck value, rising transition/aggressor edge
+    uint16_t victim;        // Coupling victim, or second address line
+    uint8_t victimBit;
+    SimCouplingEffect effect;
+};
+
+static const BenchFault FAULTS[] = {
+    {"SA0",    FAULT_STUCK,         0x1234, 3, false, 0, 0, SIM_COUPLING_INVERT},
+    {"SA1",    FAULT_STUCK,         0x5A5A, 6, true,  0, 0, SIM_COUPLING_INVERT},
+    {"TF-up",  FAULT_TRANSITION,    0x2000, 0, true,  0, 0, SIM_COUPLING_INVERT},
+    {"TF-dn",  FAULT_TRANSITION,    0x3001, 7, false, 0, 0, SIM_COUPLING_INVERT},
+    {"CFin<",  FAULT_COUPLING,      0x0100, 1, true,  0x0200, 1, SIM_COUPLING_INVERT},
+    {"CFin>",  FAULT_COUPLING,      0x7000, 2, false, 0x6000, 2, SIM_COUPLING_INVERT},
+    {"CFid<",  FAULT_COUPLING,      0x0400, 4, true,  0x0401, 4, SIM_COUPLING_SET},
+    {"CFid>",  FAULT_COUPLING,      0x4001, 5, false, 0x4000, 5, SIM_COUPLING_CLEAR},
+    {"AS3-9",  FAULT_ADDRESS_SHORT, 3, 0, false, 9, 0, SIM_COUPLING_INVERT},
+    {"A14=0",  FAULT_ADDRESS_STUCK, 14, 0, false, 0, 0, SIM_COUPLING_INVERT},
+};
+
+constexpr uint8_t FAULT_COUNT = sizeof(FAULTS) / sizeof(FAULTS[0]);
+constexpr int COVERAGE_WIDTH = FAULT_COUNT > 8 ? FAULT_COUNT : 8;  // Fits the column title
+
+static void injectFault(SimSRAM& chip, const BenchFault& fault) {
+    switch (fault.kind) {
+        case FAULT_STUCK:
+            chip.addStuckAt(fault.cell, fault.bit, fault.value);
+            break;
+        case FAULT_TRANSITION:
+            chip.addTransitionFault(fault.cell, fault.bit, fault.value);
+            break;
+        case FAULT_COUPLING:
+            chip.addCoupling(fault.cell, fault.bit, fault.value, fault.victim, fault.victimBit, fault.effect);
+            break;
+        case FAULT_ADDRESS_SHORT:
+            chip.addAddressShort((uint8_t)fault.cell, (uint8_t)fault.victim);
+            break;
+        case FAULT_ADDRESS_STUCK:
+            chip.addAddressStuck((uint8_t)fault.cell, fault.value);
+            break;
+    }
+}
+
+//=============================================================================
+// BASELINE
+// Expected cost and coverage ('X' = detected, '.' = missed, faults in
+// FAULTS order). Regenerate with --baseline after an intended change.
+//=============================================================================
+
+struct BenchBaseline {
+    const char* name;
+    uint32_t reads;
+    uint32_t writes;
+    const char* coverage;
+};
+
+static const BenchBaseline BASELINE[] = {
+    {"T1 Basic R/W", 65536, 65536, "XXXX......"},
+    {"T2 Address Bus", 512, 92, "..X.X...XX"},
+    {"T3 Walking Data", 8, 8, ".........."},
+    {"T4 Checkerboard", 65536, 65536, "XXX..X...."},
+    {"T5 Inv Checkerboard", 65536, 65536, "XXXX......"},
+    {"T6 Address=Data", 32768, 32768, "........X."},
+    {"T7 Random", 32768, 32768, ".X......XX"},
+    {"T7 Random 4 passes", 131072, 131072, "XXX.....XX"},
+    {"March MATS+", 65536, 98304, "XXX.XXXXXX"},
+    {"March C-", 163840, 163840, "XXXXXXXXXX"},
+    {"March B", 196608, 360448, "XXXXXXXXXX"},
+    {"Tests 1-6", 229896, 229476, "XXXXXX..XX"},
+    {"Tests 1-6 FUSED", 197128, 131172, "XXXXXXX.XX"},
+    {"Tests 1-6 QUICK", 9424, 9004, "..X.XX..XX"},
+    {"March C- QUICK", 6360, 6360, "..X.XX..XX"},
+    {"Profile TRIAGE", 6880, 6460, "..X.XX..XX"},
+    {"Profile PRODUCTION", 164360, 163940, "XXXXXXXXXX"},
+    {"Profile QUALIFY", 328200, 491620, "XXXXXXXXXX"},
+    {"Tests 1-6 DUAL", 229896, 229476, "XXXXXX..XX"},
+};
+
+constexpr uint8_t BASELINE_COUNT = sizeof(BASELINE) / sizeof(BASELINE[0]);
+
+//=============================================================================
+// RUNNER
+//=============================================================================
+
+static constexpr uint16_t CHIP_SIZE = 32768;
+
+static SimSRAM chip;
+static SimSRAM chipB;       // Socket B, only selected by BENCH_DUAL
+static SRAMStrategy sram;
+
+struct BenchResult {
+    bool passed;            // Good chip passed
+    uint32_t reads;
+    uint32_t writes;
+    uint32_t contentions;
+    double hostMs;
+    char coverage[FAULT_COUNT + 1];
+};
+
+static bool runCase(const BenchCase& bench) {
+    sram.setSize(CHIP_SIZE);
+    sram.setDualSocket(bench.kind == BENCH_DUAL);
+    sram.configurePins();
+    switch (bench.kind) {
+        case BENCH_TEST:  return sram.runTest(bench.number, bench.full);
+        case BENCH_SUITE:
+        case BENCH_DUAL:  return sram.runAllTests(bench.number == 7, bench.full, bench.fused);
+        case BENCH_MARCH: return sram.runMarch(bench.number, bench.full);
+        case BENCH_RANDOM: return sram.runRandom(BENCH_RANDOM_SEED, bench.number, bench.full);
+        case BENCH_PROFILE: {
+            SRAMRunPlan plan = SRAMStrategy::profilePlan(bench.number);
+            plan.randomSeed = BENCH_RANDOM_SEED;
+            SRAMProfile profile;
+            readSRAMProfile(bench.number, profile);
+            sram.setMarchAlgorithm(profile.marchAlgorithm);
+            bool passed = sram.runPlan(plan);
+            sram.setMarchAlgorithm(MARCH_DEFAULT_ALGORITHM);
+            return passed;
+        }
+    }
+    return false;
+}
+
+static void measure(const BenchCase& bench, BenchResult& result) {
+    // Cost on a good chip (reads and writes of socket A)
+    chip.fill(0x00);
+    chip.resetCounters();
+    chipB.fill(0x00);
+    chipB.resetCounters();
+    auto start = std::chrono::steady_clock::now();
+    result.passed = runCase(bench);
+    result.hostMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.reads = chip.getReads();
+    result.writes = chip.getWrites();
+    result.contentions = chip.getContentions() + chipB.getContentions();
+
+    // Coverage: one run per fault
+    for (uint8_t f = 0; f < FAULT_COUNT; f++) {
+        chip.fill(0x00);
+        injectFault(chip, FAULTS[f]);
+        result.coverage[f] = runCase(bench) ? '.' : 'X';
+    }
+    result.coverage[FAULT_COUNT] = '\0';
+}
+
+static const BenchBaseline* findBaseline(const char* name) {
+    for (uint8_t i = 0; i < BASELINE_COUNT; i++) {
+        if (strcmp(BASELINE[i].name, name) == 0) return &BASELINE[i];
+    }
+    return nullptr;
+}
+
+int main(int argc, char** argv) {
+    bool printBaseline = argc > 1 && strcmp(argv[1], "--baseline") == 0;
+
+    chip.attach(CHIP_SIZE);
+    chipB.attach(CHIP_SIZE, SIM_SOCKET_B);
+    BenchResult results[CASE_COUNT];
+    for (uint8_t i = 0; i < CASE_COUNT; i++) {
+        measure(CASES[i], results[i]);
+    }
+
+    if (printBaseline) {
+        printf("static const BenchBaseline BASELINE[] = {\n");
+        for (uint8_t i = 0; i < CASE_COUNT; i++) {
+            printf("    {\"%s\", %lu, %lu, \"%s\"},\n", CASES[i].name, (unsigned long)results[i].reads,
+                   (unsigned long)results[i].writes, results[i].coverage);
+        }
+        printf("};\n");
+        return 0;
+    }
+
+    printf("SRAM benchmark, %u-byte chip, %u faults:", CHIP_SIZE, FAULT_COUNT);
+    for (uint8_t f = 0; f < FAULT_COUNT; f++) printf(" %s", FAULTS[f].name);
+    printf("\n\n%-20s %9s %9s %7s %9s  %-*s  %s\n", "Case", "Reads", "Writes", "Ops/B", "Host ms",
+           COVERAGE_WIDTH, "Coverage", "Check");
+
+    uint8_t problems = 0;
+    for (uint8_t i = 0; i < CASE_COUNT; i++) {
+        const BenchResult& r = results[i];
+        const BenchBaseline* expected = findBaseline(CASES[i].name);
+
+        const char* check = "ok";
+        if (!r.passed) {
+            check = "FAILS ON GOOD CHIP";
+        } else if (r.contentions != 0) {
+            check = "BUS CONTENTION";
+        } else if (expected == nullptr) {
+            check = "no baseline";
+        } else if (expected->reads != r.reads || expected->writes != r.writes) {
+            check = "OPS CHANGED";
+        } else if (strcmp(expected->coverage, r.coverage) != 0) {
+            check = "COVERAGE CHANGED";
+        }
+        if (strcmp(check, "ok") != 0) problems++;
+
+        printf("%-20s %9lu %9lu %7.2f %9.1f  %-*s  %s\n", CASES[i].name, (unsigned long)r.reads,
+               (unsigned long)r.writes, (double)(r.reads + r.writes) / CHIP_SIZE, r.hostMs,
+               COVERAGE_WIDTH, r.coverage, check);
+        if (expected != nullptr && strcmp(check, "OPS CHANGED") == 0) {
+            printf("%-20s %9lu %9lu  (baseline)\n", "", (unsigned long)expected->reads,
+                   (unsigned long)expected->writes);
+        } else if (expected != nullptr && strcmp(check, "COVERAGE CHANGED") == 0) {
+            printf("%-20s %37s  %s  (baseline)\n", "", "", expected->coverage);
+        }
+    }
+
+    printf("\n%s\n", problems == 0 ? "All cases match the baseline"
+                                   : "Some cases differ from the baseline (--baseline prints a new one)");
+    return problems == 0 ? 0 : 1;
+}
@@ -0,0 +1,238 @@
+/**
+ * SimSRAM.cpp (native build)
+ *
+ * Implementation of the SRAM bus model and its faults
+ */
+
+#include "SimSRAM.h"
+
+// PORTG control bits (SRAMPins in PinConfig.h); socket B's /CS is PF0, bit 0 as well
+static constexpr uint8_t CS = 1 << 0;
+static constexpr uint8_t OE = 1 << 2;
+static constexpr uint8_t WE = 1 << 3;
+
+static constexpr uint16_t A13 = 1 << 13;  // CS2 on 8 KB chips
+
+SimSRAM* SimSRAM::active[2] = {nullptr, nullptr};
+
+SimSRAM::SimSRAM()
+    : size(32768), attached(false), socket(SIM_SOCKET_A), control(CS | OE | WE), addressAndMask(0xFFFF), addressOrMask(0),
+      reads(0), writes(0), contentions(0) {
+    memset(memory, 0, sizeof(memory));
+}
+
+SimSRAM::~SimSRAM() {
+    detach();
+}
+
+void SimSRAM::attach(uint16_t sizeInBytes, SimSocket inSocket) {
+    detach();
+    if (active[inSocket] != nullptr) active[inSocket]->detach();
+    size = sizeInBytes <= 8192 ? 8192 : 32768;
+    socket = inSocket;
+    active[socket] = this;
+    attached = true;
+
+    // /OE and /WE are shared: both sockets listen to PORTG
+    PORTG.onWrite = controlChanged;
+    DDRG.onWrite = controlChanged;
+    if (socket == SIM_SOCKET_B) {
+        PORTF.onWrite = controlChanged;
+        DDRF.onWrite = controlChanged;
+        DDRK.onWrite = directionChanged;
+        PINK.onRead = readData;
+    } else {
+        DDRL.onWrite = directionChanged;
+        PINL.onRead = readData;
+    }
+    control = controlLevel();
+    resetCounters();
+}
+
+void SimSRAM::detach() {
+    if (!attached) return;
+    if (socket == SIM_SOCKET_B) {
+        PORTF.onWrite = nullptr;
+        DDRF.onWrite = nullptr;
+        DDRK.onWrite = nullptr;
+        PINK.onRead = nullptr;
+    } else {
+        DDRL.onWrite = nullptr;
+        PINL.onRead = nullptr;
+    }
+    active[socket] = nullptr;
+    attached = false;
+
+    if (active[SIM_SOCKET_A] == nullptr && active[SIM_SOCKET_B] == nullptr) {
+        PORTG.onWrite = nullptr;
+        DDRG.onWrite = nullptr;
+    }
+}
+
+void SimSRAM::fill(uint8_t value) {
+    memset(memory, value, sizeof(memory));
+    clearFaults();
+}
+
+void SimSRAM::clearFaults() {
+    stuckAt.clear();
+    transitions.clear();
+    couplings.clear();
+    addressAndMask = 0xFFFF;
+    addressOrMask = 0;
+    addressShorts.clear();
+}
+
+void SimSRAM::addStuckAt(uint16_t cell, uint8_t bit, bool value) {
+    stuckAt.push_back(CellFault{cell, (uint8_t)(1 << bit), value});
+    applyStuckAt(cell);
+}
+
+void SimSRAM::addTransitionFault(uint16_t cell, uint8_t bit, bool rising) {
+    transitions.push_back(CellFault{cell, (uint8_t)(1 << bit), rising});
+}
+
+void SimSRAM::addCoupling(uint16_t aggressor, uint8_t aggressorBit, bool rising,
+                          uint16_t victim, uint8_t victimBit, SimCouplingEffect effect) {
+    couplings.push_back(Coupling{aggressor, (uint8_t)(1 << aggressorBit), rising,
+                                 victim, (uint8_t)(1 << victimBit), effect});
+}
+
+void SimSRAM::addAddressShort(uint8_t lineA, uint8_t lineB) {
+    addressShorts.push_back((uint16_t)((1 << lineA) | (1 << lineB)));
+}
+
+void SimSRAM::addAddressStuck(uint8_t line, bool value) {
+    if (value) {
+        addressOrMask |= (uint16_t)(1 << line);
+    } else {
+        addressAndMask &= (uint16_t)~(1 << line);
+    }
+}
+
+void SimSRAM::resetCounters() {
+    reads = 0;
+    writes = 0;
+    contentions = 0;
+}
+
+bool SimSRAM::decode(uint8_t control, uint16_t& cell) const {
+    if (control & CS) return false;
+
+    // Address lines as the chip sees them
+    uint16_t lines = (uint16_t)(PORTA.value | (PORTC.value << 8));
+    lines = (lines & addressAndMask) | addressOrMask;
+    for (uint16_t pair : addressShorts) {
+        if ((lines & pair) != pair) lines &= (uint16_t)~pair;  // Wired-AND
+    }
+
+    if (size == 8192 && !(lines & A13)) return false;
+    cell = lines & (size == 8192 ? 0x1FFF : 0x7FFF);
+    return true;
+}
+
+void SimSRAM::write(uint16_t cell, uint8_t data) {
+    uint8_t old = memory[cell];
+
+    for (const CellFault& fault : transitions) {
+        if (fault.cell != cell) continue;
+        bool rises = !(old & fault.mask) && (data & fault.mask);
+        bool falls = (old & fault.mask) && !(data & fault.mask);
+        if (fault.value ? rises : falls) data ^= fault.mask;
+    }
+    memory[cell] = data;
+    applyStuckAt(cell);
+    writes++;
+
+    uint8_t now = memory[cell];
+    for (const Coupling& coupling : couplings) {
+        if (coupling.aggressor != cell) continue;
+        uint8_t mask = coupling.aggressorMask;
+        bool fired = coupling.rising ? (!(old & mask) && (now & mask)) : ((old & mask) && !(now & mask));
+        if (!fired) continue;
+
+        uint8_t& victim = memory[coupling.victim];
+        switch (coupling.effect) {
+            case SIM_COUPLING_INVERT: victim ^= coupling.victimMask; break;
+            case SIM_COUPLING_CLEAR:  victim &= (uint8_t)~coupling.victimMask; break;
+            case SIM_COUPLING_SET:    victim |= coupling.victimMask; break;
+        }
+        applyStuckAt(coupling.victim);
+    }
+}
+
+void SimSRAM::applyStuckAt(uint16_t cell) {
+    for (const CellFault& fault : stuckAt) {
+        if (fault.cell != cell) continue;
+        if (fault.value) {
+            memory[cell] |= fault.mask;
+        } else {
+            memory[cell] &= (uint8_t)~fault.mask;
+        }
+    }
+}
+
+uint8_t SimSRAM::controlLevel() const {
+    // Pins still INPUT don't drive the strobes: the chip sees them inactive
+    uint8_t level = (uint8_t)((PORTG.value & DDRG.value) | ~DDRG.value);
+    if (socket == SIM_SOCKET_B) {
+        uint8_t cs = (uint8_t)((PORTF.value & DDRF.value) | ~DDRF.value);
+        level = (uint8_t)((level & ~CS) | (cs & CS));
+    }
+    return level;
+}
+
+NativeRegister& SimSRAM::dataPort() const {
+    return (socket == SIM_SOCKET_B) ? PORTK : PORTL;
+}
+
+NativeRegister& SimSRAM::dataDirection() const {
+    return (socket == SIM_SOCKET_B) ? DDRK : DDRL;
+}
+
+void SimSRAM::checkContention() {
+    uint16_t cell;
+    if (dataDirection().value != 0 && !(control & OE) && (control & WE) && decode(control, cell)) {
+        contentions++;
+    }
+}
+
+//=============================================================================
+// REGISTER HOOKS
+//=============================================================================
+
+uint8_t SimSRAM::readData(const NativeRegister& reg) {
+    SimSRAM& chip = *active[&reg == &PINK ? SIM_SOCKET_B : SIM_SOCKET_A];
+    uint8_t control = chip.control;
+    uint8_t direction = chip.dataDirection().value;
+    uint16_t cell;
+
+    if (!(control & OE) && (control & WE) && direction == 0 && chip.decode(control, cell)) {
+        chip.reads++;
+        return chip.memory[cell];
+    }
+    // Our own outputs, or nothing driving the floating lines
+    return direction == 0xFF ? chip.dataPort().value : 0xFF;
+}
+
+void SimSRAM::controlChanged(NativeRegister&, uint8_t) {
+    for (SimSRAM* socketChip : active) {
+        if (socketChip == nullptr) continue;
+        SimSRAM& chip = *socketChip;
+        uint8_t previous = chip.control;
+        chip.control = chip.controlLevel();
+        bool wasWriting = !(previous & (CS | WE));
+        bool isWriting = !(chip.control & (CS | WE));
+
+        // /WE- or /CS-controlled write ends on the first rising edge
+        uint16_t cell;
+        if (wasWriting && !isWriting && chip.decode(previous, cell)) {
+            chip.write(cell, chip.dataDirection().value == 0xFF ? chip.dataPort().value : 0xFF);
+        }
+        chip.checkContention();
+    }
+}
+
+void SimSRAM::directionChanged(NativeRegister& reg, uint8_t) {
+    active[&reg == &DDRK ? SIM_SOCKET_B : SIM_SOCKET_A]->checkContention();
+}
@@ -0,0 +1,62 @@
+"""
+ram_report.py
+
+PlatformIO post-link step: print static RAM use of the firmware
+
+  RAM: .data 1012 + .bss 3420 = 4432 of 8192 bytes (3760 free for stack)
+
+followed by the largest RAM symbols, so a new buffer or a literal that
+lost its F() shows up in the build log instead of as a stack crash.
+
+Enabled in platformio.ini:
+  extra_scripts = post:scripts/ram_report.py
+"""
+
+import subprocess
+
+Import("env")  # noqa: F821 (provided by PlatformIO)
+
+RAM_SIZE = 8192   # ATmega2560 internal SRAM
+TOP_SYMBOLS = 10
+
+
+def tool(name):
+    # avr-gcc -> avr-size / avr-nm from the same toolchain
+    return env.subst("$CC").replace("gcc", name)  # noqa: F821
+
+
+def section_sizes(elf):
+    output = subprocess.check_output([tool("size"), "-A", elf]).decode()
+    sizes = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0] in (".data", ".bss", ".noinit"):
+            sizes[fields[0]] = int(fields[1])
+    return sizes
+
+
+def ram_symbols(elf):
+    output = subprocess.check_output(
+        [tool("nm"), "--size-sort", "--reverse-sort", "-S", "-C", elf]).decode()
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split(None, 3)
+        if len(fields) == 4 and fields[2] in ("b", "B", "d", "D"):
+            symbols.append((int(fields[1], 16), fields[3]))
+    return symbols
+
+
+def ram_report(source, target, env):
+    elf = str(target[0]) if target else env.subst("$BUILD_DIR/${PROGNAME}.elf")
+    sizes = section_sizes(elf)
+    data = sizes.get(".data", 0)
+    bss = sizes.get(".bss", 0) + sizes.get(".noinit", 0)
+    used = data + bss
+
+    print("RAM: .data %d + .bss %d = %d of %d bytes (%d free for stack)"
+          % (data, bss, used, RAM_SIZE, RAM_SIZE - used))
+    for size, name in ram_symbols(elf)[:TOP_SYMBOLS]:
+        print("  %5d  %s" % (size, name))
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", ram_report)  # noqa: F821
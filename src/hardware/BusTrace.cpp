@@ -0,0 +1,277 @@
+/**
+ * BusTrace.cpp
+ *
+ * Implementation of the bus-cycle trace recorder and decoder
+ */
+
+#include "hardware/BusTrace.h"
+
+// Control flags of the three memory-cycle record classes
+static const uint8_t CLASS_CONTROL[3] = {
+    BUS_TRACE_FETCH | BUS_TRACE_READ | BUS_TRACE_MREQ,
+    BUS_TRACE_READ | BUS_TRACE_MREQ,
+    BUS_TRACE_WRITE | BUS_TRACE_MREQ
+};
+
+static inline uint32_t packCycle(uint16_t address, uint8_t data, uint8_t control) {
+    return address | ((uint32_t)data << 16) | ((uint32_t)control << 24);
+}
+
+// Record class for a control value, BUS_TRACE_TAG_RAW if it has none
+static inline uint8_t classOf(uint8_t control) {
+    for (uint8_t c = 0; c < 3; c++) {
+        if (control == CLASS_CONTROL[c]) return c;
+    }
+    return BUS_TRACE_TAG_RAW;
+}
+
+BusTrace::BusTrace()
+    : enabled(false), recording(false), heldTest(BUS_TRACE_NOT_HELD) {
+    clear();
+}
+
+void BusTrace::setEnabled(bool on) {
+    enabled = on;
+    if (on) clear();
+}
+
+void BusTrace::clear() {
+    recording = false;
+    heldTest = BUS_TRACE_NOT_HELD;
+    firstBlock = 0;
+    blockCount = 0;
+    writePos = BUS_TRACE_BLOCK_SIZE;
+    runCycles = 0;
+    repeatPeriod = 0;
+}
+
+void BusTrace::hold(uint8_t testNumber) {
+    if (enabled && heldTest == BUS_TRACE_NOT_HELD && blockCount != 0) {
+        heldTest = testNumber;
+    }
+}
+
+bool BusTrace::begin() {
+    if (!enabled || heldTest != BUS_TRACE_NOT_HELD) {
+        recording = false;
+        return false;
+    }
+    clear();
+    startBlock();
+    recording = true;
+    return true;
+}
+
+void BusTrace::end() {
+    if (recording && repeatPeriod != 0) {
+        flushRepeat();
+    }
+    recording = false;
+}
+
+uint32_t BusTrace::getHeldCycles() const {
+    if (blockCount == 0) return 0;
+    uint32_t first;
+    memcpy(&first, getBlock(0), sizeof(first));
+    return runCycles - first;
+}
+
+const uint8_t* BusTrace::getBlock(uint8_t n) const {
+    return buffer + (uint16_t)((firstBlock + n) % BUS_TRACE_BLOCKS) * BUS_TRACE_BLOCK_SIZE;
+}
+
+void BusTrace::startBlock() {
+    // Ring full: the oldest block goes
+    if (blockCount == BUS_TRACE_BLOCKS) {
+        firstBlock = (firstBlock + 1) % BUS_TRACE_BLOCKS;
+    } else {
+        blockCount++;
+    }
+
+    uint8_t* block = currentBlock();
+    memset(block, BUS_TRACE_TAG_END, BUS_TRACE_BLOCK_SIZE);
+    memcpy(block, &runCycles, BUS_TRACE_HEADER_SIZE);  // AVR is little-endian
+    writePos = BUS_TRACE_HEADER_SIZE;
+
+    // Decodes on its own: no history from the previous block
+    historyPos = 0;
+    historyCount = 0;
+}
+
+void BusTrace::ensureSpace(uint8_t bytes) {
+    if (writePos + bytes > BUS_TRACE_BLOCK_SIZE) {
+        startBlock();
+    }
+}
+
+void BusTrace::push(uint32_t packed, uint16_t address) {
+    historyPos = (historyPos + 1) % BUS_TRACE_PERIOD_MAX;
+    history[historyPos] = packed;
+    if (historyCount < BUS_TRACE_PERIOD_MAX) historyCount++;
+    lastAddress = address;
+}
+
+uint32_t BusTrace::past(uint8_t period) const {
+    return history[(historyPos + BUS_TRACE_PERIOD_MAX + 1 - period) % BUS_TRACE_PERIOD_MAX];
+}
+
+void BusTrace::record(uint16_t address, uint8_t data, uint8_t control) {
+    if (!recording) return;
+    uint32_t packed = packCycle(address, data, control);
+
+    if (repeatPeriod != 0) {
+        if (packed == past(repeatPeriod) && repeatCount < 0xFFFF) {
+            repeatCount++;
+            push(packed, address);
+            runCycles++;
+            return;
+        }
+        flushRepeat();
+    }
+
+    // Same cycle 1-8 back: start a REPEAT. Room for its record (or the
+    // plain 5-byte record a single repeat falls back to) stays reserved.
+    if (writePos + 5 <= BUS_TRACE_BLOCK_SIZE) {
+        for (uint8_t period = 1; period <= historyCount; period++) {
+            if (past(period) == packed) {
+                repeatPeriod = period;
+                repeatCount = 1;
+                push(packed, address);
+                runCycles++;
+                return;
+            }
+        }
+    }
+
+    writeCycle(address, data, control);
+    push(packed, address);
+    runCycles++;
+}
+
+void BusTrace::writeCycle(uint16_t address, uint8_t data, uint8_t control) {
+    uint8_t recordClass = classOf(control);
+    ensureSpace(recordClass == BUS_TRACE_TAG_RAW ? 5 : 4);
+    uint8_t* out = currentBlock() + writePos;
+
+    if (recordClass == BUS_TRACE_TAG_RAW) {
+        out[0] = BUS_TRACE_TAG_RAW;
+        out[1] = control;
+        out[2] = (uint8_t)address;
+        out[3] = (uint8_t)(address >> 8);
+        out[4] = data;
+        writePos += 5;
+        return;
+    }
+
+    uint8_t tag = recordClass << 6;
+    int16_t delta = (int16_t)(address - lastAddress);
+    if (historyCount != 0 && delta >= -(int16_t)BUS_TRACE_DELTA_BIAS && delta <= (int16_t)BUS_TRACE_DELTA_BIAS) {
+        out[0] = tag | (uint8_t)(delta + BUS_TRACE_DELTA_BIAS);
+        out[1] = data;
+        writePos += 2;
+    } else {
+        out[0] = tag | BUS_TRACE_ABSOLUTE;
+        out[1] = (uint8_t)address;
+        out[2] = (uint8_t)(address >> 8);
+        out[3] = data;
+        writePos += 4;
+    }
+}
+
+void BusTrace::flushRepeat() {
+    uint8_t period = repeatPeriod;
+    repeatPeriod = 0;
+
+    if (repeatCount == 1) {
+        // A single repeat is shorter as a plain record, coded against the cycle before it
+        uint32_t packed = past(1);
+        lastAddress = (uint16_t)past(2);
+        writeCycle((uint16_t)packed, (uint8_t)(packed >> 16), (uint8_t)(packed >> 24));
+        lastAddress = (uint16_t)packed;
+        return;
+    }
+
+    // Space was reserved when the REPEAT started
+    uint8_t* out = currentBlock() + writePos;
+    out[0] = BUS_TRACE_TAG_REPEAT;
+    out[1] = period;
+    out[2] = (uint8_t)repeatCount;
+    out[3] = (uint8_t)(repeatCount >> 8);
+    writePos += 4;
+}
+
+//=============================================================================
+// DECODER
+//=============================================================================
+
+BusTraceReader::BusTraceReader(const BusTrace& trace)
+    : trace(trace), block(0), repeatLeft(0) {
+    startBlock();
+}
+
+bool BusTraceReader::startBlock() {
+    if (block >= trace.getBlockCount()) return false;
+    memcpy(&index, trace.getBlock(block), sizeof(index));
+    pos = BUS_TRACE_HEADER_SIZE;
+    historyPos = 0;
+    lastAddress = 0;
+    repeatLeft = 0;
+    return true;
+}
+
+bool BusTraceReader::next(BusTraceCycle& cycle) {
+    uint32_t packed;
+
+    if (repeatLeft != 0) {
+        packed = history[(historyPos + BUS_TRACE_PERIOD_MAX + 1 - repeatPeriod) % BUS_TRACE_PERIOD_MAX];
+        repeatLeft--;
+    } else {
+        for (;;) {
+            if (block >= trace.getBlockCount()) return false;
+            const uint8_t* in = trace.getBlock(block) + pos;
+            uint8_t tag = (pos < BUS_TRACE_BLOCK_SIZE) ? in[0] : BUS_TRACE_TAG_END;
+
+            if (tag == BUS_TRACE_TAG_REPEAT) {
+                repeatPeriod = in[1];
+                repeatLeft = in[2] | ((uint16_t)in[3] << 8);
+                pos += 4;
+                if (repeatLeft == 0) continue;
+                packed = history[(historyPos + BUS_TRACE_PERIOD_MAX + 1 - repeatPeriod) % BUS_TRACE_PERIOD_MAX];
+                repeatLeft--;
+                break;
+            }
+            if (tag == BUS_TRACE_TAG_RAW) {
+                packed = packCycle(in[2] | ((uint16_t)in[3] << 8), in[4], in[1]);
+                pos += 5;
+                break;
+            }
+            if ((tag >> 6) == 3) {
+                // End of block (or an unknown tag): continue with the next one
+                block++;
+                startBlock();
+                continue;
+            }
+
+            uint8_t control = CLASS_CONTROL[tag >> 6];
+            uint8_t code = tag & BUS_TRACE_ABSOLUTE;
+            if (code == BUS_TRACE_ABSOLUTE) {
+                packed = packCycle(in[1] | ((uint16_t)in[2] << 8), in[3], control);
+                pos += 4;
+            } else {
+                packed = packCycle(lastAddress + code - BUS_TRACE_DELTA_BIAS, in[1], control);
+                pos += 2;
+            }
+            break;
+        }
+    }
+
+    historyPos = (historyPos + 1) % BUS_TRACE_PERIOD_MAX;
+    history[historyPos] = packed;
+    lastAddress = (uint16_t)packed;
+
+    cycle.index = index++;
+    cycle.address = (uint16_t)packed;
+    cycle.data = (uint8_t)(packed >> 16);
+    cycle.control = (uint8_t)(packed >> 24);
+    return true;
+}
@@ -0,0 +1,59 @@
+/**
+ * CycleCounter.cpp
+ *
+ * Implementation of the Timer5 cycle counter
+ */
+
+#include "hardware/CycleCounter.h"
+#include <avr/interrupt.h>
+
+// Upper 16 bits of the count, advanced by the overflow interrupt
+static volatile uint16_t overflowCount = 0;
+
+ISR(TIMER5_OVF_vect) {
+    overflowCount++;
+}
+
+void CycleCounter::begin() {
+    uint8_t sreg = SREG;
+    cli();
+
+    // Normal mode (WGM5 = 0), no output compare, clock = F_CPU / 1
+    TCCR5A = 0;
+    TCCR5B = 0;
+    TCNT5 = 0;
+    overflowCount = 0;
+    TIFR5 = (1 << TOV5);      // Clear a stale overflow flag
+    TIMSK5 = (1 << TOIE5);
+    TCCR5B = (1 << CS50);
+
+    SREG = sreg;
+}
+
+uint32_t CycleCounter::now() {
+    uint8_t sreg = SREG;
+    cli();
+
+    uint16_t low = TCNT5;
+    uint16_t high = overflowCount;
+
+    // Overflow happened but its interrupt hasn't run yet: a small low
+    // value already belongs to the next high word
+    if ((TIFR5 & (1 << TOV5)) && low < 0x8000) {
+        high++;
+    }
+
+    SREG = sreg;
+    return ((uint32_t)high << 16) | low;
+}
+
+bool CycleCounter::catchUp() {
+    if (!(TIFR5 & (1 << TOV5))) {
+        return false;
+    }
+
+    // Writing 1 clears the flag; the interrupt will not run for this one
+    TIFR5 = (1 << TOV5);
+    overflowCount++;
+    return true;
+}
@@ -0,0 +1,250 @@
+/**
+ * IC6502Bus.cpp
+ *
+ * Implementation of the 6502 bus-cycle engine (firmware clock)
+ */
+
+#include "hardware/IC6502Bus.h"
+#include "hardware/CycleCounter.h"
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+IC6502Bus::IC6502Bus()
+    : rom(nullptr), romSize(0), map(nullptr), trace(nullptr) {
+}
+
+void IC6502Bus::configurePins() {
+    // Address and data bus: INPUT, the 6502 drives them (no pull-ups)
+    DDRA = 0x00;
+    DDRC = 0x00;
+    PORTA = 0x00;
+    PORTC = 0x00;
+    DDRL = 0x00;
+    PORTL = 0x00;
+
+    // PG0-PG3: PG2 = R/W input, PG0/PG1/PG3 unused (Z80 / SRAM only)
+    Z80Pins::BusControl::input();
+
+    // PH3: SYNC input, PH4/PH5 unused; PH6: RES output, held LOW
+    Z80Pins::Status::input();
+    IC6502Pins::Reset::activate();
+    IC6502Pins::Reset::output();
+
+    // PB4-PB6: RDY (HIGH = ready), IRQ, NMI outputs, all inactive
+    // PB7 (/BUSREQ) is Z80 only: INPUT
+    IC6502Pins::Rdy::activate();
+    IC6502Pins::Rdy::output();
+    IC6502Pins::Interrupts::outputInactive();
+    Z80Pins::Busreq::input();
+
+    // PE4 (/HALT) is Z80 only: INPUT
+    Z80Pins::Halt::input();
+
+    // PD0/PD1: Φ1/Φ2 monitors; PD3: S.O. output HIGH (falling edge sets V)
+    IC6502Pins::PhaseMonitors::input();
+    IC6502Pins::SetOverflow::outputInactive();
+}
+
+void IC6502Bus::beginFirmwareClock(Timer3Clock* timer) {
+    // Timer3 stopped = OC3A disconnected, PORTE3 controls the pin
+    if (timer != nullptr) {
+        timer->stop();
+    }
+    IC6502Pins::Phi0::low();
+    IC6502Pins::Phi0::output();
+}
+
+void IC6502Bus::loadRom(const uint8_t* image, uint16_t size) {
+    rom = image;
+    romSize = (size <= IC6502_VECTORS - IC6502_ROM_BASE) ? size : IC6502_VECTORS - IC6502_ROM_BASE;
+}
+
+void IC6502Bus::clearRam(uint8_t value) {
+    memset(cpuRamWindow, value, sizeof(cpuRamWindow));
+}
+
+uint8_t IC6502Bus::peekRam(uint16_t addr) const {
+    uint16_t offset = addr - IC6502_RAM_BASE;
+    return (offset < IC6502_RAM_SIZE) ? cpuRamWindow[offset] : IC6502_UNMAPPED;
+}
+
+void IC6502Bus::pokeRam(uint16_t addr, uint8_t value) {
+    uint16_t offset = addr - IC6502_RAM_BASE;
+    if (offset < IC6502_RAM_SIZE) cpuRamWindow[offset] = value;
+}
+
+void IC6502Bus::holdReset() {
+    IC6502Pins::Reset::activate();
+}
+
+void IC6502Bus::releaseReset() {
+    IC6502Pins::Reset::deactivate();
+}
+
+void IC6502Bus::resetCpu() {
+    // RES is only sampled on clock edges: clock it while LOW
+    IC6502Pins::Reset::activate();
+    DDRL = 0x00;
+    for (uint8_t i = 0; i < IC6502_RESET_CYCLES; i++) {
+        IC6502Pins::Phi0::high();
+        delayMicroseconds(1);
+        IC6502Pins::Phi0::low();
+        delayMicroseconds(1);
+    }
+    IC6502Pins::Reset::deactivate();
+}
+
+inline uint8_t IC6502Bus::lookup(uint16_t addr) const {
+    uint16_t offset = addr - IC6502_ROM_BASE;
+    if (offset < romSize) {
+        return pgm_read_byte(rom + offset);
+    }
+    if (addr >= IC6502_VECTORS) {
+        // Every vector points at the start of the ROM image
+        return (addr & 1) ? (uint8_t)(IC6502_ROM_BASE >> 8) : (uint8_t)IC6502_ROM_BASE;
+    }
+    offset = addr - IC6502_RAM_BASE;
+    if (offset < IC6502_RAM_SIZE) {
+        return cpuRamWindow[offset];
+    }
+    return (map != nullptr) ? map->read(addr) : IC6502_UNMAPPED;
+}
+
+// Returns true when the write hit the stop port
+inline bool IC6502Bus::store(uint16_t addr, uint8_t data, IC6502RunResult& result) {
+    uint16_t offset = addr - IC6502_RAM_BASE;
+    if (offset < IC6502_RAM_SIZE) {
+        cpuRamWindow[offset] = data;
+    } else if (addr == IC6502_STOP_ADDR) {
+        result.exitCode = data;
+        return true;
+    } else if (map != nullptr) {
+        map->write(addr, data);
+    }
+    return false;
+}
+
+// One bus cycle, entered and left with Φ0 LOW. Returns true on a stop-port write.
+inline bool IC6502Bus::clockCycle(IC6502RunResult& result, IC6502Cycle& cycle) {
+    using namespace IC6502Pins;
+
+    // Φ1: address, R/W and SYNC settle
+    __builtin_avr_delay_cycles(IC6502_ADDRESS_SETUP_CYCLES);
+    uint16_t addr = PINA | ((uint16_t)PINC << 8);
+    bool read = Read::isActive();
+    bool sync = Sync::isActive();
+
+    cycle.address = addr;
+    cycle.read = read;
+    cycle.sync = sync;
+    result.cycles++;
+
+    if (read) {
+        // Byte on the bus before Φ2; bookkeeping fills Φ2 (longer than tPWH)
+        uint8_t data = lookup(addr);
+        PORTL = data;
+        DDRL = 0xFF;
+        Phi0::high();
+
+        if (sync) result.fetches++;
+        if (result.fetches != 0 && result.traced < IC6502_TRACE_SIZE) {
+            result.trace[result.traced++] = addr;
+        }
+        result.reads++;
+        cycle.data = data;
+
+        Phi0::low();  // CPU latches the byte on this edge
+        DDRL = 0x00;
+        return false;
+    }
+
+    // Write: data valid tMDS after Φ2 rises
+    Phi0::high();
+    __builtin_avr_delay_cycles(IC6502_WRITE_SETUP_CYCLES);
+    uint8_t data = PINL;
+    result.writes++;
+    cycle.data = data;
+    Phi0::low();
+
+    return store(addr, data, result);
+}
+
+inline void IC6502Bus::traceCycle(const IC6502Cycle& cycle) {
+    uint8_t control = BUS_TRACE_WRITE | BUS_TRACE_MREQ;
+    if (cycle.read) {
+        control = cycle.sync ? BUS_TRACE_FETCH | BUS_TRACE_READ | BUS_TRACE_MREQ
+                             : BUS_TRACE_READ | BUS_TRACE_MREQ;
+    }
+    trace->record(cycle.address, cycle.data, control);
+}
+
+bool IC6502Bus::burst(IC6502RunResult& result, uint16_t cycles, bool tracing) {
+    IC6502Cycle cycle;
+    for (uint16_t i = 0; i < cycles; i++) {
+        bool stopped = clockCycle(result, cycle);
+        if (tracing) traceCycle(cycle);
+        if (stopped) return true;
+    }
+    return false;
+}
+
+void IC6502Bus::step(IC6502Cycle* cycles, uint8_t count) {
+    IC6502RunResult scratch;
+    memset(&scratch, 0, sizeof(scratch));
+
+    bool tracing = trace != nullptr && trace->begin();
+
+    // Back to back, recorded: printing between cycles would stretch Φ1
+    uint8_t sreg = SREG;
+    cli();
+    for (uint8_t i = 0; i < count; i++) {
+        clockCycle(scratch, cycles[i]);
+        if (tracing) traceCycle(cycles[i]);
+    }
+    SREG = sreg;
+
+    if (tracing) trace->end();
+}
+
+IC6502RunResult IC6502Bus::run(uint32_t cycleLimit, uint16_t timeoutMs) {
+    IC6502RunResult result;
+    memset(&result, 0, sizeof(result));
+
+    resetCpu();
+    bool tracing = trace != nullptr && trace->begin();
+    unsigned long startMs = millis();
+
+    for (;;) {
+        uint16_t count = IC6502_BURST_CYCLES;
+        if (cycleLimit != 0) {
+            uint32_t remaining = cycleLimit - result.cycles;
+            if (remaining == 0) {
+                result.end = IC6502_END_LIMIT;
+                break;
+            }
+            if (remaining < count) count = (uint16_t)remaining;
+        }
+
+        // Burst with interrupts off, then pause in Φ1 for pending interrupts
+        uint8_t sreg = SREG;
+        cli();
+        uint32_t start = CycleCounter::now();
+        bool stopped = burst(result, count, tracing);
+        result.elapsed += CycleCounter::now() - start;
+        SREG = sreg;
+        result.bursts++;
+
+        if (stopped) {
+            result.end = IC6502_END_STOP;
+            break;
+        }
+        if (millis() - startMs >= timeoutMs) {
+            result.end = IC6502_END_TIMEOUT;
+            break;
+        }
+    }
+
+    holdReset();
+    if (tracing) trace->end();
+    return result;
+}
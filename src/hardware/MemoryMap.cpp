@@ -0,0 +1,135 @@
+/**
+ * MemoryMap.cpp
+ *
+ * Implementation of the paged CPU memory map
+ */
+
+#include "hardware/MemoryMap.h"
+
+uint8_t cpuRamWindow[CPU_RAM_WINDOW_SIZE];
+
+MemoryMap::MemoryMap() {
+    clear();
+}
+
+void MemoryMap::clear() {
+    memset(pages, MEMORY_ENTRY_OPEN, sizeof(pages));
+    memset(rom, 0, sizeof(rom));
+    resetFaults();
+}
+
+bool MemoryMap::mapRam(uint16_t addr, uint16_t length, uint8_t fill) {
+    uint16_t count = pageCount(addr, length);
+    uint8_t first = addr >> 8;
+
+    // Pages already RAM don't take a new pool page
+    uint16_t needed = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        if (pages[first + i] >= MEMORY_ENTRY_FLASH) needed++;
+    }
+    if (needed > getFreePoolPages()) {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t page = first + i;
+        if (pages[page] < MEMORY_ENTRY_FLASH) continue;
+        uint8_t entry = (uint8_t)findFree(0, MEMORY_POOL_PAGES);
+        memset(pool[entry], fill, MEMORY_PAGE_SIZE);
+        pages[page] = entry;
+    }
+    return true;
+}
+
+bool MemoryMap::mapRom(uint16_t addr, const uint8_t* data, uint16_t length, bool flash) {
+    uint16_t count = pageCount(addr, length);
+    if ((addr & 0xFF) != 0 || data == nullptr) {
+        return false;
+    }
+
+    uint8_t freeSlots = 0;
+    for (uint8_t slot = 0; slot < MEMORY_ROM_PAGES; slot++) {
+        if (!entryInUse(MEMORY_ENTRY_FLASH + slot) && !entryInUse(MEMORY_ENTRY_RAM_ROM + slot)) {
+            freeSlots++;
+        }
+    }
+    if (count > freeSlots) {
+        return false;
+    }
+
+    uint8_t base = flash ? MEMORY_ENTRY_FLASH : MEMORY_ENTRY_RAM_ROM;
+    for (uint16_t i = 0; i < count; i++) {
+        // A slot is free when neither kind of entry uses it
+        uint8_t slot = 0;
+        while (entryInUse(MEMORY_ENTRY_FLASH + slot) || entryInUse(MEMORY_ENTRY_RAM_ROM + slot)) {
+            slot++;
+        }
+        rom[slot] = data + i * MEMORY_PAGE_SIZE;
+        pages[(addr >> 8) + i] = base + slot;
+    }
+    return true;
+}
+
+void MemoryMap::mapFault(uint16_t addr, uint16_t length) {
+    setPages(addr, length, MEMORY_ENTRY_FAULT);
+}
+
+void MemoryMap::unmap(uint16_t addr, uint16_t length) {
+    setPages(addr, length, MEMORY_ENTRY_OPEN);
+}
+
+void MemoryMap::unmapRom() {
+    for (uint16_t page = 0; page < 256; page++) {
+        if (getKind(page) == MEMORY_ROM) pages[page] = MEMORY_ENTRY_OPEN;
+    }
+}
+
+MemoryPageKind MemoryMap::getKind(uint8_t page) const {
+    uint8_t entry = pages[page];
+    if (entry < MEMORY_ENTRY_FLASH) return MEMORY_RAM;
+    if (entry < MEMORY_ENTRY_RAM_ROM + MEMORY_ROM_PAGES) return MEMORY_ROM;
+    if (entry == MEMORY_ENTRY_FAULT) return MEMORY_FAULT;
+    return MEMORY_OPEN;
+}
+
+uint8_t MemoryMap::getFreePoolPages() const {
+    uint8_t count = 0;
+    for (uint8_t entry = 0; entry < MEMORY_POOL_PAGES; entry++) {
+        if (!entryInUse(entry)) count++;
+    }
+    return count;
+}
+
+void MemoryMap::resetFaults() {
+    faults = 0;
+    firstFault = 0;
+}
+
+void MemoryMap::setPages(uint16_t addr, uint16_t length, uint8_t entry) {
+    uint16_t count = pageCount(addr, length);
+    for (uint16_t i = 0; i < count; i++) {
+        pages[(uint8_t)((addr >> 8) + i)] = entry;
+    }
+}
+
+// Pool pages and ROM slots are free when no page refers to them
+bool MemoryMap::entryInUse(uint8_t entry) const {
+    for (uint16_t page = 0; page < 256; page++) {
+        if (pages[page] == entry) return true;
+    }
+    return false;
+}
+
+int16_t MemoryMap::findFree(uint8_t first, uint8_t count) const {
+    for (uint8_t entry = first; entry < first + count; entry++) {
+        if (!entryInUse(entry)) return entry;
+    }
+    return -1;
+}
+
+uint16_t MemoryMap::pageCount(uint16_t addr, uint16_t length) {
+    if (length == 0) return 0;
+    uint32_t last = (uint32_t)addr + length - 1;
+    if (last > 0xFFFF) last = 0xFFFF;
+    return (uint16_t)((last >> 8) - (addr >> 8) + 1);
+}
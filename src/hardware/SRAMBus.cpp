@@ -0,0 +1,142 @@
+/**
+ * SRAMBus.cpp
+ *
+ * Implementation of the SRAM block/burst access engine
+ * (range operations are templates in SRAMBus.h)
+ */
+
+#include "hardware/SRAMBus.h"
+
+SRAMBus::SRAMBus()
+    : highMask(0), sockets(SRAM_SOCKET_A), readTrim(0), accessCount(0) {
+    // No chip size configured yet
+}
+
+void SRAMBus::begin(uint16_t sizeInBytes) {
+    // CRITICAL: Pin 26 differences between chips
+    // - HM62256 (32KB): Pin 26 = A13 (address line, use normally)
+    // - HM6265 (8KB):  Pin 26 = CS2 (must be HIGH to enable chip)
+    // - D4168 (8KB):   Pin 26 = CS (must be HIGH to enable chip)
+    //
+    // For 8KB chips, force A13 (PORTC bit 5) HIGH to enable CS/CS2
+    highMask = (sizeInBytes <= 8192) ? (1 << 5) : 0;
+
+    // A new part: datasheet timing until TEST SPEED grades it
+    readTrim = 0;
+}
+
+void SRAMBus::writeByte(uint16_t addr, uint8_t data) {
+    beginWrite(addr);
+    if (sockets & SRAM_SOCKET_A) PORTL = data;
+    if (sockets & SRAM_SOCKET_B) PORTK = data;
+
+    SRAMPins::WE::activate();
+    __builtin_avr_delay_cycles(SRAM_WRITE_STROBE_CYCLES);
+    SRAMPins::WE::deactivate();
+
+    endAccess();
+    accessCount++;
+}
+
+uint8_t SRAMBus::readByte(uint16_t addr) {
+    beginRead(addr);
+    __builtin_avr_delay_cycles(SRAM_READ_SETTLE_CYCLES);
+    uint8_t data = (sockets == SRAM_SOCKET_B) ? PINK : PINL;
+    endAccess();
+    accessCount++;
+    return data;
+}
+
+bool SRAMBus::sweepCells(uint16_t first, uint16_t last, bool descending,
+                         const SRAMCellOp* ops, uint8_t opCount, SRAMFaultSink& sink) {
+    if (sockets == SRAM_SOCKETS_BOTH) {
+        return sweepTrimmed<true>(first, last, descending, ops, opCount, sink);
+    }
+    return sweepTrimmed<false>(first, last, descending, ops, opCount, sink);
+}
+
+template <bool Dual>
+bool SRAMBus::sweepTrimmed(uint16_t first, uint16_t last, bool descending,
+                           const SRAMCellOp* ops, uint8_t opCount, SRAMFaultSink& sink) {
+    switch (readTrim) {
+        case 0:
+            return sweepLoop<Dual, SRAM_READ_SETTLE_CYCLES>(first, last, descending, ops, opCount, sink);
+        case 1:
+            return sweepLoop<Dual, SRAM_READ_SETTLE_CYCLES - 1>(first, last, descending, ops, opCount, sink);
+        case 2:
+            return sweepLoop<Dual, SRAM_READ_SETTLE_CYCLES - 2>(first, last, descending, ops, opCount, sink);
+        default:
+            return sweepLoop<Dual, SRAM_READ_SETTLE_CYCLES - 3>(first, last, descending, ops, opCount, sink);
+    }
+}
+
+template <bool Dual, uint8_t Settle>
+bool SRAMBus::sweepLoop(uint16_t first, uint16_t last, bool descending,
+                        const SRAMCellOp* ops, uint8_t opCount, SRAMFaultSink& sink) {
+    uint16_t addr = descending ? last : first;
+    uint16_t end = descending ? first : last;
+
+    // Start with the bus released and the chip selected
+    SRAMPins::Strobes::deactivate();
+    DDRL = 0x00;
+    PORTL = 0x00;
+    if (Dual) {
+        DDRK = 0x00;
+        PORTK = 0x00;
+    }
+    setAddress(addr);
+    selectChips();
+
+    for (;;) {
+        for (uint8_t i = 0; i < opCount; i++) {
+            if (ops[i].write) {
+                DDRL = 0xFF;
+                PORTL = ops[i].data;
+                if (Dual) {
+                    DDRK = 0xFF;
+                    PORTK = ops[i].data;
+                }
+                SRAMPins::WE::activate();
+                __builtin_avr_delay_cycles(SRAM_WRITE_STROBE_CYCLES);
+                SRAMPins::WE::deactivate();
+
+                // Release bus and pull-ups so a floating line can't read back our data
+                DDRL = 0x00;
+                PORTL = 0x00;
+                if (Dual) {
+                    DDRK = 0x00;
+                    PORTK = 0x00;
+                }
+            } else {
+                SRAMPins::OE::activate();
+                __builtin_avr_delay_cycles(Settle);
+                uint8_t actual = PINL;
+                uint8_t actualB = Dual ? (uint8_t)PINK : ops[i].data;
+                SRAMPins::OE::deactivate();
+
+                if ((actual != ops[i].data && !sink.onFault(addr, ops[i].data, actual, ops[i].tag)) ||
+                    (actualB != ops[i].data &&
+                     !sink.onFault(addr, ops[i].data, actualB, ops[i].tag | SRAM_TAG_SOCKET_B))) {
+                    endAccess();
+                    uint16_t cells = descending ? (uint16_t)(last - addr) : (uint16_t)(addr - first);
+                    accessCount += (uint32_t)cells * opCount + i + 1;
+                    return false;
+                }
+            }
+        }
+
+        if (addr == end) break;
+        if (descending) {
+            addr--;
+            if ((uint8_t)addr == 0xFF) setHighByte(addr);
+        } else {
+            addr++;
+            if ((uint8_t)addr == 0) setHighByte(addr);
+        }
+        PORTA = (uint8_t)addr;
+    }
+
+    endAccess();
+    accessCount += ((uint16_t)(last - first) + 1UL) * opCount;
+    return true;
+}
@@ -5,9 +5,13 @@
  */
 
 #include "hardware/Timer3.h"
+#include <avr/interrupt.h>
+
+// Fast PWM needs TOP >= 3; below that (above 2 MHz) the timer runs in CTC
+static constexpr uint16_t PWM_MIN_TOP = 3;
 
 Timer3Clock::Timer3Clock()
-    : currentFrequency(0), isRunning(false), prescalerBits(0) {
+    : currentFrequency(0), isRunning(false), prescalerBits(0), prescaler(1), top(0) {
     // Initialize in stopped state
 }
 
@@ -16,22 +20,10 @@ void Timer3Clock::configure(uint32_t frequency) {
     stop();
 
     // Calculate optimal prescaler and OCR3A value
-    uint16_t ocr3a = 0;
-    prescalerBits = selectPrescaler(frequency, ocr3a);
-
-    // Configure Timer3 for CTC mode with toggle output
-    // TCCR3A: COM3A0 = 1 (toggle OC3A on compare), WGM3[1:0] = 00
-    TCCR3A = (1 << COM3A0);
-
-    // TCCR3B: WGM32 = 1 (CTC mode), CS3x = 0 (timer stopped)
-    // Prescaler bits will be set by start()
-    TCCR3B = (1 << WGM32);
+    prescalerBits = selectPrescaler(frequency, top, prescaler);
 
-    // Set compare value
-    OCR3A = ocr3a;
-
-    // Clear timer counter (clean start)
-    TCNT3 = 0;
+    // Mode, compare value and counter; prescaler bits will be set by start()
+    load();
 
     // Set PE3 (pin 5) as OUTPUT for hardware PWM
     DDRE |= (1 << DDE3);
@@ -45,8 +37,8 @@ void Timer3Clock::configure(uint32_t frequency) {
 
 void Timer3Clock::start() {
     // Set prescaler bits to start timer
-    // Keep WGM32 bit, add prescaler selection
-    TCCR3B = (1 << WGM32) | prescalerBits;
+    // Keep the waveform bits, add prescaler selection
+    TCCR3B = waveformB() | prescalerBits;
 
     // Mark as running
     isRunning = true;
@@ -66,15 +58,90 @@ void Timer3Clock::stop() {
     isRunning = false;
 }
 
+void Timer3Clock::retune(uint32_t frequency) {
+    if (!isRunning) {
+        configure(frequency);
+        return;
+    }
+
+    uint16_t newTop = 0;
+    uint16_t newPrescaler = 1;
+    uint8_t newBits = selectPrescaler(frequency, newTop, newPrescaler);
+    currentFrequency = frequency;
+
+    if (newBits == prescalerBits && newTop >= PWM_MIN_TOP && top >= PWM_MIN_TOP) {
+        // Double-buffered: loads at BOTTOM, after the current half period
+        top = newTop;
+        uint8_t sreg = SREG;
+        cli();
+        OCR3A = newTop;  // 16-bit write through TEMP
+        SREG = sreg;
+        return;
+    }
+
+    // Prescaler or mode change: reload just after the output toggled.
+    // Interrupts stay on while waiting; a late ISR only stretches the half period.
+    TIFR3 = (1 << OCF3A);
+    while (!(TIFR3 & (1 << OCF3A))) {
+    }
+
+    uint8_t sreg = SREG;
+    cli();
+    prescalerBits = newBits;
+    prescaler = newPrescaler;
+    top = newTop;
+    load();
+    TCCR3B = waveformB() | prescalerBits;
+    SREG = sreg;
+}
+
 uint32_t Timer3Clock::getFrequency() const {
     return currentFrequency;
 }
 
+uint32_t Timer3Clock::getPeriodCycles() const {
+    return 2UL * prescaler * ((uint32_t)top + 1);
+}
+
+uint32_t Timer3Clock::getActualFrequency(uint16_t* milliHz) const {
+    if (currentFrequency == 0) {
+        if (milliHz != nullptr) *milliHz = 0;
+        return 0;
+    }
+
+    uint32_t period = getPeriodCycles();
+    if (milliHz != nullptr) {
+        // Remainder < period <= 2^27: the product needs 64 bits
+        *milliHz = (uint16_t)(((uint64_t)(F_CPU % period) * 1000) / period);
+    }
+    return F_CPU / period;
+}
+
+void Timer3Clock::load() {
+    // Normal mode while OCR3A is written: not buffered, used from the first count.
+    // OC3A stays connected, so a running output holds its level.
+    TCCR3B = 0;
+    TCCR3A = (1 << COM3A0);
+    OCR3A = top;
+    TCNT3 = 0;
+
+    // TCCR3A: COM3A0 = 1 (toggle OC3A on compare), WGM3[1:0] = 11 (Fast PWM) or 00 (CTC)
+    if (top >= PWM_MIN_TOP) {
+        TCCR3A = (1 << COM3A0) | (1 << WGM31) | (1 << WGM30);
+    }
+    TCCR3B = waveformB();
+}
+
+uint8_t Timer3Clock::waveformB() const {
+    // WGM3 = 1111 (Fast PWM, TOP = OCR3A) or 0100 (CTC)
+    return (top >= PWM_MIN_TOP) ? (1 << WGM33) | (1 << WGM32) : (1 << WGM32);
+}
+
 bool Timer3Clock::running() const {
     return isRunning;
 }
 
-uint8_t Timer3Clock::selectPrescaler(uint32_t frequency, uint16_t& ocr3a) {
+uint8_t Timer3Clock::selectPrescaler(uint32_t frequency, uint16_t& ocr3a, uint16_t& division) {
     // Prescaler values and corresponding CS3x bits
     const uint16_t prescalers[] = {1, 8, 64, 256, 1024};
     const uint8_t csBits[] = {
@@ -94,6 +161,7 @@ uint8_t Timer3Clock::selectPrescaler(uint32_t frequency, uint16_t& ocr3a) {
         // Check if result is valid (must be 1-65536, stored as 0-65535)
         if (calc > 0 && calc <= 65536) {
             ocr3a = (uint16_t)(calc - 1);
+            division = prescalers[i];
             return csBits[i];
         }
     }
@@ -101,5 +169,6 @@ uint8_t Timer3Clock::selectPrescaler(uint32_t frequency, uint16_t& ocr3a) {
     // If no prescaler works (frequency too low), use largest prescaler
     // and clamp OCR3A to maximum
     ocr3a = 65535;
+    division = 1024;
     return csBits[4];  // clk/1024
 }
@@ -0,0 +1,215 @@
+/**
+ * Z80Bus.cpp
+ *
+ * Implementation of the Z80 bus-cycle engine
+ */
+
+#include "hardware/Z80Bus.h"
+#include "hardware/CycleCounter.h"
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+Z80Bus::Z80Bus()
+    : rom(nullptr), romSize(0), map(nullptr), useWait(false), noWaitLimitHz(z80NoWaitLimitHz()), trace(nullptr) {
+}
+
+void Z80Bus::configurePins() {
+    // Address and data bus: INPUT, the Z80 drives them (no pull-ups)
+    DDRA = 0x00;
+    DDRC = 0x00;
+    PORTA = 0x00;
+    PORTC = 0x00;
+    DDRL = 0x00;
+    PORTL = 0x00;
+
+    // PG0-PG3: /MREQ, /IORQ, /RD, /WR inputs
+    Z80Pins::BusControl::input();
+
+    // PH3-PH5: /M1, /RFSH, /BUSACK inputs; PH6: /RESET output, held LOW
+    Z80Pins::Status::input();
+    Z80Pins::Reset::activate();
+    Z80Pins::Reset::output();
+
+    // PB4-PB7: /WAIT, /INT, /NMI, /BUSREQ outputs, all HIGH (inactive)
+    Z80Pins::Requests::outputInactive();
+
+    // PE4: /HALT input
+    Z80Pins::Halt::input();
+
+    // 6502-only pins (PD0, PD1, PD3): INPUT, not used
+    IC6502Pins::PhaseMonitors::input();
+    IC6502Pins::SetOverflow::input();
+}
+
+void Z80Bus::loadRom(const uint8_t* image, uint16_t size) {
+    rom = image;
+    romSize = (size <= Z80_RAM_BASE) ? size : Z80_RAM_BASE;
+}
+
+void Z80Bus::clearRam(uint8_t value) {
+    memset(cpuRamWindow, value, sizeof(cpuRamWindow));
+}
+
+uint8_t Z80Bus::peekRam(uint16_t addr) const {
+    uint16_t offset = addr - Z80_RAM_BASE;
+    return (offset < Z80_RAM_SIZE) ? cpuRamWindow[offset] : Z80_UNMAPPED;
+}
+
+void Z80Bus::pokeRam(uint16_t addr, uint8_t value) {
+    uint16_t offset = addr - Z80_RAM_BASE;
+    if (offset < Z80_RAM_SIZE) cpuRamWindow[offset] = value;
+}
+
+void Z80Bus::selectWait(Z80WaitMode mode, uint32_t clockHz) {
+    if (mode == Z80_WAIT_AUTO) {
+        useWait = clockHz > noWaitLimitHz;
+    } else {
+        useWait = (mode == Z80_WAIT_ALWAYS);
+    }
+}
+
+void Z80Bus::holdReset() {
+    Z80Pins::Reset::activate();
+}
+
+void Z80Bus::releaseReset() {
+    Z80Pins::Reset::deactivate();
+}
+
+inline uint8_t Z80Bus::lookup(uint16_t addr) const {
+    if (addr < romSize) {
+        return pgm_read_byte(rom + addr);
+    }
+    uint16_t offset = addr - Z80_RAM_BASE;
+    if (offset < Z80_RAM_SIZE) {
+        return cpuRamWindow[offset];
+    }
+    return (map != nullptr) ? map->read(addr) : Z80_UNMAPPED;
+}
+
+// Timer5 overflowed while interrupts are off: fold it in, count down the timeout
+static inline bool timedOut(uint16_t& ticks) {
+    return (TIFR5 & (1 << TOV5)) && CycleCounter::catchUp() && --ticks == 0;
+}
+
+template <bool WAIT, bool TRACE>
+void Z80Bus::serve(Z80RunResult& result, uint16_t ticks, uint32_t readLimit) {
+    using namespace Z80Pins;
+
+    for (;;) {
+        // Idle: wait for /MREQ to fall (the only tight loop that sets fmax)
+        while (!Mreq::isActive()) {
+            if (Halt::isActive()) {
+                result.end = Z80_END_HALT;
+                return;
+            }
+            if (timedOut(ticks)) {
+                result.end = Z80_END_TIMEOUT;
+                return;
+            }
+        }
+        if (WAIT) Wait::activate();
+
+        uint16_t addr = PINA | ((uint16_t)PINC << 8);
+
+        if (Rd::isActive()) {
+            // Read: byte on the bus first, bookkeeping while the Z80 latches it
+            uint8_t data = lookup(addr);
+            PORTL = data;
+            DDRL = 0xFF;
+            if (TRACE) {
+                trace->record(addr, data, M1::isActive() ? BUS_TRACE_FETCH | BUS_TRACE_READ | BUS_TRACE_MREQ
+                                                         : BUS_TRACE_READ | BUS_TRACE_MREQ);
+            }
+            if (WAIT) Wait::deactivate();
+
+            if (M1::isActive()) result.fetches++;
+            if (result.reads < Z80_TRACE_SIZE) result.trace[result.reads] = addr;
+            result.reads++;
+
+            while (Rd::isActive()) {
+                if (timedOut(ticks)) {
+                    result.end = Z80_END_TIMEOUT;
+                    return;
+                }
+            }
+            DDRL = 0x00;
+
+            if (readLimit != 0 && result.reads >= readLimit) {
+                result.end = Z80_END_LIMIT;
+                return;
+            }
+            continue;
+        }
+
+        if (Rfsh::isActive()) {
+            // Refresh: nothing to serve (the Z80 doesn't sample /WAIT here)
+            if (WAIT) Wait::deactivate();
+            result.refreshes++;
+        } else {
+            // Write: /WR falls half a T after /MREQ, data is already stable
+            while (!Wr::isActive()) {
+                if (!Mreq::isActive()) break;
+            }
+            uint8_t data = PINL;
+            bool written = Wr::isActive();
+            if (TRACE && written) trace->record(addr, data, BUS_TRACE_WRITE | BUS_TRACE_MREQ);
+            if (WAIT) Wait::deactivate();
+            if (!written) continue;  // Cycle ended without /WR (missed read)
+            result.writes++;
+
+            uint16_t offset = addr - Z80_RAM_BASE;
+            if (offset < Z80_RAM_SIZE) {
+                cpuRamWindow[offset] = data;
+            } else if (addr == Z80_STOP_ADDR) {
+                result.exitCode = data;
+                result.end = Z80_END_STOP;
+                return;
+            } else if (map != nullptr) {
+                map->write(addr, data);
+            }
+        }
+
+        while (Mreq::isActive()) {
+            if (timedOut(ticks)) {
+                result.end = Z80_END_TIMEOUT;
+                return;
+            }
+        }
+    }
+}
+
+Z80RunResult Z80Bus::run(uint16_t timeoutMs, uint32_t readLimit) {
+    Z80RunResult result;
+    memset(&result, 0, sizeof(result));
+
+    // Timeout in Timer5 overflows (4.096 ms each at 16 MHz)
+    uint32_t ticks = ((uint32_t)timeoutMs * 1000UL) / (65536UL / CycleCounter::CYCLES_PER_US) + 1;
+    if (ticks > 0xFFFF) ticks = 0xFFFF;
+
+    DDRL = 0x00;
+    Z80Pins::Wait::deactivate();
+    bool tracing = trace != nullptr && trace->begin();
+
+    uint8_t sreg = SREG;
+    cli();
+    uint32_t start = CycleCounter::now();
+    releaseReset();
+
+    if (tracing) {
+        serve<true, true>(result, (uint16_t)ticks, readLimit);
+    } else if (useWait) {
+        serve<true, false>(result, (uint16_t)ticks, readLimit);
+    } else {
+        serve<false, false>(result, (uint16_t)ticks, readLimit);
+    }
+
+    holdReset();
+    DDRL = 0x00;
+    Z80Pins::Wait::deactivate();
+    result.cycles = CycleCounter::now() - start;
+    SREG = sreg;
+
+    if (tracing) trace->end();
+    return result;
+}
@@ -21,7 +21,22 @@
 #include "utils/CommandParser.h"
 #include "utils/ModeManager.h"
 #include "hardware/Timer3.h"
+#include "hardware/CycleCounter.h"
+#include "hardware/BusTrace.h"
+#include "hardware/MemoryMap.h"
 #include "strategies/SRAMStrategy.h"
+#include "strategies/MarchTest.h"
+#include "strategies/SRAMProfiles.h"
+#include "strategies/SRAMDump.h"
+#include "strategies/Z80Strategy.h"
+#include "strategies/IC6502Strategy.h"
+#include "utils/Scheduler.h"
+#include "utils/MemoryInfo.h"
+#include "utils/HealthMonitor.h"
+#include "utils/PlanStore.h"
+#include "utils/PlanRunner.h"
+#include "utils/ProgramImage.h"
+#include "utils/ImageLoader.h"
 
 // Global instances
 UARTHandler uart;
@@ -29,162 +44,630 @@ CommandParser parser;
 ModeManager modeManager;
 Timer3Clock timer3;  // Phase 2: Clock generator for testing
 SRAMStrategy sramStrategy;  // Phase 3: SRAM testing strategy
+Z80Strategy z80Strategy;    // Phase 4: Z80 testing strategy
+IC6502Strategy cpu6502Strategy;  // Phase 5: 6502 testing strategy
+BusTrace busTrace;          // Z80/6502 bus cycles of the last (or failing) run
+MemoryMap memoryMap;        // Z80/6502 pages for TEST IMAGE (MAP command)
+SRAMDump sramDump;          // DUMP / CRC read-back of the SRAM
+Scheduler scheduler;        // Runs long tests in slices between commands
+HealthMonitor health;       // Loop and command latency for STATUS
+
+// ';' batch line ("MODE SRAM 32768; TEST MARCH CMINUS; CRC 0 32768"),
+// run in place in loop()'s line buffer, one command at a time as the
+// board goes idle
+char* batchRest = nullptr;  // Commands not started yet (nullptr: none)
+bool batchActive = false;
+bool batchTestStarted = false;  // The running command started an SRAM test
+uint16_t batchErrors = 0;   // uart.getErrorLines() before the running command
+uint8_t batchCount = 0;     // Commands started
+
+void runPlanStep(char* line);
+bool isTestRunning();
+PlanStore planStore;        // Test plan in EEPROM
+PlanRunner planRunner(planStore, uart, runPlanStep, isTestRunning);  // RUN / footswitch batch runs
+ProgramImage programImage;  // Uploaded Z80/6502 test program (TEST IMAGE)
+ImageLoader imageLoader(programImage, uart);  // LOAD block transfer
+
+// CLOCK SWEEP defaults: Z80 engine range, searched to 1% resolution
+constexpr uint32_t CLOCK_SWEEP_MIN_HZ = 100000;
+constexpr uint32_t CLOCK_SWEEP_MAX_HZ = 4000000;
+constexpr uint8_t CLOCK_SWEEP_RESOLUTION_PERCENT = 1;
+
+// MODE <IC> keywords, in ModeKeyword order
+static const char KEY_SRAM[] PROGMEM = "SRAM";
+static const char KEY_Z80[] PROGMEM = "Z80";
+static const char KEY_6502[] PROGMEM = "6502";
+static const char* const MODE_KEYWORDS[] PROGMEM = {KEY_SRAM, KEY_Z80, KEY_6502};
+
+enum ModeKeyword : int8_t {
+    MODE_KEY_SRAM,
+    MODE_KEY_Z80,
+    MODE_KEY_6502,
+    MODE_KEY_COUNT
+};
+
+static_assert(sizeof(MODE_KEYWORDS) / sizeof(MODE_KEYWORDS[0]) == MODE_KEY_COUNT, "One keyword per IC");
+
+// Sub-option keywords, shared by the tables below
+static const char KEY_ON[] PROGMEM = "ON";
+static const char KEY_OFF[] PROGMEM = "OFF";
+static const char KEY_RESET[] PROGMEM = "RESET";
+static const char KEY_CLEAR[] PROGMEM = "CLEAR";
+static const char KEY_DUAL[] PROGMEM = "DUAL";
+static const char KEY_SOCKET_B[] PROGMEM = "B";
+static const char KEY_SWEEP[] PROGMEM = "SWEEP";
+static const char KEY_FOREVER[] PROGMEM = "FOREVER";
+static const char KEY_SPEED[] PROGMEM = "SPEED";
+static const char KEY_PROFILE[] PROGMEM = "PROFILE";
+static const char KEY_RANDOM[] PROGMEM = "RANDOM";
+static const char KEY_MARCH[] PROGMEM = "MARCH";
+static const char KEY_FULL[] PROGMEM = "FULL";
+static const char KEY_QUICK[] PROGMEM = "QUICK";
+static const char KEY_FUSED[] PROGMEM = "FUSED";
+static const char KEY_MAP[] PROGMEM = "MAP";
+static const char KEY_LOOP[] PROGMEM = "LOOP";
+static const char KEY_BUDGET[] PROGMEM = "BUDGET";
+static const char KEY_SEED[] PROGMEM = "SEED";
+static const char KEY_PASSES[] PROGMEM = "PASSES";
+static const char KEY_IMAGE[] PROGMEM = "IMAGE";
+static const char KEY_FMAX[] PROGMEM = "FMAX";
+static const char KEY_STEP[] PROGMEM = "STEP";
+static const char KEY_TEXT[] PROGMEM = "TEXT";
+static const char KEY_BIN[] PROGMEM = "BIN";
+static const char KEY_DUMP[] PROGMEM = "DUMP";
+static const char KEY_LIST[] PROGMEM = "LIST";
+static const char KEY_ADD[] PROGMEM = "ADD";
+static const char KEY_REPEAT[] PROGMEM = "REPEAT";
+static const char KEY_STOP[] PROGMEM = "STOP";
+static const char KEY_SAVE[] PROGMEM = "SAVE";
+static const char KEY_RAM[] PROGMEM = "RAM";
+static const char KEY_FAULT[] PROGMEM = "FAULT";
+static const char KEY_OPEN[] PROGMEM = "OPEN";
+
+// OFF/ON: the index is the setting (PLAN STOP)
+static const char* const SWITCH_KEYWORDS[] PROGMEM = {KEY_OFF, KEY_ON};
+constexpr uint8_t SWITCH_KEY_COUNT = 2;
+
+// SRAM TEST: the first word picks the tests, options follow it
+static const char* const TEST_SELECTORS[] PROGMEM = {KEY_SPEED, KEY_PROFILE, KEY_RANDOM, KEY_MARCH};
+
+enum TestSelector : int8_t {
+    TEST_SEL_SPEED,
+    TEST_SEL_PROFILE,
+    TEST_SEL_RANDOM,
+    TEST_SEL_MARCH,
+    TEST_SEL_COUNT
+};
+
+static const char* const TEST_OPTIONS[] PROGMEM = {
+    KEY_FULL, KEY_QUICK, KEY_FUSED, KEY_MAP, KEY_LOOP, KEY_BUDGET, KEY_SEED, KEY_PASSES
+};
+
+enum TestOption : int8_t {
+    TEST_OPT_FULL,
+    TEST_OPT_QUICK,      // [<stride>]
+    TEST_OPT_FUSED,
+    TEST_OPT_MAP,
+    TEST_OPT_LOOP,       // <n>|FOREVER
+    TEST_OPT_BUDGET,     // <ms>
+    TEST_OPT_SEED,       // <n>
+    TEST_OPT_PASSES,     // <k>
+    TEST_OPT_COUNT
+};
+
+// Z80 / 6502 TEST words (FMAX is Z80 only, STEP 6502 only)
+static const char* const CPU_TEST_KEYWORDS[] PROGMEM = {KEY_IMAGE, KEY_FMAX, KEY_STEP};
+
+enum CpuTestKeyword : int8_t {
+    CPU_TEST_IMAGE,
+    CPU_TEST_FMAX,
+    CPU_TEST_STEP,
+    CPU_TEST_COUNT
+};
+
+static const char* const PROTO_KEYWORDS[] PROGMEM = {KEY_TEXT, KEY_BIN};
+
+enum ProtoKeyword : int8_t {
+    PROTO_KEY_TEXT,
+    PROTO_KEY_BIN,
+    PROTO_KEY_COUNT
+};
+
+static const char* const PERF_KEYWORDS[] PROGMEM = {KEY_RESET, KEY_ON, KEY_OFF};
+
+enum PerfKeyword : int8_t {
+    PERF_KEY_RESET,
+    PERF_KEY_ON,
+    PERF_KEY_OFF,
+    PERF_KEY_COUNT
+};
+
+static const char* const TRACE_KEYWORDS[] PROGMEM = {KEY_ON, KEY_OFF, KEY_CLEAR, KEY_DUMP, KEY_LIST};
+
+enum TraceKeyword : int8_t {
+    TRACE_KEY_ON,
+    TRACE_KEY_OFF,
+    TRACE_KEY_CLEAR,
+    TRACE_KEY_DUMP,
+    TRACE_KEY_LIST,      // [<n>]
+    TRACE_KEY_COUNT
+};
+
+static const char* const PLAN_KEYWORDS[] PROGMEM = {KEY_ADD, KEY_CLEAR, KEY_REPEAT, KEY_STOP, KEY_RESET};
+
+enum PlanKeyword : int8_t {
+    PLAN_KEY_ADD,        // <command>
+    PLAN_KEY_CLEAR,
+    PLAN_KEY_REPEAT,     // <n>
+    PLAN_KEY_STOP,       // ON|OFF
+    PLAN_KEY_RESET,
+    PLAN_KEY_COUNT
+};
+
+static const char* const LOAD_KEYWORDS[] PROGMEM = {KEY_SAVE, KEY_CLEAR};
+
+enum LoadKeyword : int8_t {
+    LOAD_KEY_SAVE,
+    LOAD_KEY_CLEAR,
+    LOAD_KEY_COUNT
+};
+
+static const char* const MAP_KEYWORDS[] PROGMEM = {KEY_CLEAR, KEY_RAM, KEY_FAULT, KEY_OPEN};
+
+enum MapKeyword : int8_t {
+    MAP_KEY_CLEAR,
+    MAP_KEY_RAM,         // <addr> <len>
+    MAP_KEY_FAULT,       // <addr> <len>
+    MAP_KEY_OPEN,        // <addr> <len>
+    MAP_KEY_COUNT
+};
+
+static_assert(sizeof(SWITCH_KEYWORDS) / sizeof(SWITCH_KEYWORDS[0]) == SWITCH_KEY_COUNT, "OFF and ON");
+static_assert(sizeof(TEST_SELECTORS) / sizeof(TEST_SELECTORS[0]) == TEST_SEL_COUNT, "One keyword per selector");
+static_assert(sizeof(TEST_OPTIONS) / sizeof(TEST_OPTIONS[0]) == TEST_OPT_COUNT, "One keyword per option");
+static_assert(sizeof(CPU_TEST_KEYWORDS) / sizeof(CPU_TEST_KEYWORDS[0]) == CPU_TEST_COUNT, "One keyword per word");
+static_assert(sizeof(PROTO_KEYWORDS) / sizeof(PROTO_KEYWORDS[0]) == PROTO_KEY_COUNT, "One keyword per protocol");
+static_assert(sizeof(PERF_KEYWORDS) / sizeof(PERF_KEYWORDS[0]) == PERF_KEY_COUNT, "One keyword per option");
+static_assert(sizeof(TRACE_KEYWORDS) / sizeof(TRACE_KEYWORDS[0]) == TRACE_KEY_COUNT, "One keyword per option");
+static_assert(sizeof(PLAN_KEYWORDS) / sizeof(PLAN_KEYWORDS[0]) == PLAN_KEY_COUNT, "One keyword per option");
+static_assert(sizeof(LOAD_KEYWORDS) / sizeof(LOAD_KEYWORDS[0]) == LOAD_KEY_COUNT, "One keyword per option");
+static_assert(sizeof(MAP_KEYWORDS) / sizeof(MAP_KEYWORDS[0]) == MAP_KEY_COUNT, "One keyword per option");
+
+/**
+ * SRAM TEST options after the test selection
+ */
+struct SRAMTestOptions {
+    bool fullTest = false;
+    bool quickTest = false;
+    bool fused = false;
+    bool mapFaults = false;
+    uint16_t quickStride = SAMPLE_DEFAULT_STRIDE;
+    bool strideSet = false;
+    uint32_t loops = 0;
+    bool loopSet = false;
+    uint32_t budget = 0;
+    bool budgetSet = false;
+    uint32_t seed = 0;
+    bool seedSet = false;
+    uint32_t passes = 1;
+    bool passesSet = false;
+};
 
 // Function declarations
-void handleModeCommand(const String& parameter);
-void handleTestCommand(const String& parameter);
-void handleStatusCommand();
+void dispatchOperatorCommand(char* line);
+void startBatch(char* line);
+void runBatch();
+bool isBatchWaiting();
+void dispatchCommand(const ParsedCommand& cmd);
+void handleModeCommand(char* parameter);
+void handleTestCommand(char* parameter);
+void handleZ80TestCommand(Z80Strategy* z80, char* param);
+void handleSRAMSpeedCommand(SRAMStrategy* sram, char* param);
+void handle6502TestCommand(IC6502Strategy* cpu, char* param);
+bool parseSRAMTestOptions(char* word, char* cursor, SRAMTestOptions& options);
+bool buildSRAMTestPlan(SRAMStrategy* sram, int8_t selector, const char* word, const char* name,
+                       const SRAMTestOptions& options, SRAMRunPlan& plan);
+void sendSRAMTestUsage();
+int8_t selectSRAMProfile(SRAMStrategy* sram, const char* name, uint32_t budgetMs);
+uint32_t estimateSRAMProfileMs(SRAMStrategy* sram, uint8_t profile);
+void sendSRAMProfileList(SRAMStrategy* sram);
+void handleStatusCommand(char* parameter);
+void sendHealthReport();
+void sendHealthRecord(uint8_t stat, uint8_t command, uint32_t value);
 void handleResetCommand();
 void handleHelpCommand();
-void handleClockCommand(const String& parameter);
+void handleClockCommand(char* parameter);
 void handleClockStopCommand();
+void handleClockSweep(char* args);
+bool clockSweepPasses(uint32_t frequency);
+void handleProtoCommand(char* parameter);
+void handleAbortCommand();
+void handlePauseCommand();
+void handleResumeCommand();
+void handlePerfCommand(char* parameter);
+void handleTraceCommand(char* parameter);
+void sendTraceDump();
+void sendTraceList(uint32_t count);
+void handlePlanCommand(char* parameter);
+void handleRunCommand();
+void handleReadBackCommand(char* parameter, bool dump);
+void handleLoadCommand(char* parameter);
+void handleMapCommand(char* parameter);
+void sendMemoryMap();
+bool requireImage();
+bool refuseWhileTransferring();
 
 void setup() {
+    // Stack high-water mark for STATUS (before anything runs deep)
+    paintStack();
+
+    // Timer5 cycle counter for PERF (before any UART output is timed)
+    CycleCounter::begin();
+
     // Initialize UART communication
     uart.begin(115200);
 
     // Send startup message
-    uart.sendInfo("========================================");
-    uart.sendInfo("  Multi-IC Tester v1.0");
-    uart.sendInfo("  Arduino Mega 2560");
-    uart.sendInfo("========================================");
-    uart.sendInfo("");
-    uart.sendInfo("Supported ICs:");
-    uart.sendInfo("  - Z80 CPU (40-pin DIP)");
-    uart.sendInfo("  - 6502 CPU (40-pin DIP)");
-    uart.sendInfo("  - HM62256 SRAM (28-pin DIP)");
-    uart.sendInfo("");
-    uart.sendInfo("Type HELP for command list");
-    uart.sendInfo("");
+    uart.sendInfo(F("========================================"));
+    uart.sendInfo(F("  Multi-IC Tester v1.0"));
+    uart.sendInfo(F("  Arduino Mega 2560"));
+    uart.sendInfo(F("========================================"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("Supported ICs:"));
+    uart.sendInfo(F("  - Z80 CPU (40-pin DIP)"));
+    uart.sendInfo(F("  - 6502 CPU (40-pin DIP)"));
+    uart.sendInfo(F("  - HM62256 SRAM (28-pin DIP)"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("Type HELP for command list"));
+    uart.sendInfo(F(""));
+
+    // Stored plan: the runner's slice comes after the test it waits for
+    planStore.load();
+    planRunner.begin();
+    programImage.load();
+    sramDump.setUARTHandler(&uart);
+    scheduler.add(&sramStrategy);
+    scheduler.add(&sramDump);
+    scheduler.add(&imageLoader);
+    scheduler.add(&planRunner);
 }
 
 void loop() {
-    // Check if command received
-    if (uart.available()) {
-        // Read and parse command
-        String line = uart.readLine();
+    uint32_t start = CycleCounter::now();
 
-        // Skip empty lines
-        if (line.length() == 0) {
-            return;
+    // Check if command received (running tests also poll between slices);
+    // lines after a ';' batch wait until it is done, so a batch keeps
+    // its commands in line
+    static char line[UARTHandler::RX_LINE_SIZE];
+    if (batchActive) {
+        runBatch();
+    }
+    else if (uart.readLine(line, sizeof(line))) {
+        if (strchr(line, ';') != nullptr) {
+            startBatch(line);
+        } else {
+            dispatchOperatorCommand(line);
         }
+    }
 
-        ParsedCommand cmd = parser.parse(line);
+    // Give the running test (if any) its next time slice
+    scheduler.run();
 
-        // Handle command
-        switch (cmd.type) {
-            case MODE:
-                handleModeCommand(cmd.parameter);
-                break;
+    health.recordLoop(CycleCounter::now() - start);
+}
 
-            case TEST:
-                handleTestCommand(cmd.parameter);
-                break;
+/**
+ * Execute a command typed by the operator
+ * While a plan runs (output muted), only STATUS, HELP, ABORT and the
+ * PLAN listing are accepted, and their replies are sent
+ */
+void dispatchOperatorCommand(char* line) {
+    uint32_t start = CycleCounter::now();
+    ParsedCommand cmd = parser.parse(line);
+    if (!planRunner.isRunning()) {
+        dispatchCommand(cmd);
+        health.recordCommand(cmd.type, CycleCounter::now() - start);
+        return;
+    }
 
-            case STATUS:
-                handleStatusCommand();
-                break;
+    uart.setMuted(false);
+    bool allowed = cmd.type == STATUS || cmd.type == HELP || cmd.type == ABORT ||
+                   (cmd.type == PLAN && cmd.parameter[0] == '\0');
+    if (allowed) {
+        dispatchCommand(cmd);
+    } else {
+        uart.sendError(F("Plan running (ABORT to stop)"));
+    }
+    uart.setMuted(true);
+    health.recordCommand(cmd.type, CycleCounter::now() - start);
+}
 
-            case RESET:
-                handleResetCommand();
-                break;
+/**
+ * Start a ';' line: its commands run in order, each once the previous one
+ * (and any test, DUMP/CRC, upload or plan it started) has finished.
+ * The batch stops at the first command that replies ERROR or whose SRAM
+ * test does not pass. The commands are split in place in line, which
+ * loop() leaves alone until the batch is done.
+ */
+void startBatch(char* line) {
+    batchRest = line;
+    batchActive = true;
+    batchTestStarted = false;
+    batchErrors = uart.getErrorLines();
+    batchCount = 0;
+    runBatch();
+}
 
-            case HELP:
-                handleHelpCommand();
-                break;
+/**
+ * Next step of the batch (each main loop pass while one is active)
+ * ABORT and STATUS are answered at once, other lines wait their turn
+ */
+void runBatch() {
+    uart.poll();
+    if (uart.takeCommand(F("ABORT"))) {
+        if (isBatchWaiting()) {
+            handleAbortCommand();
+        }
+        batchActive = false;
+        uart.sendErrorf(F("Batch ABORTED at command %u"), batchCount);
+        return;
+    }
+    if (uart.takeCommand(F("STATUS"))) {
+        char status[] = "STATUS";
+        dispatchOperatorCommand(status);
+    }
+    if (isBatchWaiting()) {
+        return;
+    }
 
-            case CLOCK:
-                handleClockCommand(cmd.parameter);
-                break;
+    // The finished command failed: skip the rest
+    bool testFailed = batchTestStarted && !sramStrategy.didLastRunPass();
+    if (batchCount != 0 && (uart.getErrorLines() != batchErrors || testFailed)) {
+        batchActive = false;
+        while (batchRest != nullptr && *batchRest == ' ') batchRest++;
+        if (batchRest != nullptr && *batchRest != '\0') {
+            uart.sendErrorf(F("Batch stopped at command %u, not run: %s"), batchCount, batchRest);
+        } else {
+            uart.sendErrorf(F("Batch stopped at command %u"), batchCount);
+        }
+        return;
+    }
 
-            case CLOCKSTOP:
-                handleClockStopCommand();
-                break;
+    char* command = CommandParser::nextCommand(batchRest);
+    if (command == nullptr) {
+        batchActive = false;
+        uart.sendOKf(F("Batch done: %u commands"), batchCount);
+        return;
+    }
 
-            case INVALID:
-                uart.sendError("Invalid command. Type HELP for command list.");
-                break;
-        }
+    batchErrors = uart.getErrorLines();
+    batchCount++;
+    dispatchOperatorCommand(command);
+    batchTestStarted = sramStrategy.isRunning();
+}
+
+/**
+ * Background work a batch command started is still going
+ */
+bool isBatchWaiting() {
+    return isTestRunning() || imageLoader.isActive() || planRunner.isRunning();
+}
+
+/**
+ * PlanRunner callbacks: run one stored step, check for a background test
+ */
+void runPlanStep(char* line) {
+    dispatchCommand(parser.parse(line));
+}
+
+bool isTestRunning() {
+    return sramStrategy.isRunning() || sramDump.isActive();
+}
+
+/**
+ * Execute one parsed command
+ */
+void dispatchCommand(const ParsedCommand& cmd) {
+    // Handle command
+    switch (cmd.type) {
+        case MODE:
+            handleModeCommand(cmd.parameter);
+            break;
+
+        case TEST:
+            handleTestCommand(cmd.parameter);
+            break;
+
+        case STATUS:
+            handleStatusCommand(cmd.parameter);
+            break;
+
+        case RESET:
+            handleResetCommand();
+            break;
+
+        case HELP:
+            handleHelpCommand();
+            break;
+
+        case CLOCK:
+            handleClockCommand(cmd.parameter);
+            break;
+
+        case CLOCKSTOP:
+            handleClockStopCommand();
+            break;
+
+        case PROTO:
+            handleProtoCommand(cmd.parameter);
+            break;
+
+        case ABORT:
+            handleAbortCommand();
+            break;
+
+        case PAUSE:
+            handlePauseCommand();
+            break;
+
+        case RESUME:
+            handleResumeCommand();
+            break;
+
+        case PERF:
+            handlePerfCommand(cmd.parameter);
+            break;
+
+        case TRACE:
+            handleTraceCommand(cmd.parameter);
+            break;
+
+        case PLAN:
+            handlePlanCommand(cmd.parameter);
+            break;
+
+        case RUN:
+            handleRunCommand();
+            break;
+
+        case DUMP:
+            handleReadBackCommand(cmd.parameter, true);
+            break;
+
+        case CRC:
+            handleReadBackCommand(cmd.parameter, false);
+            break;
+
+        case LOAD:
+            handleLoadCommand(cmd.parameter);
+            break;
+
+        case MAP:
+            handleMapCommand(cmd.parameter);
+            break;
+
+        case INVALID:
+            uart.sendError(F("Invalid command. Type HELP for command list."));
+            break;
     }
 }
 
 /**
  * Handle MODE command
- * Supports: MODE Z80, MODE 6502, MODE SRAM <size>
+ * Supports: MODE Z80, MODE 6502, MODE SRAM <size> [DUAL]
  */
-void handleModeCommand(const String& parameter) {
+void handleModeCommand(char* parameter) {
+    if (sramStrategy.isRunning()) {
+        uart.sendError(F("Test already running (ABORT to stop)"));
+        return;
+    }
+    if (refuseWhileTransferring()) return;
+
     // Check if parameter provided
-    if (parameter.length() == 0) {
-        uart.sendError("Missing IC type. Usage: MODE <IC>");
-        uart.sendInfo("IC types: Z80, 6502, SRAM <size>");
-        uart.sendInfo("Example: MODE SRAM 32768");
+    if (parameter[0] == '\0') {
+        uart.sendError(F("Missing IC type. Usage: MODE <IC>"));
+        uart.sendInfo(F("IC types: Z80, 6502, SRAM <size>"));
+        uart.sendInfo(F("Example: MODE SRAM 32768"));
         return;
     }
 
-    // Check for SRAM mode
-    if (parameter.startsWith("SRAM ")) {
-        // Extract size parameter
-        String sizeStr = parameter.substring(5);
-        sizeStr.trim();
+    char* cursor = parameter;
+    int8_t ic = CommandParser::findKeyword(CommandParser::nextToken(cursor), MODE_KEYWORDS, MODE_KEY_COUNT);
 
-        if (sizeStr.length() == 0) {
-            uart.sendError("Missing SRAM size. Usage: MODE SRAM <size>");
-            uart.sendInfo("Valid sizes: 8192 (8KB), 32768 (32KB)");
+    if (ic == MODE_KEY_SRAM) {
+        const char* sizeStr = CommandParser::nextToken(cursor);
+        if (*sizeStr == '\0' || strcmp_P(sizeStr, KEY_DUAL) == 0) {
+            uart.sendError(F("Missing SRAM size. Usage: MODE SRAM <size>"));
+            uart.sendInfo(F("Valid sizes: 8192 (8KB), 32768 (32KB)"));
             return;
         }
 
-        uint32_t size = sizeStr.toInt();
+        // DUAL: second chip in socket B (PORTK data, PF0 /CS)
+        const char* option = CommandParser::nextToken(cursor);
+        bool dual = strcmp_P(option, KEY_DUAL) == 0;
 
         // Validate size (must be power of 2 and <= 64KB)
-        if (size == 0 || size > 65536) {
-            uart.sendError("Invalid SRAM size");
-            uart.sendInfo("Valid sizes: 8192 (8KB), 32768 (32KB)");
+        uint32_t size = 0;
+        bool valid = CommandParser::parseNumber(sizeStr, size, 10) && (dual || *option == '\0');
+        if (!valid || *cursor != '\0' || size == 0 || size > 65536) {
+            uart.sendError(F("Invalid SRAM size"));
+            uart.sendInfo(F("Valid sizes: 8192 (8KB), 32768 (32KB)"));
             return;
         }
 
         // Configure SRAM strategy
         sramStrategy.setSize((uint16_t)size);
         sramStrategy.setUARTHandler(&uart);
+        sramStrategy.setDualSocket(dual);
         sramStrategy.configurePins();
         modeManager.setStrategy(&sramStrategy, ModeManager::SRAM62256);
 
-        String msg = "SRAM mode set: " + String((uint16_t)size) + " bytes";
-        uart.sendOK(msg.c_str());
+        uart.sendOKf(F("SRAM mode set: %u bytes%S"), (uint16_t)size, dual ? PSTR(", sockets A and B") : PSTR(""));
 
         if (size == 32768) {
-            uart.sendInfo("Configured for HM62256 (32KB)");
+            uart.sendInfo(F("Configured for HM62256 (32KB)"));
         } else if (size == 8192) {
-            uart.sendInfo("Configured for HM6265/D4168 (8KB)");
+            uart.sendInfo(F("Configured for HM6265/D4168 (8KB)"));
+        }
+        if (dual) {
+            uart.sendInfo(F("Dual socket: both chips tested together, results per socket"));
         }
 
         return;
     }
 
-    // Check other IC types
-    if (parameter == "Z80") {
-        uart.sendError("Z80 strategy not implemented yet");
-        uart.sendInfo("Will be available in Phase 4");
+    // Check other IC types (no options)
+    if (*cursor != '\0') {
+        ic = -1;
+    }
+    if (ic == MODE_KEY_Z80) {
+        z80Strategy.setUARTHandler(&uart);
+        z80Strategy.setClock(&timer3);
+        z80Strategy.setTrace(&busTrace);
+        z80Strategy.setMemoryMap(&memoryMap);
+        z80Strategy.configurePins();
+        modeManager.setStrategy(&z80Strategy, ModeManager::Z80);
+
+        uart.sendOK(F("Z80 mode set"));
+        uart.sendInfo(F("Z80 held in reset, clock on PE3 starts with TEST"));
     }
-    else if (parameter == "6502") {
-        uart.sendError("6502 strategy not implemented yet");
-        uart.sendInfo("Will be available in Phase 5");
+    else if (ic == MODE_KEY_6502) {
+        cpu6502Strategy.setUARTHandler(&uart);
+        cpu6502Strategy.setClock(&timer3);
+        cpu6502Strategy.setTrace(&busTrace);
+        cpu6502Strategy.setMemoryMap(&memoryMap);
+        cpu6502Strategy.configurePins();
+        modeManager.setStrategy(&cpu6502Strategy, ModeManager::IC6502);
+
+        uart.sendOK(F("6502 mode set"));
+        uart.sendInfo(F("6502 held in reset, TEST clocks it from firmware"));
     }
     else {
-        uart.sendError("Invalid IC type");
-        uart.sendInfo("IC types: Z80, 6502, SRAM <size>");
-        uart.sendInfo("Example: MODE SRAM 32768");
+        uart.sendError(F("Invalid IC type"));
+        uart.sendInfo(F("IC types: Z80, 6502, SRAM <size>"));
+        uart.sendInfo(F("Example: MODE SRAM 32768"));
     }
 }
 
 /**
  * Handle TEST command
- * Supports: TEST, TEST FULL, TEST RANDOM, TEST RANDOM FULL, TEST <N>, TEST <N> FULL
+ * Supports: TEST, TEST QUICK, TEST FULL, TEST RANDOM, TEST RANDOM FULL,
+ *           TEST <N>, TEST <N> FULL, TEST MARCH <name> [QUICK],
+ *           QUICK <stride> on any QUICK form (sampling interval, default 128),
+ *           FUSED flag on the multi-test forms (tests 1/4/5 in one sweep),
+ *           MAP flag on any form (continue on error, fault map report),
+ *           SEED <n> / PASSES <k> on forms with test 7 (random pattern),
+ *           TEST PROFILE [<name>] (fast-fail tiers), TEST BUDGET <ms>,
+ *           LOOP <n> / LOOP FOREVER after any form (soak, statistics only),
+ *           TEST SPEED [OFF] (access-time grade, read timing of later runs)
  */
-void handleTestCommand(const String& parameter) {
+void handleTestCommand(char* parameter) {
+    if (refuseWhileTransferring()) return;
+
     // Check if mode is set
     if (modeManager.getCurrentMode() == ModeManager::NONE) {
-        uart.sendError("No IC mode selected");
-        uart.sendInfo("Use MODE command first: MODE SRAM <size>");
+        uart.sendError(F("No IC mode selected"));
+        uart.sendInfo(F("Use MODE command first: MODE SRAM <size>"));
         return;
     }
 
@@ -192,7 +675,7 @@ void handleTestCommand(const String& parameter) {
     ICTestStrategy* strategy = modeManager.getCurrentStrategy();
 
     if (strategy == nullptr) {
-        uart.sendError("No strategy configured");
+        uart.sendError(F("No strategy configured"));
         return;
     }
 
@@ -200,201 +683,1521 @@ void handleTestCommand(const String& parameter) {
     if (modeManager.getCurrentMode() == ModeManager::SRAM62256) {
         SRAMStrategy* sram = static_cast<SRAMStrategy*>(strategy);
 
-        String param = parameter;
-        param.trim();
+        char* cursor = parameter;
+        char* word = CommandParser::nextToken(cursor);
+        int8_t selector = CommandParser::findKeyword(word, TEST_SELECTORS, TEST_SEL_COUNT);
+        if (selector == TEST_SEL_SPEED) {
+            handleSRAMSpeedCommand(sram, cursor);
+            return;
+        }
+
+        // Test selection first (none for "TEST FULL ..."), with the March
+        // algorithm or profile name after it; then the options, any order
+        const char* selection = "";
+        const char* name = "";
+        if (*word != '\0' && CommandParser::findKeyword(word, TEST_OPTIONS, TEST_OPT_COUNT) < 0) {
+            selection = word;
+            word = CommandParser::nextToken(cursor);
+            bool named = selector == TEST_SEL_MARCH || selector == TEST_SEL_PROFILE;
+            if (named && *word != '\0' && CommandParser::findKeyword(word, TEST_OPTIONS, TEST_OPT_COUNT) < 0) {
+                name = word;
+                word = CommandParser::nextToken(cursor);
+            }
+        }
+
+        SRAMTestOptions options;
+        if (!parseSRAMTestOptions(word, cursor, options)) {
+            sendSRAMTestUsage();
+            return;
+        }
+        if (options.quickTest) options.fullTest = false;
 
-        // Check for FULL mode flag
-        bool fullTest = param.endsWith("FULL");
-        if (fullTest) {
-            param = param.substring(0, param.length() - 4);
-            param.trim();
+        if (sram->isRunning()) {
+            uart.sendError(F("Test already running (ABORT to stop)"));
+            return;
+        }
+
+        // Runs in the background: scheduler.run() in loop() drives it
+        if ((options.seedSet && options.seed == 0) || options.passes < 1 ||
+            options.passes > SRAM_MAX_RANDOM_PASSES) {
+            uart.sendErrorf(F("SEED must be 1-0xFFFFFFFF, PASSES 1-%u"), SRAM_MAX_RANDOM_PASSES);
+            return;
         }
 
-        if (param.length() == 0) {
-            // No parameter: Default (tests 1-6, QUICK or FULL)
-            uart.sendInfo(fullTest ? "Running tests 1-6 (FULL mode)..." : "Running tests 1-6 (QUICK mode)...");
-            sram->runAllTests(false, fullTest);
+        SRAMRunPlan plan;
+        int8_t profile = -1;
+        SRAMProfile entry;
+        if (options.budgetSet || selector == TEST_SEL_PROFILE) {
+            // Profiles bring their own mode and tiers
+            if (options.fullTest || options.quickTest || options.fused) {
+                uart.sendError(F("Profiles set their own mode (no QUICK/FULL/FUSED)"));
+                return;
+            }
+            if (selector != TEST_SEL_PROFILE && *selection != '\0') {
+                uart.sendError(F("BUDGET picks a profile: TEST BUDGET <ms> or TEST PROFILE <name> BUDGET <ms>"));
+                return;
+            }
+            if (options.budgetSet && options.budget == 0) {
+                uart.sendError(F("BUDGET must be at least 1 ms"));
+                return;
+            }
+            profile = selectSRAMProfile(sram, name, options.budget);
+            if (profile < 0) return;
+            readSRAMProfile((uint8_t)profile, entry);
+            sram->setMarchAlgorithm(entry.marchAlgorithm);
+            plan = SRAMStrategy::profilePlan((uint8_t)profile);
+        } else if (!buildSRAMTestPlan(sram, selector, selection, name, options, plan)) {
             return;
         }
 
-        if (param == "RANDOM") {
-            // Run all tests including random
-            uart.sendInfo(fullTest ? "Running tests 1-7 (FULL mode)..." : "Running tests 1-7 (QUICK mode)...");
-            sram->runAllTests(true, fullTest);
+        if ((options.seedSet || options.passesSet) && plan.tests[plan.testCount - 1] != 7) {
+            uart.sendError(F("SEED/PASSES need test 7 (TEST RANDOM or TEST 7)"));
             return;
         }
+        if (options.loopSet && options.loops == 0) {
+            uart.sendError(F("LOOP must be at least 1 (or LOOP FOREVER)"));
+            return;
+        }
+        plan.mapFaults = options.mapFaults;
+        plan.loopCount = options.loops;
+        if (options.strideSet) plan.quickStride = options.quickStride;
+        plan.randomSeed = options.seed;
+        if (options.passesSet) plan.randomPasses = (uint8_t)options.passes;
 
-        // Check if it's a test number
-        uint8_t testNum = param.toInt();
-        if (testNum >= 1 && testNum <= 7) {
-            uart.sendInfo(fullTest ? "Running single test (FULL mode)..." : "Running single test (QUICK mode)...");
-            sram->runTest(testNum, fullTest);
+        if (profile >= 0) {
+            uint32_t estimate = sram->estimateRunMs(plan, entry.marchAlgorithm);
+            uart.sendInfof(F("Running profile %S (%S), estimated %lu ms..."), entry.keyword, entry.description,
+                           (unsigned long)estimate);
+        }
+        if (!sram->startRun(plan)) {
             return;
         }
+        if (options.strideSet && !plan.fullTest) {
+            uart.sendInfof(F("QUICK sampling: every %u, %lu cells per pass"),
+                           sram->getQuickStride(), (unsigned long)sram->getQuickCellCount());
+        }
+        if (options.loopSet && options.loops == SRAM_LOOP_FOREVER) {
+            uart.sendInfof(F("Soak until ABORT: first failure in full, summary every %u s"),
+                           SRAM_LOOP_REPORT_INTERVAL_MS / 1000);
+        } else if (options.loopSet) {
+            uart.sendInfof(F("Soak: %lu iterations, first failure in full, summary every %u s"),
+                           (unsigned long)options.loops, SRAM_LOOP_REPORT_INTERVAL_MS / 1000);
+        }
+        return;
+    }
+
+    if (modeManager.getCurrentMode() == ModeManager::Z80) {
+        handleZ80TestCommand(static_cast<Z80Strategy*>(strategy), parameter);
+        return;
+    }
 
-        uart.sendError("Invalid TEST parameter");
-        uart.sendInfo("Usage: TEST [FULL|RANDOM|RANDOM FULL|<1-7>|<1-7> FULL]");
+    if (modeManager.getCurrentMode() == ModeManager::IC6502) {
+        handle6502TestCommand(static_cast<IC6502Strategy*>(strategy), parameter);
         return;
     }
 
     // For other ICs, use default runTests()
-    uart.sendInfo("Starting tests...");
+    uart.sendInfo(F("Starting tests..."));
     strategy->runTests();
 }
 
 /**
- * Handle STATUS command
- * Shows current mode and system information
+ * Take the SRAM TEST options, from word on (cursor holds the rest)
+ *
+ * @return false for an unknown word or a missing number (nothing set up)
  */
-void handleStatusCommand() {
-    uart.sendInfo("========================================");
-    uart.sendInfo("  Multi-IC Tester Status");
-    uart.sendInfo("========================================");
+bool parseSRAMTestOptions(char* word, char* cursor, SRAMTestOptions& options) {
+    while (*word != '\0') {
+        int8_t option = CommandParser::findKeyword(word, TEST_OPTIONS, TEST_OPT_COUNT);
+        char* next = CommandParser::nextToken(cursor);
+        uint32_t value = 0;
+        bool number = CommandParser::parseNumber(next, value, 0);
 
-    // Current mode
-    uart.sendInfo("");
-    uart.sendInfo("Current Mode:");
-    const char* modeName = ModeManager::getModeName(modeManager.getCurrentMode());
-    String modeStr = String("  ") + modeName;
-    uart.sendInfo(modeStr.c_str());
+        switch (option) {
+            case TEST_OPT_FULL:
+                options.fullTest = true;
+                break;
 
-    // Firmware version
-    uart.sendInfo("");
-    uart.sendInfo("Firmware:");
-    uart.sendInfo("  Version: 1.0 (Phase 1 Complete)");
-    uart.sendInfo("  Platform: Arduino Mega 2560");
-    uart.sendInfo("  UART: 115200 baud");
+            case TEST_OPT_QUICK:
+                // Optional sampling interval, decimal (range checked by the strategy)
+                options.quickTest = true;
+                if (CommandParser::parseNumber(next, value, 10)) {
+                    options.quickStride = (value > 0xFFFF) ? 0 : (uint16_t)value;
+                    options.strideSet = true;
+                    next = CommandParser::nextToken(cursor);
+                }
+                break;
 
-    // Memory usage
-    uart.sendInfo("");
-    uart.sendInfo("Memory:");
-    // Note: Free RAM calculation could be added here in future
+            case TEST_OPT_FUSED:
+                options.fused = true;
+                break;
 
-    // Available commands
-    uart.sendInfo("");
-    uart.sendInfo("Ready for commands");
-    uart.sendInfo("Type HELP for command list");
-    uart.sendInfo("========================================");
+            case TEST_OPT_MAP:
+                options.mapFaults = true;
+                break;
+
+            case TEST_OPT_LOOP:
+                if (strcmp_P(next, KEY_FOREVER) == 0) {
+                    value = SRAM_LOOP_FOREVER;
+                } else if (!number) {
+                    return false;
+                }
+                options.loops = value;
+                options.loopSet = true;
+                next = CommandParser::nextToken(cursor);
+                break;
+
+            case TEST_OPT_BUDGET:
+            case TEST_OPT_SEED:
+            case TEST_OPT_PASSES:
+                if (!number) return false;
+                if (option == TEST_OPT_BUDGET) {
+                    options.budget = value;
+                    options.budgetSet = true;
+                } else if (option == TEST_OPT_SEED) {
+                    options.seed = value;
+                    options.seedSet = true;
+                } else {
+                    options.passes = value;
+                    options.passesSet = true;
+                }
+                next = CommandParser::nextToken(cursor);
+                break;
+
+            default:
+                return false;
+        }
+        word = next;
+    }
+    return true;
 }
 
 /**
- * Handle RESET command
- * Resets the currently selected IC (not implemented yet)
+ * Handle TEST SPEED in SRAM mode
+ * Supports: TEST SPEED (sweep, grade, apply), TEST SPEED OFF
  */
-void handleResetCommand() {
-    // Check if mode is set
-    if (modeManager.getCurrentMode() == ModeManager::NONE) {
-        uart.sendError("No IC mode selected");
-        uart.sendInfo("Use MODE command first");
+void handleSRAMSpeedCommand(SRAMStrategy* sram, char* param) {
+    if (sram->isRunning()) {
+        uart.sendError(F("Test already running (ABORT to stop)"));
         return;
     }
 
-    // Get current strategy
-    ICTestStrategy* strategy = modeManager.getCurrentStrategy();
+    const char* option = CommandParser::nextToken(param);
+    if (option[0] == '\0') {
+        sram->measureSpeed();
+        return;
+    }
 
-    if (strategy == nullptr) {
-        uart.sendError("No strategy configured");
+    if (strcmp_P(option, KEY_OFF) == 0 && *param == '\0') {
+        sram->useDatasheetTiming();
+        uart.sendOKf(F("Reads settle %u cycles (datasheet timing)"), SRAM_READ_SETTLE_CYCLES);
         return;
     }
 
-    // Reset IC (strategy implementation coming in Phase 3+)
-    uart.sendInfo("Resetting IC...");
-    strategy->reset();
-    uart.sendOK("IC reset complete");
+    uart.sendError(F("Usage: TEST SPEED [OFF]"));
 }
 
 /**
- * Handle HELP command
- * Displays available commands and usage
+ * Handle TEST in Z80 mode
+ * Supports: TEST, TEST <1-5>, TEST FMAX, TEST IMAGE
  */
-void handleHelpCommand() {
-    uart.sendInfo("========================================");
-    uart.sendInfo("  Multi-IC Tester - Command Reference");
-    uart.sendInfo("========================================");
-    uart.sendInfo("");
-    uart.sendInfo("Available Commands:");
-    uart.sendInfo("");
-    uart.sendInfo("  MODE <IC>");
-    uart.sendInfo("    Select IC type for testing");
-    uart.sendInfo("    IC types: Z80, 6502, SRAM <size>");
-    uart.sendInfo("    Example: MODE SRAM 32768 (HM62256)");
-    uart.sendInfo("");
-    uart.sendInfo("  TEST [options]");
-    uart.sendInfo("    Run tests for selected IC");
-    uart.sendInfo("    Must select MODE first");
-    uart.sendInfo("    For SRAM:");
-    uart.sendInfo("      TEST          - Tests 1-6, QUICK");
-    uart.sendInfo("      TEST FULL     - Tests 1-6, FULL");
-    uart.sendInfo("      TEST RANDOM   - Tests 1-7, QUICK");
-    uart.sendInfo("      TEST <1-7>    - Run single test");
-    uart.sendInfo("");
-    uart.sendInfo("  STATUS");
-    uart.sendInfo("    Show current configuration");
-    uart.sendInfo("    and system information");
-    uart.sendInfo("");
-    uart.sendInfo("  RESET");
-    uart.sendInfo("    Reset the selected IC");
-    uart.sendInfo("    Must select MODE first");
-    uart.sendInfo("");
-    uart.sendInfo("  HELP");
-    uart.sendInfo("    Show this help message");
-    uart.sendInfo("");
-    uart.sendInfo("  CLOCK <frequency>");
-    uart.sendInfo("    Start Timer3 clock at frequency (Hz)");
-    uart.sendInfo("    Output on PE3 (pin 5)");
-    uart.sendInfo("    Example: CLOCK 1000000");
-    uart.sendInfo("");
-    uart.sendInfo("  CLOCKSTOP");
-    uart.sendInfo("    Stop Timer3 clock output");
-    uart.sendInfo("");
-    uart.sendInfo("========================================");
-    uart.sendInfo("Notes:");
-    uart.sendInfo("  - Commands are case-sensitive");
-    uart.sendInfo("  - Only one IC tested at a time");
-    uart.sendInfo("  - Strategies implemented in Phase 3+");
-    uart.sendInfo("  - CLOCK commands for Phase 2 testing");
-    uart.sendInfo("========================================");
+void handleZ80TestCommand(Z80Strategy* z80, char* param) {
+    if (param[0] == '\0') {
+        z80->runTests();
+        return;
+    }
+
+    const char* word = CommandParser::nextToken(param);
+    int8_t keyword = CommandParser::findKeyword(word, CPU_TEST_KEYWORDS, CPU_TEST_COUNT);
+    uint32_t testNum = 0;
+    bool number = CommandParser::parseNumber(word, testNum, 10);
+
+    if (*param != '\0') {
+        keyword = -1;
+        number = false;
+    }
+    if (keyword == CPU_TEST_IMAGE) {
+        if (!requireImage()) return;
+        z80->setImage(programImage.getData(), programImage.getBase(), programImage.getLength());
+        z80->runTest(Z80_IMAGE_TEST);
+        return;
+    }
+
+    if (keyword == CPU_TEST_FMAX) {
+        uart.sendInfo(F("Measuring Z80 fmax (benchmark program, with and without /WAIT)..."));
+        z80->measureFmax();
+        return;
+    }
+
+    if (number && testNum >= 1 && testNum <= Z80_TEST_COUNT) {
+        z80->runTest((uint8_t)testNum);
+        return;
+    }
+
+    uart.sendError(F("Invalid TEST parameter"));
+    uart.sendInfo(F("Usage: TEST [<1-5>|FMAX|IMAGE]"));
 }
 
 /**
- * Handle CLOCK command (Phase 2 testing)
- * Configure and start Timer3 clock at specified frequency
+ * Handle TEST in 6502 mode
+ * Supports: TEST, TEST <1-5>, TEST STEP [n], TEST IMAGE
  */
-void handleClockCommand(const String& parameter) {
-    // Check if parameter provided
-    if (parameter.length() == 0) {
-        uart.sendError("Missing frequency. Usage: CLOCK <frequency>");
-        uart.sendInfo("Example: CLOCK 1000000 (for 1 MHz)");
+void handle6502TestCommand(IC6502Strategy* cpu, char* param) {
+    if (param[0] == '\0') {
+        cpu->runTests();
         return;
     }
 
-    // Parse frequency
-    uint32_t frequency = parameter.toInt();
+    const char* word = CommandParser::nextToken(param);
+    int8_t keyword = CommandParser::findKeyword(word, CPU_TEST_KEYWORDS, CPU_TEST_COUNT);
 
-    // Validate frequency (1 Hz to 8 MHz)
-    if (frequency < 1 || frequency > 8000000) {
-        uart.sendError("Frequency out of range (1 Hz to 8 MHz)");
+    if (keyword == CPU_TEST_STEP) {
+        const char* count = CommandParser::nextToken(param);
+        uint32_t cycles = IC6502_STEP_DEFAULT;
+        if (*param == '\0' && (*count == '\0' || CommandParser::parseNumber(count, cycles, 10))) {
+            cpu->stepCycles(cycles > 0xFF ? 0 : (uint8_t)cycles);
+            return;
+        }
+        keyword = -1;
+    }
+
+    uint32_t testNum = 0;
+    bool number = CommandParser::parseNumber(word, testNum, 10);
+    if (*param != '\0') {
+        keyword = -1;
+        number = false;
+    }
+
+    if (keyword == CPU_TEST_IMAGE) {
+        if (!requireImage()) return;
+        cpu->setImage(programImage.getData(), programImage.getBase(), programImage.getLength());
+        cpu->runTest(IC6502_IMAGE_TEST);
         return;
     }
 
-    // Configure and start clock
-    timer3.configure(frequency);
-    timer3.start();
+    if (number && testNum >= 1 && testNum <= IC6502_TEST_COUNT) {
+        cpu->runTest((uint8_t)testNum);
+        return;
+    }
 
-    // Send confirmation
-    String msg = "Clock started at " + String(frequency) + " Hz";
-    uart.sendOK(msg.c_str());
-    uart.sendInfo("Output on PE3 (pin 5)");
+    uart.sendError(F("Invalid TEST parameter"));
+    uart.sendInfo(F("Usage: TEST [<1-5>|STEP [cycles]|IMAGE]"));
 }
 
 /**
- * Handle CLOCKSTOP command (Phase 2 testing)
- * Stop Timer3 clock output
+ * Build the SRAM run plan for a TEST selection (options already taken)
+ *
+ * @param selector TEST_SELECTORS index of word, or -1 (test number, none)
+ * @param name MARCH algorithm ("" for the default)
+ * @return false if the selection was invalid (usage sent, nothing to run)
  */
-void handleClockStopCommand() {
-    // Stop clock
-    timer3.stop();
+bool buildSRAMTestPlan(SRAMStrategy* sram, int8_t selector, const char* word, const char* name,
+                       const SRAMTestOptions& options, SRAMRunPlan& plan) {
+    bool fullTest = options.fullTest;
+    bool quickTest = options.quickTest;
+    bool fused = options.fused;
 
-    // Send confirmation
-    uart.sendOK("Clock stopped");
+    if (word[0] == '\0') {
+        if (!fullTest && !quickTest && !fused) {
+            // No parameter: Production screen (March C-, FULL)
+            uart.sendInfo(F("Running production screen (March C-, FULL mode)..."));
+            sram->setMarchAlgorithm(MARCH_DEFAULT_ALGORITHM);
+            plan = SRAMStrategy::singleTestPlan(8, true);
+            plan.summary = true;
+            plan.prescreen = true;
+            return true;
+        }
+
+        // Tests 1-6, QUICK or FULL
+        uart.sendInfo(fullTest ? F("Running tests 1-6 (FULL mode)...") : F("Running tests 1-6 (QUICK mode)..."));
+        plan = SRAMStrategy::allTestsPlan(false, fullTest, fused);
+        return true;
+    }
+
+    if (selector == TEST_SEL_RANDOM) {
+        // Run all tests including random
+        uart.sendInfo(fullTest ? F("Running tests 1-7 (FULL mode)...") : F("Running tests 1-7 (QUICK mode)..."));
+        plan = SRAMStrategy::allTestsPlan(true, fullTest, fused);
+        return true;
+    }
+
+    if (selector == TEST_SEL_MARCH) {
+        // March tests cover the whole array unless QUICK is requested
+        int8_t algorithm = (*name != '\0') ? findMarchAlgorithm(name) : MARCH_DEFAULT_ALGORITHM;
+        if (algorithm < 0) {
+            uart.sendError(F("Unknown March algorithm"));
+            uart.sendInfo(F("Algorithms: MATS+ (5n), CMINUS (10n), B (17n)"));
+            return false;
+        }
+
+        uart.sendInfo(quickTest ? F("Running March test (QUICK mode)...") : F("Running March test (FULL mode)..."));
+        sram->setMarchAlgorithm((uint8_t)algorithm);
+        plan = SRAMStrategy::singleTestPlan(8, !quickTest);
+        return true;
+    }
+
+    // Check if it's a test number
+    uint32_t testNum = 0;
+    if (CommandParser::parseNumber(word, testNum, 10) && testNum >= 1 && testNum <= 8) {
+        uart.sendInfo(fullTest ? F("Running single test (FULL mode)...") : F("Running single test (QUICK mode)..."));
+        plan = SRAMStrategy::singleTestPlan((uint8_t)testNum, fullTest);
+        return true;
+    }
+
+    sendSRAMTestUsage();
+    return false;
+}
+
+void sendSRAMTestUsage() {
+    uart.sendError(F("Invalid TEST parameter"));
+    uart.sendInfo(F("Usage: TEST [QUICK|FULL|RANDOM|RANDOM FULL|<1-8>|<1-8> FULL]"));
+    uart.sendInfo(F("       TEST [RANDOM] [QUICK|FULL] FUSED"));
+    uart.sendInfo(F("       TEST MARCH <MATS+|CMINUS|B> [QUICK]"));
+    uart.sendInfo(F("       QUICK <stride> on any QUICK form: sample every <stride> (1-4096)"));
+    uart.sendInfo(F("       MAP after any form: collect all failures, report at end"));
+    uart.sendInfo(F("       SEED <n> / PASSES <k> with RANDOM or 7: seed of pass 1, passes"));
+    uart.sendInfo(F("       TEST PROFILE [TRIAGE|PRODUCTION|QUALIFY] | TEST BUDGET <ms>"));
+    uart.sendInfo(F("       LOOP <n> / LOOP FOREVER after any form: soak, summary lines only"));
+    uart.sendInfo(F("       TEST SPEED [OFF]: grade the access time, later runs read at it"));
+}
+
+/**
+ * Pick the profile for TEST PROFILE [<name>] / TEST BUDGET <ms>
+ *
+ * TEST PROFILE alone lists the profiles with their estimates. A budget
+ * picks the strongest profile that fits, or checks the named one.
+ *
+ * @param name Profile keyword ("" for none)
+ * @param budgetMs 0 = no budget
+ * @return Index into SRAM_PROFILES, or -1 (listing or error sent, nothing to run)
+ */
+int8_t selectSRAMProfile(SRAMStrategy* sram, const char* name, uint32_t budgetMs) {
+    if (*name == '\0' && budgetMs == 0) {
+        sendSRAMProfileList(sram);
+        return -1;
+    }
+
+    int8_t profile = -1;
+    if (*name != '\0') {
+        profile = findSRAMProfile(name);
+        if (profile < 0) {
+            uart.sendError(F("Unknown profile"));
+            uart.sendInfo(F("Profiles: TRIAGE, PRODUCTION, QUALIFY (TEST PROFILE lists them)"));
+            return -1;
+        }
+    }
+
+    // A run is about to start: only now may the estimates write the chip
+    sram->measureAccessTiming();
+
+    if (profile >= 0) {
+        uint32_t estimate = estimateSRAMProfileMs(sram, (uint8_t)profile);
+        if (budgetMs != 0 && estimate > budgetMs) {
+            SRAMProfile entry;
+            readSRAMProfile((uint8_t)profile, entry);
+            uart.sendErrorf(F("Profile %S needs ~%lu ms, budget is %lu ms"), entry.keyword,
+                            (unsigned long)estimate, (unsigned long)budgetMs);
+            return -1;
+        }
+        return profile;
+    }
+
+    // Profiles are ordered weakest first: take the last one that fits
+    for (profile = SRAM_PROFILE_COUNT - 1; profile >= 0; profile--) {
+        if (estimateSRAMProfileMs(sram, (uint8_t)profile) <= budgetMs) {
+            return profile;
+        }
+    }
+    SRAMProfile weakest;
+    readSRAMProfile(0, weakest);
+    uart.sendErrorf(F("No profile fits %lu ms (%S needs ~%lu ms)"), (unsigned long)budgetMs,
+                    weakest.keyword, (unsigned long)estimateSRAMProfileMs(sram, 0));
+    return -1;
+}
+
+uint32_t estimateSRAMProfileMs(SRAMStrategy* sram, uint8_t profile) {
+    SRAMProfile entry;
+    readSRAMProfile(profile, entry);
+    return sram->estimateRunMs(SRAMStrategy::profilePlan(profile), entry.marchAlgorithm);
+}
+
+/**
+ * TEST PROFILE: every profile with its estimate for this chip
+ *
+ * Only lists: the access times are measured (cells 0-511 written) when a
+ * profile or budget run starts, so before the first one there are no
+ * estimates yet.
+ */
+void sendSRAMProfileList(SRAMStrategy* sram) {
+    bool measured = sram->hasAccessTiming();
+    if (measured) {
+        const SRAMAccessTiming& timing = sram->getAccessTiming();
+        uart.sendInfof(F("Profiles for %u bytes (measured: burst %u ns, cell %u ns, single %u ns per access)"),
+                       sram->getSize(), timing.burstNs, timing.cellNs, timing.singleNs);
+    } else {
+        uart.sendInfof(F("Profiles for %u bytes (estimates after the first profile run, which times cells 0-511)"),
+                       sram->getSize());
+    }
+    for (uint8_t profile = 0; profile < SRAM_PROFILE_COUNT; profile++) {
+        SRAMProfile entry;
+        readSRAMProfile(profile, entry);
+        if (measured) {
+            uart.sendInfof(F("  %-11S %-39S ~%lu ms"), entry.keyword, entry.description,
+                           (unsigned long)estimateSRAMProfileMs(sram, profile));
+        } else {
+            uart.sendInfof(F("  %-11S %S"), entry.keyword, entry.description);
+        }
+    }
+    uart.sendInfo(F("TEST PROFILE <name> runs one, TEST BUDGET <ms> the strongest that fits"));
+}
+
+/**
+ * Handle STATUS command
+ * Supports: STATUS, STATUS RESET
+ * Shows current mode and system information
+ */
+void handleStatusCommand(char* parameter) {
+    if (strcmp_P(parameter, KEY_RESET) == 0) {
+        health.reset();
+        paintStack();
+        uart.sendOK(F("Loop, command and stack figures cleared"));
+        return;
+    }
+    if (parameter[0] != '\0') {
+        uart.sendError(F("Invalid STATUS option. Usage: STATUS [RESET]"));
+        return;
+    }
+
+    // Mid-test: one line instead of the full report
+    if (sramStrategy.isRunning()) {
+        sramStrategy.sendRunStatus();
+        return;
+    }
+    if (sramDump.isActive()) {
+        sramDump.sendStatus();
+        return;
+    }
+    if (imageLoader.isActive()) {
+        imageLoader.sendStatus();
+        return;
+    }
+
+    uart.sendInfo(F("========================================"));
+    uart.sendInfo(F("  Multi-IC Tester Status"));
+    uart.sendInfo(F("========================================"));
+
+    // Current mode
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("Current Mode:"));
+    uart.sendInfof(F("  %S"), (PGM_P)ModeManager::getModeName(modeManager.getCurrentMode()));
+    if (modeManager.getCurrentMode() == ModeManager::SRAM62256) {
+        SRAMBus& bus = sramStrategy.getBus();
+        uart.sendInfof(F("  Reads settle %u cycles%S"), bus.getReadSettleCycles(),
+                       bus.getReadTrim() != 0 ? PSTR(" (TEST SPEED)") : PSTR(" (datasheet)"));
+    }
+
+    // Firmware version
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("Firmware:"));
+    uart.sendInfo(F("  Version: 1.0 (Phase 1 Complete)"));
+    uart.sendInfo(F("  Platform: Arduino Mega 2560"));
+    uart.sendInfof(F("  UART: %lu baud, %S protocol"), (unsigned long)uart.getBaud(),
+                   uart.isBinary() ? PSTR("BIN") : PSTR("TEXT"));
+
+    // Clock generator
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("Clock (PE3):"));
+    if (timer3.running()) {
+        uint16_t milliHz;
+        uint32_t actual = timer3.getActualFrequency(&milliHz);
+        uart.sendInfof(F("  %lu Hz requested, %lu.%03u Hz actual"), (unsigned long)timer3.getFrequency(),
+                       (unsigned long)actual, milliHz);
+    } else {
+        uart.sendInfo(F("  Stopped"));
+    }
+
+    // Memory usage
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("Memory:"));
+    uart.sendInfof(F("  Static: %u bytes, heap: %u bytes"), staticRam(), heapUsed());
+    uart.sendInfof(F("  Free RAM: %u bytes, %u at the stack high-water mark"), freeRam(), stackUnused());
+
+    // Loop and command latency, UART input losses
+    sendHealthReport();
+
+    // Stored plan and batch
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("Plan:"));
+    if (planRunner.isRunning()) {
+        uart.sendInfof(F("  Running DUT %u, pass %u, step %u of %u"), planRunner.getDutCount(),
+                       planRunner.getPass(), planRunner.getStep(), planStore.getStepCount());
+    } else {
+        uart.sendInfof(F("  %u steps, repeat %u"), planStore.getStepCount(), planStore.getRepeat());
+    }
+    uart.sendInfof(F("  Batch: %u DUTs, %u PASS, %u FAIL"), planRunner.getDutCount(),
+                   planRunner.getPassCount(), planRunner.getFailCount());
+
+    // Available commands
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("Ready for commands"));
+    uart.sendInfo(F("Type HELP for command list"));
+    uart.sendInfo(F("========================================"));
+}
+
+/**
+ * STATUS: the Health section (plus HEALTH records in BIN mode)
+ */
+void sendHealthReport() {
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("Health:"));
+    uart.sendInfof(F("  Loop: %lu passes, mean %lu us, max %lu us"), (unsigned long)health.getLoops(),
+                   (unsigned long)health.getLoopMeanUs(), (unsigned long)health.getLoopMaxUs());
+    uart.sendInfof(F("  UART: %u RX overruns, %u dropped lines, %u bad frames"), uart.getRxOverruns(),
+                   uart.getDroppedLines(), uart.getBadFrames());
+    uart.sendInfo(F("  Commands    count      mean       max"));
+    for (uint8_t type = 0; type < COMMAND_TYPE_COUNT; type++) {
+        const HealthCommandStats& stats = health.getCommand((CommandType)type);
+        if (stats.count == 0) continue;
+        uart.sendInfof(F("    %-9S %5u %7lu us %7lu us"), CommandParser::getCommandName((CommandType)type),
+                       stats.count, (unsigned long)health.getCommandMeanUs((CommandType)type),
+                       (unsigned long)stats.maxUs);
+    }
+
+    if (!uart.isBinary()) return;
+    sendHealthRecord(BIN_HEALTH_FREE_RAM, 0, freeRam());
+    sendHealthRecord(BIN_HEALTH_STACK_UNUSED, 0, stackUnused());
+    sendHealthRecord(BIN_HEALTH_HEAP, 0, heapUsed());
+    sendHealthRecord(BIN_HEALTH_LOOPS, 0, health.getLoops());
+    sendHealthRecord(BIN_HEALTH_LOOP_MAX_US, 0, health.getLoopMaxUs());
+    sendHealthRecord(BIN_HEALTH_LOOP_MEAN_US, 0, health.getLoopMeanUs());
+    sendHealthRecord(BIN_HEALTH_RX_OVERRUNS, 0, uart.getRxOverruns());
+    sendHealthRecord(BIN_HEALTH_DROPPED_LINES, 0, uart.getDroppedLines());
+    sendHealthRecord(BIN_HEALTH_BAD_FRAMES, 0, uart.getBadFrames());
+    for (uint8_t type = 0; type < COMMAND_TYPE_COUNT; type++) {
+        const HealthCommandStats& stats = health.getCommand((CommandType)type);
+        if (stats.count == 0) continue;
+        sendHealthRecord(BIN_HEALTH_COMMAND_COUNT, type, stats.count);
+        sendHealthRecord(BIN_HEALTH_COMMAND_MEAN_US, type, health.getCommandMeanUs((CommandType)type));
+        sendHealthRecord(BIN_HEALTH_COMMAND_MAX_US, type, stats.maxUs);
+    }
+}
+
+void sendHealthRecord(uint8_t stat, uint8_t command, uint32_t value) {
+    BinaryRecord record(BIN_REC_HEALTH);
+    record.put8(stat).put8(command).put8(0).put8(0).put32(value);
+    uart.sendRecord(record);
+}
+
+/**
+ * Handle RESET command
+ * Resets the currently selected IC (not implemented yet)
+ */
+void handleResetCommand() {
+    if (sramStrategy.isRunning()) {
+        uart.sendError(F("Test already running (ABORT to stop)"));
+        return;
+    }
+    if (refuseWhileTransferring()) return;
+
+    // Check if mode is set
+    if (modeManager.getCurrentMode() == ModeManager::NONE) {
+        uart.sendError(F("No IC mode selected"));
+        uart.sendInfo(F("Use MODE command first"));
+        return;
+    }
+
+    // Get current strategy
+    ICTestStrategy* strategy = modeManager.getCurrentStrategy();
+
+    if (strategy == nullptr) {
+        uart.sendError(F("No strategy configured"));
+        return;
+    }
+
+    // Reset IC (strategy implementation coming in Phase 3+)
+    uart.sendInfo(F("Resetting IC..."));
+    strategy->reset();
+    uart.sendOK(F("IC reset complete"));
+}
+
+/**
+ * Handle HELP command
+ * Displays available commands and usage
+ */
+void handleHelpCommand() {
+    uart.sendInfo(F("========================================"));
+    uart.sendInfo(F("  Multi-IC Tester - Command Reference"));
+    uart.sendInfo(F("========================================"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("Available Commands:"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  MODE <IC>"));
+    uart.sendInfo(F("    Select IC type for testing"));
+    uart.sendInfo(F("    IC types: Z80, 6502, SRAM <size>"));
+    uart.sendInfo(F("    Example: MODE SRAM 32768 (HM62256)"));
+    uart.sendInfo(F("    MODE SRAM <size> DUAL - Sockets A and B in parallel"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  TEST [options]"));
+    uart.sendInfo(F("    Run tests for selected IC"));
+    uart.sendInfo(F("    Must select MODE first"));
+    uart.sendInfo(F("    For SRAM:"));
+    uart.sendInfo(F("      TEST          - Production screen (March C-)"));
+    uart.sendInfo(F("      TEST QUICK    - Tests 1-6, QUICK"));
+    uart.sendInfo(F("      TEST QUICK 32 - QUICK, every 32nd cell (default 128)"));
+    uart.sendInfo(F("      TEST FULL     - Tests 1-6, FULL"));
+    uart.sendInfo(F("      TEST RANDOM   - Tests 1-7, QUICK"));
+    uart.sendInfo(F("      TEST RANDOM ... SEED <n> PASSES <k> - test 7 seed, k seeds"));
+    uart.sendInfo(F("      TEST FULL FUSED - Tests 1-6, 1/4/5 in one sweep"));
+    uart.sendInfo(F("      TEST <1-8>    - Run single test"));
+    uart.sendInfo(F("      TEST MARCH <MATS+|CMINUS|B> - March test"));
+    uart.sendInfo(F("      TEST ... MAP  - Collect all failures, map at end"));
+    uart.sendInfo(F("      TEST PROFILE [name] - TRIAGE/PRODUCTION/QUALIFY tiers, or list"));
+    uart.sendInfo(F("      TEST BUDGET <ms> - Strongest profile that fits the time"));
+    uart.sendInfo(F("      TEST ... LOOP <n|FOREVER> - Soak: repeat, statistics on board"));
+    uart.sendInfo(F("      TEST SPEED    - Access-time grade, later runs use the fastest safe reads"));
+    uart.sendInfo(F("      TEST SPEED OFF - Back to datasheet read timing"));
+    uart.sendInfo(F("    For Z80:"));
+    uart.sendInfo(F("      TEST          - Tests 1-5 (CLOCK frequency or 500 kHz)"));
+    uart.sendInfo(F("      TEST <1-5>    - Run single test"));
+    uart.sendInfo(F("      TEST FMAX     - Highest clock with no missed cycles"));
+    uart.sendInfo(F("      TEST IMAGE    - Run the LOADed program (00h to 1FFFh or HALT passes)"));
+    uart.sendInfo(F("    For 6502 (firmware burst clock):"));
+    uart.sendInfo(F("      TEST          - Tests 1-5"));
+    uart.sendInfo(F("      TEST <1-5>    - Run single test"));
+    uart.sendInfo(F("      TEST STEP [n] - List the first n bus cycles (default 16)"));
+    uart.sendInfo(F("      TEST IMAGE    - Run the LOADed program (00h to $1FFF passes)"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  STATUS"));
+    uart.sendInfo(F("    Show current configuration, system information"));
+    uart.sendInfo(F("    and health (RAM, stack, loop/command latency)"));
+    uart.sendInfo(F("  STATUS RESET"));
+    uart.sendInfo(F("    Clear the latency figures and stack high-water mark"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  RESET"));
+    uart.sendInfo(F("    Reset the selected IC"));
+    uart.sendInfo(F("    Must select MODE first"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  HELP"));
+    uart.sendInfo(F("    Show this help message"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  CLOCK <frequency>"));
+    uart.sendInfo(F("    Start Timer3 clock at frequency (Hz)"));
+    uart.sendInfo(F("    Output on PE3 (pin 5), running clock retuned glitch-free"));
+    uart.sendInfo(F("    Example: CLOCK 1000000"));
+    uart.sendInfo(F("  CLOCK SWEEP [min max]"));
+    uart.sendInfo(F("    Z80: highest clock at which all tests pass (default 100k-4M)"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  CLOCKSTOP"));
+    uart.sendInfo(F("    Stop Timer3 clock output"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  ABORT"));
+    uart.sendInfo(F("    Stop the running test (STATUS also works mid-test)"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  PAUSE / RESUME"));
+    uart.sendInfo(F("    Hold the running test at its current address and continue"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  PERF [RESET|ON|OFF]"));
+    uart.sendInfo(F("    Time, bus/UART share and accesses/s of the last run of each test"));
+    uart.sendInfo(F("    ON adds a PERF line after every test result"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  TRACE [ON|OFF|CLEAR|DUMP|LIST [n]]"));
+    uart.sendInfo(F("    Record Z80/6502 bus cycles; a failing test holds its run"));
+    uart.sendInfo(F("    DUMP sends binary records, LIST shows the last n (default 16)"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  PROTO <TEXT|BIN> [baud]"));
+    uart.sendInfo(F("    Test output as text lines or binary records"));
+    uart.sendInfo(F("    Baud: 9600-115200, 250000, 500000, 1000000"));
+    uart.sendInfo(F("    Example: PROTO BIN 1000000"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  PLAN [ADD <command>|CLEAR|REPEAT <n>|STOP <ON|OFF>|RESET]"));
+    uart.sendInfo(F("    Test plan kept in EEPROM (up to 8 commands), shown without option"));
+    uart.sendInfo(F("    REPEAT: passes per DUT, STOP: end DUT at first failing step"));
+    uart.sendInfo(F("    RESET clears the batch PASS/FAIL counts"));
+    uart.sendInfo(F("    Example: PLAN ADD MODE SRAM 32768"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  RUN"));
+    uart.sendInfo(F("    Run the plan on one DUT, one summary line (footswitch PD2 also starts)"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  DUMP [<start> <len>] [B]"));
+    uart.sendInfo(F("    SRAM: send the bytes as binary records, then their CRC-32"));
+    uart.sendInfo(F("  CRC [<start> <len>] [16|32] [B]"));
+    uart.sendInfo(F("    SRAM: CRC-32 (or CRC-16) computed on the board, whole chip by default"));
+    uart.sendInfo(F("    B: socket B in DUAL mode. Example: CRC 0x1000 0x800"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  LOAD [<addr> <len>|SAVE|CLEAR]"));
+    uart.sendInfo(F("    Receive a Z80/6502 program as LOAD_DATA records (TEST IMAGE runs it)"));
+    uart.sendInfo(F("    SAVE keeps it in EEPROM across resets, shown without option"));
+    uart.sendInfo(F("    Example: LOAD 0xF000 64"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("  MAP [RAM|FAULT|OPEN <addr> <len>|CLEAR]"));
+    uart.sendInfo(F("    Z80/6502 pages for TEST IMAGE beside the image (256 bytes each)"));
+    uart.sendInfof(F("    RAM from a %u-page pool, FAULT fails the run, shown without option"), MEMORY_POOL_PAGES);
+    uart.sendInfo(F("    Example: MAP RAM 0xFF00 256"));
+    uart.sendInfo(F(""));
+    uart.sendInfo(F("========================================"));
+    uart.sendInfo(F("Notes:"));
+    uart.sendInfo(F("  - Commands are case-sensitive"));
+    uart.sendInfo(F("  - Several commands per line with ';', each after the last finishes:"));
+    uart.sendInfo(F("    MODE SRAM 32768; TEST MARCH CMINUS; CRC (stops at the first failure)"));
+    uart.sendInfof(F("  - Lines up to %u characters, plan steps up to %u"),
+                   UARTHandler::RX_LINE_SIZE - 1, PLAN_STEP_SIZE - 1);
+    uart.sendInfo(F("  - Only one IC tested at a time"));
+    uart.sendInfo(F("  - Strategies implemented in Phase 3+"));
+    uart.sendInfo(F("  - CLOCK commands for Phase 2 testing"));
+    uart.sendInfo(F("========================================"));
+}
+
+/**
+ * Handle CLOCK command (Phase 2 testing)
+ * Configure and start Timer3 clock at specified frequency; a running
+ * clock is retuned without a glitch. CLOCK SWEEP [min max] speed-bins the CPU.
+ */
+void handleClockCommand(char* parameter) {
+    // Check if parameter provided
+    if (parameter[0] == '\0') {
+        uart.sendError(F("Missing frequency. Usage: CLOCK <frequency>"));
+        uart.sendInfo(F("Example: CLOCK 1000000 (for 1 MHz)"));
+        return;
+    }
+
+    char* cursor = parameter;
+    const char* word = CommandParser::nextToken(cursor);
+    if (strcmp_P(word, KEY_SWEEP) == 0) {
+        handleClockSweep(cursor);
+        return;
+    }
+
+    // Parse frequency
+    uint32_t frequency = 0;
+    if (!CommandParser::parseNumber(word, frequency, 10) || *cursor != '\0') {
+        uart.sendError(F("Invalid frequency. Usage: CLOCK <frequency> (Hz, decimal)"));
+        return;
+    }
+
+    // Validate frequency (1 Hz to 8 MHz)
+    if (frequency < 1 || frequency > 8000000) {
+        uart.sendError(F("Frequency out of range (1 Hz to 8 MHz)"));
+        return;
+    }
+
+    // Retune a running clock in place, otherwise configure and start
+    bool retuned = timer3.running();
+    if (retuned) {
+        timer3.retune(frequency);
+    } else {
+        timer3.configure(frequency);
+        timer3.start();
+    }
+
+    // Send confirmation
+    uint16_t milliHz;
+    uint32_t actual = timer3.getActualFrequency(&milliHz);
+    uart.sendOKf(F("Clock %S at %lu Hz"), retuned ? PSTR("retuned") : PSTR("started"), (unsigned long)frequency);
+    uart.sendInfof(F("Actual %lu.%03u Hz, output on PE3 (pin 5)"), (unsigned long)actual, milliHz);
+}
+
+/**
+ * Run the selected CPU's tests at one clock frequency, one line of output
+ */
+bool clockSweepPasses(uint32_t frequency) {
+    if (timer3.running()) {
+        timer3.retune(frequency);
+    } else {
+        timer3.configure(frequency);
+        timer3.start();
+    }
+
+    // Quiet run: the strategy's own lines would bury the sweep
+    z80Strategy.setUARTHandler(nullptr);
+    bool passed = z80Strategy.runTests();
+    z80Strategy.setUARTHandler(&uart);
+
+    uart.sendInfof(F("  %lu Hz: %S"), (unsigned long)timer3.getActualFrequency(), passed ? PSTR("PASS") : PSTR("FAIL"));
+    return passed;
+}
+
+/**
+ * Handle CLOCK SWEEP [min max]
+ * Binary search for the highest Timer3 clock at which all tests pass
+ */
+void handleClockSweep(char* args) {
+    if (modeManager.getCurrentMode() != ModeManager::Z80) {
+        uart.sendError(F("CLOCK SWEEP needs MODE Z80 (6502 tests run on the firmware clock)"));
+        return;
+    }
+
+    uint32_t low = CLOCK_SWEEP_MIN_HZ;
+    uint32_t high = CLOCK_SWEEP_MAX_HZ;
+    if (*args != '\0') {
+        bool valid = CommandParser::parseNumber(CommandParser::nextToken(args), low, 10) &&
+                     CommandParser::parseNumber(CommandParser::nextToken(args), high, 10) && *args == '\0';
+        if (!valid || low < 1 || high > 8000000 || low >= high) {
+            uart.sendError(F("Invalid range. Usage: CLOCK SWEEP [min max] (1 Hz to 8 MHz)"));
+            return;
+        }
+    }
+
+    uint32_t savedHz = timer3.running() ? timer3.getFrequency() : 0;
+    uart.sendInfof(F("Clock sweep %lu - %lu Hz, tests 1-%d"), (unsigned long)low, (unsigned long)high, Z80_TEST_COUNT);
+
+    bool found = clockSweepPasses(low);
+    uint32_t failHz = 0;
+    if (found && !clockSweepPasses(high)) {
+        // low passes, high fails: halve until the gap is within the resolution
+        failHz = high;
+        while (failHz - low > 1 && failHz - low > low / (100 / CLOCK_SWEEP_RESOLUTION_PERCENT)) {
+            uint32_t middle = low + (failHz - low) / 2;
+            if (clockSweepPasses(middle)) {
+                low = middle;
+            } else {
+                failHz = middle;
+            }
+        }
+    }
+
+    // Report the real output frequency of the best passing step
+    uint32_t bestHz = (failHz == 0) ? high : low;
+    uint16_t milliHz = 0;
+    if (found) {
+        timer3.retune(bestHz);
+        uint32_t actual = timer3.getActualFrequency(&milliHz);
+        if (failHz == 0) {
+            uart.sendOKf(F("SWEEP: all tests pass up to %lu.%03u Hz (sweep maximum)"), (unsigned long)actual, milliHz);
+        } else {
+            uart.sendOKf(F("SWEEP: all tests pass up to %lu.%03u Hz, fail at %lu Hz"),
+                         (unsigned long)actual, milliHz, (unsigned long)failHz);
+        }
+    } else {
+        uart.sendErrorf(F("SWEEP: tests already fail at %lu Hz"), (unsigned long)low);
+    }
+
+    // Leave the clock as the user had it
+    if (savedHz != 0) {
+        timer3.retune(savedHz);
+    } else {
+        timer3.stop();
+    }
+}
+
+/**
+ * Handle CLOCKSTOP command (Phase 2 testing)
+ * Stop Timer3 clock output
+ */
+void handleClockStopCommand() {
+    // Stop clock
+    timer3.stop();
+
+    // Send confirmation
+    uart.sendOK(F("Clock stopped"));
+}
+
+/**
+ * Handle PROTO command
+ * Supports: PROTO, PROTO TEXT [baud], PROTO BIN [baud]
+ */
+void handleProtoCommand(char* parameter) {
+    if (parameter[0] == '\0') {
+        uart.sendOKf(F("Protocol: %S, %lu baud"), uart.isBinary() ? PSTR("BIN") : PSTR("TEXT"),
+                     (unsigned long)uart.getBaud());
+        return;
+    }
+
+    // Optional baud rate after the protocol name
+    char* cursor = parameter;
+    const char* name = CommandParser::nextToken(cursor);
+    int8_t keyword = CommandParser::findKeyword(name, PROTO_KEYWORDS, PROTO_KEY_COUNT);
+    uint32_t baud = 0;
+    if (*cursor != '\0') {
+        bool valid = CommandParser::parseNumber(CommandParser::nextToken(cursor), baud, 10) && *cursor == '\0';
+        if (!valid || !UARTHandler::isSupportedBaud(baud)) {
+            uart.sendError(F("Unsupported baud rate"));
+            uart.sendInfo(F("Baud: 9600, 19200, 38400, 57600, 115200, 250000, 500000, 1000000"));
+            return;
+        }
+    }
+
+    if (keyword < 0) {
+        uart.sendError(F("Invalid protocol. Usage: PROTO <TEXT|BIN> [baud]"));
+        return;
+    }
+    UARTHandler::Protocol protocol = (keyword == PROTO_KEY_BIN) ? UARTHandler::PROTOCOL_BINARY
+                                                               : UARTHandler::PROTOCOL_TEXT;
+
+    uart.setProtocol(protocol);
+    if (baud != 0) {
+        uart.sendOKf(F("Protocol set: %s, switching to %lu baud"), name, (unsigned long)baud);
+    } else {
+        uart.sendOKf(F("Protocol set: %s"), name);
+    }
+
+    // Confirmation goes out at the old rate, host reopens at the new one
+    if (baud != 0) {
+        uart.setBaud(baud);
+    }
+}
+
+/**
+ * Handle ABORT command
+ * Ends the running test at its next 1KB unit (reported as ABORTED)
+ */
+void handleAbortCommand() {
+    // Batch run: stop the DUT, and its test if one is in progress
+    if (planRunner.isRunning()) {
+        planRunner.abort();
+        if (sramStrategy.isRunning()) {
+            sramStrategy.abortRun();
+        }
+        uart.sendInfo(F("ABORT received"));
+        return;
+    }
+
+    // DUMP/CRC/LOAD: the task reports where it stopped
+    if (sramDump.isActive()) {
+        sramDump.abort();
+        uart.sendInfo(F("ABORT received"));
+        return;
+    }
+    if (imageLoader.isActive()) {
+        uart.sendInfo(F("ABORT received"));
+        imageLoader.abort();
+        return;
+    }
+
+    if (!sramStrategy.isRunning()) {
+        uart.sendError(F("No test running"));
+        return;
+    }
+
+    sramStrategy.abortRun();
+    uart.sendInfo(F("ABORT received"));
+}
+
+/**
+ * Handle PAUSE command
+ * Holds the running test between units; bus state is left as is
+ */
+void handlePauseCommand() {
+    if (!sramStrategy.isRunning()) {
+        uart.sendError(F("No test running"));
+        return;
+    }
+    if (sramStrategy.isPaused()) {
+        uart.sendError(F("Test already paused"));
+        return;
+    }
+
+    sramStrategy.pause();
+    uart.sendOK(F("Test paused (RESUME to continue)"));
+}
+
+/**
+ * Handle RESUME command
+ */
+void handleResumeCommand() {
+    if (!sramStrategy.isPaused()) {
+        uart.sendError(F("No paused test"));
+        return;
+    }
+
+    sramStrategy.resume();
+    uart.sendOK(F("Test resumed"));
+}
+
+/**
+ * Handle PERF command
+ * Supports: PERF, PERF RESET, PERF ON, PERF OFF
+ */
+void handlePerfCommand(char* parameter) {
+    if (parameter[0] == '\0') {
+        if (modeManager.getCurrentMode() != ModeManager::SRAM62256) {
+            uart.sendError(F("No SRAM tests measured. Use MODE SRAM <size> first"));
+            return;
+        }
+        sramStrategy.sendPerfReport();
+        return;
+    }
+
+    int8_t option = CommandParser::findKeyword(parameter, PERF_KEYWORDS, PERF_KEY_COUNT);
+    switch (option) {
+        case PERF_KEY_RESET:
+            sramStrategy.resetPerf();
+            uart.sendOK(F("PERF counters cleared"));
+            break;
+
+        case PERF_KEY_ON:
+            sramStrategy.setPerfAttach(true);
+            uart.sendOK(F("PERF line after each test result"));
+            break;
+
+        case PERF_KEY_OFF:
+            sramStrategy.setPerfAttach(false);
+            uart.sendOK(F("PERF lines off"));
+            break;
+
+        default:
+            uart.sendError(F("Invalid PERF option. Usage: PERF [RESET|ON|OFF]"));
+            break;
+    }
+}
+
+/**
+ * Handle TRACE command
+ * Supports: TRACE, TRACE ON, TRACE OFF, TRACE CLEAR, TRACE DUMP, TRACE LIST [n]
+ */
+void handleTraceCommand(char* parameter) {
+    if (parameter[0] == '\0') {
+        uart.sendOKf(F("Trace %S: %lu of %lu cycles in %u bytes"),
+                     busTrace.isEnabled() ? PSTR("ON") : PSTR("OFF"),
+                     (unsigned long)busTrace.getHeldCycles(), (unsigned long)busTrace.getRunCycles(),
+                     (uint16_t)busTrace.getBlockCount() * BUS_TRACE_BLOCK_SIZE);
+        if (busTrace.getHeldTest() != BUS_TRACE_NOT_HELD) {
+            uart.sendInfof(F("Held: run of failed test %d (TRACE CLEAR releases it)"), busTrace.getHeldTest());
+        }
+        return;
+    }
+
+    char* cursor = parameter;
+    int8_t option = CommandParser::findKeyword(CommandParser::nextToken(cursor), TRACE_KEYWORDS, TRACE_KEY_COUNT);
+    if (option == TRACE_KEY_LIST) {
+        const char* countStr = CommandParser::nextToken(cursor);
+        uint32_t count = 16;
+        if ((*countStr != '\0' && !CommandParser::parseNumber(countStr, count, 10)) || *cursor != '\0' ||
+            count == 0) {
+            uart.sendError(F("Invalid count. Usage: TRACE LIST [n]"));
+            return;
+        }
+        sendTraceList(count);
+        return;
+    }
+    if (*cursor != '\0') {
+        option = -1;
+    }
+
+    switch (option) {
+        case TRACE_KEY_ON:
+            busTrace.setEnabled(true);
+            uart.sendOK(F("Trace on: Z80/6502 runs are recorded"));
+            break;
+
+        case TRACE_KEY_OFF:
+            busTrace.setEnabled(false);
+            uart.sendOK(F("Trace off"));
+            break;
+
+        case TRACE_KEY_CLEAR:
+            busTrace.clear();
+            uart.sendOK(F("Trace cleared"));
+            break;
+
+        case TRACE_KEY_DUMP:
+            sendTraceDump();
+            break;
+
+        default:
+            uart.sendError(F("Invalid TRACE option. Usage: TRACE [ON|OFF|CLEAR|DUMP|LIST [n]]"));
+            break;
+    }
+}
+
+/**
+ * Stream the trace blocks as TRACE_INFO + TRACE_DATA records (any protocol)
+ */
+void sendTraceDump() {
+    if (busTrace.getBlockCount() == 0) {
+        uart.sendError(F("Trace empty. Use TRACE ON, then TEST"));
+        return;
+    }
+
+    uint16_t bytes = (uint16_t)busTrace.getBlockCount() * BUS_TRACE_BLOCK_SIZE;
+    BinaryRecord info(BIN_REC_TRACE_INFO);
+    info.put8(busTrace.getBlockCount()).put8(busTrace.getHeldTest()).put16(bytes).put32(busTrace.getHeldCycles());
+    uart.sendRecord(info);
+
+    // Blocks oldest first, as one byte stream cut into chunks
+    for (uint16_t offset = 0; offset < bytes; offset += BIN_TRACE_CHUNK) {
+        BinaryRecord data(BIN_REC_TRACE_DATA);
+        data.put16(offset);
+        for (uint16_t i = offset; i < offset + BIN_TRACE_CHUNK && i < bytes; i++) {
+            data.put8(busTrace.getBlock(i / BUS_TRACE_BLOCK_SIZE)[i % BUS_TRACE_BLOCK_SIZE]);
+        }
+        uart.sendRecord(data);
+    }
+
+    uart.sendOKf(F("Trace dump: %u bytes, %lu cycles"), bytes, (unsigned long)busTrace.getHeldCycles());
+}
+
+/**
+ * Decode the trace on the device and list its last count cycles
+ */
+void sendTraceList(uint32_t count) {
+    uint32_t held = busTrace.getHeldCycles();
+    if (held == 0) {
+        uart.sendError(F("Trace empty. Use TRACE ON, then TEST"));
+        return;
+    }
+    if (count > held) count = held;
+
+    BusTraceReader reader(busTrace);
+    BusTraceCycle cycle;
+    for (uint32_t skip = held - count; skip > 0; skip--) {
+        reader.next(cycle);
+    }
+
+    uart.sendInfo(F("     Cycle  Addr  Data  Type"));
+    while (reader.next(cycle)) {
+        PGM_P type;
+        switch (cycle.control) {
+            case BUS_TRACE_FETCH | BUS_TRACE_READ | BUS_TRACE_MREQ: type = PSTR("fetch"); break;
+            case BUS_TRACE_READ | BUS_TRACE_MREQ: type = PSTR("read"); break;
+            case BUS_TRACE_WRITE | BUS_TRACE_MREQ: type = PSTR("write"); break;
+            case BUS_TRACE_READ | BUS_TRACE_IORQ: type = PSTR("io read"); break;
+            case BUS_TRACE_WRITE | BUS_TRACE_IORQ: type = PSTR("io write"); break;
+            case BUS_TRACE_FETCH | BUS_TRACE_IORQ: type = PSTR("int ack"); break;
+            default: type = PSTR("other"); break;
+        }
+        uart.sendInfof(F("  %8lu  %04X  %02X    %S"), (unsigned long)cycle.index, cycle.address, cycle.data, type);
+    }
+    uart.sendOKf(F("Last %lu of %lu cycles"), (unsigned long)count, (unsigned long)busTrace.getRunCycles());
+}
+
+/**
+ * Handle PLAN command
+ * Supports: PLAN, PLAN ADD <command>, PLAN CLEAR, PLAN REPEAT <n>,
+ * PLAN STOP <ON|OFF>, PLAN RESET
+ */
+void handlePlanCommand(char* parameter) {
+    if (parameter[0] == '\0') {
+        uint8_t count = planStore.getStepCount();
+        if (count == 0) {
+            uart.sendInfo(F("Plan: empty (PLAN ADD <command>)"));
+        } else {
+            uart.sendInfof(F("Plan: %u steps, repeat %u, stop on fail %S"), count, planStore.getRepeat(),
+                           planStore.getStopOnFail() ? PSTR("ON") : PSTR("OFF"));
+            char step[PLAN_STEP_SIZE];
+            for (uint8_t i = 0; i < count; i++) {
+                planStore.getStep(i, step, sizeof(step));
+                uart.sendInfof(F("  %u: %s"), i + 1, step);
+            }
+        }
+        uart.sendInfof(F("Batch: %u DUTs, %u PASS, %u FAIL"), planRunner.getDutCount(),
+                       planRunner.getPassCount(), planRunner.getFailCount());
+        return;
+    }
+
+    char* cursor = parameter;
+    int8_t option = CommandParser::findKeyword(CommandParser::nextToken(cursor), PLAN_KEYWORDS, PLAN_KEY_COUNT);
+    if (option == PLAN_KEY_ADD) {
+        // The rest of the line is the step
+        const char* command = cursor;
+
+        // Check the command word on a copy (parse() splits in place)
+        char check[PLAN_STEP_SIZE];
+        strncpy(check, command, sizeof(check) - 1);
+        check[sizeof(check) - 1] = '\0';
+        CommandType type = parser.parse(check).type;
+        if (type == INVALID || type == PLAN || type == RUN || type == PROTO || type == ABORT ||
+            type == PAUSE || type == RESUME) {
+            uart.sendError(F("Not a plan step. Use MODE, TEST, RESET, CLOCK, PERF, TRACE, ..."));
+            return;
+        }
+
+        if (strlen(command) >= PLAN_STEP_SIZE) {
+            uart.sendErrorf(F("Step too long (max %u)"), PLAN_STEP_SIZE - 1);
+            return;
+        }
+        if (!planStore.addStep(command)) {
+            uart.sendErrorf(F("Plan full (%u steps)"), PLAN_MAX_STEPS);
+            return;
+        }
+        uart.sendOKf(F("Step %u: %s"), planStore.getStepCount(), command);
+        return;
+    }
+
+    // The other options take at most one word
+    const char* argument = CommandParser::nextToken(cursor);
+    bool hasArgument = option == PLAN_KEY_REPEAT || option == PLAN_KEY_STOP;
+    if (*cursor != '\0' || (*argument != '\0') != hasArgument) {
+        option = -1;
+    }
+
+    switch (option) {
+        case PLAN_KEY_CLEAR:
+            planStore.clear();
+            uart.sendOK(F("Plan cleared"));
+            break;
+
+        case PLAN_KEY_REPEAT: {
+            uint32_t repeat = 0;
+            if (!CommandParser::parseNumber(argument, repeat, 10) || repeat < 1 || repeat > 255) {
+                uart.sendError(F("Invalid repeat count (1-255)"));
+                return;
+            }
+            planStore.setRepeat((uint8_t)repeat);
+            uart.sendOKf(F("Plan repeat %u"), planStore.getRepeat());
+            break;
+        }
+
+        case PLAN_KEY_STOP: {
+            int8_t stop = CommandParser::findKeyword(argument, SWITCH_KEYWORDS, SWITCH_KEY_COUNT);
+            if (stop < 0) {
+                uart.sendError(F("Usage: PLAN STOP <ON|OFF>"));
+                return;
+            }
+            planStore.setStopOnFail(stop == 1);
+            uart.sendOK(stop == 1 ? F("DUT ends at its first failing step") : F("DUT runs all steps after a failure"));
+            break;
+        }
+
+        case PLAN_KEY_RESET:
+            planRunner.resetCounts();
+            uart.sendOK(F("Batch counts cleared"));
+            break;
+
+        default:
+            uart.sendError(F("Invalid PLAN option. Usage: PLAN [ADD <command>|CLEAR|REPEAT <n>|STOP <ON|OFF>|RESET]"));
+            break;
+    }
+}
+
+/**
+ * Handle RUN command
+ * Runs the stored plan on one DUT; the summary line is the reply
+ */
+void handleRunCommand() {
+    if (sramStrategy.isRunning()) {
+        uart.sendError(F("Test already running (ABORT to stop)"));
+        return;
+    }
+    if (refuseWhileTransferring()) return;
+    if (planStore.getStepCount() == 0) {
+        uart.sendError(F("No plan stored (PLAN ADD <command>)"));
+        return;
+    }
+
+    planRunner.start();
+}
+
+/**
+ * Refuse a command while DUMP/CRC reads the SRAM bus or LOAD receives
+ * (a CPU test would hold the main loop, and the link, for its run)
+ *
+ * @return true if refused (error sent)
+ */
+bool refuseWhileTransferring() {
+    if (sramDump.isActive()) {
+        uart.sendError(F("DUMP/CRC running (ABORT to stop)"));
+        return true;
+    }
+    if (imageLoader.isActive()) {
+        uart.sendError(F("LOAD in progress (ABORT to stop)"));
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Handle DUMP and CRC commands
+ * Supports: DUMP [<start> <len>] [B], CRC [<start> <len>] [16|32] [B]
+ * Numbers in decimal or 0x hex; without a range, the whole chip.
+ * Runs in the background like a test; the OK line carries the result.
+ */
+void handleReadBackCommand(char* parameter, bool dump) {
+    if (sramStrategy.isRunning()) {
+        uart.sendError(F("Test already running (ABORT to stop)"));
+        return;
+    }
+    if (refuseWhileTransferring()) return;
+
+    if (modeManager.getCurrentMode() != ModeManager::SRAM62256) {
+        uart.sendError(F("No SRAM selected"));
+        uart.sendInfo(F("Use MODE command first: MODE SRAM <size>"));
+        return;
+    }
+
+    // Up to three numbers: [start len] and, for CRC, the width; B last
+    PGM_P usage = dump ? PSTR("DUMP [<start> <len>] [B]") : PSTR("CRC [<start> <len>] [16|32] [B]");
+    uint32_t values[3];
+    uint8_t count = 0;
+    bool socketB = false;
+    char* cursor = parameter;
+    while (*cursor != '\0') {
+        const char* word = CommandParser::nextToken(cursor);
+        if (*cursor == '\0' && strcmp_P(word, KEY_SOCKET_B) == 0) {
+            socketB = true;
+        } else if (count == 3 || !CommandParser::parseNumber(word, values[count++], 0)) {
+            uart.sendErrorf(F("Usage: %S"), usage);
+            return;
+        }
+    }
+    if (socketB && !sramStrategy.isDualSocket()) {
+        uart.sendError(F("Socket B needs MODE SRAM <size> DUAL"));
+        return;
+    }
+
+    uint32_t width = 32;
+    if (!dump && (count == 1 || count == 3)) {
+        width = values[--count];
+    }
+    if (count == 1 || count == 3 || (width != 16 && width != 32)) {
+        uart.sendErrorf(F("Usage: %S"), usage);
+        return;
+    }
+
+    uint32_t size = sramStrategy.getSize();
+    uint32_t start = (count == 2) ? values[0] : 0;
+    uint32_t length = (count == 2) ? values[1] : size;
+    if (length == 0 || start >= size || length > size - start) {
+        uart.sendErrorf(F("Range must be within 0x0000-0x%04X"), (uint16_t)(size - 1));
+        return;
+    }
+
+    uint8_t kind = dump ? SRAM_READ_DUMP : (width == 16) ? SRAM_READ_CRC16 : SRAM_READ_CRC32;
+    sramDump.start(sramStrategy.getBus(), (uint16_t)start, length, kind,
+                   socketB ? SRAM_SOCKET_B : SRAM_SOCKET_A);
+}
+
+/**
+ * Check that TEST IMAGE has a program to run
+ *
+ * @return false if none (error sent)
+ */
+bool requireImage() {
+    if (programImage.isLoaded()) {
+        return true;
+    }
+    uart.sendError(F("No image loaded (LOAD <addr> <len>)"));
+    return false;
+}
+
+/**
+ * Handle LOAD command
+ * Supports: LOAD (show), LOAD <addr> <len>, LOAD SAVE, LOAD CLEAR
+ * Address and length in decimal or 0x hex; the host then sends
+ * LOAD_DATA records (see utils/ImageLoader.h)
+ */
+void handleLoadCommand(char* parameter) {
+    if (sramStrategy.isRunning()) {
+        uart.sendError(F("Test already running (ABORT to stop)"));
+        return;
+    }
+    if (refuseWhileTransferring()) return;
+
+    if (parameter[0] == '\0') {
+        if (!programImage.isLoaded()) {
+            uart.sendInfo(F("No image loaded"));
+            return;
+        }
+        uart.sendInfof(F("Image: %u bytes at 0x%04X, CRC-32 0x%08lX, %S"), programImage.getLength(),
+                       programImage.getBase(), (unsigned long)programImage.getCrc32(),
+                       programImage.isSaved() ? PSTR("saved") : PSTR("not saved"));
+        return;
+    }
+
+    int8_t option = CommandParser::findKeyword(parameter, LOAD_KEYWORDS, LOAD_KEY_COUNT);
+    if (option == LOAD_KEY_SAVE) {
+        if (!programImage.save()) {
+            uart.sendError(F("No image loaded"));
+            return;
+        }
+        uart.sendOKf(F("Image saved: %u bytes at 0x%04X"), programImage.getLength(), programImage.getBase());
+        return;
+    }
+
+    if (option == LOAD_KEY_CLEAR) {
+        programImage.clear();
+        uart.sendOK(F("Image cleared"));
+        return;
+    }
+
+    char* cursor = parameter;
+    uint32_t base = 0;
+    uint32_t length = 0;
+    bool valid = CommandParser::parseNumber(CommandParser::nextToken(cursor), base, 0) &&
+                 CommandParser::parseNumber(CommandParser::nextToken(cursor), length, 0) && *cursor == '\0';
+    if (!valid || base > 0xFFFF || length > 0xFFFF ||
+        !ProgramImage::isValidBlock((uint16_t)base, (uint16_t)length)) {
+        uart.sendErrorf(F("Usage: LOAD <addr> <len> (1-%u bytes from a 256-byte page, within 0x0000-0xFFFF)"),
+                        PROGRAM_IMAGE_SIZE);
+        return;
+    }
+
+    uart.sendInfof(F("LOAD 0x%04X, %u bytes: send LOAD_DATA records, window %u"), (uint16_t)base,
+                   (uint16_t)length, LOAD_WINDOW);
+    imageLoader.start((uint16_t)base, (uint16_t)length);
+}
+
+/**
+ * Handle MAP command
+ * Supports: MAP (show), MAP RAM|FAULT|OPEN <addr> <len>, MAP CLEAR
+ * Whole 256-byte pages around the range; the image is mapped in as ROM
+ * pages by TEST IMAGE (see hardware/MemoryMap.h)
+ */
+void handleMapCommand(char* parameter) {
+    if (parameter[0] == '\0') {
+        sendMemoryMap();
+        return;
+    }
+
+    char* cursor = parameter;
+    int8_t option = CommandParser::findKeyword(CommandParser::nextToken(cursor), MAP_KEYWORDS, MAP_KEY_COUNT);
+    if (option == MAP_KEY_CLEAR && *cursor == '\0') {
+        memoryMap.clear();
+        uart.sendOK(F("Memory map cleared (all pages open)"));
+        return;
+    }
+    if (option < 0 || option == MAP_KEY_CLEAR) {
+        uart.sendError(F("Usage: MAP [RAM|FAULT|OPEN <addr> <len>|CLEAR]"));
+        return;
+    }
+
+    uint32_t base = 0;
+    uint32_t length = 0;
+    bool valid = CommandParser::parseNumber(CommandParser::nextToken(cursor), base, 0) &&
+                 CommandParser::parseNumber(CommandParser::nextToken(cursor), length, 0) && *cursor == '\0';
+    if (!valid || base > 0xFFFF || length == 0 || base + length > 0x10000) {
+        uart.sendError(F("Usage: MAP RAM|FAULT|OPEN <addr> <len> (within 0x0000-0xFFFF)"));
+        return;
+    }
+
+    if (option == MAP_KEY_RAM) {
+        if (!memoryMap.mapRam((uint16_t)base, (uint16_t)length)) {
+            uart.sendErrorf(F("Not enough RAM pages (%u of %u free)"), memoryMap.getFreePoolPages(),
+                            MEMORY_POOL_PAGES);
+            return;
+        }
+    } else if (option == MAP_KEY_FAULT) {
+        memoryMap.mapFault((uint16_t)base, (uint16_t)length);
+    } else {
+        memoryMap.unmap((uint16_t)base, (uint16_t)length);
+    }
+    sendMemoryMap();
+}
+
+/**
+ * List the mapped page ranges, consecutive pages of one kind together
+ */
+void sendMemoryMap() {
+    uart.sendInfof(F("Memory map: %u of %u RAM pages free"), memoryMap.getFreePoolPages(), MEMORY_POOL_PAGES);
+
+    bool any = false;
+    uint16_t page = 0;
+    while (page < 256) {
+        MemoryPageKind kind = memoryMap.getKind((uint8_t)page);
+        uint16_t last = page;
+        while (last < 255 && memoryMap.getKind((uint8_t)(last + 1)) == kind) last++;
+
+        if (kind != MEMORY_OPEN) {
+            PGM_P name = (kind == MEMORY_RAM) ? PSTR("RAM") : (kind == MEMORY_ROM) ? PSTR("ROM") : PSTR("FAULT");
+            uart.sendInfof(F("  0x%04X-0x%04X %S"), page << 8, (last << 8) | 0xFF, name);
+            any = true;
+        }
+        page = last + 1;
+    }
+    if (!any) {
+        uart.sendInfo(F("  All pages open"));
+    }
+    if (memoryMap.getFaults() != 0) {
+        uart.sendInfof(F("  Faults in the last run: %u, first at 0x%04X"), memoryMap.getFaults(),
+                       memoryMap.getFirstFault());
+    }
 }
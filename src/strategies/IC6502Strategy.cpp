@@ -0,0 +1,409 @@
+/**
+ * IC6502Strategy.cpp
+ *
+ * Implementation of the 6502 CPU testing strategy
+ */
+
+#include "strategies/IC6502Strategy.h"
+#include <Arduino.h>
+
+//=============================================================================
+// TEST PROGRAMS (ROM images at F000h, PROGMEM)
+//=============================================================================
+
+// Test 3: JMP $F000 (3 reads per loop: opcode + 2 operand bytes)
+static const uint8_t PROGRAM_JMP_LOOP[] PROGMEM = {
+    0x4C, 0x00, 0xF0             // JMP $F000
+};
+
+// Test 4: two zero-page writes, second value on the stop port
+static const uint8_t PROGRAM_MEMORY_WRITE[] PROGMEM = {
+    0xA9, 0x55,                  // LDA #$55
+    0x85, 0x00,                  // STA $00
+    0xA9, 0xAA,                  // LDA #$AA
+    0x85, 0x01,                  // STA $01
+    0x8D, 0xFF, 0x1F,            // STA $1FFF
+    0x4C, 0x0B, 0xF0             // JMP * (run ends on the stop port first)
+};
+
+// Test 5: read both bytes back, report their EOR on the stop port
+static const uint8_t PROGRAM_MEMORY_READ[] PROGMEM = {
+    0xA5, 0x00,                  // LDA $00
+    0x45, 0x01,                  // EOR $01
+    0x8D, 0xFF, 0x1F,            // STA $1FFF
+    0x4C, 0x07, 0xF0             // JMP *
+};
+
+constexpr uint32_t JMP_LOOP_CYCLES = 3000;    // ~1000 loops, long enough for a rate figure
+constexpr uint8_t RESET_VECTOR_CYCLES = 12;   // 2 + 7-cycle sequence + first fetches
+
+IC6502Strategy::IC6502Strategy()
+    : clock(nullptr), uart(nullptr), savedClockHz(0), image(nullptr), imageBase(0), imageSize(0), map(nullptr) {
+}
+
+void IC6502Strategy::setClock(Timer3Clock* timer) {
+    clock = timer;
+}
+
+void IC6502Strategy::setUARTHandler(UARTHandler* handler) {
+    uart = handler;
+}
+
+void IC6502Strategy::setTrace(BusTrace* trace) {
+    bus.setTrace(trace);
+}
+
+void IC6502Strategy::setImage(const uint8_t* data, uint16_t base, uint16_t size) {
+    image = data;
+    imageBase = base;
+    imageSize = (data != nullptr) ? size : 0;
+}
+
+void IC6502Strategy::setMemoryMap(MemoryMap* memory) {
+    map = memory;
+}
+
+const __FlashStringHelper* IC6502Strategy::getName() const {
+    return F("6502");
+}
+
+void IC6502Strategy::configurePins() {
+    // 6502 drives address, data, R/W, SYNC; we drive RES, RDY, IRQ, NMI,
+    // S.O. Held in reset until a test runs.
+    bus.configurePins();
+}
+
+void IC6502Strategy::reset() {
+    if (clock != nullptr && clock->running()) {
+        // Free-running Timer3: RES LOW for 2+ of its cycles
+        bus.holdReset();
+        delayMicroseconds((uint16_t)(4000000UL / clock->getFrequency()) + 1);
+        bus.releaseReset();
+    } else {
+        // No clock: firmware clocks the reset, CPU then idles in Φ1
+        bus.beginFirmwareClock(clock);
+        bus.resetCpu();
+    }
+}
+
+bool IC6502Strategy::runTests() {
+    if (uart != nullptr) {
+        uart->sendInfo(F("Starting 6502 CPU tests (firmware burst clock)..."));
+    }
+
+    saveClock();
+    uint8_t failed = 0;
+    for (uint8_t test = 1; test <= IC6502_TEST_COUNT; test++) {
+        if (!runSingle(test)) failed++;
+    }
+    restoreClock();
+
+    if (uart != nullptr) {
+        if (failed == 0) {
+            uart->sendOK(F("All tests PASSED"));
+        } else {
+            uart->sendErrorf(F("%d of %d tests FAILED"), failed, IC6502_TEST_COUNT);
+        }
+    }
+    return failed == 0;
+}
+
+bool IC6502Strategy::runTest(uint8_t testNumber) {
+    if (testNumber < 1 || testNumber > IC6502_IMAGE_TEST) {
+        if (uart != nullptr) {
+            uart->sendErrorf(F("Invalid test number (1-%d)"), IC6502_IMAGE_TEST);
+        }
+        return false;
+    }
+    if (testNumber == IC6502_IMAGE_TEST && (imageSize == 0 || map == nullptr)) {
+        if (uart != nullptr) {
+            uart->sendError(F("No image loaded (LOAD <addr> <len>)"));
+        }
+        return false;
+    }
+
+    saveClock();
+    bool passed = runSingle(testNumber);
+    restoreClock();
+    return passed;
+}
+
+bool IC6502Strategy::runSingle(uint8_t testNumber) {
+    if (uart != nullptr) {
+        uart->sendInfof(F("Test %d (%S)"), testNumber, getTestName(testNumber));
+    }
+
+    bool passed;
+    switch (testNumber) {
+        case 1: passed = testResetVector(); break;
+        case 2: passed = testClock(); break;
+        case 3: passed = testJmpLoop(); break;
+        case 4: passed = testMemoryWrite(); break;
+        case 5: passed = testMemoryRead(); break;
+        default: passed = testImage(); break;
+    }
+
+    // Keep the failing run's bus cycles for TRACE DUMP (tests that run a program)
+    BusTrace* trace = bus.getTrace();
+    bool held = false;
+    if (!passed && testNumber != 2 && trace != nullptr) {
+        trace->hold(testNumber);
+        held = trace->getHeldTest() == testNumber;
+    }
+
+    if (uart != nullptr) {
+        if (passed) {
+            uart->sendOKf(F("Test %d (%S) - PASSED"), testNumber, getTestName(testNumber));
+        } else {
+            uart->sendErrorf(F("Test %d (%S) - FAILED"), testNumber, getTestName(testNumber));
+            if (held) {
+                uart->sendInfof(F("  Bus trace held: %lu cycles (TRACE DUMP)"),
+                                (unsigned long)trace->getHeldCycles());
+            }
+        }
+    }
+    return passed;
+}
+
+void IC6502Strategy::stepCycles(uint8_t count) {
+    if (count == 0 || count > IC6502_STEP_MAX) {
+        if (uart != nullptr) {
+            uart->sendErrorf(F("Step count must be 1-%u"), IC6502_STEP_MAX);
+        }
+        return;
+    }
+
+    // Recorded first, printed afterwards (NMOS parts can't wait for the UART)
+    IC6502Cycle cycles[IC6502_STEP_MAX];
+    saveClock();
+    bus.loadRom(PROGRAM_MEMORY_WRITE, sizeof(PROGRAM_MEMORY_WRITE));
+    bus.clearRam();
+    bus.resetCpu();
+    bus.step(cycles, count);
+    bus.holdReset();
+    restoreClock();
+
+    if (uart == nullptr) return;
+    uart->sendInfo(F("  Cycle  Addr  Data  R/W  SYNC"));
+    for (uint8_t i = 0; i < count; i++) {
+        uart->sendInfof(F("  %5u  %04X  %02X    %c    %S"), i + 1, cycles[i].address, cycles[i].data,
+                        cycles[i].read ? 'R' : 'W', cycles[i].sync ? PSTR("*") : PSTR(""));
+    }
+    uart->sendOKf(F("%u cycles after reset (test 4 program)"), count);
+}
+
+//=============================================================================
+// TESTS
+//=============================================================================
+
+// Test 1: reset sequence reads the RES vector, then fetches from it
+bool IC6502Strategy::testResetVector() {
+    IC6502Cycle cycles[RESET_VECTOR_CYCLES];
+    bus.loadRom(PROGRAM_JMP_LOOP, sizeof(PROGRAM_JMP_LOOP));
+    bus.resetCpu();
+    bus.step(cycles, RESET_VECTOR_CYCLES);
+    bus.holdReset();
+
+    for (uint8_t i = 0; i + 2 < RESET_VECTOR_CYCLES; i++) {
+        if (cycles[i].read && cycles[i].address == 0xFFFC &&
+            cycles[i + 1].read && cycles[i + 1].address == 0xFFFD) {
+            bool fetched = cycles[i + 2].sync && cycles[i + 2].address == IC6502_ROM_BASE;
+            if (uart != nullptr) {
+                uart->sendInfof(F("  Vector read in cycles %u-%u, next fetch %04X%S"), i + 1, i + 2,
+                                cycles[i + 2].address, cycles[i + 2].sync ? PSTR(" (SYNC)") : PSTR(" (no SYNC)"));
+            }
+            return fetched;
+        }
+    }
+
+    if (uart != nullptr) {
+        uart->sendInfof(F("  No FFFC/FFFD read in %u cycles (first: %04X %04X %04X)"), RESET_VECTOR_CYCLES,
+                        cycles[0].address, cycles[1].address, cycles[2].address);
+    }
+    return false;
+}
+
+// Test 2: Timer3 free-run on Φ0, the CPU's Φ1/Φ2 outputs follow it
+bool IC6502Strategy::testClock() {
+    if (clock == nullptr) {
+        if (uart != nullptr) {
+            uart->sendError(F("No clock generator configured"));
+        }
+        return false;
+    }
+
+    // Φ1/Φ2 follow Φ0 in reset too
+    bus.holdReset();
+    clock->configure(IC6502_FREE_RUN_HZ);
+    clock->start();
+
+    uint16_t phi1Edges = 0;
+    uint16_t phi2Edges = 0;
+    uint16_t overlaps = 0;
+    using IC6502Pins::Phi1;
+    using IC6502Pins::Phi2;
+    uint8_t last = IC6502Pins::PhaseMonitors::read();
+    for (uint16_t i = 0; i < 2000; i++) {
+        uint8_t level = IC6502Pins::PhaseMonitors::read();
+        uint8_t changed = level ^ last;
+        if (changed & Phi1::MASK) phi1Edges++;
+        if (changed & Phi2::MASK) phi2Edges++;
+        if (level == IC6502Pins::PhaseMonitors::MASK) overlaps++;
+        last = level;
+    }
+
+    // Back to the firmware clock for the execution tests
+    bus.beginFirmwareClock(clock);
+
+    if (uart != nullptr) {
+        uart->sendInfof(F("  Timer3 %lu Hz: PHI1 %u edges, PHI2 %u edges, %u overlaps in 2000 samples"),
+                        (unsigned long)IC6502_FREE_RUN_HZ, phi1Edges, phi2Edges, overlaps);
+    }
+    return phi1Edges > 0 && phi2Edges > 0 && overlaps == 0;
+}
+
+// Test 3: JMP loop fetches F000, F001, F002 over and over
+bool IC6502Strategy::testJmpLoop() {
+    IC6502RunResult result = runProgram(PROGRAM_JMP_LOOP, sizeof(PROGRAM_JMP_LOOP), JMP_LOOP_CYCLES);
+
+    bool sequence = result.traced == IC6502_TRACE_SIZE;
+    for (uint8_t i = 0; i < result.traced; i++) {
+        if (result.trace[i] != IC6502_ROM_BASE + i % 3) sequence = false;
+    }
+
+    // Everything after the reset sequence is 3-cycle loops
+    uint32_t loopCycles = result.fetches * 3;
+    bool counts = result.writes == 0 && loopCycles <= result.cycles + 2 &&
+                  result.cycles - loopCycles <= RESET_VECTOR_CYCLES;
+    bool passed = result.end == IC6502_END_LIMIT && sequence && counts;
+
+    if (uart != nullptr) {
+        sendRunEnd(result);
+        if (!sequence) {
+            uart->sendInfof(F("  Reads: %04X %04X %04X %04X %04X %04X (expected F000 F001 F002 ...)"),
+                            result.trace[0], result.trace[1], result.trace[2],
+                            result.trace[3], result.trace[4], result.trace[5]);
+        }
+        if (result.elapsed != 0) {
+            uart->sendInfof(F("  Burst clock: %lu kHz effective"),
+                            (unsigned long)(result.cycles * (F_CPU / 1000UL) / result.elapsed));
+        }
+    }
+    return passed;
+}
+
+// Test 4: program stores 55h/AAh in zero page and reports AAh
+bool IC6502Strategy::testMemoryWrite() {
+    bus.clearRam();
+    IC6502RunResult result = runProgram(PROGRAM_MEMORY_WRITE, sizeof(PROGRAM_MEMORY_WRITE));
+
+    uint8_t first = bus.peekRam(0x0000);
+    uint8_t second = bus.peekRam(0x0001);
+    bool passed = result.end == IC6502_END_STOP && result.exitCode == 0xAA &&
+                  result.writes == 3 && first == 0x55 && second == 0xAA;
+
+    if (uart != nullptr) {
+        sendRunEnd(result);
+        uart->sendInfof(F("  RAM[$00]=%02X RAM[$01]=%02X (expected 55 AA), exit %02X"),
+                        first, second, result.exitCode);
+    }
+    return passed;
+}
+
+// Test 5: program reads 55h/AAh from zero page and reports their EOR (FFh)
+bool IC6502Strategy::testMemoryRead() {
+    bus.clearRam();
+    bus.pokeRam(0x0000, 0x55);
+    bus.pokeRam(0x0001, 0xAA);
+    IC6502RunResult result = runProgram(PROGRAM_MEMORY_READ, sizeof(PROGRAM_MEMORY_READ));
+
+    bool passed = result.end == IC6502_END_STOP && result.exitCode == 0xFF;
+
+    if (uart != nullptr) {
+        sendRunEnd(result);
+        uart->sendInfof(F("  55h EOR AAh = %02X (expected FF)"), result.exitCode);
+    }
+    return passed;
+}
+
+// Test 6 (TEST IMAGE): uploaded program, passes on 00h to the stop port
+bool IC6502Strategy::testImage() {
+    bus.clearRam();
+
+    // The image replaces the last program's ROM pages; MAP pages stay
+    map->unmapRom();
+    if (!map->mapRom(imageBase, image, imageSize)) {
+        if (uart != nullptr) {
+            uart->sendError(F("Image doesn't fit the memory map (base must be on a 256-byte page)"));
+        }
+        return false;
+    }
+    map->resetFaults();
+    bus.setMemoryMap(map);
+    IC6502RunResult result = runProgram(nullptr, 0);
+    bus.setMemoryMap(nullptr);
+
+    bool passed = result.end == IC6502_END_STOP && result.exitCode == 0x00 && map->getFaults() == 0;
+
+    if (uart != nullptr) {
+        sendRunEnd(result);
+        uint8_t ram[8];
+        for (uint8_t i = 0; i < sizeof(ram); i++) {
+            ram[i] = bus.peekRam(IC6502_RAM_BASE + i);
+        }
+        uart->sendInfof(F("  Exit %02X%S, RAM[$00-$07]: %02X %02X %02X %02X %02X %02X %02X %02X"),
+                        result.exitCode, (result.end == IC6502_END_STOP) ? PSTR("") : PSTR(" (no stop write)"),
+                        ram[0], ram[1], ram[2], ram[3], ram[4], ram[5], ram[6], ram[7]);
+        if (map->getFaults() != 0) {
+            uart->sendInfof(F("  Map faults: %u, first at $%04X"), map->getFaults(), map->getFirstFault());
+        }
+    }
+    return passed;
+}
+
+//=============================================================================
+// HELPERS
+//=============================================================================
+
+void IC6502Strategy::saveClock() {
+    savedClockHz = (clock != nullptr && clock->running()) ? clock->getFrequency() : 0;
+    bus.beginFirmwareClock(clock);
+}
+
+void IC6502Strategy::restoreClock() {
+    if (savedClockHz != 0 && clock != nullptr) {
+        clock->configure(savedClockHz);
+        clock->start();
+    }
+}
+
+IC6502RunResult IC6502Strategy::runProgram(const uint8_t* program, uint16_t size, uint32_t cycleLimit) {
+    bus.loadRom(program, size);
+    return bus.run(cycleLimit, IC6502_RUN_TIMEOUT_MS);
+}
+
+PGM_P IC6502Strategy::getTestName(uint8_t testNumber) {
+    switch (testNumber) {
+        case 1: return PSTR("Reset Vector");
+        case 2: return PSTR("Clock Generation");
+        case 3: return PSTR("JMP Loop");
+        case 4: return PSTR("Memory Write");
+        case 5: return PSTR("Memory Read");
+        case 6: return PSTR("Loaded Image");
+        default: return PSTR("Unknown");
+    }
+}
+
+void IC6502Strategy::sendRunEnd(const IC6502RunResult& result) {
+    if (uart == nullptr) return;
+
+    PGM_P end;
+    switch (result.end) {
+        case IC6502_END_STOP: end = PSTR("stop port"); break;
+        case IC6502_END_LIMIT: end = PSTR("cycle limit"); break;
+        default: end = PSTR("TIMEOUT"); break;
+    }
+    uart->sendInfof(F("  Ended by %S after %lu cycles: %lu reads (%lu fetches), %lu writes, %u bursts"),
+                    end, (unsigned long)result.cycles, (unsigned long)result.reads,
+                    (unsigned long)result.fetches, (unsigned long)result.writes, result.bursts);
+}
@@ -0,0 +1,91 @@
+/**
+ * MarchTest.cpp
+ *
+ * Built-in March algorithm tables (PROGMEM) and lookup helpers
+ */
+
+#include "strategies/MarchTest.h"
+#include <avr/pgmspace.h>
+
+// MATS+: ⇕(w0); ⇑(r0,w1); ⇓(r1,w0)
+static const MarchElement MATS_PLUS[] PROGMEM = {
+    {MARCH_ANY,  1, {MARCH_W0}},
+    {MARCH_UP,   2, {MARCH_R0, MARCH_W1}},
+    {MARCH_DOWN, 2, {MARCH_R1, MARCH_W0}}
+};
+
+// March C-: ⇕(w0); ⇑(r0,w1); ⇑(r1,w0); ⇓(r0,w1); ⇓(r1,w0); ⇕(r0)
+static const MarchElement MARCH_C_MINUS[] PROGMEM = {
+    {MARCH_ANY,  1, {MARCH_W0}},
+    {MARCH_UP,   2, {MARCH_R0, MARCH_W1}},
+    {MARCH_UP,   2, {MARCH_R1, MARCH_W0}},
+    {MARCH_DOWN, 2, {MARCH_R0, MARCH_W1}},
+    {MARCH_DOWN, 2, {MARCH_R1, MARCH_W0}},
+    {MARCH_ANY,  1, {MARCH_R0}}
+};
+
+// March B: ⇕(w0); ⇑(r0,w1,r1,w0,r0,w1); ⇑(r1,w0,w1); ⇓(r1,w0,w1,w0); ⇓(r0,w1,w0)
+static const MarchElement MARCH_B[] PROGMEM = {
+    {MARCH_ANY,  1, {MARCH_W0}},
+    {MARCH_UP,   6, {MARCH_R0, MARCH_W1, MARCH_R1, MARCH_W0, MARCH_R0, MARCH_W1}},
+    {MARCH_UP,   3, {MARCH_R1, MARCH_W0, MARCH_W1}},
+    {MARCH_DOWN, 4, {MARCH_R1, MARCH_W0, MARCH_W1, MARCH_W0}},
+    {MARCH_DOWN, 3, {MARCH_R0, MARCH_W1, MARCH_W0}}
+};
+
+static const char KEY_MATS_PLUS[] PROGMEM = "MATS+";
+static const char KEY_C_MINUS[] PROGMEM = "CMINUS";
+static const char NAME_C_MINUS[] PROGMEM = "March C-";
+static const char KEY_B[] PROGMEM = "B";
+static const char NAME_B[] PROGMEM = "March B";
+
+const MarchAlgorithm MARCH_ALGORITHMS[MARCH_ALGORITHM_COUNT] = {
+    {KEY_MATS_PLUS, KEY_MATS_PLUS, 0x00, 5,  sizeof(MATS_PLUS) / sizeof(MarchElement),     MATS_PLUS},
+    {KEY_C_MINUS,   NAME_C_MINUS,  0x00, 10, sizeof(MARCH_C_MINUS) / sizeof(MarchElement), MARCH_C_MINUS},
+    {KEY_B,         NAME_B,        0x00, 17, sizeof(MARCH_B) / sizeof(MarchElement),       MARCH_B}
+};
+
+// Fused tests 1/4/5: ⇑(w0); ⇑(r0[4], w1, r1[1]); ⇑(r1[4,5], w0, r0[1]); ⇑(r0[5])
+static const MarchElement FUSED_PATTERNS[] PROGMEM = {
+    {MARCH_UP, 1, {MARCH_W0}},
+    {MARCH_UP, 3, {MARCH_R0 | marchTag(FUSED_TAG_CHECKERBOARD),
+                   MARCH_W1,
+                   MARCH_R1 | marchTag(FUSED_TAG_BASIC)}},
+    {MARCH_UP, 3, {MARCH_R1 | marchTag(FUSED_TAG_CHECKERBOARD | FUSED_TAG_INVERSE),
+                   MARCH_W0,
+                   MARCH_R0 | marchTag(FUSED_TAG_BASIC)}},
+    {MARCH_UP, 1, {MARCH_R0 | marchTag(FUSED_TAG_INVERSE)}}
+};
+
+static const char KEY_FUSED[] PROGMEM = "FUSED";
+static const char NAME_FUSED[] PROGMEM = "Fused 1/4/5";
+
+const MarchAlgorithm MARCH_FUSED_PATTERNS = {
+    KEY_FUSED, NAME_FUSED, 0x55, 8, sizeof(FUSED_PATTERNS) / sizeof(MarchElement), FUSED_PATTERNS
+};
+
+// Test 1: ⇑(w0, r0); ⇑(w1, r1)
+static const MarchElement BASIC_PATTERNS[] PROGMEM = {
+    {MARCH_UP, 2, {MARCH_W0, MARCH_R0}},
+    {MARCH_UP, 2, {MARCH_W1, MARCH_R1}}
+};
+
+static const char KEY_BASIC[] PROGMEM = "BASIC";
+static const char NAME_BASIC[] PROGMEM = "Basic Read/Write";
+
+const MarchAlgorithm MARCH_BASIC_PATTERNS = {
+    KEY_BASIC, NAME_BASIC, 0xAA, 4, sizeof(BASIC_PATTERNS) / sizeof(MarchElement), BASIC_PATTERNS
+};
+
+int8_t findMarchAlgorithm(const char* keyword) {
+    for (uint8_t i = 0; i < MARCH_ALGORITHM_COUNT; i++) {
+        if (strcmp_P(keyword, MARCH_ALGORITHMS[i].keyword) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void readMarchElement(const MarchAlgorithm& algorithm, uint8_t index, MarchElement& element) {
+    memcpy_P(&element, &algorithm.elements[index], sizeof(MarchElement));
+}
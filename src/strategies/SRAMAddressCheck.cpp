@@ -0,0 +1,100 @@
+/**
+ * SRAMAddressCheck.cpp
+ *
+ * Implementation of the address bus diagnosis (walking ones / zeros with
+ * aliasing checks)
+ */
+
+#include "strategies/SRAMAddressCheck.h"
+
+#include <string.h>
+
+SRAMAddressCheck::SRAMAddressCheck() : lineCount(0), dataFault(false) {
+    noEffect[0] = noEffect[1] = 0;
+    memset(shorted, 0, sizeof(shorted));
+}
+
+bool SRAMAddressCheck::run(SRAMBus& bus, uint8_t lines) {
+    lineCount = (lines > SRAM_ADDRESS_MAX_LINES) ? SRAM_ADDRESS_MAX_LINES : lines;
+    dataFault = false;
+    noEffect[0] = noEffect[1] = 0;
+    memset(shorted, 0, sizeof(shorted));
+    firstFault = SRAMFirstFault();
+
+    uint16_t lineMask = (uint16_t)((1UL << lineCount) - 1);
+    if (!walk(bus, 0, 0x0000) || !walk(bus, 1, lineMask)) {
+        dataFault = true;
+    }
+    return !firstFault.failed;
+}
+
+bool SRAMAddressCheck::walk(SRAMBus& bus, uint8_t walkIndex, uint16_t base) {
+    // Background on the base and every neighbour, all of it must read back
+    bus.writeByte(base, SRAM_ADDRESS_BACKGROUND);
+    for (uint8_t line = 0; line < lineCount; line++) {
+        bus.writeByte(base ^ (1 << line), SRAM_ADDRESS_BACKGROUND);
+    }
+    if (check(bus, base, SRAM_ADDRESS_BACKGROUND) != SRAM_ADDRESS_BACKGROUND) return false;
+    for (uint8_t line = 0; line < lineCount; line++) {
+        uint16_t addr = base ^ (1 << line);
+        if (check(bus, addr, SRAM_ADDRESS_BACKGROUND) != SRAM_ADDRESS_BACKGROUND) return false;
+    }
+
+    for (uint8_t line = 0; line < lineCount; line++) {
+        uint16_t addr = base ^ (1 << line);
+        bus.writeByte(addr, SRAM_ADDRESS_MARK);
+        if (check(bus, addr, SRAM_ADDRESS_MARK) != SRAM_ADDRESS_MARK) return false;
+
+        if (check(bus, base, SRAM_ADDRESS_BACKGROUND) != SRAM_ADDRESS_BACKGROUND) {
+            // Same cell as the base: other neighbours that changed are base
+            // aliases too (found in their own iteration), not shorts
+            noEffect[walkIndex] |= (uint16_t)(1 << line);
+        } else {
+            for (uint8_t other = 0; other < lineCount; other++) {
+                if (other == line) continue;
+                if (check(bus, base ^ (1 << other), SRAM_ADDRESS_BACKGROUND) != SRAM_ADDRESS_BACKGROUND) {
+                    shorted[line] |= (uint16_t)(1 << other);
+                    shorted[other] |= (uint16_t)(1 << line);
+                }
+            }
+        }
+
+        // Restores every alias of addr as well
+        bus.writeByte(addr, SRAM_ADDRESS_BACKGROUND);
+    }
+    return true;
+}
+
+uint8_t SRAMAddressCheck::check(SRAMBus& bus, uint16_t addr, uint8_t expected) {
+    uint8_t actual = bus.readByte(addr);
+    if (actual != expected && !firstFault.failed) {
+        firstFault.onFault(addr, expected, actual, 0);
+    }
+    return actual;
+}
+
+uint16_t SRAMAddressCheck::accessCount(uint8_t lines) {
+    // Per walk: background written and read (base + lines), then per line
+    // mark write + read, base read, other neighbours, restore
+    return 2 * (2 * (lines + 1) + lines * (lines + 3));
+}
+
+uint16_t SRAMAddressCheck::getStuckLines() const {
+    return noEffect[0] & noEffect[1];
+}
+
+uint16_t SRAMAddressCheck::getShortedWith(uint8_t line) const {
+    return (line < lineCount) ? shorted[line] : 0;
+}
+
+uint16_t SRAMAddressCheck::getUnpairedLines() const {
+    return (uint16_t)((noEffect[0] ^ noEffect[1]) & ~shortedLines());
+}
+
+uint16_t SRAMAddressCheck::shortedLines() const {
+    uint16_t lines = 0;
+    for (uint8_t line = 0; line < lineCount; line++) {
+        if (shorted[line] != 0) lines |= (uint16_t)(1 << line);
+    }
+    return lines;
+}
@@ -0,0 +1,162 @@
+/**
+ * SRAMDump.cpp
+ *
+ * Implementation of the SRAM dump and CRC task
+ */
+
+#include "strategies/SRAMDump.h"
+#include "utils/CRC.h"
+
+SRAMDump::SRAMDump()
+    : bus(nullptr), uart(nullptr), kind(SRAM_READ_DUMP), socket(SRAM_SOCKET_A), first(0), length(0),
+      bytesRead(0), crc(0), active(false), aborted(false), chunkLength(0), chunkAddress(0) {
+}
+
+void SRAMDump::setUARTHandler(UARTHandler* handler) {
+    uart = handler;
+}
+
+bool SRAMDump::start(SRAMBus& sramBus, uint16_t firstAddress, uint32_t byteCount, uint8_t readKind,
+                     uint8_t readSocket) {
+    if (active || byteCount == 0) return false;
+
+    bus = &sramBus;
+    first = firstAddress;
+    length = byteCount;
+    kind = readKind;
+    socket = readSocket;
+    bytesRead = 0;
+    crc = (kind == SRAM_READ_CRC16) ? CRC16_INIT : CRC32_INIT;
+    chunkLength = 0;
+    aborted = false;
+    active = true;
+    return true;
+}
+
+bool SRAMDump::step(uint16_t budgetUs) {
+    if (!active) return false;
+
+    // The bus is shared with the tests: select our socket for this slice only
+    uint8_t sockets = bus->getSockets();
+    bus->setSockets(socket);
+
+    uint32_t start = micros();
+    while (!aborted) {
+        if (kind == SRAM_READ_DUMP) {
+            if (chunkLength == 0 && bytesRead < length) {
+                uint32_t remaining = length - bytesRead;
+                chunkAddress = (uint16_t)(first + bytesRead);
+                chunkLength = (remaining < BIN_DUMP_CHUNK) ? (uint8_t)remaining : BIN_DUMP_CHUNK;
+                readUnit(chunkAddress, chunkLength, chunk);
+            }
+            // TX ring full: the chunk waits for the next slice
+            if (chunkLength != 0 && !sendChunk()) break;
+        } else if (bytesRead < length) {
+            uint32_t remaining = length - bytesRead;
+            readUnit((uint16_t)(first + bytesRead), (remaining < CRC_UNIT) ? (uint16_t)remaining : CRC_UNIT,
+                     nullptr);
+        }
+
+        if (bytesRead >= length && chunkLength == 0) break;
+        if (micros() - start >= budgetUs) break;
+    }
+
+    bus->setSockets(sockets);
+    if (aborted || (bytesRead >= length && chunkLength == 0)) {
+        finish();
+    }
+    return active;
+}
+
+void SRAMDump::readUnit(uint16_t address, uint16_t count, uint8_t* into) {
+    // CRC of every byte read; DUMP also keeps them for the record
+    struct Reader {
+        SRAMDump& dump;
+        uint8_t* into;
+        void operator()(uint16_t, uint8_t data) {
+            if (dump.kind == SRAM_READ_CRC16) {
+                dump.crc = crc16Update((uint16_t)dump.crc, data);
+            } else {
+                dump.crc = crc32Update(dump.crc, data);
+            }
+            if (into != nullptr) *into++ = data;
+        }
+    };
+
+    Reader reader = {*this, into};
+    bus->read(address, (uint16_t)(address + count - 1), reader);
+    bytesRead += count;
+}
+
+bool SRAMDump::sendChunk() {
+    if (uart == nullptr) {
+        chunkLength = 0;
+        return true;
+    }
+
+    BinaryRecord record(BIN_REC_DUMP_DATA);
+    record.put16(chunkAddress);
+    for (uint8_t i = 0; i < chunkLength; i++) {
+        record.put8(chunk[i]);
+    }
+    if (!uart->trySendRecord(record)) return false;
+
+    chunkLength = 0;
+    return true;
+}
+
+void SRAMDump::finish() {
+    active = false;
+    if (kind != SRAM_READ_CRC16 && !aborted) {
+        crc = crc32Final(crc);
+    }
+    if (uart == nullptr) return;
+
+    uint16_t last = (uint16_t)(first + length - 1);
+    PGM_P socketName = (socket == SRAM_SOCKET_B) ? PSTR(" (socket B)") : PSTR("");
+    if (aborted) {
+        uart->sendErrorf(F("%S ABORTED at 0x%04X"), (kind == SRAM_READ_DUMP) ? PSTR("Dump") : PSTR("CRC"),
+                         (uint16_t)(first + bytesRead));
+        return;
+    }
+
+    // DUMP always ends with its CRC record; CRC sends one for BIN hosts
+    if (kind == SRAM_READ_DUMP || uart->isBinary()) {
+        BinaryRecord record(BIN_REC_CRC);
+        record.put16(first).put16((uint16_t)length).put32(crc);
+        uart->sendRecord(record);
+    }
+
+    if (kind == SRAM_READ_DUMP) {
+        uart->sendOKf(F("Dump 0x%04X-0x%04X%S: %lu bytes, CRC-32 0x%08lX"), first, last, socketName,
+                      (unsigned long)length, (unsigned long)crc);
+    } else if (kind == SRAM_READ_CRC16) {
+        uart->sendOKf(F("CRC-16 0x%04X-0x%04X%S: 0x%04X"), first, last, socketName, (uint16_t)crc);
+    } else {
+        uart->sendOKf(F("CRC-32 0x%04X-0x%04X%S: 0x%08lX"), first, last, socketName, (unsigned long)crc);
+    }
+}
+
+bool SRAMDump::isActive() const {
+    return active;
+}
+
+void SRAMDump::abort() {
+    if (active) aborted = true;
+}
+
+void SRAMDump::sendStatus() {
+    if (uart == nullptr) return;
+
+    uint8_t percent = (uint8_t)(bytesRead * 100 / length);
+    uart->sendInfof(F("STATUS: %S 0x%04X-0x%04X, %d%%"), (kind == SRAM_READ_DUMP) ? PSTR("Dump") : PSTR("CRC"),
+                    first, (uint16_t)(first + length - 1), percent);
+}
+
+uint32_t SRAMDump::getCrc() const {
+    return crc;
+}
+
+uint32_t SRAMDump::getBytesRead() const {
+    return bytesRead;
+}
@@ -0,0 +1,83 @@
+/**
+ * SRAMFaultMap.cpp
+ *
+ * Implementation of continue-on-error fault collection
+ */
+
+#include "strategies/SRAMFaultMap.h"
+
+SRAMFaultMap::SRAMFaultMap() {
+    clear();
+}
+
+void SRAMFaultMap::clear() {
+    currentTest = 0;
+    totalFailures = 0;
+    unmappedFailures = 0;
+    rangeCount = 0;
+    recordCount = 0;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        bitReadLow[bit] = 0;
+        bitReadHigh[bit] = 0;
+    }
+}
+
+void SRAMFaultMap::setTest(uint8_t testNumber) {
+    currentTest = testNumber;
+}
+
+bool SRAMFaultMap::onFault(uint16_t address, uint8_t expected, uint8_t actual, uint8_t) {
+    record(currentTest, address, expected, actual);
+    return true;
+}
+
+void SRAMFaultMap::record(uint8_t testNumber, uint16_t address, uint8_t expected, uint8_t actual) {
+    totalFailures++;
+
+    // Which data lines disagree, and in which direction
+    uint8_t diff = expected ^ actual;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        uint8_t mask = (1 << bit);
+        if (!(diff & mask)) continue;
+
+        uint16_t& counter = (actual & mask) ? bitReadHigh[bit] : bitReadLow[bit];
+        if (counter != 0xFFFF) counter++;
+    }
+
+    addToRanges(address);
+
+    if (recordCount < MAP_MAX_RECORDS) {
+        SRAMFaultRecord& entry = records[recordCount++];
+        entry.test = testNumber;
+        entry.address = address;
+        entry.expected = expected;
+        entry.actual = actual;
+    }
+}
+
+void SRAMFaultMap::addToRanges(uint16_t address) {
+    // Extend a range that contains or touches this address
+    for (uint8_t i = 0; i < rangeCount; i++) {
+        SRAMFaultRange& range = ranges[i];
+        bool inside = (address >= range.first && address <= range.last);
+        bool below = (range.first != 0 && address == range.first - 1);
+        bool above = (range.last != 0xFFFF && address == range.last + 1);
+
+        if (inside || below || above) {
+            if (below) range.first = address;
+            if (above) range.last = address;
+            if (range.failures != 0xFFFF) range.failures++;
+            return;
+        }
+    }
+
+    if (rangeCount < MAP_MAX_RANGES) {
+        SRAMFaultRange& range = ranges[rangeCount++];
+        range.first = address;
+        range.last = address;
+        range.failures = 1;
+        return;
+    }
+
+    unmappedFailures++;
+}
@@ -0,0 +1,38 @@
+/**
+ * SRAMProfiles.cpp
+ *
+ * Built-in SRAM test profiles and lookup
+ */
+
+#include "strategies/SRAMProfiles.h"
+#include "strategies/MarchTest.h"
+#include <avr/pgmspace.h>
+
+static const char KEY_TRIAGE[] PROGMEM = "TRIAGE";
+static const char DESC_TRIAGE[] PROGMEM = "data, address, March C- QUICK";
+static const char KEY_PRODUCTION[] PROGMEM = "PRODUCTION";
+static const char DESC_PRODUCTION[] PROGMEM = "data, address, March C- FULL";
+static const char KEY_QUALIFY[] PROGMEM = "QUALIFY";
+static const char DESC_QUALIFY[] PROGMEM = "data, address, March B, random x4 FULL";
+
+constexpr uint8_t MARCH_B_INDEX = 2;  // MARCH_ALGORITHMS order: MATS+, C-, B
+
+// Data bus before address bus: the aliasing checks need working data lines
+const SRAMProfile SRAM_PROFILES[SRAM_PROFILE_COUNT] PROGMEM = {
+    {KEY_TRIAGE,     DESC_TRIAGE,     {3, 2, 8},    3, false, MARCH_DEFAULT_ALGORITHM, 1},
+    {KEY_PRODUCTION, DESC_PRODUCTION, {3, 2, 8},    3, true,  MARCH_DEFAULT_ALGORITHM, 1},
+    {KEY_QUALIFY,    DESC_QUALIFY,    {3, 2, 8, 7}, 4, true,  MARCH_B_INDEX,           4}
+};
+
+int8_t findSRAMProfile(const char* keyword) {
+    for (uint8_t i = 0; i < SRAM_PROFILE_COUNT; i++) {
+        if (strcmp_P(keyword, (PGM_P)pgm_read_ptr(&SRAM_PROFILES[i].keyword)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void readSRAMProfile(uint8_t index, SRAMProfile& profile) {
+    memcpy_P(&profile, &SRAM_PROFILES[index < SRAM_PROFILE_COUNT ? index : 0], sizeof(SRAMProfile));
+}
@@ -0,0 +1,102 @@
+/**
+ * SRAMSampleSet.cpp
+ *
+ * Implementation of the QUICK mode sample run list
+ */
+
+#include "strategies/SRAMSampleSet.h"
+
+SRAMSampleSet::SRAMSampleSet() : runCount(0), stride(0), cellCount(0) {}
+
+bool SRAMSampleSet::build(uint16_t maxAddress, uint16_t sampleStride) {
+    if (sampleStride == 0 || sampleStride > SAMPLE_MAX_STRIDE) {
+        return false;
+    }
+
+    stride = sampleStride;
+    runCount = 0;
+    cellCount = 0;
+
+    // 32-bit so the walk can step past 0xFFFF on a 64KB map
+    uint32_t top = maxAddress;
+    uint32_t tailStart = (top >= SAMPLE_EDGE_BYTES) ? top - (SAMPLE_EDGE_BYTES - 1) : 0;
+    uint32_t addr = 0;
+
+    while (addr <= top) {
+        if (!append((uint16_t)addr)) {
+            // Can't happen for valid strides (< 30 runs worst case); test
+            // every remaining address rather than skip any
+            runs[runCount - 1].last = maxAddress;
+            runs[runCount - 1].step = 1;
+            break;
+        }
+
+        // Next sampled address: the edges are contiguous, in between the
+        // nearest of stride multiple, power of two, or tail start
+        uint32_t next = addr + 1;
+        if (next >= SAMPLE_EDGE_BYTES && next < tailStart) {
+            uint32_t multiple = (next + stride - 1) / stride * stride;
+            uint32_t power = 1;
+            while (power < next) power <<= 1;
+
+            next = tailStart;
+            if (multiple < next) next = multiple;
+            if (power < next) next = power;
+        }
+        addr = next;
+    }
+
+    cellCount = 0;
+    for (uint8_t i = 0; i < runCount; i++) {
+        cellCount += (uint32_t)(runs[i].last - runs[i].first) / runs[i].step + 1;
+    }
+    return true;
+}
+
+bool SRAMSampleSet::append(uint16_t addr) {
+    if (runCount > 0) {
+        SRAMSampleRun& run = runs[runCount - 1];
+
+        // A single address takes its step from the next one
+        if (run.first == run.last) {
+            run.step = addr - run.first;
+            run.last = addr;
+            return true;
+        }
+        if ((uint16_t)(addr - run.last) == run.step) {
+            run.last = addr;
+            return true;
+        }
+    }
+
+    if (runCount >= SAMPLE_MAX_RUNS) {
+        return false;
+    }
+
+    SRAMSampleRun& run = runs[runCount++];
+    run.first = addr;
+    run.last = addr;
+    run.step = 1;
+    return true;
+}
+
+bool SRAMSampleSet::clip(uint8_t index, uint16_t low, uint16_t high, SRAMSampleRun& out) const {
+    const SRAMSampleRun& run = runs[index];
+    if (run.last < low || run.first > high) {
+        return false;
+    }
+
+    out.step = run.step;
+
+    // First and last cell of the run inside [low, high]
+    out.first = run.first;
+    if (low > run.first) {
+        out.first = run.first + (uint16_t)((low - run.first + run.step - 1) / run.step) * run.step;
+        if (out.first < low || out.first > run.last) return false;
+    }
+    out.last = run.last;
+    if (high < run.last) {
+        out.last = run.first + (uint16_t)((high - run.first) / run.step) * run.step;
+    }
+    return out.first <= out.last;
+}
@@ -0,0 +1,69 @@
+/**
+ * SRAMSoakStats.cpp
+ *
+ * Implementation of soak run statistics
+ */
+
+#include "strategies/SRAMSoakStats.h"
+
+SRAMSoakStats::SRAMSoakStats() {
+    begin(nullptr, 0, 0);
+}
+
+void SRAMSoakStats::begin(const uint8_t* planTests, uint8_t planTestCount, uint32_t iterationTarget) {
+    target = iterationTarget;
+    iterations = 0;
+    failedIterations = 0;
+    firstFailed = 0;
+
+    testCount = (planTestCount > SOAK_MAX_TESTS) ? SOAK_MAX_TESTS : planTestCount;
+    for (uint8_t i = 0; i < testCount; i++) {
+        testStats[i].test = planTests[i];
+        testStats[i].runs = 0;
+        testStats[i].failures = 0;
+        testStats[i].minUs = 0xFFFFFFFF;
+        testStats[i].maxUs = 0;
+        testStats[i].meanUs = 0;
+    }
+}
+
+void SRAMSoakStats::recordTest(uint8_t index, uint32_t us, bool passed) {
+    if (index >= testCount) return;
+
+    SRAMSoakTestStats& stats = testStats[index];
+    stats.runs++;
+    if (!passed) stats.failures++;
+    if (us < stats.minUs) stats.minUs = us;
+    if (us > stats.maxUs) stats.maxUs = us;
+
+    // mean += (us - mean) / runs, kept unsigned
+    if (us >= stats.meanUs) {
+        stats.meanUs += (us - stats.meanUs) / stats.runs;
+    } else {
+        stats.meanUs -= (stats.meanUs - us) / stats.runs;
+    }
+}
+
+void SRAMSoakStats::endIteration(bool passed) {
+    iterations++;
+    if (!passed) {
+        failedIterations++;
+        if (firstFailed == 0) firstFailed = iterations;
+    }
+}
+
+bool SRAMSoakStats::isDone() const {
+    return target != SRAM_LOOP_FOREVER && iterations >= target;
+}
+
+uint32_t SRAMSoakStats::getMeanUs(uint8_t index) const {
+    return testStats[index].meanUs;
+}
+
+uint8_t SRAMSoakStats::getFailingTests() const {
+    uint8_t failing = 0;
+    for (uint8_t i = 0; i < testCount; i++) {
+        if (testStats[i].failures > 0) failing++;
+    }
+    return failing;
+}
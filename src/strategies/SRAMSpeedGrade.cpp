@@ -0,0 +1,192 @@
+/**
+ * SRAMSpeedGrade.cpp
+ *
+ * Implementation of the TEST SPEED strobe sweep
+ */
+
+#include "strategies/SRAMSpeedGrade.h"
+#include "strategies/MarchTest.h"
+#include <avr/interrupt.h>
+
+//=============================================================================
+// SWEEP STEPS
+// One instance per cycle count: __builtin_avr_delay_cycles() needs a constant
+//=============================================================================
+
+typedef void (*SpeedFill)(SRAMBus& bus, uint16_t first, uint16_t last, uint8_t seed);
+typedef bool (*SpeedVerify)(SRAMBus& bus, uint16_t first, uint16_t last, uint8_t seed, SRAMFaultSink& sink);
+
+template <uint8_t Strobe>
+static void fillStep(SRAMBus& bus, uint16_t first, uint16_t last, uint8_t seed) {
+    bus.fillTimed<Strobe>(first, last, seed);
+}
+
+template <uint8_t Settle, bool SocketB>
+static bool verifyStep(SRAMBus& bus, uint16_t first, uint16_t last, uint8_t seed, SRAMFaultSink& sink) {
+    return bus.verifyTimed<Settle, SocketB>(first, last, seed, sink);
+}
+
+// In flash like the other lookup tables: read entries with pgm_read_ptr()
+static const SpeedFill FILL_STEPS[] PROGMEM = {
+    fillStep<0>, fillStep<1>, fillStep<2>, fillStep<3>
+};
+
+static const SpeedVerify VERIFY_STEPS[2][SRAM_SPEED_READ_STEPS] PROGMEM = {
+    {verifyStep<0, false>, verifyStep<1, false>, verifyStep<2, false>, verifyStep<3, false>,
+     verifyStep<4, false>, verifyStep<5, false>, verifyStep<6, false>, verifyStep<7, false>},
+    {verifyStep<0, true>, verifyStep<1, true>, verifyStep<2, true>, verifyStep<3, true>,
+     verifyStep<4, true>, verifyStep<5, true>, verifyStep<6, true>, verifyStep<7, true>}
+};
+
+static_assert(sizeof(FILL_STEPS) / sizeof(FILL_STEPS[0]) == SRAM_SPEED_WRITE_STEPS, "One fill per write step");
+static_assert(sizeof(VERIFY_STEPS[0]) / sizeof(VERIFY_STEPS[0][0]) == SRAM_SPEED_READ_STEPS,
+              "One verify per read step");
+
+// A page at a time with interrupts off: a timer tick inside an access
+// would stretch it past the step being measured
+static void fillChip(SpeedFill fill, SRAMBus& bus, uint16_t last, uint8_t seed) {
+    for (uint32_t first = 0; first <= last; first += 256) {
+        uint16_t end = (first + 255 < last) ? (uint16_t)(first + 255) : last;
+        uint8_t sreg = SREG;
+        cli();
+        fill(bus, (uint16_t)first, end, seed);
+        SREG = sreg;
+    }
+}
+
+static bool verifyChip(SpeedVerify verify, SRAMBus& bus, uint16_t last, uint8_t seed, SRAMFirstFault& fault) {
+    for (uint32_t first = 0; first <= last; first += 256) {
+        uint16_t end = (first + 255 < last) ? (uint16_t)(first + 255) : last;
+        uint8_t sreg = SREG;
+        cli();
+        bool passed = verify(bus, (uint16_t)first, end, seed, fault);
+        SREG = sreg;
+        if (!passed) return false;
+    }
+    return true;
+}
+
+//=============================================================================
+// GRADES
+//=============================================================================
+
+PGM_P sramSpeedGradeName(uint8_t readCycles) {
+    if (readCycles == SRAM_SPEED_FAILED) return PSTR("failed");
+
+    // No -55 bin: the fixed cycle alone is 63 ns, so faster parts show as -70
+    uint16_t ns = sramCyclesToNs(readCycles + SRAM_SPEED_READ_FIXED_CYCLES);
+    if (ns <= 70) return PSTR("-70");
+    if (ns <= 85) return PSTR("-85");
+    if (ns <= 100) return PSTR("-10");
+    if (ns <= 120) return PSTR("-12");
+    if (ns <= 150) return PSTR("-15");
+    if (ns <= 200) return PSTR("-20");
+    return PSTR("slower than -20");
+}
+
+//=============================================================================
+// SWEEP
+//=============================================================================
+
+bool SRAMSpeedGrade::run(SRAMBus& bus, uint16_t size, SRAMSpeedResult& result) {
+    uint16_t last = size - 1;
+    uint8_t sockets = bus.getSockets();
+    result.readCycles = 0;
+    result.writeCycles = 0;
+    result.readTrim = 0;
+    result.marchPassed = false;
+    result.fault = SRAMFirstFault();
+    bus.setReadTrim(0);
+
+    // Each socket on its own (their reads are sampled a cycle apart in
+    // dual mode); the slower one counts, SRAM_SPEED_FAILED beats any step
+    for (uint8_t socket = SRAM_SOCKET_A; socket <= SRAM_SOCKET_B; socket <<= 1) {
+        if (!(sockets & socket)) continue;
+        bus.setSockets(socket);
+        SRAMFirstFault readFault;
+        SRAMFirstFault writeFault;
+        uint8_t reads = sweepReads(bus, last, socket == SRAM_SOCKET_B, readFault);
+        uint8_t writes = sweepWrites(bus, last, socket == SRAM_SOCKET_B, writeFault);
+        if (reads > result.readCycles) result.readCycles = reads;
+        if (writes > result.writeCycles) result.writeCycles = writes;
+        if (!result.fault.failed) {
+            if (reads == SRAM_SPEED_FAILED) result.fault = readFault;
+            else if (writes == SRAM_SPEED_FAILED) result.fault = writeFault;
+        }
+    }
+    bus.setSockets(sockets);
+
+    if (result.readCycles == SRAM_SPEED_FAILED || result.writeCycles == SRAM_SPEED_FAILED) {
+        return false;
+    }
+
+    // Shortest pass plus margin; a failing March steps back toward the datasheet
+    uint8_t production = result.readCycles + SRAM_SPEED_MARGIN_CYCLES;
+    bus.setReadTrim((production < SRAM_READ_SETTLE_CYCLES) ? SRAM_READ_SETTLE_CYCLES - production : 0);
+    for (;;) {
+        SRAMFirstFault fault;
+        result.marchPassed = marchPass(bus, last, fault);
+        if (result.marchPassed || bus.getReadTrim() == 0) {
+            if (!result.marchPassed) result.fault = fault;
+            break;
+        }
+        bus.setReadTrim(bus.getReadTrim() - 1);
+    }
+    result.readTrim = bus.getReadTrim();
+    return result.marchPassed;
+}
+
+uint8_t SRAMSpeedGrade::sweepReads(SRAMBus& bus, uint16_t last, bool socketB, SRAMFirstFault& fault) {
+    uint8_t shortest = SRAM_SPEED_FAILED;
+    SpeedFill fill = (SpeedFill)pgm_read_ptr(&FILL_STEPS[SRAM_WRITE_STROBE_CYCLES]);
+    for (int8_t cycles = SRAM_SPEED_READ_STEPS - 1; cycles >= 0; cycles--) {
+        SpeedVerify verify = (SpeedVerify)pgm_read_ptr(&VERIFY_STEPS[socketB][cycles]);
+        for (uint8_t polarity = 0; polarity < 2; polarity++) {
+            uint8_t seed = polarity ? (uint8_t)~SRAM_SPEED_SEED : SRAM_SPEED_SEED;
+            fillChip(fill, bus, last, seed);
+            if (!verifyChip(verify, bus, last, seed, fault)) {
+                return shortest;
+            }
+        }
+        shortest = (uint8_t)cycles;
+    }
+    return shortest;
+}
+
+uint8_t SRAMSpeedGrade::sweepWrites(SRAMBus& bus, uint16_t last, bool socketB, SRAMFirstFault& fault) {
+    uint8_t shortest = SRAM_SPEED_FAILED;
+    SpeedVerify verify = (SpeedVerify)pgm_read_ptr(&VERIFY_STEPS[socketB][SRAM_READ_SETTLE_CYCLES]);
+    for (int8_t cycles = SRAM_SPEED_WRITE_STEPS - 1; cycles >= 0; cycles--) {
+        SpeedFill fill = (SpeedFill)pgm_read_ptr(&FILL_STEPS[cycles]);
+        for (uint8_t polarity = 0; polarity < 2; polarity++) {
+            uint8_t seed = polarity ? (uint8_t)~SRAM_SPEED_SEED : SRAM_SPEED_SEED;
+            fillChip(fill, bus, last, seed);
+            if (!verifyChip(verify, bus, last, seed, fault)) {
+                return shortest;
+            }
+        }
+        shortest = (uint8_t)cycles;
+    }
+    return shortest;
+}
+
+// March C- on the selected socket(s) at the bus's current read trim
+bool SRAMSpeedGrade::marchPass(SRAMBus& bus, uint16_t last, SRAMFirstFault& fault) {
+    const MarchAlgorithm& algorithm = MARCH_ALGORITHMS[MARCH_DEFAULT_ALGORITHM];
+    for (uint8_t i = 0; i < algorithm.elementCount; i++) {
+        MarchElement element;
+        readMarchElement(algorithm, i, element);
+
+        SRAMCellOp ops[MARCH_MAX_OPS];
+        for (uint8_t j = 0; j < element.opCount; j++) {
+            ops[j].write = (element.ops[j] & MARCH_OP_WRITE) != 0;
+            ops[j].data = (element.ops[j] & MARCH_OP_INVERT) ? (uint8_t)~algorithm.background
+                                                             : algorithm.background;
+            ops[j].tag = 0;
+        }
+        if (!bus.sweepCells(0, last, element.order == MARCH_DOWN, ops, element.opCount, fault)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -5,17 +5,98 @@
  */
 
 #include "strategies/SRAMStrategy.h"
+#include "strategies/SRAMPatterns.h"
 #include "hardware/PinConfig.h"
+#include "hardware/CycleCounter.h"
 #include <Arduino.h>
 
+/**
+ * Fault sink for the fused 1/4/5 sweep
+ *
+ * Each read is tagged with the tests it stands in for (FUSED_TAG_*); the
+ * first mismatch per test is kept. The sweep continues until every test
+ * has failed, so one bad cell doesn't hide the result of the others.
+ * With a fault map, every mismatch is also recorded and the sweep never stops.
+ * Dual socket: socket B's mismatches go to the three slots after socket A's.
+ */
+class FusedFaultSink : public SRAMFaultSink {
+public:
+    FusedFaultSink(SRAMFirstFault* slots, uint8_t sockets, SRAMFaultMap* map)
+        : slots(slots), slotCount(3 * sockets), map(map) {}
+
+    bool onFault(uint16_t addr, uint8_t exp, uint8_t act, uint8_t tag) override {
+        static const uint8_t TEST_NUMBERS[3] = {1, 4, 5};
+
+        SRAMFirstFault* socketSlots = slots + ((tag & SRAM_TAG_SOCKET_B) ? 3 : 0);
+        bool mapped = false;
+        for (uint8_t i = 0; i < 3; i++) {
+            if (tag & (1 << i)) {
+                if (!socketSlots[i].failed) socketSlots[i].onFault(addr, exp, act, tag);
+                if (map != nullptr && !mapped) {
+                    map->record(TEST_NUMBERS[i], addr, exp, act);
+                    mapped = true;
+                }
+            }
+        }
+
+        bool anyPassing = false;
+        for (uint8_t i = 0; i < slotCount; i++) {
+            if (!slots[i].failed) anyPassing = true;
+        }
+        return anyPassing || map != nullptr;
+    }
+
+private:
+    SRAMFirstFault* slots;  // Indexed by FUSED_TAG_* bit (+3 for socket B)
+    uint8_t slotCount;
+    SRAMFaultMap* map;      // Optional, nullptr when fail-fast
+};
+
+/**
+ * Fault sink for a dual-socket sweep: first mismatch per socket
+ *
+ * The sweep goes on while either chip is still passing, so a bad chip in
+ * one socket doesn't cut the other one's test short.
+ */
+class SocketFaultSink : public SRAMFaultSink {
+public:
+    explicit SocketFaultSink(SRAMFirstFault* faults) : faults(faults) {}
+
+    bool onFault(uint16_t addr, uint8_t exp, uint8_t act, uint8_t tag) override {
+        SRAMFirstFault& fault = faults[(tag & SRAM_TAG_SOCKET_B) ? 1 : 0];
+        if (!fault.failed) fault.onFault(addr, exp, act, tag);
+        return !faults[0].failed || !faults[1].failed;
+    }
+
+private:
+    SRAMFirstFault* faults;  // [socket A, socket B]
+};
+
 SRAMStrategy::SRAMStrategy()
-    : sramSize(0), maxAddress(0), addressBits(0), uart(nullptr) {
+    : sramSize(0), maxAddress(0), addressBits(0), uart(nullptr),
+      marchAlgorithm(MARCH_DEFAULT_ALGORITHM), currentTest(0), testStartMs(0),
+      mapFaults(false), mapFailuresAtStart(0),
+      running(false), paused(false), abortRequested(false), lastRunPassed(false),
+      planIndex(0), testsFailed(0), runStartMs(0), testsSkipped(0), testStarted(false),
+      faultsSent(0), testSocketsFailed(0), dualSocket(false), currentSocket(0),
+      soakFailureShown(false), lastSoakReportMs(0),
+      phaseIndex(0), phaseLoaded(false), cursor(0), marchOpCount(0),
+      marchDescending(false), randomPattern(0), randomSeed(0),
+      perfMark(0), perfTxMark(0), perfAccessStart(0), perfAttach(false),
+      timingSize(0), lastProgressMs(0), progressSent(0), progressCoalesced(0) {
     // Initialize with no size configured
+    plan.testCount = 0;
+    socketTestsFailed[0] = socketTestsFailed[1] = 0;
+    perfCurrent = SRAMTestPerf();
+    timing = SRAMAccessTiming();
+    resetPerf();
 }
 
 void SRAMStrategy::setSize(uint16_t sizeInBytes) {
     sramSize = sizeInBytes;
     maxAddress = sizeInBytes - 1;
+    bus.begin(sizeInBytes);
+    samples.build(maxAddress, SAMPLE_DEFAULT_STRIDE);
 
     // Calculate number of address bits
     // 8192 (8KB) = 2^13 = 13 bits
@@ -32,12 +113,75 @@ uint16_t SRAMStrategy::getSize() const {
     return sramSize;
 }
 
+bool SRAMStrategy::setDualSocket(bool dual) {
+    if (running) return false;
+
+    dualSocket = dual;
+    bus.setSockets(dual ? SRAM_SOCKETS_BOTH : SRAM_SOCKET_A);
+    timingSize = 0;  // Dual bus loops drive two ports: measure again
+    return true;
+}
+
+bool SRAMStrategy::isDualSocket() const {
+    return dualSocket;
+}
+
+SRAMBus& SRAMStrategy::getBus() {
+    return bus;
+}
+
+bool SRAMStrategy::measureSpeed() {
+    if (running || sramSize == 0) return false;
+
+    if (uart != nullptr) {
+        uart->sendInfof(F("Measuring access time: read settle %u-0, /WE +%u-0 cycles (%u ns steps)%S..."),
+                        SRAM_SPEED_READ_STEPS - 1, SRAM_SPEED_WRITE_STEPS - 1, sramCyclesToNs(1),
+                        dualSocket ? PSTR(", each socket") : PSTR(""));
+    }
+
+    SRAMSpeedGrade grade;
+    SRAMSpeedResult result;
+    bool passed = grade.run(bus, sramSize, result);
+    timingSize = 0;  // Reads got faster: estimates measure again
+
+    if (uart == nullptr) return passed;
+
+    if (result.readCycles == SRAM_SPEED_FAILED || result.writeCycles == SRAM_SPEED_FAILED) {
+        uart->sendErrorf(F("SPEED: %S fail even at the slowest step, 0x%04X: expected %02X, read %02X (run TEST)"),
+                         (result.readCycles == SRAM_SPEED_FAILED) ? PSTR("reads") : PSTR("writes"),
+                         result.fault.address, result.fault.expected, result.fault.actual);
+        return false;
+    }
+
+    uart->sendInfof(F("  Reads:  pass down to settle %u cycles, tAA <= %u ns"), result.readCycles,
+                    sramCyclesToNs(result.readCycles + SRAM_SPEED_READ_FIXED_CYCLES));
+    uart->sendInfof(F("  Writes: pass down to /WE +%u cycles, tWP <= %u ns"), result.writeCycles,
+                    sramCyclesToNs(result.writeCycles + SRAM_SPEED_WRITE_FIXED_CYCLES));
+    uart->sendInfof(F("  Grade: %S"), sramSpeedGradeName(result.readCycles));
+    uart->sendInfof(F("  March C- at settle %u cycles (datasheet %u): %S"), bus.getReadSettleCycles(),
+                    SRAM_READ_SETTLE_CYCLES, result.marchPassed ? PSTR("PASSED") : PSTR("FAILED"));
+
+    if (!passed) {
+        uart->sendErrorf(F("SPEED: March C- fails at datasheet timing, 0x%04X: expected %02X, read %02X"),
+                         result.fault.address, result.fault.expected, result.fault.actual);
+        return false;
+    }
+    uart->sendOKf(F("Reads now settle %u cycles, %u below datasheet (TEST SPEED OFF restores)"),
+                  bus.getReadSettleCycles(), result.readTrim);
+    return true;
+}
+
+void SRAMStrategy::useDatasheetTiming() {
+    bus.setReadTrim(0);
+    timingSize = 0;
+}
+
 void SRAMStrategy::setUARTHandler(UARTHandler* handler) {
     uart = handler;
 }
 
-const char* SRAMStrategy::getName() const {
-    return "SRAM";
+const __FlashStringHelper* SRAMStrategy::getName() const {
+    return F("SRAM");
 }
 
 void SRAMStrategy::configurePins() {
@@ -49,524 +193,1500 @@ void SRAMStrategy::configurePins() {
     DDRL = 0x00;  // D0-D7 INPUT
     PORTL = 0x00; // Disable pull-ups
 
-    // Set control pins to OUTPUT
-    // PG0 = /CS, PG2 = /OE, PG3 = /WE
-    DDRG |= (1 << 0) | (1 << 2) | (1 << 3);
-
-    // Set all control signals HIGH (inactive)
-    // /CS HIGH (deselected)
-    // /OE HIGH (output disabled)
-    // /WE HIGH (write disabled)
-    PORTG |= (1 << 0) | (1 << 2) | (1 << 3);
+    // Control pins to OUTPUT, all HIGH (inactive) first
+    // PG0 = /CS (deselected), PG2 = /OE (output disabled), PG3 = /WE (write disabled)
+    SRAMPins::Control::outputInactive();
+
+    // Socket B: data bus PORTK as input, /CS on PF0 (released with one socket)
+    DDRK = 0x00;
+    PORTK = 0x00;
+    if (dualSocket) {
+        SRAMPins::CSB::outputInactive();
+    } else {
+        SRAMPins::CSB::input();
+    }
 }
 
 void SRAMStrategy::reset() {
     // SRAM has no reset pin
     // Just deassert all control signals
-    PORTG |= (1 << 0) | (1 << 2) | (1 << 3);
+    SRAMPins::Control::deactivate();
+    if (dualSocket) {
+        SRAMPins::CSB::deactivate();
+    }
 
     // Set data bus to INPUT (safe state)
     DDRL = 0x00;
+    DDRK = 0x00;
 }
 
 bool SRAMStrategy::runTests() {
-    // Default: Run tests 1-6 (no random), QUICK mode
-    return runAllTests(false, false);
+    // Default: production screen
+    return runProductionScreen();
 }
 
-void SRAMStrategy::setAddress(uint16_t addr) {
-    // Set address on address bus
-    // Low byte (A0-A7) on PORTA
-    PORTA = (uint8_t)(addr & 0xFF);
-
-    // High byte (A8-A15) on PORTC
-    uint8_t highByte = (uint8_t)((addr >> 8) & 0xFF);
+//=============================================================================
+// TEST DEFINITIONS
+// Tests 1 and 4-7 are fixed phase lists; test 8 and the fused sweep come
+// from the March tables; tests 2-3 are single walking-bit phases.
+//=============================================================================
+
+// Progress labels (PROGMEM, copied into phaseLabel when a phase starts)
+static const char LABEL_TEST1[] PROGMEM = "Test 1";
+static const char LABEL_TEST4_WRITE[] PROGMEM = "Test 4 (write 0x55)";
+static const char LABEL_TEST4_VERIFY[] PROGMEM = "Test 4 (verify 0x55)";
+static const char LABEL_TEST5_WRITE[] PROGMEM = "Test 5 (write 0xAA)";
+static const char LABEL_TEST5_VERIFY[] PROGMEM = "Test 5 (verify 0xAA)";
+static const char LABEL_TEST6_WRITE[] PROGMEM = "Test 6 (write)";
+static const char LABEL_TEST6_VERIFY[] PROGMEM = "Test 6 (verify)";
+
+static const SRAMPhase TEST4_PHASES[] PROGMEM = {
+    {PHASE_FILL,   PATTERN_CONSTANT, 0x55, LABEL_TEST4_WRITE},
+    {PHASE_VERIFY, PATTERN_CONSTANT, 0x55, LABEL_TEST4_VERIFY},
+    {PHASE_FILL,   PATTERN_CONSTANT, 0xAA, nullptr},
+    {PHASE_VERIFY, PATTERN_CONSTANT, 0xAA, nullptr}
+};
+
+static const SRAMPhase TEST5_PHASES[] PROGMEM = {
+    {PHASE_FILL,   PATTERN_CONSTANT, 0xAA, LABEL_TEST5_WRITE},
+    {PHASE_VERIFY, PATTERN_CONSTANT, 0xAA, LABEL_TEST5_VERIFY},
+    {PHASE_FILL,   PATTERN_CONSTANT, 0x55, nullptr},
+    {PHASE_VERIFY, PATTERN_CONSTANT, 0x55, nullptr}
+};
+
+// Test 6: low byte of address as data
+static const SRAMPhase TEST6_PHASES[] PROGMEM = {
+    {PHASE_FILL,   PATTERN_ADDRESS, 0, LABEL_TEST6_WRITE},
+    {PHASE_VERIFY, PATTERN_ADDRESS, 0, LABEL_TEST6_VERIFY}
+};
+
+static const SRAMPhase WALK_ADDRESS_PHASE PROGMEM = {PHASE_WALK_ADDRESS, 0, 0, nullptr};
+static const SRAMPhase WALK_DATA_PHASE PROGMEM = {PHASE_WALK_DATA, 0, 0, nullptr};
+
+bool SRAMStrategy::loadPhase(uint8_t testNumber, uint8_t index, SRAMPhase& out) {
+    const SRAMPhase* table = nullptr;
+    uint8_t count = 0;
+
+    if (isFusedTest(testNumber)) {
+        // Test 1 carries the whole fused sweep, tests 4/5 only report
+        if (testNumber != 1 || index >= MARCH_FUSED_PATTERNS.elementCount) return false;
+        out = {PHASE_MARCH, 0, index, phaseLabel};
+        snprintf_P(phaseLabel, sizeof(phaseLabel), PSTR("Fused (S%d)"), index);
+        return true;
+    }
 
-    // CRITICAL: Pin 26 differences between chips
-    // - HM62256 (32KB): Pin 26 = A13 (address line, use normally)
-    // - HM6265 (8KB):  Pin 26 = CS2 (must be HIGH to enable chip)
-    // - D4168 (8KB):   Pin 26 = CS (must be HIGH to enable chip)
-    //
-    // For 8KB chips, force A13 (PORTC bit 5) HIGH to enable CS/CS2
-    if (sramSize <= 8192) {
-        highByte |= (1 << 5);  // Set A13 HIGH (PORTC bit 5 = pin 26)
+    switch (testNumber) {
+        case 1:
+            // Write then read back each cell (MARCH_BASIC_PATTERNS elements)
+            if (index >= MARCH_BASIC_PATTERNS.elementCount) return false;
+            out = {PHASE_MARCH, 0, index, (index == 0) ? LABEL_TEST1 : nullptr};
+            return true;
+        case 2: table = &WALK_ADDRESS_PHASE; count = 1; break;
+        case 3: table = &WALK_DATA_PHASE; count = 1; break;
+        case 4: table = TEST4_PHASES; count = sizeof(TEST4_PHASES) / sizeof(SRAMPhase); break;
+        case 5: table = TEST5_PHASES; count = sizeof(TEST5_PHASES) / sizeof(SRAMPhase); break;
+        case 6: table = TEST6_PHASES; count = sizeof(TEST6_PHASES) / sizeof(SRAMPhase); break;
+        case 7:
+            // Fill + verify per pass (value = pass); same seed regenerates the sequence
+            if (index >= 2 * plan.randomPasses) return false;
+            out = {(uint8_t)((index & 1) ? PHASE_VERIFY : PHASE_FILL), PATTERN_RANDOM,
+                   (uint16_t)(index / 2), phaseLabel};
+            if (plan.randomPasses == 1) {
+                snprintf_P(phaseLabel, sizeof(phaseLabel), PSTR("Test 7 (%S)"),
+                           (index & 1) ? PSTR("verify") : PSTR("write"));
+            } else {
+                snprintf_P(phaseLabel, sizeof(phaseLabel), PSTR("Test 7 P%d (%S)"), index / 2 + 1,
+                           (index & 1) ? PSTR("verify") : PSTR("write"));
+            }
+            return true;
+        case 8:
+            if (index >= MARCH_ALGORITHMS[marchAlgorithm].elementCount) return false;
+            out = {PHASE_MARCH, 0, index, phaseLabel};
+            snprintf_P(phaseLabel, sizeof(phaseLabel), PSTR("Test 8 (M%d)"), index);
+            return true;
+        default: return false;
     }
 
-    PORTC = highByte;
+    if (index >= count) return false;
+    memcpy_P(&out, &table[index], sizeof(SRAMPhase));
+    if (out.label != nullptr) {
+        strncpy_P(phaseLabel, out.label, sizeof(phaseLabel) - 1);
+        phaseLabel[sizeof(phaseLabel) - 1] = '\0';
+        out.label = phaseLabel;
+    }
+    return true;
 }
 
-void SRAMStrategy::writeByte(uint16_t addr, uint8_t data) {
-    // CRITICAL: Prevent bus contention
-    // Set data bus to OUTPUT before driving it
+bool SRAMStrategy::isFusedTest(uint8_t testNumber) const {
+    return plan.fused && (testNumber == 1 || testNumber == 4 || testNumber == 5);
+}
 
-    // Set address
-    setAddress(addr);
+uint8_t SRAMStrategy::socketCount() const {
+    return dualSocket ? 2 : 1;
+}
 
-    // Set data bus to OUTPUT
-    DDRL = 0xFF;
+//=============================================================================
+// RUN PLANS
+//=============================================================================
 
-    // Put data on bus
-    PORTL = data;
+SRAMRunPlan SRAMStrategy::allTestsPlan(bool includeRandom, bool fullTest, bool fused) {
+    SRAMRunPlan result;
+    result.testCount = includeRandom ? 7 : 6;
+    for (uint8_t i = 0; i < result.testCount; i++) {
+        result.tests[i] = i + 1;
+    }
+    result.fullTest = fullTest;
+    result.quickStride = SAMPLE_DEFAULT_STRIDE;
+    result.fused = fused;
+    result.mapFaults = false;
+    result.summary = true;
+    result.randomSeed = 0;
+    result.randomPasses = 1;
+    result.prescreen = true;
+    result.stopOnFail = false;
+    result.loopCount = 0;
+    return result;
+}
 
-    // Assert /CS (LOW)
-    PORTG &= ~(1 << 0);
+SRAMRunPlan SRAMStrategy::singleTestPlan(uint8_t testNumber, bool fullTest) {
+    SRAMRunPlan result;
+    result.tests[0] = testNumber;
+    result.testCount = 1;
+    result.fullTest = fullTest;
+    result.quickStride = SAMPLE_DEFAULT_STRIDE;
+    result.fused = false;
+    result.mapFaults = false;
+    result.summary = false;
+    result.randomSeed = 0;
+    result.randomPasses = 1;
+    result.prescreen = false;
+    result.stopOnFail = false;
+    result.loopCount = 0;
+    return result;
+}
 
-    // Assert /WE (LOW) - initiate write
-    PORTG &= ~(1 << 3);
+SRAMRunPlan SRAMStrategy::profilePlan(uint8_t profile) {
+    SRAMProfile entry;
+    readSRAMProfile(profile, entry);
+    SRAMRunPlan result = singleTestPlan(entry.tests[0], entry.fullTest);
+    for (uint8_t i = 0; i < entry.testCount; i++) {
+        result.tests[i] = entry.tests[i];
+    }
+    result.testCount = entry.testCount;
+    result.randomPasses = entry.randomPasses;
+    result.summary = true;
+    result.stopOnFail = true;
+    return result;
+}
 
-    // Wait for write pulse width (tWP ~ 70ns, but use 1µs to be safe)
-    delayMicroseconds(1);
+bool SRAMStrategy::setMarchAlgorithm(uint8_t algorithm) {
+    if (algorithm >= MARCH_ALGORITHM_COUNT) {
+        if (uart != nullptr) {
+            uart->sendError(F("Invalid March algorithm"));
+        }
+        return false;
+    }
 
-    // Deassert /WE (HIGH) - latch data
-    PORTG |= (1 << 3);
+    marchAlgorithm = algorithm;
+    return true;
+}
 
-    // Deassert /CS (HIGH)
-    PORTG |= (1 << 0);
+bool SRAMStrategy::runTest(uint8_t testNumber, bool fullTest) {
+    if (testNumber < 1 || testNumber > 8) {
+        if (uart != nullptr) {
+            uart->sendError(F("Invalid test number (1-8)"));
+        }
+        return false;
+    }
+    return runPlan(singleTestPlan(testNumber, fullTest));
+}
 
-    // Set data bus back to INPUT (safe state, prevent bus contention)
-    DDRL = 0x00;
+bool SRAMStrategy::runAllTests(bool includeRandom, bool fullTest, bool fused) {
+    return runPlan(allTestsPlan(includeRandom, fullTest, fused));
 }
 
-uint8_t SRAMStrategy::readByte(uint16_t addr) {
-    // Set address
-    setAddress(addr);
+bool SRAMStrategy::runMarch(uint8_t algorithm, bool fullTest) {
+    if (!setMarchAlgorithm(algorithm)) return false;
+    return runPlan(singleTestPlan(8, fullTest));
+}
 
-    // Ensure data bus is INPUT (safe to read)
-    DDRL = 0x00;
+bool SRAMStrategy::runRandom(uint32_t seed, uint8_t passes, bool fullTest) {
+    SRAMRunPlan random = singleTestPlan(7, fullTest);
+    random.randomSeed = seed;
+    random.randomPasses = passes;
+    return runPlan(random);
+}
 
-    // Assert /CS (LOW)
-    PORTG &= ~(1 << 0);
+uint32_t SRAMStrategy::getRandomSeed() const {
+    return randomSeed;
+}
 
-    // Assert /OE (LOW) - enable output
-    PORTG &= ~(1 << 2);
+bool SRAMStrategy::runProductionScreen() {
+    setMarchAlgorithm(MARCH_DEFAULT_ALGORITHM);
+    SRAMRunPlan production = singleTestPlan(8, true);
+    production.summary = true;
+    production.prescreen = true;
+    return runPlan(production);
+}
 
-    // Wait for access time (tACC ~ 70ns, but use 1µs to be safe)
-    delayMicroseconds(1);
+bool SRAMStrategy::runPlan(const SRAMRunPlan& runPlan) {
+    if (!startRun(runPlan)) return false;
 
-    // Read data from data bus
-    uint8_t data = PINL;
+    while (step(RUN_SLICE_US)) {
+        checkpoint();
+    }
+    return lastRunPassed;
+}
 
-    // Deassert /OE (HIGH)
-    PORTG |= (1 << 2);
+//=============================================================================
+// RUN ENGINE
+//=============================================================================
 
-    // Deassert /CS (HIGH)
-    PORTG |= (1 << 0);
+bool SRAMStrategy::startRun(const SRAMRunPlan& runPlan) {
+    if (running) {
+        if (uart != nullptr) {
+            uart->sendError(F("Test already running (ABORT to stop)"));
+        }
+        return false;
+    }
+    if (sramSize == 0) {
+        if (uart != nullptr) {
+            uart->sendError(F("SRAM size not configured"));
+        }
+        return false;
+    }
+    if (runPlan.testCount == 0 || runPlan.testCount > sizeof(plan.tests)) {
+        return false;
+    }
+    if (!runPlan.fullTest && runPlan.quickStride != samples.getStride() &&
+        !samples.build(maxAddress, runPlan.quickStride)) {
+        if (uart != nullptr) {
+            uart->sendErrorf(F("QUICK stride must be 1-%u"), SAMPLE_MAX_STRIDE);
+        }
+        return false;
+    }
+    if (runPlan.randomPasses < 1 || runPlan.randomPasses > SRAM_MAX_RANDOM_PASSES) {
+        if (uart != nullptr) {
+            uart->sendErrorf(F("Random passes must be 1-%u"), SRAM_MAX_RANDOM_PASSES);
+        }
+        return false;
+    }
+    if (runPlan.loopCount != 0 && runPlan.mapFaults) {
+        // A map report per iteration is what LOOP is there to avoid
+        if (uart != nullptr) {
+            uart->sendError(F("LOOP can't be combined with MAP"));
+        }
+        return false;
+    }
+    if (runPlan.mapFaults && dualSocket) {
+        // One fault map, two chips: the ranges would mix
+        if (uart != nullptr) {
+            uart->sendError(F("MAP can't be combined with DUAL"));
+        }
+        return false;
+    }
 
-    return data;
+    plan = runPlan;
+    if (plan.prescreen) {
+        applyPrescreen();
+    }
+    // A new pattern every run unless a seed was given (reported, so failures reproduce)
+    randomSeed = (plan.randomSeed != 0) ? plan.randomSeed
+                                        : SRAMRandomPattern::nextSeed(micros() ^ CycleCounter::now());
+    running = true;
+    paused = false;
+    abortRequested = false;
+    lastRunPassed = false;
+    runStartMs = millis();
+
+    // Counted for the plan as run: pre-screen applied
+    soak.begin(plan.tests, plan.testCount, plan.loopCount);
+    soakFailureShown = false;
+    lastSoakReportMs = runStartMs;
+    beginIteration();
+
+    mapFaults = plan.mapFaults;
+    if (mapFaults) {
+        faultMap.clear();
+    }
+    return true;
 }
 
-bool SRAMStrategy::shouldTestAddress(uint16_t addr, bool fullTest) {
-    if (fullTest) {
-        // FULL mode: test every address
-        return true;
-    }
+bool SRAMStrategy::step(uint16_t budgetUs) {
+    if (!running || paused) return running;
 
-    // QUICK mode: Strategic sampling
+    uint32_t start = micros();
+    do {
+        perfStart();
+        advance();
+        perfCollect();
+    } while (running && !paused && (micros() - start) < budgetUs);
 
-    // Always test first 512 bytes
-    if (addr < 512) {
-        return true;
-    }
+    return running;
+}
 
-    // Always test last 512 bytes
-    if (addr > maxAddress - 512) {
-        return true;
+void SRAMStrategy::advance() {
+    if (abortRequested) {
+        if (testStarted) {
+            endTest(plan.tests[planIndex]);
+        }
+        finishRun();
+        return;
     }
 
-    // Test power-of-2 addresses (walking ones)
-    if ((addr & (addr - 1)) == 0) {
-        return true;
+    if (planIndex >= plan.testCount) {
+        finishRun();
+        return;
     }
 
-    // Test every 128th address for sampling
-    if ((addr & 0x7F) == 0) {
-        return true;
+    uint8_t testNumber = plan.tests[planIndex];
+    if (!testStarted) {
+        beginTest(testNumber);
+        return;
     }
 
-    return false;
-}
+    if (!phaseLoaded) {
+        if (!loadPhase(testNumber, phaseIndex, phase)) {
+            // No phases left: report and move to the next test
+            nextTest(endTest(testNumber));
+            return;
+        }
+        beginPhase();
+    }
 
-const char* SRAMStrategy::getTestName(uint8_t testNumber) {
-    switch (testNumber) {
-        case 1: return "Basic Read/Write";
-        case 2: return "Walking Ones Address";
-        case 3: return "Walking Ones Data";
-        case 4: return "Checkerboard";
-        case 5: return "Inverse Checkerboard";
-        case 6: return "Address Equals Data";
-        case 7: return "Random Pattern";
-        default: return "Unknown";
+    bool completed = runUnit();
+    // Walks and the fused sweep send their own failure lines
+    if (!isFusedTest(testNumber) && phase.kind != PHASE_WALK_ADDRESS && phase.kind != PHASE_WALK_DATA) {
+        sendNewFaults(testNumber);
+    }
+    if (!completed) {
+        // Fail-fast mismatch (both chips with two sockets): remaining phases are skipped
+        nextTest(endTest(testNumber));
     }
 }
 
-void SRAMStrategy::sendProgress(const char* message) {
-    if (uart != nullptr) {
-        uart->sendInfo(message);
+void SRAMStrategy::applyPrescreen() {
+    // Test 2 moves to the front, or is added there
+    uint8_t index = 0;
+    while (index < plan.testCount && plan.tests[index] != 2) index++;
+    if (index == plan.testCount) {
+        if (plan.testCount >= sizeof(plan.tests)) {
+            plan.prescreen = false;
+            return;
+        }
+        plan.testCount++;
     }
+    for (; index > 0; index--) {
+        plan.tests[index] = plan.tests[index - 1];
+    }
+    plan.tests[0] = 2;
 }
 
-void SRAMStrategy::sendProgress(const char* message, uint16_t current, uint16_t total) {
-    if (uart != nullptr) {
-        uint8_t percent = (uint32_t)current * 100 / total;
-        String msg = String(message) + ": " + String(percent) + "%";
-        uart->sendInfo(msg.c_str());
+void SRAMStrategy::beginTest(uint8_t testNumber) {
+    perfCurrent = SRAMTestPerf();
+    perfAccessStart = bus.getAccessCount();
+
+    sendTestStart(testNumber, plan.fullTest);
+    testFaults[0] = testFaults[1] = SRAMFirstFault();
+    faultsSent = 0;
+    if (plan.fused && testNumber == 1) {
+        for (uint8_t i = 0; i < 6; i++) {
+            fusedFaults[i] = SRAMFirstFault();
+        }
     }
+    testStarted = true;
+    phaseIndex = 0;
+    phaseLoaded = false;
 }
 
-void SRAMStrategy::sendTestStart(uint8_t testNumber, bool fullTest) {
-    if (uart != nullptr) {
-        String msg = "Test " + String(testNumber) + " (" + getTestName(testNumber) + ") - ";
-        msg += fullTest ? "FULL mode" : "QUICK mode";
-        uart->sendInfo(msg.c_str());
+bool SRAMStrategy::endTest(uint8_t testNumber) {
+    // Measured up to here: the result line itself isn't part of the test
+    perfCollect();
+    if (!abortRequested) {
+        commitTestPerf(testNumber);
     }
-}
 
-void SRAMStrategy::sendTestResult(uint8_t testNumber, bool passed) {
-    if (uart != nullptr) {
-        String msg = "Test " + String(testNumber) + " (" + getTestName(testNumber) + ") - ";
-        msg += passed ? "PASSED" : "FAILED";
-        if (passed) {
-            uart->sendOK(msg.c_str());
-        } else {
-            uart->sendError(msg.c_str());
+    bool passed = true;
+    testSocketsFailed = 0;
+    if (abortRequested) {
+        sendTestAborted(testNumber);
+        passed = false;
+    } else {
+        for (uint8_t socket = 0; socket < socketCount(); socket++) {
+            currentSocket = socket;
+            if (!reportSocket(testNumber, socket)) {
+                socketTestsFailed[socket]++;
+                testSocketsFailed++;
+                passed = false;
+            }
         }
+        currentSocket = 0;
     }
-}
 
-void SRAMStrategy::sendTestError(uint8_t testNumber, uint16_t addr, uint8_t expected, uint8_t actual) {
-    if (uart != nullptr) {
-        char buf[80];
-        sprintf(buf, "Test %d FAIL - Addr: 0x%04X Expected: 0x%02X Got: 0x%02X",
-                testNumber, addr, expected, actual);
-        uart->sendError(buf);
+    if (!passed) {
+        testsFailed++;
     }
-}
 
-bool SRAMStrategy::runTest(uint8_t testNumber, bool fullTest) {
-    switch (testNumber) {
-        case 1: return testBasicReadWrite(fullTest);
-        case 2: return testWalkingOnesAddress(fullTest);
-        case 3: return testWalkingOnesData(fullTest);
-        case 4: return testCheckerboard(fullTest);
-        case 5: return testInverseCheckerboard(fullTest);
-        case 6: return testAddressEqualsData(fullTest);
-        case 7: return testRandomPattern(fullTest);
-        default:
-            if (uart != nullptr) {
-                uart->sendError("Invalid test number (1-7)");
+    if (plan.loopCount != 0 && !abortRequested) {
+        soak.recordTest(planIndex, CycleCounter::toMicros(perfCurrent.cycles), passed);
+        if (!passed && !soakFailureShown) {
+            if (uart != nullptr && !uart->isBinary()) {
+                uart->sendInfof(F("LOOP: first failure in iteration %lu"),
+                                (unsigned long)(soak.getIterations() + 1));
             }
-            return false;
+            soakFailureShown = true;
+        }
     }
+    return passed;
 }
 
-bool SRAMStrategy::runAllTests(bool includeRandom, bool fullTest) {
-    if (sramSize == 0) {
-        if (uart != nullptr) {
-            uart->sendError("SRAM size not configured");
-        }
+bool SRAMStrategy::reportSocket(uint8_t testNumber, uint8_t socket) {
+    if (isFusedTest(testNumber)) {
+        return reportFusedTest(testNumber, fusedFaults[3 * socket + (testNumber == 1 ? 0 : testNumber - 3)]);
+    }
+    if (testFaults[socket].failed) {
+        // Error line already sent when the mismatch was found
+        sendTestResult(testNumber, false);
         return false;
     }
+    return finishTest(testNumber);
+}
 
-    uint8_t maxTest = includeRandom ? 7 : 6;
-    bool allPassed = true;
+void SRAMStrategy::nextTest(bool passed) {
+    planIndex++;
+    testStarted = false;
 
-    for (uint8_t test = 1; test <= maxTest; test++) {
-        bool passed = runTest(test, fullTest);
-        if (!passed) {
-            allPassed = false;
-        }
+    // Failed pre-screen or tier: the longer tests would only repeat the verdict
+    // (with two sockets, only once both chips have failed)
+    if (!passed && testSocketsFailed == socketCount() && planIndex < plan.testCount && (plan.stopOnFail || (plan.prescreen && planIndex == 1))) {
+        testsSkipped = plan.testCount - planIndex;
+        plan.testCount = planIndex;
     }
+}
 
-    if (uart != nullptr) {
-        if (allPassed) {
-            uart->sendOK("All tests PASSED");
-        } else {
-            uart->sendError("Some tests FAILED");
+void SRAMStrategy::finishRun() {
+    // Tests reported so far, including the one that was aborted
+    uint8_t testsRun = planIndex + ((abortRequested && testStarted) ? 1 : 0);
+    if (testsRun > plan.testCount) testsRun = plan.testCount;
+
+    lastRunPassed = (testsFailed == 0) && !abortRequested;
+
+    if (plan.loopCount != 0) {
+        // An aborted iteration is incomplete: not counted
+        if (!abortRequested) {
+            soak.endIteration(lastRunPassed);
+            if (!soak.isDone()) {
+                if (millis() - lastSoakReportMs >= SRAM_LOOP_REPORT_INTERVAL_MS && sendSoakLine(true)) {
+                    lastSoakReportMs = millis();
+                }
+                beginIteration();
+                return;
+            }
         }
+
+        sendSoakReport();
+        lastRunPassed = soak.getFailedIterations() == 0 && !abortRequested;
+        sendSummary(lastRunPassed, soak.getTestCount(), soak.getFailingTests(), runStartMs);
+        running = false;
+        paused = false;
+        testStarted = false;
+        return;
     }
 
-    return allPassed;
+    if (testsSkipped > 0 && uart != nullptr && !uart->isBinary()) {
+        uart->sendInfof(F("%S FAILED: %u test(s) skipped"),
+                        plan.stopOnFail ? PSTR("Tier") : PSTR("Address pre-screen"), testsSkipped);
+    }
+    if (plan.summary) {
+        sendSocketSummary();
+        sendSummary(lastRunPassed, testsRun, testsFailed, runStartMs);
+    }
+    if (plan.mapFaults) {
+        sendFaultMapReport();
+    }
+
+    mapFaults = false;
+    running = false;
+    paused = false;
+    testStarted = false;
 }
 
-// Test 1: Basic Read/Write
-bool SRAMStrategy::testBasicReadWrite(bool fullTest) {
-    sendTestStart(1, fullTest);
+void SRAMStrategy::beginIteration() {
+    // A tier or pre-screen cut only ends its own iteration
+    if (plan.loopCount != 0 && soak.getIterations() > 0) {
+        plan.testCount = soak.getTestCount();
+        // SEED repeats one pattern every iteration, otherwise the seed chain goes on
+        if (plan.randomSeed == 0) {
+            randomSeed = randomPassSeed(plan.randomPasses);
+        }
+    }
+    planIndex = 0;
+    testsFailed = 0;
+    socketTestsFailed[0] = socketTestsFailed[1] = 0;
+    testsSkipped = 0;
+    testStarted = false;
+    phaseIndex = 0;
+    phaseLoaded = false;
+}
 
-    // Test pattern 1: 0xAA
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
+void SRAMStrategy::beginPhase() {
+    cursor = 0;
+    phaseLoaded = true;
 
-        writeByte(addr, 0xAA);
-        uint8_t read = readByte(addr);
-        if (read != 0xAA) {
-            sendTestError(1, addr, 0xAA, read);
-            sendTestResult(1, false);
-            return false;
+    if (phase.kind == PHASE_FILL || phase.kind == PHASE_VERIFY) {
+        if (phase.pattern == PATTERN_RANDOM) {
+            uint32_t seed = randomPassSeed((uint8_t)phase.value);
+            if (phase.kind == PHASE_FILL) {
+                sendRandomSeed((uint8_t)phase.value + 1, seed);
+            }
+            randomPattern = SRAMRandomPattern(seed);
         }
+        return;
+    }
 
-        // Progress update every 4096 addresses
-        if (fullTest && (addr & 0x0FFF) == 0 && addr > 0) {
-            sendProgress("Test 1", addr, maxAddress);
+    if (phase.kind == PHASE_MARCH) {
+        uint8_t testNumber = plan.tests[planIndex];
+        const MarchAlgorithm& algorithm = isFusedTest(testNumber) ? MARCH_FUSED_PATTERNS
+                                        : (testNumber == 1)       ? MARCH_BASIC_PATTERNS
+                                                                  : MARCH_ALGORITHMS[marchAlgorithm];
+        MarchElement element;
+        readMarchElement(algorithm, (uint8_t)phase.value, element);
+
+        // Resolve "0"/"1" against the data background once per element
+        marchOpCount = element.opCount;
+        for (uint8_t i = 0; i < element.opCount; i++) {
+            marchOps[i].write = (element.ops[i] & MARCH_OP_WRITE) != 0;
+            marchOps[i].data = (element.ops[i] & MARCH_OP_INVERT) ? (uint8_t)~algorithm.background
+                                                                  : algorithm.background;
+            marchOps[i].tag = element.ops[i] >> MARCH_TAG_SHIFT;
         }
+        marchDescending = (element.order == MARCH_DOWN);
     }
+}
 
-    // Test pattern 2: 0x55
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
+bool SRAMStrategy::runUnit() {
+    if (phase.kind == PHASE_WALK_ADDRESS || phase.kind == PHASE_WALK_DATA) {
+        // Walks report their own errors: UART time isn't bus time
+        uint32_t busStart = CycleCounter::now();
+        uint32_t txStart = txCycles();
+        bool completed = true;
+        for (uint8_t socket = 0; socket < socketCount(); socket++) {
+            // Single-byte probes: one socket at a time, so each chip's lines are named
+            currentSocket = socket;
+            if (dualSocket) bus.setSockets(socket == 0 ? SRAM_SOCKET_A : SRAM_SOCKET_B);
+            if (!((phase.kind == PHASE_WALK_ADDRESS) ? runWalkAddress() : runWalkData())) completed = false;
+        }
+        currentSocket = 0;
+        if (dualSocket) bus.setSockets(SRAM_SOCKETS_BOTH);
+        perfCurrent.busCycles += (CycleCounter::now() - busStart) - (txCycles() - txStart);
+        phaseIndex++;
+        phaseLoaded = false;
+        return completed;
+    }
 
-        writeByte(addr, 0x55);
-        uint8_t read = readByte(addr);
-        if (read != 0x55) {
-            sendTestError(1, addr, 0x55, read);
-            sendTestResult(1, false);
-            return false;
+    // Next unit of at most STEP_CHUNK addresses (from the top when descending)
+    bool descending = (phase.kind == PHASE_MARCH) && marchDescending;
+    uint16_t remaining = maxAddress - cursor;
+    uint16_t span = (remaining < STEP_CHUNK) ? remaining : STEP_CHUNK - 1;
+    uint16_t first = descending ? maxAddress - cursor - span : cursor;
+    uint16_t last = first + span;
+
+    FusedFaultSink fusedSink(fusedFaults, socketCount(), mapFaults ? &faultMap : nullptr);
+    SocketFaultSink socketSink(testFaults);
+    SRAMFaultSink& sink = isFusedTest(plan.tests[planIndex]) ? static_cast<SRAMFaultSink&>(fusedSink)
+                        : mapFaults ? static_cast<SRAMFaultSink&>(faultMap)
+                        : dualSocket ? static_cast<SRAMFaultSink&>(socketSink)
+                        : static_cast<SRAMFaultSink&>(testFaults[0]);
+
+    uint32_t busStart = CycleCounter::now();
+    bool completed;
+    if (phase.kind == PHASE_MARCH) {
+        completed = marchUnit(first, last, sink);
+    } else {
+        bool write = (phase.kind == PHASE_FILL);
+        if (phase.pattern == PATTERN_CONSTANT) {
+            SRAMConstantPattern pattern((uint8_t)phase.value);
+            completed = patternUnit(pattern, write, first, last, sink);
+        } else if (phase.pattern == PATTERN_ADDRESS) {
+            SRAMAddressPattern pattern;
+            completed = patternUnit(pattern, write, first, last, sink);
+        } else {
+            completed = patternUnit(randomPattern, write, first, last, sink);
         }
     }
+    perfCurrent.busCycles += CycleCounter::now() - busStart;
+    if (!completed) return false;
+
+    if (span == remaining) {
+        phaseIndex++;
+        phaseLoaded = false;
+        return true;
+    }
 
-    sendTestResult(1, true);
+    cursor += span + 1;
+    if (plan.fullTest && phase.label != nullptr && (cursor & (PASS_CHUNK - 1)) == 0) {
+        sendProgress(phase.label, cursor, maxAddress);
+    }
     return true;
 }
 
-// Test 2: Walking Ones Address
-bool SRAMStrategy::testWalkingOnesAddress(bool fullTest) {
-    sendTestStart(2, fullTest);
-
-    uint8_t testPattern = 0xAA;
+template <typename Pattern>
+bool SRAMStrategy::patternUnit(Pattern& pattern, bool write, uint16_t first, uint16_t last,
+                               SRAMFaultSink& sink) {
+    if (plan.fullTest) {
+        if (write) {
+            bus.fill(first, last, pattern);
+            return true;
+        }
+        return bus.verify(first, last, pattern, sink);
+    }
 
-    // Test each address bit
-    for (uint8_t bit = 0; bit < addressBits; bit++) {
-        uint16_t addr = (1 << bit);
+    // QUICK mode: sampled runs inside the unit, contiguous runs as one burst
+    for (uint8_t i = 0; i < samples.getRunCount(); i++) {
+        SRAMSampleRun run;
+        if (!samples.clip(i, first, last, run)) continue;
 
-        writeByte(addr, testPattern);
-        uint8_t read = readByte(addr);
+        if (run.step == 1) {
+            if (write) {
+                bus.fill(run.first, run.last, pattern);
+            } else if (!bus.verify(run.first, run.last, pattern, sink)) {
+                return false;
+            }
+            continue;
+        }
+        for (uint16_t addr = run.first;; addr += run.step) {
+            if (write) {
+                bus.fill(addr, addr, pattern);
+            } else if (!bus.verify(addr, addr, pattern, sink)) {
+                return false;
+            }
+            if (addr == run.last) break;
+        }
+    }
+    return true;
+}
 
-        if (read != testPattern) {
-            sendTestError(2, addr, testPattern, read);
-            if (uart != nullptr) {
-                char buf[50];
-                sprintf(buf, "Possible issue with address line A%d", bit);
-                uart->sendInfo(buf);
+bool SRAMStrategy::marchUnit(uint16_t first, uint16_t last, SRAMFaultSink& sink) {
+    if (!plan.fullTest) {
+        // QUICK mode: element applied to the sampled runs, in element order
+        uint8_t runCount = samples.getRunCount();
+        for (uint8_t i = 0; i < runCount; i++) {
+            SRAMSampleRun run;
+            if (!samples.clip(marchDescending ? runCount - 1 - i : i, first, last, run)) continue;
+
+            if (run.step == 1) {
+                if (!bus.sweepCells(run.first, run.last, marchDescending, marchOps, marchOpCount, sink)) {
+                    return false;
+                }
+                continue;
+            }
+            uint16_t addr = marchDescending ? run.last : run.first;
+            for (;;) {
+                if (!bus.sweepCells(addr, addr, marchDescending, marchOps, marchOpCount, sink)) {
+                    return false;
+                }
+                if (addr == (marchDescending ? run.first : run.last)) break;
+                addr = marchDescending ? addr - run.step : addr + run.step;
             }
-            sendTestResult(2, false);
-            return false;
         }
+        return true;
     }
 
-    sendTestResult(2, true);
-    return true;
+    // Single-operation elements that don't care about order use the fast
+    // fill/verify loops (no bus turnaround per cell)
+    if (marchOpCount == 1 && !marchDescending) {
+        SRAMConstantPattern pattern(marchOps[0].data);
+        if (marchOps[0].write) {
+            bus.fill(first, last, pattern);
+            return true;
+        }
+        return bus.verify(first, last, pattern, sink, marchOps[0].tag);
+    }
+
+    return bus.sweepCells(first, last, marchDescending, marchOps, marchOpCount, sink);
 }
 
-// Test 3: Walking Ones Data
-bool SRAMStrategy::testWalkingOnesData(bool fullTest) {
-    sendTestStart(3, fullTest);
+// Test 2: Address bus diagnosis (SRAMAddressCheck.h); every faulty line is named
+bool SRAMStrategy::runWalkAddress() {
+    SRAMAddressCheck check;
+    if (check.run(bus, addressBits)) return true;
+
+    const SRAMFirstFault& fault = check.getFirstFault();
+    if (mapFaults) {
+        faultMap.onFault(fault.address, fault.expected, fault.actual, 0);
+    } else {
+        testFaults[currentSocket].onFault(fault.address, fault.expected, fault.actual, 0);
+        sendTestError(2, fault.address, fault.expected, fault.actual);
+    }
+    sendAddressDiagnosis(check);
+    return mapFaults;
+}
 
+// Test 3: Walking Ones Data
+bool SRAMStrategy::runWalkData() {
     uint16_t testAddr = 0x0000;  // Use address 0 for data line test
 
     // Test each data bit
     for (uint8_t bit = 0; bit < 8; bit++) {
         uint8_t testPattern = (1 << bit);
 
-        writeByte(testAddr, testPattern);
-        uint8_t read = readByte(testAddr);
+        bus.writeByte(testAddr, testPattern);
+        uint8_t read = bus.readByte(testAddr);
 
         if (read != testPattern) {
+            if (mapFaults) {
+                faultMap.onFault(testAddr, testPattern, read, 0);
+                continue;
+            }
+            testFaults[currentSocket].onFault(testAddr, testPattern, read, 0);
             sendTestError(3, testAddr, testPattern, read);
-            if (uart != nullptr) {
-                char buf[50];
-                sprintf(buf, "Possible issue with data line D%d", bit);
-                uart->sendInfo(buf);
+            if (uart != nullptr && !uart->isBinary()) {
+                uart->sendInfof(F("%SPossible issue with data line D%d"), socketPrefix(), bit);
             }
-            sendTestResult(3, false);
             return false;
         }
     }
 
-    sendTestResult(3, true);
     return true;
 }
 
-// Test 4: Checkerboard Pattern
-bool SRAMStrategy::testCheckerboard(bool fullTest) {
-    sendTestStart(4, fullTest);
+//=============================================================================
+// RUN CONTROL
+//=============================================================================
 
-    // Write phase: 0x55
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
-        writeByte(addr, 0x55);
+bool SRAMStrategy::isRunning() const {
+    return running;
+}
 
-        if (fullTest && (addr & 0x0FFF) == 0 && addr > 0) {
-            sendProgress("Test 4 (write 0x55)", addr, maxAddress);
-        }
+bool SRAMStrategy::isPaused() const {
+    return paused;
+}
+
+void SRAMStrategy::pause() {
+    if (running) paused = true;
+}
+
+void SRAMStrategy::resume() {
+    paused = false;
+}
+
+void SRAMStrategy::abortRun() {
+    if (running) {
+        abortRequested = true;
+        paused = false;
     }
+}
 
-    // Verify phase: 0x55
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
+bool SRAMStrategy::wasAborted() const {
+    return abortRequested;
+}
 
-        uint8_t read = readByte(addr);
-        if (read != 0x55) {
-            sendTestError(4, addr, 0x55, read);
-            sendTestResult(4, false);
-            return false;
-        }
+bool SRAMStrategy::didLastRunPass() const {
+    return lastRunPassed;
+}
 
-        if (fullTest && (addr & 0x0FFF) == 0 && addr > 0) {
-            sendProgress("Test 4 (verify 0x55)", addr, maxAddress);
+void SRAMStrategy::checkpoint() {
+    // Blocking runs: answer the mid-test commands the main loop can't see
+    if (uart == nullptr) return;
+
+    uart->poll();
+    if (uart->takeCommand(F("STATUS"))) {
+        sendRunStatus();
+    }
+    if (uart->takeCommand(F("ABORT"))) {
+        abortRun();
+        uart->sendInfo(F("ABORT received"));
+    }
+}
+
+void SRAMStrategy::sendRunStatus() {
+    if (uart == nullptr) return;
+
+    uint8_t percent = phaseLoaded ? (uint32_t)cursor * 100 / maxAddress : 0;
+
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_PROGRESS);
+        record.put8(currentTest).put8(percent).put16(cursor).put16(maxAddress);
+        uart->sendRecord(record);
+        if (running && plan.loopCount != 0) {
+            sendSoakLine(false);
         }
+        return;
     }
 
-    // Write phase: 0xAA
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
-        writeByte(addr, 0xAA);
+    uart->sendInfof(F("STATUS: Test %d (%S) %S, %d%%"), currentTest, getTestName(currentTest),
+                    paused ? PSTR("paused") : PSTR("running"), percent);
+    if (running && plan.loopCount != 0) {
+        sendSoakLine(false);
     }
+}
 
-    // Verify phase: 0xAA
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
+const SRAMSoakStats& SRAMStrategy::getSoakStats() const {
+    return soak;
+}
 
-        uint8_t read = readByte(addr);
-        if (read != 0xAA) {
-            sendTestError(4, addr, 0xAA, read);
-            sendTestResult(4, false);
-            return false;
-        }
+uint16_t SRAMStrategy::getQuickStride() const {
+    return samples.getStride();
+}
+
+uint32_t SRAMStrategy::getQuickCellCount() const {
+    return samples.getCellCount();
+}
+
+PGM_P SRAMStrategy::getTestName(uint8_t testNumber) {
+    switch (testNumber) {
+        case 1: return PSTR("Basic Read/Write");
+        case 2: return PSTR("Address Bus");
+        case 3: return PSTR("Walking Ones Data");
+        case 4: return PSTR("Checkerboard");
+        case 5: return PSTR("Inverse Checkerboard");
+        case 6: return PSTR("Address Equals Data");
+        case 7: return PSTR("Random Pattern");
+        case 8: return MARCH_ALGORITHMS[marchAlgorithm].name;
+        default: return PSTR("Unknown");
     }
+}
 
-    sendTestResult(4, true);
-    return true;
+void SRAMStrategy::sendProgress(const char* message, uint16_t current, uint16_t total) {
+    if (uart == nullptr || soakMuted(false)) return;
+
+    // Too soon, or no room in the TX ring: skip, the next update carries on
+    uint32_t now = millis();
+    if (now - lastProgressMs < SRAM_PROGRESS_INTERVAL_MS) {
+        progressCoalesced++;
+        return;
+    }
+
+    uint8_t percent = (uint32_t)current * 100 / total;
+    bool sent;
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_PROGRESS);
+        record.put8(currentTest).put8(percent).put16(current).put16(total);
+        sent = uart->trySendRecord(record);
+    } else {
+        sent = uart->trySendInfof(F("%s: %d%%"), message, percent);
+    }
+
+    if (!sent) {
+        progressCoalesced++;
+        return;
+    }
+    lastProgressMs = now;
+    progressSent++;
 }
 
-// Test 5: Inverse Checkerboard Pattern
-bool SRAMStrategy::testInverseCheckerboard(bool fullTest) {
-    sendTestStart(5, fullTest);
+void SRAMStrategy::sendTestStart(uint8_t testNumber, bool fullTest) {
+    currentTest = testNumber;
+    testStartMs = millis();
+    lastProgressMs = testStartMs;
+    faultMap.setTest(testNumber);
+    mapFailuresAtStart = faultMap.getTotalFailures();
+    if (uart == nullptr || soakMuted(false)) return;
+
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_TEST_START);
+        record.put8(testNumber).put8(fullTest ? 1 : 0).put16(sramSize);
+        uart->sendRecord(record);
+        return;
+    }
 
-    // Write phase: 0xAA
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
-        writeByte(addr, 0xAA);
+    uart->sendInfof(F("Test %d (%S) - %S mode"), testNumber, getTestName(testNumber),
+                    fullTest ? PSTR("FULL") : PSTR("QUICK"));
+}
 
-        if (fullTest && (addr & 0x0FFF) == 0 && addr > 0) {
-            sendProgress("Test 5 (write 0xAA)", addr, maxAddress);
+void SRAMStrategy::sendTestResult(uint8_t testNumber, bool passed) {
+    if (uart == nullptr || soakMuted(!passed)) return;
+
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_TEST_END);
+        record.put8(testNumber).put8(passed ? 1 : 0).put32(millis() - testStartMs).put8(socketId());
+        uart->sendRecord(record);
+        if (perfAttach && currentSocket == socketCount() - 1 && perfSlot(testNumber) != PERF_NO_SLOT) {
+            sendTestPerf(perfSlot(testNumber));
         }
+        return;
     }
 
-    // Verify phase: 0xAA
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
+    if (passed) {
+        uart->sendOKf(F("Test %d (%S%S) - PASSED"), testNumber, getTestName(testNumber), socketSuffix());
+    } else {
+        uart->sendErrorf(F("Test %d (%S%S) - FAILED"), testNumber, getTestName(testNumber), socketSuffix());
+    }
 
-        uint8_t read = readByte(addr);
-        if (read != 0xAA) {
-            sendTestError(5, addr, 0xAA, read);
-            sendTestResult(5, false);
-            return false;
+    // One PERF line per test: the sockets share the bus cycles
+    if (perfAttach && currentSocket == socketCount() - 1) {
+        uint8_t slot = perfSlot(testNumber);
+        if (slot != PERF_NO_SLOT) {
+            sendTestPerf(slot);
         }
+    }
+}
+
+void SRAMStrategy::sendTestError(uint8_t testNumber, uint16_t addr, uint8_t expected, uint8_t actual) {
+    if (uart == nullptr || soakMuted(true)) return;
+
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_FAILURE);
+        record.put8(testNumber).put16(addr).put8(expected).put8(actual).put8(socketId());
+        uart->sendRecord(record);
+        return;
+    }
+
+    PGM_P socket = !dualSocket ? PSTR("") : (currentSocket == 0) ? PSTR(" Socket: A") : PSTR(" Socket: B");
+    if (testNumber == 7) {
+        // The pass seed repeats the failing pattern: TEST 7 SEED <seed>
+        uart->sendErrorf(F("Test %d FAIL - Addr: 0x%04X Expected: 0x%02X Got: 0x%02X Seed: 0x%08lX%S"),
+                         testNumber, addr, expected, actual,
+                         (unsigned long)randomPassSeed((uint8_t)phase.value), socket);
+        return;
+    }
+    uart->sendErrorf(F("Test %d FAIL - Addr: 0x%04X Expected: 0x%02X Got: 0x%02X%S"),
+                     testNumber, addr, expected, actual, socket);
+}
 
-        if (fullTest && (addr & 0x0FFF) == 0 && addr > 0) {
-            sendProgress("Test 5 (verify 0xAA)", addr, maxAddress);
+void SRAMStrategy::sendNewFaults(uint8_t testNumber) {
+    for (uint8_t socket = 0; socket < socketCount(); socket++) {
+        const SRAMFirstFault& fault = testFaults[socket];
+        if (!fault.failed || (faultsSent & (1 << socket))) continue;
+
+        currentSocket = socket;
+        sendTestError(testNumber, fault.address, fault.expected, fault.actual);
+        faultsSent |= (uint8_t)(1 << socket);
+    }
+    currentSocket = 0;
+}
+
+void SRAMStrategy::sendSocketSummary() {
+    if (uart == nullptr || !dualSocket || uart->isBinary() || abortRequested) return;
+
+    for (uint8_t socket = 0; socket < 2; socket++) {
+        if (socketTestsFailed[socket] == 0) {
+            uart->sendInfof(F("Socket %c: PASSED"), 'A' + socket);
+        } else {
+            uart->sendInfof(F("Socket %c: FAILED (%u test(s))"), 'A' + socket, socketTestsFailed[socket]);
         }
     }
+}
+
+uint8_t SRAMStrategy::socketId() const {
+    if (!dualSocket) return 0;
+    return (currentSocket == 0) ? SRAM_SOCKET_A : SRAM_SOCKET_B;
+}
 
-    // Write phase: 0x55
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
-        writeByte(addr, 0x55);
+PGM_P SRAMStrategy::socketSuffix() const {
+    if (!dualSocket) return PSTR("");
+    return (currentSocket == 0) ? PSTR(", socket A") : PSTR(", socket B");
+}
+
+PGM_P SRAMStrategy::socketPrefix() const {
+    if (!dualSocket) return PSTR("");
+    return (currentSocket == 0) ? PSTR("Socket A: ") : PSTR("Socket B: ");
+}
+
+void SRAMStrategy::sendRandomSeed(uint8_t pass, uint32_t seed) {
+    if (uart == nullptr || soakMuted(false)) return;
+
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_SEED);
+        record.put8(7).put8(pass).put32(seed);
+        uart->sendRecord(record);
+        return;
+    }
+
+    uart->sendInfof(F("Test 7 pass %u/%u: seed 0x%08lX"), pass, plan.randomPasses, (unsigned long)seed);
+}
+
+uint32_t SRAMStrategy::randomPassSeed(uint8_t pass) const {
+    uint32_t seed = randomSeed;
+    for (uint8_t i = 0; i < pass; i++) {
+        seed = SRAMRandomPattern::nextSeed(seed);
     }
+    return seed;
+}
 
-    // Verify phase: 0x55
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
+void SRAMStrategy::sendAddressDiagnosis(const SRAMAddressCheck& check) {
+    if (uart == nullptr || soakMuted(true)) return;
 
-        uint8_t read = readByte(addr);
-        if (read != 0x55) {
-            sendTestError(5, addr, 0x55, read);
-            sendTestResult(5, false);
-            return false;
+    uint16_t shortedLines = 0;
+    for (uint8_t line = 0; line < addressBits; line++) {
+        if (check.getShortedWith(line) != 0) shortedLines |= (uint16_t)(1 << line);
+    }
+
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_ADDRESS);
+        record.put16(check.getStuckLines()).put16(shortedLines).put16(check.getUnpairedLines())
+              .put8(addressBits).put8(check.hasDataFault() ? 1 : 0);
+        uart->sendRecord(record);
+        return;
+    }
+
+    if (check.hasDataFault()) {
+        // 8KB: A13 drives CS2, a fault there deselects the chip
+        uart->sendInfof(F("%SData fault at 0x%04X: check chip, /CS%S and data bus (test 3)"), socketPrefix(),
+                        check.getFirstFault().address, sramSize <= 8192 ? PSTR(", A13 (CS2)") : PSTR(""));
+        return;
+    }
+
+    for (uint8_t line = 0; line < addressBits; line++) {
+        uint16_t bit = (uint16_t)(1 << line);
+        if (check.getStuckLines() & bit) {
+            uart->sendInfof(F("%SAddress line A%d stuck or open"), socketPrefix(), line);
+        }
+        for (uint8_t other = line + 1; other < addressBits; other++) {
+            if (check.getShortedWith(line) & (1 << other)) {
+                uart->sendInfof(F("%SAddress lines A%d and A%d shorted"), socketPrefix(), line, other);
+            }
+        }
+        if (check.getUnpairedLines() & bit) {
+            uart->sendInfof(F("%SAddress line A%d shorted to another signal"), socketPrefix(), line);
         }
     }
+}
+
+void SRAMStrategy::sendTestAborted(uint8_t testNumber) {
+    if (uart == nullptr) return;
+
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_TEST_END);
+        record.put8(testNumber).put8(BIN_TEST_ABORTED).put32(millis() - testStartMs).put8(socketId());
+        uart->sendRecord(record);
+        return;
+    }
+
+    uart->sendErrorf(F("Test %d (%S%S) - ABORTED"), testNumber, getTestName(testNumber), socketSuffix());
+}
+
+void SRAMStrategy::sendSummary(bool allPassed, uint8_t testsRun, uint8_t testsFailed, uint32_t startMs) {
+    if (uart == nullptr) return;
+
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_SUMMARY);
+        record.put8(allPassed ? 1 : 0).put8(testsRun).put8(testsFailed).put8(abortRequested ? 1 : 0)
+              .put32(millis() - startMs);
+        uart->sendRecord(record);
+        return;
+    }
+
+    if (abortRequested) {
+        uart->sendError(F("Tests ABORTED"));
+    } else if (allPassed) {
+        uart->sendOK(F("All tests PASSED"));
+    } else {
+        uart->sendError(F("Some tests FAILED"));
+    }
+}
+
+bool SRAMStrategy::reportFusedTest(uint8_t testNumber, const SRAMFirstFault& fault) {
+    if (fault.failed && mapFaults) {
+        // Details are in the fault map report
+        sendTestResult(testNumber, false);
+        return false;
+    }
+
+    if (fault.failed) {
+        sendTestError(testNumber, fault.address, fault.expected, fault.actual);
+        sendTestResult(testNumber, false);
+        return false;
+    }
 
-    sendTestResult(5, true);
+    sendTestResult(testNumber, true);
     return true;
 }
 
-// Test 6: Address Equals Data
-bool SRAMStrategy::testAddressEqualsData(bool fullTest) {
-    sendTestStart(6, fullTest);
+bool SRAMStrategy::finishTest(uint8_t testNumber) {
+    if (abortRequested) {
+        sendTestAborted(testNumber);
+        return false;
+    }
 
-    // Write phase
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
+    // Fail-fast tests only get here when they passed
+    bool passed = !mapFaults || faultMap.getTotalFailures() == mapFailuresAtStart;
+    sendTestResult(testNumber, passed);
+    return passed;
+}
 
-        uint8_t data = (uint8_t)(addr & 0xFF);  // Low byte of address
-        writeByte(addr, data);
+// Soak: routine per-test output is muted, failures until the first one is shown
+bool SRAMStrategy::soakMuted(bool failure) const {
+    return running && plan.loopCount != 0 && (!failure || soakFailureShown);
+}
 
-        if (fullTest && (addr & 0x0FFF) == 0 && addr > 0) {
-            sendProgress("Test 6 (write)", addr, maxAddress);
-        }
+bool SRAMStrategy::sendSoakLine(bool tryOnly) {
+    if (uart == nullptr) return true;
+
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_LOOP);
+        record.put32(soak.getIterations()).put32(soak.getFailedIterations());
+        if (tryOnly) return uart->trySendRecord(record);
+        uart->sendRecord(record);
+        return true;
     }
 
-    // Verify phase
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
+    // "1234/5000" or "1234/FOREVER"
+    char target[12];
+    if (soak.getTarget() == SRAM_LOOP_FOREVER) {
+        strcpy_P(target, PSTR("FOREVER"));
+    } else {
+        snprintf_P(target, sizeof(target), PSTR("%lu"), (unsigned long)soak.getTarget());
+    }
+    char first[24] = "";
+    if (soak.getFirstFailedIteration() != 0) {
+        snprintf_P(first, sizeof(first), PSTR(" (first: %lu)"), (unsigned long)soak.getFirstFailedIteration());
+    }
 
-        uint8_t expected = (uint8_t)(addr & 0xFF);
-        uint8_t actual = readByte(addr);
+    char line[80];
+    snprintf_P(line, sizeof(line), PSTR("LOOP: %lu/%s iterations, %lu failed%s, %lu s"),
+               (unsigned long)soak.getIterations(), target, (unsigned long)soak.getFailedIterations(),
+               first, (unsigned long)((millis() - runStartMs) / 1000));
+    if (tryOnly) return uart->trySendInfof(F("%s"), line);
+    uart->sendInfo(line);
+    return true;
+}
 
-        if (actual != expected) {
-            sendTestError(6, addr, expected, actual);
-            sendTestResult(6, false);
-            return false;
+void SRAMStrategy::sendSoakReport() {
+    if (uart == nullptr) return;
+
+    sendSoakLine(false);
+    for (uint8_t i = 0; i < soak.getTestCount(); i++) {
+        const SRAMSoakTestStats& stats = soak.getTest(i);
+        uint32_t minUs = (stats.runs > 0) ? stats.minUs : 0;
+        uint32_t meanUs = soak.getMeanUs(i);
+
+        if (uart->isBinary()) {
+            const uint8_t kinds[5] = {BIN_LOOP_RUNS, BIN_LOOP_FAILURES, BIN_LOOP_MIN_US,
+                                      BIN_LOOP_MAX_US, BIN_LOOP_MEAN_US};
+            const uint32_t values[5] = {stats.runs, stats.failures, minUs, stats.maxUs, meanUs};
+            for (uint8_t k = 0; k < 5; k++) {
+                BinaryRecord record(BIN_REC_LOOP_TEST);
+                record.put8(stats.test).put8(kinds[k]).put8(0).put8(0).put32(values[k]);
+                uart->sendRecord(record);
+            }
+            continue;
         }
 
-        if (fullTest && (addr & 0x0FFF) == 0 && addr > 0) {
-            sendProgress("Test 6 (verify)", addr, maxAddress);
+        uart->sendInfof(F("  Test %d: %lu runs, %lu failed, min/mean/max %lu.%lu/%lu.%lu/%lu.%lu ms"),
+                        stats.test, (unsigned long)stats.runs, (unsigned long)stats.failures,
+                        (unsigned long)(minUs / 1000), (unsigned long)((minUs / 100) % 10),
+                        (unsigned long)(meanUs / 1000), (unsigned long)((meanUs / 100) % 10),
+                        (unsigned long)(stats.maxUs / 1000), (unsigned long)((stats.maxUs / 100) % 10));
+    }
+}
+
+void SRAMStrategy::sendFaultMapReport() {
+    if (uart == nullptr) return;
+
+    if (uart->isBinary()) {
+        BinaryRecord total(BIN_REC_MAP_TOTAL);
+        total.put32(faultMap.getTotalFailures()).put32(faultMap.getUnmappedFailures());
+        uart->sendRecord(total);
+
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            if (faultMap.getBitReadLow(bit) == 0 && faultMap.getBitReadHigh(bit) == 0) continue;
+            BinaryRecord record(BIN_REC_MAP_BIT);
+            record.put8(bit).put16(faultMap.getBitReadLow(bit)).put16(faultMap.getBitReadHigh(bit));
+            uart->sendRecord(record);
+        }
+        for (uint8_t i = 0; i < faultMap.getRangeCount(); i++) {
+            const SRAMFaultRange& range = faultMap.getRange(i);
+            BinaryRecord record(BIN_REC_MAP_RANGE);
+            record.put16(range.first).put16(range.last).put16(range.failures);
+            uart->sendRecord(record);
+        }
+        for (uint8_t i = 0; i < faultMap.getRecordCount(); i++) {
+            const SRAMFaultRecord& entry = faultMap.getRecord(i);
+            BinaryRecord record(BIN_REC_FAILURE);
+            record.put8(entry.test).put16(entry.address).put8(entry.expected).put8(entry.actual);
+            uart->sendRecord(record);
         }
+        return;
     }
 
-    sendTestResult(6, true);
-    return true;
+    uart->sendInfof(F("Fault map: %lu failures"), (unsigned long)faultMap.getTotalFailures());
+    if (faultMap.getTotalFailures() == 0) return;
+
+    uart->sendInfo(F("  Data bits (expected 1 read 0 / expected 0 read 1):"));
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        if (faultMap.getBitReadLow(bit) == 0 && faultMap.getBitReadHigh(bit) == 0) continue;
+        uart->sendInfof(F("    D%d: %u / %u"), bit, faultMap.getBitReadLow(bit), faultMap.getBitReadHigh(bit));
+    }
+
+    uart->sendInfof(F("  Failing ranges (%d):"), faultMap.getRangeCount());
+    for (uint8_t i = 0; i < faultMap.getRangeCount(); i++) {
+        const SRAMFaultRange& range = faultMap.getRange(i);
+        uart->sendInfof(F("    0x%04X-0x%04X: %u failures"), range.first, range.last, range.failures);
+    }
+    if (faultMap.getUnmappedFailures() > 0) {
+        uart->sendInfof(F("    (%lu failures outside listed ranges)"),
+                        (unsigned long)faultMap.getUnmappedFailures());
+    }
+
+    uart->sendInfo(F("  First failures:"));
+    for (uint8_t i = 0; i < faultMap.getRecordCount(); i++) {
+        const SRAMFaultRecord& entry = faultMap.getRecord(i);
+        uart->sendInfof(F("    Test %d Addr: 0x%04X Expected: 0x%02X Got: 0x%02X"),
+                        entry.test, entry.address, entry.expected, entry.actual);
+    }
+}
+
+//=============================================================================
+// RUN-TIME ESTIMATES
+//=============================================================================
+
+/**
+ * Sink that keeps sweeping (calibration doesn't care about the data)
+ */
+class IgnoreFaults : public SRAMFaultSink {
+public:
+    bool onFault(uint16_t, uint8_t, uint8_t, uint8_t) override { return true; }
+};
+
+static constexpr uint16_t CALIBRATION_CELLS = 512;
+static constexpr uint8_t CALIBRATION_SINGLES = 16;
+
+static uint16_t accessNs(uint32_t cycles, uint16_t accesses) {
+    uint32_t ns = cycles * 1000UL / ((uint32_t)CycleCounter::CYCLES_PER_US * accesses);
+    return (ns > 0xFFFF) ? 0xFFFF : (uint16_t)ns;
 }
 
-// Test 7: Random Pattern
-bool SRAMStrategy::testRandomPattern(bool fullTest) {
-    sendTestStart(7, fullTest);
+void SRAMStrategy::measureAccessTiming() {
+    if (hasAccessTiming() || sramSize == 0 || running) {
+        return;
+    }
+
+    // The same bus loops the tests use, on the part in the socket
+    IgnoreFaults ignore;
+    SRAMConstantPattern pattern(0x55);
+
+    uint32_t start = CycleCounter::now();
+    bus.fill(0, CALIBRATION_CELLS - 1, pattern);
+    bus.verify(0, CALIBRATION_CELLS - 1, pattern, ignore);
+    timing.burstNs = accessNs(CycleCounter::now() - start, 2 * CALIBRATION_CELLS);
+
+    const SRAMCellOp ops[2] = {{false, 0x55, 0}, {true, 0xAA, 0}};
+    start = CycleCounter::now();
+    bus.sweepCells(0, CALIBRATION_CELLS - 1, false, ops, 2, ignore);
+    timing.cellNs = accessNs(CycleCounter::now() - start, 2 * CALIBRATION_CELLS);
+
+    start = CycleCounter::now();
+    for (uint8_t i = 0; i < CALIBRATION_SINGLES; i++) {
+        bus.writeByte(i, 0x55);
+        bus.readByte(i);
+    }
+    timing.singleNs = accessNs(CycleCounter::now() - start, 2 * CALIBRATION_SINGLES);
+
+    timingSize = sramSize;
+}
 
-    // Seed random number generator with known value
-    randomSeed(12345);
+float SRAMStrategy::marchNs(const MarchAlgorithm& algorithm, bool fullTest, uint32_t burstCells,
+                            uint32_t singleCells) {
+    float ns = 0;
+    for (uint8_t i = 0; i < algorithm.elementCount; i++) {
+        MarchElement element;
+        readMarchElement(algorithm, i, element);
 
-    // Write phase
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
+        // FULL single-op ascending elements use fill/verify (see marchUnit())
+        if (fullTest && element.opCount == 1 && element.order != MARCH_DOWN) {
+            ns += (float)burstCells * timing.burstNs;
+        } else {
+            ns += (float)element.opCount * ((float)burstCells * timing.cellNs + (float)singleCells * timing.singleNs);
+        }
+    }
+    return ns;
+}
 
-        uint8_t data = (uint8_t)(random(256));
-        writeByte(addr, data);
+uint32_t SRAMStrategy::estimateRunMs(const SRAMRunPlan& estimatePlan, uint8_t algorithm) {
+    if (!hasAccessTiming() || algorithm >= MARCH_ALGORITHM_COUNT) return 0;
 
-        if (fullTest && (addr & 0x0FFF) == 0 && addr > 0) {
-            sendProgress("Test 7 (write)", addr, maxAddress);
+    // Cells per sweep: contiguous runs go as bursts, QUICK strided cells one by one
+    uint32_t burstCells = sramSize;
+    uint32_t singleCells = 0;
+    if (!estimatePlan.fullTest) {
+        if (estimatePlan.quickStride != samples.getStride() && !running) {
+            samples.build(maxAddress, estimatePlan.quickStride);
+        }
+        burstCells = 0;
+        for (uint8_t i = 0; i < samples.getRunCount(); i++) {
+            SRAMSampleRun run;
+            if (!samples.clip(i, 0, maxAddress, run)) continue;
+            uint32_t cells = (uint32_t)(run.last - run.first) / run.step + 1;
+            if (run.step == 1) burstCells += cells;
+            else singleCells += cells;
+        }
+    }
+    float sweepNs = (float)burstCells * timing.burstNs + (float)singleCells * timing.singleNs;
+
+    bool hasAddressTest = false;
+    float ns = 0;
+    for (uint8_t i = 0; i < estimatePlan.testCount; i++) {
+        uint8_t testNumber = estimatePlan.tests[i];
+        bool fusedTest = estimatePlan.fused && (testNumber == 1 || testNumber == 4 || testNumber == 5);
+        switch (testNumber) {
+            case 2:
+                hasAddressTest = true;
+                ns += (float)socketCount() * SRAMAddressCheck::accessCount(addressBits) * timing.singleNs;
+                break;
+            case 3: ns += 16.0f * socketCount() * timing.singleNs; break;
+            case 6: ns += 2 * sweepNs; break;
+            case 7: ns += 2.0f * estimatePlan.randomPasses * sweepNs; break;
+            case 8:
+                ns += marchNs(MARCH_ALGORITHMS[algorithm], estimatePlan.fullTest, burstCells, singleCells);
+                break;
+            default:
+                // Test 1 writes and reads each cell, tests 4/5 are two fill/verify
+                // pairs each; fused, test 1 carries one sweep for all three
+                if (!fusedTest) {
+                    ns += (testNumber == 1) ? marchNs(MARCH_BASIC_PATTERNS, estimatePlan.fullTest, burstCells, singleCells)
+                                            : 4 * sweepNs;
+                } else if (testNumber == 1) {
+                    ns += marchNs(MARCH_FUSED_PATTERNS, estimatePlan.fullTest, burstCells, singleCells);
+                }
+                break;
         }
     }
+    if (estimatePlan.prescreen && !hasAddressTest) {
+        ns += (float)socketCount() * SRAMAddressCheck::accessCount(addressBits) * timing.singleNs;
+    }
 
-    // Reset random seed for verification
-    randomSeed(12345);
+    return (uint32_t)(ns / 1000000.0f + 0.5f);
+}
 
-    // Verify phase
-    for (uint16_t addr = 0; addr <= maxAddress; addr++) {
-        if (!shouldTestAddress(addr, fullTest)) continue;
+//=============================================================================
+// PERF INSTRUMENTATION
+//=============================================================================
 
-        uint8_t expected = (uint8_t)(random(256));
-        uint8_t actual = readByte(addr);
+void SRAMStrategy::resetPerf() {
+    for (uint8_t i = 0; i < PERF_SLOTS; i++) {
+        testPerf[i] = SRAMTestPerf();
+    }
+    progressSent = 0;
+    progressCoalesced = 0;
+}
 
-        if (actual != expected) {
-            sendTestError(7, addr, expected, actual);
-            sendTestResult(7, false);
-            return false;
+void SRAMStrategy::setPerfAttach(bool attach) {
+    perfAttach = attach;
+}
+
+bool SRAMStrategy::getPerfAttach() const {
+    return perfAttach;
+}
+
+const SRAMTestPerf& SRAMStrategy::getTestPerf(uint8_t slot) const {
+    return testPerf[slot < PERF_SLOTS ? slot : PERF_FUSED_SLOT];
+}
+
+uint32_t SRAMStrategy::getProgressSent() const {
+    return progressSent;
+}
+
+uint32_t SRAMStrategy::getProgressCoalesced() const {
+    return progressCoalesced;
+}
+
+uint32_t SRAMStrategy::txCycles() const {
+    return (uart != nullptr) ? uart->getTxCycles() : 0;
+}
+
+uint8_t SRAMStrategy::perfSlot(uint8_t testNumber) const {
+    if (running && plan.fused && isFusedTest(testNumber)) {
+        return (testNumber == 1) ? PERF_FUSED_SLOT : PERF_NO_SLOT;
+    }
+    return (testNumber < PERF_SLOTS) ? testNumber : PERF_NO_SLOT;
+}
+
+void SRAMStrategy::perfStart() {
+    perfMark = CycleCounter::now();
+    perfTxMark = txCycles();
+}
+
+void SRAMStrategy::perfCollect() {
+    uint32_t now = CycleCounter::now();
+    uint32_t tx = txCycles();
+    perfCurrent.cycles += now - perfMark;
+    perfCurrent.uartCycles += tx - perfTxMark;
+    perfMark = now;
+    perfTxMark = tx;
+}
+
+void SRAMStrategy::commitTestPerf(uint8_t testNumber) {
+    uint8_t slot = perfSlot(testNumber);
+    if (slot == PERF_NO_SLOT) return;
+
+    uint16_t runs = testPerf[slot].runs;
+    testPerf[slot] = perfCurrent;
+    testPerf[slot].accesses = bus.getAccessCount() - perfAccessStart;
+    testPerf[slot].runs = (runs != 0xFFFF) ? runs + 1 : runs;
+}
+
+// Share of total in percent (0 when nothing was measured)
+static uint8_t perfPercent(uint32_t part, uint32_t total) {
+    if (total < 100) return 0;
+    uint32_t percent = part / (total / 100);
+    return (percent > 100) ? 100 : (uint8_t)percent;
+}
+
+void SRAMStrategy::sendTestPerf(uint8_t slot) {
+    if (uart == nullptr) return;
+
+    const SRAMTestPerf& perf = testPerf[slot];
+    uint8_t busPercent = perfPercent(perf.busCycles, perf.cycles);
+    uint8_t uartPercent = perfPercent(perf.uartCycles, perf.cycles);
+
+    if (uart->isBinary()) {
+        BinaryRecord record(BIN_REC_PERF);
+        record.put8(slot).put8(busPercent).put8(uartPercent)
+              .put8(perf.runs > 0xFF ? 0xFF : perf.runs).put32(perf.cycles);
+        uart->sendRecord(record);
+
+        BinaryRecord accesses(BIN_REC_PERF_ACCESSES);
+        accesses.put8(slot).put8(0).put8(0).put8(0).put32(perf.accesses);
+        uart->sendRecord(accesses);
+        return;
+    }
+
+    uint32_t us = CycleCounter::toMicros(perf.cycles);
+    uint32_t rate = (us > 0) ? (uint32_t)((float)perf.accesses * 1000000.0f / us) : 0;
+
+    // "Test 4" or "Fused 1/4/5"
+    char name[12];
+    if (slot == PERF_FUSED_SLOT) {
+        strcpy_P(name, MARCH_FUSED_PATTERNS.name);
+    } else {
+        snprintf_P(name, sizeof(name), PSTR("Test %d"), slot);
+    }
+    uart->sendInfof(F("PERF: %s - %lu.%lu ms, %lu accesses, %lu acc/s, bus %d%%, UART %d%%"),
+                    name, (unsigned long)(us / 1000), (unsigned long)((us / 100) % 10),
+                    (unsigned long)perf.accesses, (unsigned long)rate, busPercent, uartPercent);
+}
+
+void SRAMStrategy::sendPerfReport() {
+    if (uart == nullptr) return;
+
+    bool any = false;
+    for (uint8_t slot = 0; slot < PERF_SLOTS; slot++) {
+        if (testPerf[slot].runs > 0) {
+            any = true;
         }
+    }
 
-        if (fullTest && (addr & 0x0FFF) == 0 && addr > 0) {
-            sendProgress("Test 7 (verify)", addr, maxAddress);
+    if (!uart->isBinary()) {
+        uart->sendInfof(F("PERF: last run of each test (Timer5, %d cycles/us)"),
+                        CycleCounter::CYCLES_PER_US);
+        if (!any) {
+            uart->sendInfo(F("  No tests measured since PERF RESET"));
         }
     }
 
-    sendTestResult(7, true);
-    return true;
+    for (uint8_t slot = 0; slot < PERF_SLOTS; slot++) {
+        if (testPerf[slot].runs > 0) {
+            sendTestPerf(slot);
+        }
+    }
+
+    if (!uart->isBinary()) {
+        uint32_t txMs = CycleCounter::toMicros(txCycles()) / 1000;
+        uart->sendInfof(F("  UART send total: %lu ms since power-up%S"), (unsigned long)txMs,
+                        perfAttach ? PSTR(" (PERF ON)") : PSTR(""));
+        uart->sendInfof(F("  Progress: %lu sent, %lu coalesced (at most one per %u ms)"),
+                        (unsigned long)progressSent, (unsigned long)progressCoalesced,
+                        SRAM_PROGRESS_INTERVAL_MS);
+    }
 }
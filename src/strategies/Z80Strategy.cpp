@@ -0,0 +1,469 @@
+/**
+ * Z80Strategy.cpp
+ *
+ * Implementation of the Z80 CPU testing strategy
+ */
+
+#include "strategies/Z80Strategy.h"
+#include "hardware/CycleCounter.h"
+#include <Arduino.h>
+
+//=============================================================================
+// TEST PROGRAMS (ROM images at 0x0000, PROGMEM)
+//=============================================================================
+
+// Test 3: JP 0000h (3 reads per loop: opcode + 2 operand bytes)
+static const uint8_t PROGRAM_JP_LOOP[] PROGMEM = {
+    0xC3, 0x00, 0x00             // JP 0000h
+};
+
+// Test 4: two RAM writes, then HALT
+static const uint8_t PROGRAM_MEMORY_WRITE[] PROGMEM = {
+    0x3E, 0x55,                  // LD A, 55h
+    0x32, 0x00, 0x10,            // LD (1000h), A
+    0x3E, 0xAA,                  // LD A, AAh
+    0x32, 0x01, 0x10,            // LD (1001h), A
+    0x76                         // HALT
+};
+
+// Test 5: read both bytes back, report their XOR on the stop port
+static const uint8_t PROGRAM_MEMORY_READ[] PROGMEM = {
+    0x3A, 0x00, 0x10,            // LD A, (1000h)
+    0x47,                        // LD B, A
+    0x3A, 0x01, 0x10,            // LD A, (1001h)
+    0xA8,                        // XOR B
+    0x32, 0xFF, 0x1F,            // LD (1FFFh), A
+    0x76                         // HALT
+};
+
+// TEST FMAX: fill 64 RAM bytes, fold them into A, report A on the stop port
+static const uint8_t PROGRAM_BENCHMARK[] PROGMEM = {
+    0x21, 0x00, 0x10,            // LD HL, 1000h
+    0x06, 0x40,                  // LD B, 64
+    0xAF,                        // XOR A
+    0x77,                        // fill: LD (HL), A
+    0xC6, 0x07,                  //       ADD A, 7
+    0x23,                        //       INC HL
+    0x10, 0xFA,                  //       DJNZ fill
+    0x21, 0x00, 0x10,            // LD HL, 1000h
+    0x06, 0x40,                  // LD B, 64
+    0xAF,                        // XOR A
+    0xAE,                        // sum:  XOR (HL)
+    0x07,                        //       RLCA
+    0x23,                        //       INC HL
+    0x10, 0xFB,                  //       DJNZ sum
+    0x32, 0xFF, 0x1F,            // LD (1FFFh), A
+    0x76                         // HALT
+};
+constexpr uint8_t BENCHMARK_RESULT = 0x0C;
+
+constexpr uint32_t JP_LOOP_READS = 300;  // 100 loops
+
+// TEST FMAX candidates (reachable Timer3 frequencies at prescaler 1)
+static const uint32_t FMAX_STEPS[] PROGMEM = {
+    100000, 200000, 250000, 400000, 500000, 666666, 800000,
+    1000000, 1142857, 1333333, 1600000, 2000000, 2666666, 4000000
+};
+
+Z80Strategy::Z80Strategy()
+    : clock(nullptr), uart(nullptr), clockHz(Z80_TEST_CLOCK_HZ), image(nullptr), imageBase(0), imageSize(0), map(nullptr) {
+}
+
+void Z80Strategy::setClock(Timer3Clock* timer) {
+    clock = timer;
+}
+
+void Z80Strategy::setUARTHandler(UARTHandler* handler) {
+    uart = handler;
+}
+
+void Z80Strategy::setTrace(BusTrace* trace) {
+    bus.setTrace(trace);
+}
+
+void Z80Strategy::setImage(const uint8_t* data, uint16_t base, uint16_t size) {
+    image = data;
+    imageBase = base;
+    imageSize = (data != nullptr) ? size : 0;
+}
+
+void Z80Strategy::setMemoryMap(MemoryMap* memory) {
+    map = memory;
+}
+
+const __FlashStringHelper* Z80Strategy::getName() const {
+    return F("Z80");
+}
+
+void Z80Strategy::configurePins() {
+    // Z80 drives address, data and status; we drive /RESET, /WAIT, /INT,
+    // /NMI, /BUSREQ. Held in reset until a test runs.
+    bus.configurePins();
+}
+
+void Z80Strategy::reset() {
+    // /RESET LOW for at least 3 clock cycles, then released
+    bus.holdReset();
+    uint32_t hz = (clock != nullptr && clock->running()) ? clock->getFrequency() : Z80_TEST_CLOCK_HZ;
+    delayMicroseconds((uint16_t)(4000000UL / hz) + 1);
+    bus.releaseReset();
+}
+
+bool Z80Strategy::runTests() {
+    if (uart != nullptr) {
+        uart->sendInfo(F("Starting Z80 CPU tests..."));
+    }
+
+    uint8_t failed = 0;
+    for (uint8_t test = 1; test <= Z80_TEST_COUNT; test++) {
+        if (!runTest(test)) failed++;
+    }
+
+    if (uart != nullptr) {
+        if (failed == 0) {
+            uart->sendOK(F("All tests PASSED"));
+        } else {
+            uart->sendErrorf(F("%d of %d tests FAILED"), failed, Z80_TEST_COUNT);
+        }
+    }
+    return failed == 0;
+}
+
+bool Z80Strategy::runTest(uint8_t testNumber) {
+    if (testNumber < 1 || testNumber > Z80_IMAGE_TEST) {
+        if (uart != nullptr) {
+            uart->sendErrorf(F("Invalid test number (1-%d)"), Z80_IMAGE_TEST);
+        }
+        return false;
+    }
+    if (testNumber == Z80_IMAGE_TEST && (imageSize == 0 || map == nullptr)) {
+        if (uart != nullptr) {
+            uart->sendError(F("No image loaded (LOAD <addr> <len>)"));
+        }
+        return false;
+    }
+    if (clock == nullptr) {
+        if (uart != nullptr) {
+            uart->sendError(F("No clock generator configured"));
+        }
+        return false;
+    }
+
+    // CLOCK set by the user wins over the default test clock
+    clockHz = clock->running() ? clock->getFrequency() : Z80_TEST_CLOCK_HZ;
+    // Image reads take the slower lookup path: always with /WAIT
+    bus.selectWait((testNumber == Z80_IMAGE_TEST) ? Z80_WAIT_ALWAYS : Z80_WAIT_AUTO, clockHz);
+
+    if (uart != nullptr) {
+        uart->sendInfof(F("Test %d (%S) - %lu Hz, %S"), testNumber, getTestName(testNumber),
+                        (unsigned long)clockHz, bus.getUseWait() ? PSTR("/WAIT") : PSTR("no wait states"));
+    }
+
+    bool passed;
+    switch (testNumber) {
+        case 1: passed = testControlSignals(); break;
+        case 2: passed = testClock(); break;
+        case 3: passed = testJpLoop(); break;
+        case 4: passed = testMemoryWrite(); break;
+        case 5: passed = testMemoryRead(); break;
+        default: passed = testImage(); break;
+    }
+
+    // Keep the failing run's bus cycles for TRACE DUMP (tests that run a program)
+    BusTrace* trace = bus.getTrace();
+    bool held = false;
+    if (!passed && testNumber >= 3 && trace != nullptr) {
+        trace->hold(testNumber);
+        held = trace->getHeldTest() == testNumber;
+    }
+
+    if (uart != nullptr) {
+        if (passed) {
+            uart->sendOKf(F("Test %d (%S) - PASSED"), testNumber, getTestName(testNumber));
+        } else {
+            uart->sendErrorf(F("Test %d (%S) - FAILED"), testNumber, getTestName(testNumber));
+            if (held) {
+                uart->sendInfof(F("  Bus trace held: %lu cycles (TRACE DUMP)"),
+                                (unsigned long)trace->getHeldCycles());
+            }
+        }
+    }
+    return passed;
+}
+
+//=============================================================================
+// TESTS
+//=============================================================================
+
+// Test 1: every Z80 output inactive (HIGH) while /RESET is held
+bool Z80Strategy::testControlSignals() {
+    // Reset only takes effect on clock edges
+    startClock(clockHz);
+    bus.holdReset();
+    delayMicroseconds((uint16_t)(4000000UL / clockHz) + 1);
+
+    using namespace Z80Pins;
+    bool levels[7] = {
+        Mreq::isHigh(), Iorq::isHigh(), Rd::isHigh(), Wr::isHigh(),
+        M1::isHigh(), Rfsh::isHigh(), Halt::isHigh()
+    };
+
+    bool passed = true;
+    for (uint8_t i = 0; i < 7; i++) {
+        if (!levels[i]) passed = false;
+    }
+
+    if (uart != nullptr) {
+        PGM_P high = PSTR("HIGH");
+        PGM_P low = PSTR("LOW");
+        uart->sendInfof(F("  /MREQ=%S /IORQ=%S /RD=%S /WR=%S /M1=%S /RFSH=%S /HALT=%S"),
+                        levels[0] ? high : low, levels[1] ? high : low, levels[2] ? high : low,
+                        levels[3] ? high : low, levels[4] ? high : low, levels[5] ? high : low,
+                        levels[6] ? high : low);
+    }
+    return passed;
+}
+
+// Test 2: Timer3 output toggles on PE3
+bool Z80Strategy::testClock() {
+    startClock(clockHz);
+
+    // PINE reads back the OC3A output level
+    uint16_t edges = 0;
+    bool last = Z80Pins::Clock::isHigh();
+    for (uint16_t i = 0; i < 2000; i++) {
+        bool level = Z80Pins::Clock::isHigh();
+        if (level != last) edges++;
+        last = level;
+    }
+
+    if (uart != nullptr) {
+        uart->sendInfof(F("  Clock on PE3: %u edges in 2000 samples"), edges);
+    }
+    return edges > 0;
+}
+
+// Test 3: JP loop fetches 0000, 0001, 0002 over and over
+bool Z80Strategy::testJpLoop() {
+    Z80RunResult result = runProgram(PROGRAM_JP_LOOP, sizeof(PROGRAM_JP_LOOP), JP_LOOP_READS);
+
+    bool sequence = true;
+    for (uint8_t i = 0; i < Z80_TRACE_SIZE; i++) {
+        if (result.trace[i] != i % 3) sequence = false;
+    }
+    bool passed = result.end == Z80_END_LIMIT && sequence &&
+                  result.fetches * 3 == result.reads;
+
+    if (uart != nullptr) {
+        sendRunEnd(result);
+        if (!sequence) {
+            uart->sendInfof(F("  Reads: %04X %04X %04X %04X %04X %04X (expected 0000 0001 0002 ...)"),
+                            result.trace[0], result.trace[1], result.trace[2],
+                            result.trace[3], result.trace[4], result.trace[5]);
+        } else {
+            uart->sendInfof(F("  Address sequence 0000-0001-0002 (%lu loops, %lu /M1 fetches)"),
+                            (unsigned long)(result.reads / 3), (unsigned long)result.fetches);
+        }
+    }
+    return passed;
+}
+
+// Test 4: program stores 55h/AAh in RAM and halts
+bool Z80Strategy::testMemoryWrite() {
+    bus.clearRam();
+    Z80RunResult result = runProgram(PROGRAM_MEMORY_WRITE, sizeof(PROGRAM_MEMORY_WRITE));
+
+    uint8_t first = bus.peekRam(Z80_RAM_BASE);
+    uint8_t second = bus.peekRam(Z80_RAM_BASE + 1);
+    bool passed = result.end == Z80_END_HALT && result.writes == 2 &&
+                  first == 0x55 && second == 0xAA;
+
+    if (uart != nullptr) {
+        sendRunEnd(result);
+        uart->sendInfof(F("  RAM[1000h]=%02X RAM[1001h]=%02X (expected 55 AA), %lu writes"),
+                        first, second, (unsigned long)result.writes);
+    }
+    return passed;
+}
+
+// Test 5: program reads 55h/AAh from RAM and reports their XOR (FFh)
+bool Z80Strategy::testMemoryRead() {
+    bus.clearRam();
+    bus.pokeRam(Z80_RAM_BASE, 0x55);
+    bus.pokeRam(Z80_RAM_BASE + 1, 0xAA);
+    Z80RunResult result = runProgram(PROGRAM_MEMORY_READ, sizeof(PROGRAM_MEMORY_READ));
+
+    bool passed = result.end == Z80_END_STOP && result.exitCode == 0xFF;
+
+    if (uart != nullptr) {
+        sendRunEnd(result);
+        uart->sendInfof(F("  55h XOR AAh = %02X (expected FF)"), result.exitCode);
+    }
+    return passed;
+}
+
+// Test 6 (TEST IMAGE): uploaded program, passes on 00h to the stop port or HALT
+bool Z80Strategy::testImage() {
+    startClock(clockHz);
+    bus.clearRam();
+
+    // The image replaces the last program's ROM pages; MAP pages stay
+    map->unmapRom();
+    if (!map->mapRom(imageBase, image, imageSize)) {
+        if (uart != nullptr) {
+            uart->sendError(F("Image doesn't fit the memory map (base must be on a 256-byte page)"));
+        }
+        return false;
+    }
+    map->resetFaults();
+    bus.setMemoryMap(map);
+    Z80RunResult result = runProgram(nullptr, 0);
+    bus.setMemoryMap(nullptr);
+
+    bool passed = ((result.end == Z80_END_STOP && result.exitCode == 0x00) || result.end == Z80_END_HALT) &&
+                  map->getFaults() == 0;
+
+    if (uart != nullptr) {
+        sendRunEnd(result);
+        uint8_t ram[8];
+        for (uint8_t i = 0; i < sizeof(ram); i++) {
+            ram[i] = bus.peekRam(Z80_RAM_BASE + i);
+        }
+        uart->sendInfof(F("  Exit %02X%S, RAM[1000h-1007h]: %02X %02X %02X %02X %02X %02X %02X %02X"),
+                        result.exitCode, (result.end == Z80_END_STOP) ? PSTR("") : PSTR(" (no stop write)"),
+                        ram[0], ram[1], ram[2], ram[3], ram[4], ram[5], ram[6], ram[7]);
+        if (map->getFaults() != 0) {
+            uart->sendInfof(F("  Map faults: %u, first at %04Xh"), map->getFaults(), map->getFirstFault());
+        }
+    }
+    return passed;
+}
+
+//=============================================================================
+// FMAX
+//=============================================================================
+
+bool Z80Strategy::measureFmax() {
+    if (clock == nullptr) return false;
+
+    // Sweep runs aren't traced: /WAIT on every cycle would hide the misses
+    BusTrace* trace = bus.getTrace();
+    bus.setTrace(nullptr);
+
+    if (uart != nullptr) {
+        uart->sendInfof(F("FMAX: estimate %lu Hz without /WAIT, %lu Hz with /WAIT"),
+                        (unsigned long)z80NoWaitLimitHz(), (unsigned long)z80WaitLimitHz());
+    }
+
+    // Reference: slow clock, /WAIT on every cycle
+    startClock(Z80_FMAX_REFERENCE_HZ);
+    bus.selectWait(Z80_WAIT_ALWAYS, Z80_FMAX_REFERENCE_HZ);
+    bus.clearRam();
+    Z80RunResult reference = runProgram(PROGRAM_BENCHMARK, sizeof(PROGRAM_BENCHMARK));
+
+    bool referenceOk = reference.end == Z80_END_STOP && reference.exitCode == BENCHMARK_RESULT;
+    if (!referenceOk) {
+        if (uart != nullptr) {
+            uart->sendErrorf(F("FMAX reference run failed at %lu Hz"), (unsigned long)Z80_FMAX_REFERENCE_HZ);
+            sendRunEnd(reference);
+        }
+        startClock(clockHz);
+        bus.setTrace(trace);
+        return false;
+    }
+    if (uart != nullptr) {
+        uart->sendInfof(F("  Reference: %lu reads (%lu fetches), %lu writes"),
+                        (unsigned long)reference.reads, (unsigned long)reference.fetches,
+                        (unsigned long)reference.writes);
+    }
+
+    uint32_t fmax[2] = {0, 0};  // Without /WAIT, with /WAIT
+    for (uint8_t mode = 0; mode < 2; mode++) {
+        for (uint8_t i = 0; i < sizeof(FMAX_STEPS) / sizeof(FMAX_STEPS[0]); i++) {
+            uint32_t hz = pgm_read_dword(&FMAX_STEPS[i]);
+            startClock(hz);
+            bus.selectWait(mode == 0 ? Z80_WAIT_NEVER : Z80_WAIT_ALWAYS, hz);
+            bus.clearRam();
+            Z80RunResult result = runProgram(PROGRAM_BENCHMARK, sizeof(PROGRAM_BENCHMARK));
+
+            if (!sameRun(result, reference)) {
+                if (uart != nullptr) {
+                    uart->sendInfof(F("  %S: %lu Hz missed cycles (%lu/%lu reads, %lu/%lu writes)"),
+                                    mode == 0 ? PSTR("No wait") : PSTR("/WAIT"), (unsigned long)hz,
+                                    (unsigned long)result.reads, (unsigned long)reference.reads,
+                                    (unsigned long)result.writes, (unsigned long)reference.writes);
+                }
+                break;
+            }
+            fmax[mode] = hz;
+        }
+    }
+
+    // Measured limit replaces the estimate for Z80_WAIT_AUTO
+    bus.setNoWaitLimit(fmax[0]);
+    startClock(clockHz);
+    bus.setTrace(trace);
+
+    if (uart != nullptr) {
+        uart->sendOKf(F("FMAX: %lu Hz without /WAIT, %lu Hz with /WAIT"),
+                      (unsigned long)fmax[0], (unsigned long)fmax[1]);
+    }
+    return true;
+}
+
+//=============================================================================
+// HELPERS
+//=============================================================================
+
+void Z80Strategy::startClock(uint32_t frequency) {
+    if (clock->running()) {
+        // Glitch-free: the FMAX sweep steps without restarting the timer
+        if (clock->getFrequency() != frequency) clock->retune(frequency);
+        return;
+    }
+    clock->configure(frequency);
+    clock->start();
+}
+
+Z80RunResult Z80Strategy::runProgram(const uint8_t* program, uint16_t size, uint32_t readLimit) {
+    bus.loadRom(program, size);
+
+    // /RESET LOW for 4 clocks, then run() releases it
+    bus.holdReset();
+    uint32_t hz = clock->getFrequency();
+    delayMicroseconds((uint16_t)(4000000UL / hz) + 1);
+
+    return bus.run(Z80_RUN_TIMEOUT_MS, readLimit);
+}
+
+bool Z80Strategy::sameRun(const Z80RunResult& a, const Z80RunResult& b) {
+    return a.end == b.end && a.exitCode == b.exitCode && a.reads == b.reads &&
+           a.fetches == b.fetches && a.writes == b.writes;
+}
+
+PGM_P Z80Strategy::getTestName(uint8_t testNumber) {
+    switch (testNumber) {
+        case 1: return PSTR("Control Signals");
+        case 2: return PSTR("Clock Generation");
+        case 3: return PSTR("JP Loop");
+        case 4: return PSTR("Memory Write");
+        case 5: return PSTR("Memory Read");
+        case 6: return PSTR("Loaded Image");
+        default: return PSTR("Unknown");
+    }
+}
+
+void Z80Strategy::sendRunEnd(const Z80RunResult& result) {
+    if (uart == nullptr) return;
+
+    PGM_P end;
+    switch (result.end) {
+        case Z80_END_STOP: end = PSTR("stop port"); break;
+        case Z80_END_HALT: end = PSTR("HALT"); break;
+        case Z80_END_LIMIT: end = PSTR("read limit"); break;
+        default: end = PSTR("TIMEOUT"); break;
+    }
+    uart->sendInfof(F("  Ended by %S after %lu us: %lu reads, %lu writes, %lu refresh"), end,
+                    (unsigned long)CycleCounter::toMicros(result.cycles), (unsigned long)result.reads,
+                    (unsigned long)result.writes, (unsigned long)result.refreshes);
+}
@@ -6,60 +6,122 @@
 
 #include "utils/CommandParser.h"
 
-ParsedCommand CommandParser::parse(const String& line) {
-    ParsedCommand result;
-    result.type = INVALID;
-    result.parameter = "";
+// Command words, in CommandType order
+static const char KEY_MODE[] PROGMEM = "MODE";
+static const char KEY_TEST[] PROGMEM = "TEST";
+static const char KEY_STATUS[] PROGMEM = "STATUS";
+static const char KEY_RESET[] PROGMEM = "RESET";
+static const char KEY_HELP[] PROGMEM = "HELP";
+static const char KEY_CLOCK[] PROGMEM = "CLOCK";
+static const char KEY_CLOCKSTOP[] PROGMEM = "CLOCKSTOP";
+static const char KEY_PROTO[] PROGMEM = "PROTO";
+static const char KEY_ABORT[] PROGMEM = "ABORT";
+static const char KEY_PAUSE[] PROGMEM = "PAUSE";
+static const char KEY_RESUME[] PROGMEM = "RESUME";
+static const char KEY_PERF[] PROGMEM = "PERF";
+static const char KEY_TRACE[] PROGMEM = "TRACE";
+static const char KEY_PLAN[] PROGMEM = "PLAN";
+static const char KEY_RUN[] PROGMEM = "RUN";
+static const char KEY_DUMP[] PROGMEM = "DUMP";
+static const char KEY_CRC[] PROGMEM = "CRC";
+static const char KEY_LOAD[] PROGMEM = "LOAD";
+static const char KEY_MAP[] PROGMEM = "MAP";
+static const char KEY_INVALID[] PROGMEM = "INVALID";
 
-    // Handle empty lines
-    if (line.length() == 0) {
-        return result;
-    }
+static const char* const COMMAND_KEYWORDS[] PROGMEM = {
+    KEY_MODE, KEY_TEST, KEY_STATUS, KEY_RESET, KEY_HELP, KEY_CLOCK, KEY_CLOCKSTOP,
+    KEY_PROTO, KEY_ABORT, KEY_PAUSE, KEY_RESUME, KEY_PERF, KEY_TRACE, KEY_PLAN,
+    KEY_RUN, KEY_DUMP, KEY_CRC, KEY_LOAD, KEY_MAP
+};
 
-    // Find first space to separate command from parameter
-    int spaceIndex = line.indexOf(' ');
-
-    String command;
-    if (spaceIndex == -1) {
-        // No space - entire line is the command
-        command = line;
-    } else {
-        // Split into command and parameter
-        command = line.substring(0, spaceIndex);
-        result.parameter = line.substring(spaceIndex + 1);
-        result.parameter.trim();  // Remove leading/trailing whitespace
-    }
+static_assert(sizeof(COMMAND_KEYWORDS) / sizeof(COMMAND_KEYWORDS[0]) == INVALID,
+              "One keyword per CommandType");
+
+ParsedCommand CommandParser::parse(char* line) {
+    ParsedCommand result;
 
-    // Parse command type
-    result.type = parseCommandType(command);
+    // Command word, then the rest trimmed as the parameter
+    char* cursor = line;
+    char* word = nextToken(cursor);
+    char* end = cursor + strlen(cursor);
+    while (end > cursor && end[-1] == ' ') end--;
+    *end = '\0';
+    result.parameter = cursor;
+
+    // Empty line: INVALID
+    result.type = (word[0] != '\0') ? parseCommandType(word) : INVALID;
 
     return result;
 }
 
-CommandType CommandParser::parseCommandType(const String& cmd) {
+CommandType CommandParser::parseCommandType(const char* cmd) {
     // Case-sensitive command matching
-    if (cmd == "MODE") {
-        return MODE;
-    }
-    else if (cmd == "TEST") {
-        return TEST;
-    }
-    else if (cmd == "STATUS") {
-        return STATUS;
+    int8_t index = findKeyword(cmd, COMMAND_KEYWORDS, INVALID);
+    return (index >= 0) ? (CommandType)index : INVALID;
+}
+
+PGM_P CommandParser::getCommandName(CommandType type) {
+    if (type >= INVALID) {
+        return KEY_INVALID;
     }
-    else if (cmd == "RESET") {
-        return RESET;
+    return (PGM_P)pgm_read_ptr(&COMMAND_KEYWORDS[type]);
+}
+
+char* CommandParser::nextToken(char*& cursor) {
+    while (*cursor == ' ') cursor++;
+    char* word = cursor;
+    while (*cursor != '\0' && *cursor != ' ') cursor++;
+
+    // Terminate the word and step over the spaces after it
+    if (*cursor == ' ') {
+        *cursor++ = '\0';
+        while (*cursor == ' ') cursor++;
     }
-    else if (cmd == "HELP") {
-        return HELP;
+    return word;
+}
+
+int8_t CommandParser::findKeyword(const char* word, const char* const* table, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        if (strcmp_P(word, (PGM_P)pgm_read_ptr(&table[i])) == 0) {
+            return i;
+        }
     }
-    else if (cmd == "CLOCK") {
-        return CLOCK;
+    return -1;
+}
+
+bool CommandParser::parseNumber(const char* word, uint32_t& value, uint8_t base) {
+    // strtoul() alone skips spaces, takes a sign and stops at the first bad character
+    if (*word < '0' || *word > '9') {
+        return false;
     }
-    else if (cmd == "CLOCKSTOP") {
-        return CLOCKSTOP;
+    char* end;
+    unsigned long parsed = strtoul(word, &end, base);
+    if (*end != '\0') {
+        return false;
     }
-    else {
-        return INVALID;
+    value = parsed;
+    return true;
+}
+
+char* CommandParser::nextCommand(char*& cursor) {
+    while (cursor != nullptr) {
+        char* command = cursor;
+        char* separator = strchr(cursor, ';');
+        if (separator != nullptr) {
+            *separator = '\0';
+            cursor = separator + 1;
+        } else {
+            cursor = nullptr;
+        }
+
+        // Trim; skip empty commands ("A;;B", a trailing ';')
+        while (*command == ' ') command++;
+        char* end = command + strlen(command);
+        while (end > command && end[-1] == ' ') end--;
+        *end = '\0';
+        if (command[0] != '\0') {
+            return command;
+        }
     }
+    return nullptr;
 }
@@ -0,0 +1,65 @@
+/**
+ * HealthMonitor.cpp
+ *
+ * Implementation of the loop and command latency figures
+ */
+
+#include "utils/HealthMonitor.h"
+#include "hardware/CycleCounter.h"
+
+HealthMonitor::HealthMonitor() {
+    reset();
+}
+
+void HealthMonitor::reset() {
+    loops = 0;
+    loopMaxCycles = 0;
+    loopMeanCycles = 0;
+    windowCycles = 0;
+    windowLoops = 0;
+    memset(commands, 0, sizeof(commands));
+}
+
+void HealthMonitor::recordLoop(uint32_t cycles) {
+    if (loops != 0xFFFFFFFF) loops++;
+    if (cycles > loopMaxCycles) loopMaxCycles = cycles;
+
+    // Saturate: a window of multi-second passes only needs to read as slow
+    windowCycles = (windowCycles > 0xFFFFFFFF - cycles) ? 0xFFFFFFFF : windowCycles + cycles;
+    if (++windowLoops == HEALTH_LOOP_WINDOW) {
+        loopMeanCycles = windowCycles / HEALTH_LOOP_WINDOW;
+        windowCycles = 0;
+        windowLoops = 0;
+    }
+}
+
+void HealthMonitor::recordCommand(CommandType type, uint32_t cycles) {
+    HealthCommandStats& stats = commands[type > INVALID ? INVALID : type];
+    uint32_t us = CycleCounter::toMicros(cycles);
+    if (stats.count == 0xFFFF) return;
+
+    // mean += (us - mean) / count, kept unsigned
+    stats.count++;
+    if (us >= stats.meanUs) {
+        stats.meanUs += (us - stats.meanUs) / stats.count;
+    } else {
+        stats.meanUs -= (stats.meanUs - us) / stats.count;
+    }
+    if (us > stats.maxUs) stats.maxUs = us;
+}
+
+uint32_t HealthMonitor::getLoopMaxUs() const {
+    return CycleCounter::toMicros(loopMaxCycles);
+}
+
+uint32_t HealthMonitor::getLoopMeanUs() const {
+    return CycleCounter::toMicros(loopMeanCycles);
+}
+
+const HealthCommandStats& HealthMonitor::getCommand(CommandType type) const {
+    return commands[type > INVALID ? INVALID : type];
+}
+
+uint32_t HealthMonitor::getCommandMeanUs(CommandType type) const {
+    return getCommand(type).meanUs;
+}
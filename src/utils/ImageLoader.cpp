@@ -0,0 +1,119 @@
+/**
+ * ImageLoader.cpp
+ *
+ * Implementation of the LOAD block transfer
+ */
+
+#include "utils/ImageLoader.h"
+
+ImageLoader::ImageLoader(ProgramImage& image, UARTHandler& uart)
+    : image(image), uart(uart), active(false), resendSent(false), retries(0), base(0), length(0),
+      received(0), lastActivityMs(0) {
+}
+
+bool ImageLoader::start(uint16_t blockBase, uint16_t blockLength) {
+    if (active || !image.begin(blockBase, blockLength)) {
+        return false;
+    }
+
+    // Records left over from an earlier transfer
+    BinaryRecord stale(0);
+    while (uart.readRecord(stale)) {
+    }
+
+    base = blockBase;
+    length = blockLength;
+    received = 0;
+    retries = 0;
+    resendSent = false;
+    lastActivityMs = millis();
+    active = true;
+    sendAck(BIN_LOAD_CONTINUE);
+    return true;
+}
+
+void ImageLoader::abort() {
+    if (active) fail(F("ABORTED"));
+}
+
+bool ImageLoader::isActive() const {
+    return active;
+}
+
+void ImageLoader::sendStatus() {
+    uart.sendInfof(F("STATUS: LOAD 0x%04X, %u of %u bytes"), base, received, length);
+}
+
+bool ImageLoader::step(uint16_t) {
+    if (!active) return false;
+
+    // At most a window of records is queued: no time budget needed
+    BinaryRecord record(0);
+    while (uart.readRecord(record)) {
+        if (record.type != BIN_REC_LOAD_DATA) continue;
+        lastActivityMs = millis();
+
+        uint16_t offset = record.get16(0);
+        if (offset == received) {
+            uint16_t remaining = length - received;
+            uint8_t count = (remaining < BIN_LOAD_CHUNK) ? (uint8_t)remaining : BIN_LOAD_CHUNK;
+            image.write(offset, &record.payload[2], count);
+            received += count;
+            retries = 0;
+            resendSent = false;
+            if (received == length) {
+                finish();
+                return false;
+            }
+            sendAck(BIN_LOAD_CONTINUE);
+        } else if (offset > received && !resendSent) {
+            // Gap: everything after it is dropped until the host goes back
+            sendAck(BIN_LOAD_RESEND);
+            resendSent = true;
+        }
+        // Below received: a resent record that is already stored
+    }
+
+    if (millis() - lastActivityMs >= LOAD_RETRY_MS) {
+        if (++retries > LOAD_MAX_RETRIES) {
+            fail(F("timed out"));
+            return false;
+        }
+        sendAck(BIN_LOAD_RESEND);
+        lastActivityMs = millis();
+    }
+    return true;
+}
+
+void ImageLoader::sendAck(uint8_t status) {
+    BinaryRecord ack(BIN_REC_LOAD_ACK);
+    ack.put16(received).put8(status).put8(LOAD_WINDOW);
+
+    // A skipped CONTINUE is covered by the next one (acks are cumulative)
+    if (status == BIN_LOAD_CONTINUE) {
+        uart.trySendRecord(ack);
+    } else {
+        uart.sendRecord(ack);
+    }
+}
+
+void ImageLoader::finish() {
+    active = false;
+    image.commit();
+    sendAck(BIN_LOAD_DONE);
+
+    uint32_t crc = image.getCrc32();
+    BinaryRecord record(BIN_REC_CRC);
+    record.put16(base).put16(length).put32(crc);
+    uart.sendRecord(record);
+
+    uart.sendOKf(F("Loaded %u bytes at 0x%04X, CRC-32 0x%08lX (LOAD SAVE keeps it)"), length, base,
+                 (unsigned long)crc);
+}
+
+void ImageLoader::fail(const __FlashStringHelper* reason) {
+    active = false;
+    image.load();             // Back to the saved image, if there is one
+    sendAck(BIN_LOAD_FAILED);
+    uart.sendErrorf(F("LOAD %S at offset %u of %u"), (PGM_P)reason, received, length);
+}
@@ -29,17 +29,17 @@ void ModeManager::clearStrategy() {
     currentMode = NONE;
 }
 
-const char* ModeManager::getModeName(ICMode mode) {
+const __FlashStringHelper* ModeManager::getModeName(ICMode mode) {
     switch (mode) {
         case NONE:
-            return "NONE";
+            return F("NONE");
         case Z80:
-            return "Z80";
+            return F("Z80");
         case IC6502:
-            return "6502";
+            return F("6502");
         case SRAM62256:
-            return "HM62256";
+            return F("HM62256");
         default:
-            return "UNKNOWN";
+            return F("UNKNOWN");
     }
 }
@@ -0,0 +1,178 @@
+/**
+ * PlanRunner.cpp
+ *
+ * Implementation of stored-plan batch runs
+ */
+
+#include "utils/PlanRunner.h"
+#include "hardware/PinConfig.h"
+
+PlanRunner::PlanRunner(PlanStore& store, UARTHandler& uart, PlanDispatch dispatch, PlanBusy busy)
+    : store(store), uart(uart), dispatch(dispatch), busy(busy), running(false), aborted(false),
+      stepPending(false), stepIndex(0), pass(0), stepsRun(0), failedStep(0), failedPass(0),
+      abortedStep(0), errorsBefore(0), savedProtocol(UARTHandler::PROTOCOL_TEXT), startMs(0), dutCount(0),
+      passCount(0), failCount(0), switchLevel(false), switchPressed(false), switchChangedMs(0) {
+    line[0] = '\0';
+}
+
+void PlanRunner::begin() {
+    // Input with pull-up: open switch reads HIGH
+    PanelPins::Start::input();
+    PanelPins::Start::high();
+}
+
+bool PlanRunner::start() {
+    if (running || busy() || store.getStepCount() == 0) {
+        return false;
+    }
+
+    running = true;
+    aborted = false;
+    stepPending = false;
+    stepIndex = 0;
+    pass = 0;
+    stepsRun = 0;
+    failedStep = 0;
+    failedPass = 0;
+    dutCount++;
+    startMs = millis();
+
+    // Failures must arrive as ERROR lines to be counted
+    savedProtocol = uart.getProtocol();
+    uart.setProtocol(UARTHandler::PROTOCOL_TEXT);
+    uart.clearMutedErrors();
+    uart.setMuted(true);
+    return true;
+}
+
+void PlanRunner::abort() {
+    if (running && !aborted) {
+        aborted = true;
+        abortedStep = stepIndex + 1;
+    }
+}
+
+bool PlanRunner::isRunning() const {
+    return running;
+}
+
+uint8_t PlanRunner::getStep() const {
+    return stepIndex + 1;
+}
+
+uint8_t PlanRunner::getPass() const {
+    return pass + 1;
+}
+
+uint16_t PlanRunner::getDutCount() const {
+    return dutCount;
+}
+
+uint16_t PlanRunner::getPassCount() const {
+    return passCount;
+}
+
+uint16_t PlanRunner::getFailCount() const {
+    return failCount;
+}
+
+void PlanRunner::resetCounts() {
+    dutCount = running ? 1 : 0;
+    passCount = 0;
+    failCount = 0;
+}
+
+bool PlanRunner::step(uint16_t budgetUs) {
+    (void)budgetUs;
+
+    if (footswitchPressed() && !running) {
+        start();
+    }
+    if (!running) {
+        return false;
+    }
+
+    // Background test of the pending step still going
+    if (busy()) {
+        return true;
+    }
+    if (stepPending) {
+        completeStep();
+    }
+
+    bool stopped = aborted || (failedStep != 0 && store.getStopOnFail());
+    if (stopped || pass >= store.getRepeat()) {
+        finish();
+        return false;
+    }
+
+    dispatchNext();
+    return true;
+}
+
+bool PlanRunner::footswitchPressed() {
+    bool level = PanelPins::Start::isActive();
+    uint32_t now = millis();
+    if (level != switchLevel) {
+        switchLevel = level;
+        switchChangedMs = now;
+        return false;
+    }
+
+    // Level held long enough: take it, report the press edge once
+    if (level != switchPressed && now - switchChangedMs >= PLAN_FOOTSWITCH_DEBOUNCE_MS) {
+        switchPressed = level;
+        return level;
+    }
+    return false;
+}
+
+void PlanRunner::completeStep() {
+    stepPending = false;
+    stepsRun++;
+    if (failedStep == 0 && uart.getMutedErrors() != errorsBefore) {
+        failedStep = stepIndex + 1;
+        failedPass = pass + 1;
+    }
+
+    stepIndex++;
+    if (stepIndex >= store.getStepCount()) {
+        stepIndex = 0;
+        pass++;
+    }
+}
+
+void PlanRunner::dispatchNext() {
+    if (!store.getStep(stepIndex, line, sizeof(line))) {
+        // Plan changed under us (PLAN CLEAR is refused while running)
+        abort();
+        return;
+    }
+
+    errorsBefore = uart.getMutedErrors();
+    stepPending = true;
+    dispatch(line);
+}
+
+void PlanRunner::finish() {
+    running = false;
+    uart.setMuted(false);
+    uart.setProtocol(savedProtocol);
+
+    uint32_t elapsed = millis() - startMs;
+    if (failedStep != 0) {
+        failCount++;
+        if (store.getRepeat() > 1) {
+            uart.sendErrorf(F("DUT %u FAIL pass %u step %u: %s"), dutCount, failedPass, failedStep,
+                            uart.getFirstMutedError());
+        } else {
+            uart.sendErrorf(F("DUT %u FAIL step %u: %s"), dutCount, failedStep, uart.getFirstMutedError());
+        }
+    } else if (aborted) {
+        failCount++;
+        uart.sendErrorf(F("DUT %u ABORTED at step %u"), dutCount, abortedStep);
+    } else {
+        passCount++;
+        uart.sendOKf(F("DUT %u PASS (%u steps, %lu ms)"), dutCount, stepsRun, (unsigned long)elapsed);
+    }
+}
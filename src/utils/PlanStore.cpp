@@ -0,0 +1,110 @@
+/**
+ * PlanStore.cpp
+ *
+ * Implementation of the EEPROM test plan
+ */
+
+#include "utils/PlanStore.h"
+#include "utils/CRC.h"
+#include <avr/eeprom.h>
+
+PlanStore::PlanStore() {
+    setDefaults();
+}
+
+void PlanStore::setDefaults() {
+    header.magic = PLAN_MAGIC;
+    header.stepCount = 0;
+    header.repeat = PLAN_DEFAULT_REPEAT;
+    header.flags = FLAG_STOP_ON_FAIL;
+    header.reserved = 0;
+    header.crc = 0;
+}
+
+bool PlanStore::load() {
+    eeprom_read_block(&header, (const void*)PLAN_EEPROM_ADDRESS, sizeof(header));
+    if (header.magic == PLAN_MAGIC && header.stepCount <= PLAN_MAX_STEPS && header.repeat != 0 &&
+        header.crc == computeCrc()) {
+        return true;
+    }
+
+    setDefaults();
+    return false;
+}
+
+uint8_t PlanStore::getStepCount() const {
+    return header.stepCount;
+}
+
+bool PlanStore::getStep(uint8_t index, char* buffer, uint8_t size) const {
+    buffer[0] = '\0';
+    if (index >= header.stepCount || size == 0) {
+        return false;
+    }
+
+    uint8_t length = size < PLAN_STEP_SIZE ? size : PLAN_STEP_SIZE;
+    eeprom_read_block(buffer, stepAddress(index), length);
+    buffer[length - 1] = '\0';
+    return true;
+}
+
+bool PlanStore::addStep(const char* command) {
+    uint8_t length = strlen(command);
+    if (header.stepCount >= PLAN_MAX_STEPS || length == 0 || length >= PLAN_STEP_SIZE) {
+        return false;
+    }
+
+    // Whole slot, so the CRC never depends on old bytes past the NUL
+    char slot[PLAN_STEP_SIZE];
+    memset(slot, 0, sizeof(slot));
+    memcpy(slot, command, length);
+    eeprom_update_block(slot, stepAddress(header.stepCount), sizeof(slot));
+
+    header.stepCount++;
+    save();
+    return true;
+}
+
+void PlanStore::clear() {
+    header.stepCount = 0;
+    save();
+}
+
+uint8_t PlanStore::getRepeat() const {
+    return header.repeat;
+}
+
+void PlanStore::setRepeat(uint8_t repeat) {
+    header.repeat = repeat == 0 ? 1 : repeat;
+    save();
+}
+
+bool PlanStore::getStopOnFail() const {
+    return (header.flags & FLAG_STOP_ON_FAIL) != 0;
+}
+
+void PlanStore::setStopOnFail(bool stop) {
+    header.flags = stop ? (header.flags | FLAG_STOP_ON_FAIL) : (header.flags & ~FLAG_STOP_ON_FAIL);
+    save();
+}
+
+void PlanStore::save() {
+    header.magic = PLAN_MAGIC;
+    header.crc = computeCrc();
+    eeprom_update_block(&header, (void*)PLAN_EEPROM_ADDRESS, sizeof(header));
+}
+
+uint16_t PlanStore::computeCrc() const {
+    uint16_t crc = crc16((const uint8_t*)&header, offsetof(PlanHeader, crc));
+    for (uint8_t i = 0; i < header.stepCount; i++) {
+        const uint8_t* address = stepAddress(i);
+        for (uint8_t j = 0; j < PLAN_STEP_SIZE; j++) {
+            crc = crc16Update(crc, eeprom_read_byte(address + j));
+        }
+    }
+    return crc;
+}
+
+uint8_t* PlanStore::stepAddress(uint8_t index) {
+    return (uint8_t*)(PLAN_EEPROM_ADDRESS + sizeof(PlanHeader) + (uint16_t)index * PLAN_STEP_SIZE);
+}
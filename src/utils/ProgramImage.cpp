@@ -0,0 +1,94 @@
+/**
+ * ProgramImage.cpp
+ *
+ * Implementation of the uploaded CPU test program
+ */
+
+#include "utils/ProgramImage.h"
+#include "utils/CRC.h"
+#include <avr/eeprom.h>
+
+ProgramImage::ProgramImage() : loaded(false), saved(false) {
+    header.magic = IMAGE_MAGIC;
+    header.reserved = 0;
+    header.base = 0;
+    header.length = 0;
+    header.crc = 0;
+}
+
+bool ProgramImage::load() {
+    eeprom_read_block(&header, (const void*)IMAGE_EEPROM_ADDRESS, sizeof(header));
+    if (header.magic == IMAGE_MAGIC && isValidBlock(header.base, header.length)) {
+        memset(data, MEMORY_OPEN_BUS, sizeof(data));
+        eeprom_read_block(data, (const void*)(IMAGE_EEPROM_ADDRESS + sizeof(header)), header.length);
+        if (header.crc == computeCrc()) {
+            loaded = saved = true;
+            return true;
+        }
+    }
+
+    header.length = 0;
+    loaded = saved = false;
+    return false;
+}
+
+bool ProgramImage::save() {
+    if (!loaded) {
+        return false;
+    }
+
+    header.magic = IMAGE_MAGIC;
+    header.crc = computeCrc();
+    eeprom_update_block(data, (void*)(IMAGE_EEPROM_ADDRESS + sizeof(header)), header.length);
+    eeprom_update_block(&header, (void*)IMAGE_EEPROM_ADDRESS, sizeof(header));
+    saved = true;
+    return true;
+}
+
+void ProgramImage::clear() {
+    // A wrong magic is enough for load() to find nothing
+    eeprom_update_byte((uint8_t*)IMAGE_EEPROM_ADDRESS, 0xFF);
+    header.length = 0;
+    loaded = saved = false;
+}
+
+bool ProgramImage::begin(uint16_t base, uint16_t length) {
+    if (!isValidBlock(base, length)) {
+        return false;
+    }
+
+    header.base = base;
+    header.length = length;
+    memset(data, MEMORY_OPEN_BUS, sizeof(data));
+    loaded = saved = false;
+    return true;
+}
+
+void ProgramImage::write(uint16_t offset, const uint8_t* bytes, uint8_t count) {
+    for (uint8_t i = 0; i < count && offset + i < header.length; i++) {
+        data[offset + i] = bytes[i];
+    }
+}
+
+void ProgramImage::commit() {
+    loaded = header.length != 0;
+}
+
+bool ProgramImage::isValidBlock(uint16_t base, uint16_t length) {
+    // Whole pages from base: the memory map serves the image page by page
+    return length != 0 && length <= PROGRAM_IMAGE_SIZE && (base & (MEMORY_PAGE_SIZE - 1)) == 0 &&
+           (uint32_t)base + length <= 0x10000;
+}
+
+uint32_t ProgramImage::getCrc32() const {
+    uint32_t crc = CRC32_INIT;
+    for (uint16_t i = 0; i < header.length; i++) {
+        crc = crc32Update(crc, data[i]);
+    }
+    return crc32Final(crc);
+}
+
+uint16_t ProgramImage::computeCrc() const {
+    uint16_t crc = crc16((const uint8_t*)&header, offsetof(ImageHeader, crc));
+    return crc16(data, header.length, crc);
+}
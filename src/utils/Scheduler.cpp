@@ -0,0 +1,34 @@
+/**
+ * Scheduler.cpp
+ *
+ * Implementation of cooperative round-robin scheduler
+ */
+
+#include "utils/Scheduler.h"
+
+Scheduler::Scheduler()
+    : taskCount(0), busy(false) {
+    // No tasks registered
+}
+
+bool Scheduler::add(SchedulerTask* task) {
+    if (task == nullptr || taskCount >= MAX_TASKS) {
+        return false;
+    }
+    tasks[taskCount++] = task;
+    return true;
+}
+
+void Scheduler::run(uint16_t sliceUs) {
+    bool anyBusy = false;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        if (tasks[i]->step(sliceUs)) {
+            anyBusy = true;
+        }
+    }
+    busy = anyBusy;
+}
+
+bool Scheduler::isBusy() const {
+    return busy;
+}
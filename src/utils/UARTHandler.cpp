@@ -5,71 +5,434 @@
  */
 
 #include "utils/UARTHandler.h"
+#include "utils/CRC.h"
+#include "hardware/CycleCounter.h"
+
+// Arduino core RX ring (holds one byte less than its size)
+#ifndef SERIAL_RX_BUFFER_SIZE
+#define SERIAL_RX_BUFFER_SIZE 64
+#endif
+
+// Rates with an exact or <2.2% divider at 16 MHz
+static const uint32_t SUPPORTED_BAUD_RATES[] = {
+    9600, 19200, 38400, 57600, 115200, 250000, 500000, 1000000
+};
+
+// Adds the cycles spent in one send call to the handler's total
+class TxTimer {
+public:
+    explicit TxTimer(uint32_t& total) : total(total), start(CycleCounter::now()) {}
+    ~TxTimer() { total += CycleCounter::now() - start; }
+
+private:
+    uint32_t& total;
+    uint32_t start;
+};
+
+UARTHandler::UARTHandler()
+    : baudRate(0), protocol(PROTOCOL_TEXT), queueBytes(0), queueCount(0), rxLength(0), droppedLines(0),
+      rxFrameLength(0), recordCount(0), badFrames(0), rxOverruns(0), txCycles(0), errorLines(0),
+      muted(false), mutedErrors(0) {
+    firstMutedError[0] = '\0';
+    // Port opened in begin()
+}
 
 void UARTHandler::begin(uint32_t baud) {
+    baudRate = baud;
     Serial.begin(baud);
     // Wait for serial port to initialize
     delay(100);
 }
 
-bool UARTHandler::available() {
-    return Serial.available() > 0;
+bool UARTHandler::setBaud(uint32_t baud) {
+    if (!isSupportedBaud(baud)) {
+        return false;
+    }
+
+    // Let the confirmation go out at the old rate
+    Serial.flush();
+    Serial.end();
+    baudRate = baud;
+    Serial.begin(baud);
+    return true;
 }
 
-String UARTHandler::readLine() {
-    String line = "";
+uint32_t UARTHandler::getBaud() const {
+    return baudRate;
+}
 
-    // Wait for data if not available
-    while (!Serial.available()) {
-        delay(1);
+bool UARTHandler::isSupportedBaud(uint32_t baud) {
+    for (uint8_t i = 0; i < sizeof(SUPPORTED_BAUD_RATES) / sizeof(SUPPORTED_BAUD_RATES[0]); i++) {
+        if (SUPPORTED_BAUD_RATES[i] == baud) {
+            return true;
+        }
     }
+    return false;
+}
 
-    // Read until newline
-    while (true) {
-        if (Serial.available()) {
-            char c = Serial.read();
+void UARTHandler::setProtocol(Protocol newProtocol) {
+    protocol = newProtocol;
+}
 
-            // Handle line endings (\n or \r\n)
-            if (c == '\n') {
-                break;
-            }
-            else if (c == '\r') {
-                // Skip \r, wait for \n
-                continue;
-            }
-            else {
-                line += c;
+UARTHandler::Protocol UARTHandler::getProtocol() const {
+    return protocol;
+}
+
+bool UARTHandler::isBinary() const {
+    return protocol == PROTOCOL_BINARY;
+}
+
+void UARTHandler::setMuted(bool mute) {
+    muted = mute;
+}
+
+void UARTHandler::clearMutedErrors() {
+    mutedErrors = 0;
+    firstMutedError[0] = '\0';
+}
+
+bool UARTHandler::isMuted() const {
+    return muted;
+}
+
+uint8_t UARTHandler::getMutedErrors() const {
+    return mutedErrors;
+}
+
+const char* UARTHandler::getFirstMutedError() const {
+    return firstMutedError;
+}
+
+void UARTHandler::countMutedError(const char* message, bool inFlash) {
+    if (mutedErrors == 0) {
+        if (inFlash) {
+            strncpy_P(firstMutedError, message, sizeof(firstMutedError) - 1);
+        } else {
+            strncpy(firstMutedError, message, sizeof(firstMutedError) - 1);
+        }
+        firstMutedError[sizeof(firstMutedError) - 1] = '\0';
+    }
+    if (mutedErrors != 0xFF) mutedErrors++;
+}
+
+void UARTHandler::sendRecord(const BinaryRecord& record) {
+    if (muted) return;
+    TxTimer timer(txCycles);
+    uint8_t frame[BIN_FRAME_SIZE];
+    frame[0] = BIN_SYNC;
+    frame[1] = record.type;
+    memcpy(&frame[2], record.payload, BIN_PAYLOAD_SIZE);
+
+    uint16_t crc = crc16(&frame[1], 1 + BIN_PAYLOAD_SIZE);
+    frame[BIN_FRAME_SIZE - 2] = (uint8_t)crc;
+    frame[BIN_FRAME_SIZE - 1] = (uint8_t)(crc >> 8);
+
+    Serial.write(frame, BIN_FRAME_SIZE);
+}
+
+bool UARTHandler::trySendRecord(const BinaryRecord& record) {
+    if (muted) return true;
+    if (getTxFree() < BIN_FRAME_SIZE) return false;
+    sendRecord(record);
+    return true;
+}
+
+bool UARTHandler::trySendInfof(const __FlashStringHelper* format, ...) {
+    if (muted) return true;
+    TxTimer timer(txCycles);
+    va_list args;
+    va_start(args, format);
+    vsnprintf_P(lineBuffer, sizeof(lineBuffer), (PGM_P)format, args);
+    va_end(args);
+
+    // Line plus CR LF
+    if (getTxFree() < strlen(lineBuffer) + 2) return false;
+    Serial.println(lineBuffer);
+    return true;
+}
+
+uint16_t UARTHandler::getTxFree() {
+    return (uint16_t)Serial.availableForWrite();
+}
+
+void UARTHandler::poll() {
+    // Full ring: the USART interrupt had no room for anything received since
+    if (Serial.available() >= SERIAL_RX_BUFFER_SIZE - 1) {
+        if (rxOverruns != 0xFF) rxOverruns++;
+    }
+
+    while (Serial.available()) {
+        char c = Serial.read();
+
+        // Binary record from the host (never part of a text line)
+        if (rxFrameLength != 0 || (uint8_t)c == BIN_SYNC) {
+            receiveFrameByte((uint8_t)c);
+            continue;
+        }
+
+        // Handle line endings (\n or \r\n)
+        if (c == '\n') {
+            queueLine();
+        }
+        else if (c == '\r') {
+            continue;
+        }
+        else {
+            // Stored after the queued lines while it fits; counted either
+            // way so an overlong or unqueueable line is rejected at its end
+            uint16_t at = queueBytes + rxLength;
+            if (rxLength < RX_LINE_SIZE - 1 && at < RX_QUEUE_BYTES - 1) {
+                rxQueue[at] = c;
             }
+            if (rxLength != 0xFF) rxLength++;
         }
     }
+}
 
-    // Trim whitespace
-    line.trim();
+bool UARTHandler::available() {
+    poll();
+    return queueCount > 0;
+}
+
+bool UARTHandler::readLine(char* buffer, uint8_t size) {
+    poll();
+    if (queueCount == 0) {
+        buffer[0] = '\0';
+        return false;
+    }
 
-    return line;
+    size_t length = strlen(rxQueue);
+    if (length > (size_t)size - 1) length = size - 1;
+    memcpy(buffer, rxQueue, length);
+    buffer[length] = '\0';
+    removeQueued(0);
+    return true;
+}
+
+bool UARTHandler::takeCommand(const __FlashStringHelper* keyword) {
+    uint16_t offset = 0;
+    for (uint8_t i = 0; i < queueCount; i++) {
+        if (strcmp_P(&rxQueue[offset], (PGM_P)keyword) == 0) {
+            removeQueued(offset);
+            return true;
+        }
+        offset += strlen(&rxQueue[offset]) + 1;
+    }
+    return false;
+}
+
+uint8_t UARTHandler::getDroppedLines() const {
+    return droppedLines;
+}
+
+bool UARTHandler::readRecord(BinaryRecord& record) {
+    poll();
+    if (recordCount == 0) {
+        return false;
+    }
+
+    record.type = rxRecords[0][0];
+    memcpy(record.payload, &rxRecords[0][1], BIN_PAYLOAD_SIZE);
+    record.length = BIN_PAYLOAD_SIZE;
+    recordCount--;
+    memmove(rxRecords[0], rxRecords[1], recordCount * sizeof(rxRecords[0]));
+    return true;
+}
+
+uint8_t UARTHandler::getBadFrames() const {
+    return badFrames;
+}
+
+uint8_t UARTHandler::getRxOverruns() const {
+    return rxOverruns;
+}
+
+void UARTHandler::receiveFrameByte(uint8_t c) {
+    rxFrame[rxFrameLength++] = c;
+    if (rxFrameLength < BIN_FRAME_SIZE) {
+        return;
+    }
+
+    uint16_t crc = rxFrame[BIN_FRAME_SIZE - 2] | ((uint16_t)rxFrame[BIN_FRAME_SIZE - 1] << 8);
+    if (crc == crc16(&rxFrame[1], 1 + BIN_PAYLOAD_SIZE)) {
+        rxFrameLength = 0;
+        if (recordCount == RX_RECORD_QUEUE_SIZE) {
+            if (badFrames != 0xFF) badFrames++;
+            return;
+        }
+        memcpy(rxRecords[recordCount++], &rxFrame[1], 1 + BIN_PAYLOAD_SIZE);
+        return;
+    }
+
+    // Bad CRC: drop it, and resync on a later sync byte inside it
+    if (badFrames != 0xFF) badFrames++;
+    uint8_t next = 1;
+    while (next < BIN_FRAME_SIZE && rxFrame[next] != BIN_SYNC) next++;
+    rxFrameLength = BIN_FRAME_SIZE - next;
+    memmove(rxFrame, &rxFrame[next], rxFrameLength);
+}
+
+uint16_t UARTHandler::getErrorLines() const {
+    return errorLines;
+}
+
+uint32_t UARTHandler::getTxCycles() const {
+    return txCycles;
+}
+
+void UARTHandler::queueLine() {
+    uint8_t received = rxLength;
+    rxLength = 0;
+
+    // Skip empty lines
+    if (received == 0) {
+        return;
+    }
+
+    // Overlong line: a truncated command must not run. Answered even
+    // while muted, since the operator sent it and not the plan
+    if (received > RX_LINE_SIZE - 1) {
+        bool wasMuted = muted;
+        muted = false;
+        sendErrorf(F("Line too long (max %u)"), RX_LINE_SIZE - 1);
+        muted = wasMuted;
+        return;
+    }
+
+    // Not all of it fit after the queued lines
+    if (queueBytes + received >= RX_QUEUE_BYTES) {
+        if (droppedLines != 0xFF) droppedLines++;
+        return;
+    }
+
+    // Trim whitespace, in place at the end of the queue
+    char* line = &rxQueue[queueBytes];
+    uint8_t start = 0;
+    while (start < received && line[start] == ' ') start++;
+    while (received > start && line[received - 1] == ' ') received--;
+    uint8_t length = received - start;
+    if (length == 0) {
+        return;
+    }
+
+    memmove(line, &line[start], length);
+    line[length] = '\0';
+    queueBytes += length + 1;
+    queueCount++;
+}
+
+void UARTHandler::removeQueued(uint16_t offset) {
+    // Later lines, and the one being received, move up
+    uint16_t length = strlen(&rxQueue[offset]) + 1;
+    memmove(&rxQueue[offset], &rxQueue[offset + length], RX_QUEUE_BYTES - offset - length);
+    queueBytes -= length;
+    queueCount--;
 }
 
 void UARTHandler::sendOK(const char* message) {
-    Serial.print("OK: ");
+    if (muted) return;
+    TxTimer timer(txCycles);
+    Serial.print(F("OK: "));
+    Serial.println(message);
+}
+
+void UARTHandler::sendOK(const __FlashStringHelper* message) {
+    if (muted) return;
+    TxTimer timer(txCycles);
+    Serial.print(F("OK: "));
     Serial.println(message);
 }
 
 void UARTHandler::sendError(const char* message) {
-    Serial.print("ERROR: ");
+    if (muted) {
+        countMutedError(message, false);
+        return;
+    }
+    TxTimer timer(txCycles);
+    errorLines++;
+    Serial.print(F("ERROR: "));
+    Serial.println(message);
+}
+
+void UARTHandler::sendError(const __FlashStringHelper* message) {
+    if (muted) {
+        countMutedError((PGM_P)message, true);
+        return;
+    }
+    TxTimer timer(txCycles);
+    errorLines++;
+    Serial.print(F("ERROR: "));
     Serial.println(message);
 }
 
 void UARTHandler::sendInfo(const char* message) {
+    if (muted) return;
+    TxTimer timer(txCycles);
+    Serial.println(message);
+}
+
+void UARTHandler::sendInfo(const __FlashStringHelper* message) {
+    if (muted) return;
+    TxTimer timer(txCycles);
     Serial.println(message);
 }
 
+void UARTHandler::sendOKf(const __FlashStringHelper* format, ...) {
+    va_list args;
+    va_start(args, format);
+    sendFormatted(F("OK: "), format, args);
+    va_end(args);
+}
+
+void UARTHandler::sendErrorf(const __FlashStringHelper* format, ...) {
+    va_list args;
+    va_start(args, format);
+    if (muted) {
+        vsnprintf_P(lineBuffer, sizeof(lineBuffer), (PGM_P)format, args);
+        countMutedError(lineBuffer, false);
+    } else {
+        errorLines++;
+        sendFormatted(F("ERROR: "), format, args);
+    }
+    va_end(args);
+}
+
+void UARTHandler::sendInfof(const __FlashStringHelper* format, ...) {
+    va_list args;
+    va_start(args, format);
+    sendFormatted(nullptr, format, args);
+    va_end(args);
+}
+
+void UARTHandler::sendFormatted(const __FlashStringHelper* prefix, const __FlashStringHelper* format,
+                                va_list args) {
+    if (muted) return;
+    TxTimer timer(txCycles);
+    vsnprintf_P(lineBuffer, sizeof(lineBuffer), (PGM_P)format, args);
+    if (prefix != nullptr) {
+        Serial.print(prefix);
+    }
+    Serial.println(lineBuffer);
+}
+
 void UARTHandler::sendResult(bool passed, const char* message) {
+    if (muted) {
+        if (!passed) {
+            if (message != nullptr && message[0] != '\0') {
+                countMutedError(message, false);
+            } else {
+                countMutedError(PSTR("RESULT: FAIL"), true);
+            }
+        }
+        return;
+    }
+    TxTimer timer(txCycles);
     if (passed) {
-        Serial.println("RESULT: PASS");
+        Serial.println(F("RESULT: PASS"));
     } else {
-        Serial.print("RESULT: FAIL");
+        Serial.print(F("RESULT: FAIL"));
         if (message && strlen(message) > 0) {
-            Serial.print(" - ");
+            Serial.print(F(" - "));
             Serial.println(message);
         } else {
             Serial.println();